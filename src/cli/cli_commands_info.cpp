@@ -2,10 +2,10 @@
 #include "cli_helpers.h"
 #include <QDir>
 #include <QMap>
-#include "../core/scanner.h"
 #include "../core/hasher.h"
 #include "../core/header_detector.h"
 #include "../core/constants/constants.h"
+#include "../services/library_service.h"
 #include "terminal_image.h"
 #include "cli_logging.h"
 
@@ -93,67 +93,44 @@ int handleScanCommand(CliContext &ctx)
 
     if (scanPath.isEmpty()) { qCritical() << "Scan path not provided"; return 1; }
 
-    qInfo() << "Scanning directory:" << scanPath;
-    qInfo() << "";
-
-    Scanner scanner;
-    scanner.setExtensions(ctx.detector.getAllExtensions());
-
-    QObject::connect(&scanner, &Scanner::fileFound, [](const QString &path) {
-        qDebug() << "Found:" << path;
-    });
-    QObject::connect(&scanner, &Scanner::scanProgress, [](int processed, int) {
-        if (processed % 50 == 0) qInfo() << "Processed" << processed << "files...";
-    });
-
-    QList<ScanResult> results = scanner.scan(scanPath);
-    qInfo() << "";
-    qInfo() << "Scan complete:" << results.size() << "files found";
-
-    int libraryId = ctx.db.insertLibrary(scanPath);
-    int insertedCount = 0;
-    int skippedCount = 0;
-
-    for (const ScanResult &result : results) {
-        const QString systemDetectPath = result.isCompressed && !result.archiveInternalPath.isEmpty()
-            ? result.archiveInternalPath : result.path;
-        const QString systemName = ctx.detector.detectSystem(result.extension, systemDetectPath);
-        const int systemId = systemName.isEmpty() ? 0 : ctx.db.getSystemId(systemName);
-
-        FileRecord record;
-        record.libraryId          = libraryId;
-        record.originalPath       = result.path;
-        record.currentPath        = result.path;
-        record.filename           = result.filename;
-        record.extension          = result.extension;
-        record.fileSize           = result.fileSize;
-        record.isCompressed       = result.isCompressed;
-        record.archivePath        = result.archivePath;
-        record.archiveInternalPath = result.archiveInternalPath;
-        record.systemId           = systemId;
-        record.isPrimary          = result.isPrimary;
-        record.lastModified       = result.lastModified;
-
-        if (ctx.db.insertFile(record) > 0) insertedCount++; else skippedCount++;
-    }
+    // Same reconciliation as the GUI and TUI: a rescan refreshes changed
+    // files and prunes vanished ones instead of only adding new rows
+    LibraryService libraryService;
+    libraryService.scan(
+        scanPath, &ctx.db,
+        [](int done, int, const QString &path) {
+            if (!path.isEmpty()) {
+                qDebug() << "Found:" << path;
+            } else if (done > 0 && done % 50 == 0) {
+                qInfo() << "Processed" << done << "files...";
+            }
+        },
+        [](const QString &message) { qInfo().noquote() << message; });
 
+    const LibraryService::RescanSummary summary = libraryService.lastRescanSummary();
     qInfo() << "";
     qInfo() << "Database updated:";
-    qInfo() << "  - Inserted:" << insertedCount << "files";
-    qInfo() << "  - Skipped:" << skippedCount << "files";
+    qInfo() << "  - Inserted:" << summary.added << "files";
+    qInfo() << "  - Unchanged:" << summary.unchanged << "files";
+    qInfo() << "  - Modified:" << summary.modified << "files";
+    qInfo() << "  - Removed:" << summary.removed << "files";
+    qInfo() << "  - Throughput:" << qRound(summary.rowsPerSecond) << "rows/s";
 
     if (ctx.parser.isSet("hash") || ctx.processRequested) {
         qInfo() << "";
         qInfo() << "Calculating hashes...";
 
         Hasher hasher;
+        applyReadStrategy(ctx.parser, hasher);
         QList<FileRecord> filesToHash = ctx.db.getFilesWithoutHashes();
         int hashedCount = 0;
+        WriteBatch hashBatch(ctx.db);
 
         for (const FileRecord &file : filesToHash) {
             HashResult hashResult = hashFileRecord(file, hasher);
             if (hashResult.success) {
                 ctx.db.updateFileHashes(file.id, hashResult.crc32, hashResult.md5, hashResult.sha1);
+                hashBatch.recordWrite();
                 hashedCount++;
                 if (hashedCount % 10 == 0)
                     qInfo() << "  Hashed" << hashedCount << "of" << filesToHash.size() << "files...";
@@ -161,6 +138,11 @@ int handleScanCommand(CliContext &ctx)
                 qWarning() << "  Hash failed for" << file.filename << ":" << hashResult.error;
             }
         }
+        if (!hashBatch.finish()) {
+            qWarning() << "Database commit failed," << hashBatch.rowsLost()
+                       << "hash updates rolled back:" << hashBatch.lastError();
+            hashedCount -= hashBatch.rowsLost();
+        }
         qInfo() << "Hash calculation complete:" << hashedCount << "files hashed";
     }
     return 0;
@@ -192,13 +174,16 @@ int handleHashAllCommand(CliContext &ctx)
     qInfo() << "";
     qInfo() << "Hashing files without hashes...";
     Hasher hasher;
+    applyReadStrategy(ctx.parser, hasher);
     QList<FileRecord> filesToHash = ctx.db.getFilesWithoutHashes();
     int hashedCount = 0;
+    WriteBatch hashBatch(ctx.db);
 
     for (const FileRecord &file : filesToHash) {
         HashResult hashResult = hashFileRecord(file, hasher);
         if (hashResult.success) {
             ctx.db.updateFileHashes(file.id, hashResult.crc32, hashResult.md5, hashResult.sha1);
+            hashBatch.recordWrite();
             hashedCount++;
             if (hashedCount % 10 == 0)
                 qInfo() << "  Hashed" << hashedCount << "of" << filesToHash.size() << "files...";
@@ -206,6 +191,11 @@ int handleHashAllCommand(CliContext &ctx)
             qWarning() << "  Hash failed for" << file.filename << ":" << hashResult.error;
         }
     }
+    if (!hashBatch.finish()) {
+        qWarning() << "Database commit failed," << hashBatch.rowsLost()
+                   << "hash updates rolled back:" << hashBatch.lastError();
+        hashedCount -= hashBatch.rowsLost();
+    }
     qInfo() << "Hashing complete:" << hashedCount << "files hashed";
     return 0;
 }
@@ -3,6 +3,7 @@
 #include <QDateTime>
 #include <QFile>
 #include <QTextStream>
+#include "../metadata/metadata_cache.h"
 #include "../metadata/provider_orchestrator.h"
 #include "../core/constants/constants.h"
 #include "cli_logging.h"
@@ -18,7 +19,9 @@ int handleMatchCommand(CliContext &ctx)
     qInfo() << "=== Intelligent Metadata Matching (M3) ===";
     qInfo() << "";
 
+    MetadataCache metadataCache(ctx.db.database());
     auto orchestrator = buildOrchestrator(ctx.parser);
+    orchestrator->setMetadataCache(&metadataCache);
 
     QObject::connect(orchestrator.get(), &ProviderOrchestrator::tryingProvider,
                      [](const QString &name, const QString &method) {
@@ -44,11 +47,19 @@ int handleMatchCommand(CliContext &ctx)
     }
     qInfo() << "";
 
-    int matched = 0, failed = 0;
-
-    for (const FileRecord &file : files) {
+    // One pipelined batch up front instead of a Hasheous request per file
+    QList<FileRecord> unmatched;
+    QList<ProviderOrchestrator::FileHashes> hashes;
+    for (const FileRecord &file : std::as_const(files)) {
         if (ctx.db.getMatchForFile(file.id).matchId != 0) continue;
+        unmatched.append(file);
+        hashes.append({file.crc32, file.md5, file.sha1});
+    }
+    orchestrator->prefetchHashes(hashes);
 
+    int matched = 0, failed = 0;
+
+    for (const FileRecord &file : std::as_const(unmatched)) {
         qInfo() << "Matching:" << file.filename;
 
         GameMetadata metadata = orchestrator->searchWithFallback(
@@ -86,6 +97,7 @@ int handleMatchCommand(CliContext &ctx)
         qInfo() << "Success rate:"
                 << QString::number((matched * 100.0) / (matched + failed), 'f', 1) + "%";
     }
+    orchestrator->logProviderStats();
     return 0;
 }
 
@@ -97,7 +109,9 @@ int handleMatchReportCommand(CliContext &ctx)
     qInfo() << "=== Matching Report with Confidence Scores ===";
     qInfo() << "";
 
+    MetadataCache metadataCache(ctx.db.database());
     auto orchestrator  = buildOrchestrator(ctx.parser);
+    orchestrator->setMetadataCache(&metadataCache);
     QList<FileRecord> files = getHashedFiles(ctx.db);
     int minConfidence  = ctx.parser.value("min-confidence").toInt();
 
@@ -122,6 +136,12 @@ int handleMatchReportCommand(CliContext &ctx)
     outStream << "│ ID         │ Filename                     │ Conf %   │ Method   │ Title                │\n";
     outStream << "├────────────┼──────────────────────────────┼──────────┼──────────┼──────────────────────┤\n";
 
+    QList<ProviderOrchestrator::FileHashes> hashes;
+    for (const FileRecord &file : std::as_const(files)) {
+        hashes.append({file.crc32, file.md5, file.sha1});
+    }
+    orchestrator->prefetchHashes(hashes);
+
     for (const FileRecord &file : files) {
         GameMetadata metadata = orchestrator->searchWithFallback(
             selectBestHash(file), file.filename, "",
@@ -1,4 +1,5 @@
 #include "cli_commands.h"
+#include "cli_helpers.h"
 #include <QFileInfo>
 #include "../core/hasher.h"
 #include "../core/verification_engine.h"
@@ -27,6 +28,7 @@ int handleChecksumVerifyCommand(CliContext &ctx)
     }
 
     Hasher hasher;
+    applyReadStrategy(ctx.parser, hasher);
     HashResult result = hasher.calculateHashes(filePath, false, 0);
     QString calculatedHash;
     if      (hashType == "md5")  calculatedHash = result.md5.toLower();
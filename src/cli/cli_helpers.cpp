@@ -2,6 +2,7 @@
 #include <QFileInfo>
 #include <QTemporaryDir>
 #include "../core/archive_extractor.h"
+#include "../core/zip_reader.h"
 #include "../metadata/screenscraper_provider.h"
 #include "../metadata/thegamesdb_provider.h"
 #include "../metadata/igdb_provider.h"
@@ -59,6 +60,13 @@ HashResult hashFileRecord(const FileRecord &file, Hasher &hasher)
         return result;
     }
 
+    const QString internalPath = file.archiveInternalPath.isEmpty() ? file.filename : file.archiveInternalPath;
+    if (ZipReader::isZipPath(archivePath)) {
+        result = hasher.calculateZipMemberHashes(archivePath, internalPath, file.extension);
+        if (result.success) return result;
+        result = HashResult();
+    }
+
     QTemporaryDir tempDir;
     if (!tempDir.isValid()) {
         result.error = "Failed to create temporary directory";
@@ -66,7 +74,6 @@ HashResult hashFileRecord(const FileRecord &file, Hasher &hasher)
     }
 
     ArchiveExtractor extractor;
-    const QString internalPath = file.archiveInternalPath.isEmpty() ? file.filename : file.archiveInternalPath;
     ExtractionResult extraction = extractor.extractFile(archivePath, internalPath, tempDir.path());
     if (!extraction.success || extraction.extractedFiles.isEmpty()) {
         extraction = extractor.extract(archivePath, tempDir.path(), false);
@@ -91,6 +98,15 @@ HashResult hashFileRecord(const FileRecord &file, Hasher &hasher)
     return hasher.calculateHashes(extractedPath, headerSize > 0, headerSize);
 }
 
+void applyReadStrategy(const QCommandLineParser &parser, Hasher &hasher)
+{
+    const QString name = parser.value("read-strategy").trimmed().toLower();
+    const Hasher::ReadStrategy strategy = Hasher::readStrategyFromName(name);
+    if (Hasher::readStrategyName(strategy) != name)
+        qWarning() << "Unknown read strategy" << name << "- using auto";
+    hasher.setReadStrategy(strategy);
+}
+
 std::unique_ptr<ProviderOrchestrator> buildOrchestrator(const QCommandLineParser &parser)
 {
     auto orchestrator = std::make_unique<ProviderOrchestrator>();
@@ -120,6 +136,11 @@ std::unique_ptr<ProviderOrchestrator> buildOrchestrator(const QCommandLineParser
     orchestrator->addProvider(Providers::IGDB, igdbProvider,
                               igdbInfo ? igdbInfo->priority : 40);
 
+    if (parser.isSet("hedge-delay"))
+        orchestrator->setHedgeDelay(parser.value("hedge-delay").toInt());
+    if (parser.isSet("concurrent-lookups"))
+        orchestrator->setConcurrentLookups(true);
+
     return orchestrator;
 }
 
@@ -23,6 +23,10 @@ QString selectBestHash(const FileRecord &file);
 // by extracting to a temporary directory first.
 HashResult hashFileRecord(const FileRecord &file, Hasher &hasher);
 
+// Make a Hasher read files the way --read-strategy asks.
+// Unknown names fall back to auto with a warning.
+void applyReadStrategy(const QCommandLineParser &parser, Hasher &hasher);
+
 // Construct a ProviderOrchestrator configured from parser credentials.
 // Adds Hasheous, TheGamesDB, and IGDB unconditionally; ScreenScraper only
 // when --ss-user / --ss-pass are both set.
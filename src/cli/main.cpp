@@ -74,6 +74,7 @@ int main(int argc, char *argv[])
     parser.addOption({{"d", "db"}, "Database file path", "database", Constants::DatabaseSchema::DATABASE_FILENAME});
     parser.addOption(QCommandLineOption("hash", "Calculate hashes for scanned files"));
     parser.addOption(QCommandLineOption("hash-all", "Calculate hashes for all files in database that lack hashes"));
+    parser.addOption(QCommandLineOption("read-strategy", "How hashing reads files (auto|buffered|pread|mmap|direct)", "strategy", "auto"));
     parser.addOption({{"l", "list"}, "List scanned files by system"});
     parser.addOption(QCommandLineOption("stats", "Show library statistics"));
     parser.addOption(QCommandLineOption("info", "Show detailed info for a file id", "fileId"));
@@ -91,6 +92,8 @@ int main(int argc, char *argv[])
     parser.addOption(QCommandLineOption("ss-pass",    "ScreenScraper password",      "password"));
     parser.addOption(QCommandLineOption("ss-devid",   "ScreenScraper dev ID",        "devid"));
     parser.addOption(QCommandLineOption("ss-devpass", "ScreenScraper dev password",  "devpassword"));
+    parser.addOption(QCommandLineOption("concurrent-lookups", "Ask metadata providers in parallel"));
+    parser.addOption(QCommandLineOption("hedge-delay", "Delay (ms) before the next provider is also asked with --concurrent-lookups", "ms"));
 
     // M3 Matching options
     parser.addOption(QCommandLineOption("match", "Match scanned files with metadata (M3 intelligent matching)"));
@@ -1,4 +1,7 @@
 #include "archive_extractor.h"
+#include "archive_listing_cache.h"
+#include "seven_zip_reader.h"
+#include "zip_reader.h"
 #include <QProcess>
 #include <QFileInfo>
 #include <QDir>
@@ -73,11 +76,41 @@ ArchiveFormat ArchiveExtractor::detectFormat(const QString &path)
 }
 
 ArchiveInfo ArchiveExtractor::getArchiveInfo(const QString &path)
+{
+    if (!m_listingCache) {
+        return listArchive(path);
+    }
+
+    const QFileInfo fileInfo(path);
+    ArchiveInfo info;
+    info.path = path;
+    if (m_listingCache->lookup(fileInfo, info)) {
+        return info;
+    }
+
+    info = listArchive(path);
+    // Failed tool runs list nothing; don't let them stick
+    if (!info.members.isEmpty()) {
+        m_listingCache->store(fileInfo, info);
+    }
+    return info;
+}
+
+void ArchiveExtractor::setListingCache(ArchiveListingCache *cache)
+{
+    m_listingCache = cache;
+}
+
+ArchiveInfo ArchiveExtractor::listArchive(const QString &path)
 {
     ArchiveInfo info;
     info.path = path;
     info.format = detectFormat(path);
     info.compressedSize = QFileInfo(path).size();
+
+    if (readNativeListing(path, info)) {
+        return info;
+    }
     
     QStringList args;
     ProcessResult processResult;
@@ -144,6 +177,7 @@ ArchiveInfo ArchiveExtractor::getArchiveInfo(const QString &path)
                     QString filename = match.captured(3).trimmed();
                     if (!filename.isEmpty() && filename != "1 file") {
                         info.contents.append(filename);
+                        info.members.append({filename, match.captured(1).toLongLong(), QString()});
                         info.fileCount++;
                     }
                 }
@@ -183,6 +217,7 @@ ArchiveInfo ArchiveExtractor::getArchiveInfo(const QString &path)
                     QString filename = match.captured(3).trimmed();
                     if (!filename.isEmpty()) {
                         info.contents.append(filename);
+                        info.members.append({filename, match.captured(2).toLongLong(), QString()});
                         info.fileCount++;
                     }
                 } else {
@@ -192,6 +227,7 @@ ArchiveInfo ArchiveExtractor::getArchiveInfo(const QString &path)
                         QString filename = parts.last();
                         if (!filename.isEmpty() && !filename.contains(QRegularExpression("^\\d+$"))) {
                             info.contents.append(filename);
+                            info.members.append({filename, -1, QString()});
                             info.fileCount++;
                         }
                     }
@@ -219,6 +255,7 @@ ArchiveInfo ArchiveExtractor::getArchiveInfo(const QString &path)
                     QString filename = parts[0];
                     if (!filename.isEmpty()) {
                         info.contents.append(filename);
+                        info.members.append({filename, parts[1].toLongLong(), QString()});
                         info.fileCount++;
                     }
                 }
@@ -229,6 +266,46 @@ ArchiveInfo ArchiveExtractor::getArchiveInfo(const QString &path)
     return info;
 }
 
+bool ArchiveExtractor::readNativeListing(const QString &path, ArchiveInfo &info)
+{
+    auto addMember = [&info](const QString &name, quint64 size, bool hasCrc, quint32 crc) {
+        const QString crcHex = hasCrc ? QString("%1").arg(crc, 8, 16, QLatin1Char('0')) : QString();
+        info.members.append({name, static_cast<qint64>(size), crcHex});
+        info.contents.append(name);
+        info.uncompressedSize += static_cast<qint64>(size);
+        info.fileCount++;
+    };
+
+    if (ZipReader::isZipPath(path)) {
+        ZipReader zip(path);
+        if (!zip.open()) {
+            qDebug() << "Native ZIP listing failed, using external tool:" << path << zip.errorString();
+            return false;
+        }
+        for (const ZipEntry &entry : zip.entries()) {
+            if (!entry.isDirectory()) {
+                addMember(entry.name, entry.uncompressedSize, true, entry.crc32);
+            }
+        }
+    } else if (SevenZipReader::isSevenZipPath(path)) {
+        SevenZipReader sevenZip(path);
+        if (!sevenZip.open()) {
+            qDebug() << "Native 7z listing failed, using external tool:" << path << sevenZip.errorString();
+            return false;
+        }
+        for (const SevenZipEntry &entry : sevenZip.entries()) {
+            if (!entry.isDirectory) {
+                addMember(entry.name, entry.size, entry.hasCrc32, entry.crc32);
+            }
+        }
+    } else {
+        return false;
+    }
+
+    info.listedNatively = true;
+    return true;
+}
+
 ExtractionResult ArchiveExtractor::extract(const QString &archivePath,
                                             const QString &outputDir,
                                             bool createSubfolder)
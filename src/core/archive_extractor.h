@@ -3,11 +3,14 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <QList>
 #include <QMap>
 #include <QProcess>
 
 namespace Remus {
 
+class ArchiveListingCache;
+
 /**
  * @brief Supported archive formats
  */
@@ -21,6 +24,15 @@ enum class ArchiveFormat {
     TarBz2
 };
 
+/**
+ * @brief One file inside an archive
+ */
+struct ArchiveMember {
+    QString path;                  // Path within archive
+    qint64 size = -1;              // Uncompressed size (-1 if unknown)
+    QString crc32;                 // Stored CRC32, lowercase hex (empty if unknown)
+};
+
 /**
  * @brief Information about an archive file
  */
@@ -31,6 +43,8 @@ struct ArchiveInfo {
     qint64 uncompressedSize = 0;   // Total extracted size
     int fileCount = 0;             // Number of files in archive
     QStringList contents;          // List of contained files
+    QList<ArchiveMember> members;  // Same files with sizes/CRCs where known
+    bool listedNatively = false;   // Read in-process rather than via an external tool
 };
 
 /**
@@ -53,6 +67,10 @@ struct ExtractionResult {
  * - ZIP: unzip (standard on most systems)
  * - 7z: 7z or 7za (7-zip command line)
  * - RAR: unrar or rar
+ *
+ * Listings of ZIP and 7z archives are read in-process (ZipReader,
+ * SevenZipReader), including member sizes and stored CRC32s; the tools
+ * are only spawned for other formats or archives those readers reject.
  * 
  * Automatically detects format from file extension.
  */
@@ -84,9 +102,26 @@ public:
 
     /**
      * @brief Get information about an archive without extracting
+     *
+     * With a listing cache set, an archive whose size and mtime match a
+     * cached listing is not opened at all; fresh listings are added to it.
      */
     ArchiveInfo getArchiveInfo(const QString &path);
 
+    /**
+     * @brief Consult and fill a persistent listing cache (not owned; nullptr disables)
+     */
+    void setListingCache(ArchiveListingCache *cache);
+    ArchiveListingCache *listingCache() const { return m_listingCache; }
+
+    /**
+     * @brief List a ZIP or 7z archive in-process
+     * @param path Archive path
+     * @param info Filled with members, sizes and CRCs on success
+     * @return False for other formats or unreadable archives
+     */
+    static bool readNativeListing(const QString &path, ArchiveInfo &info);
+
     /**
      * @brief Detect archive format from file path
      */
@@ -161,6 +196,7 @@ protected:
     virtual QStringList listFiles(const QString &dirPath) const;
 
 private:
+    ArchiveInfo listArchive(const QString &path);
 
     ExtractionResult extractZip(const QString &archivePath, const QString &outputDir);
     ExtractionResult extract7z(const QString &archivePath, const QString &outputDir);
@@ -172,6 +208,7 @@ private:
     QString m_unzipPath;
     QString m_sevenZipPath;
     QString m_unrarPath;
+    ArchiveListingCache *m_listingCache = nullptr;
     
     bool m_cancelled = false;
     ::QProcess *m_process = nullptr;
@@ -0,0 +1,171 @@
+#include "archive_listing_cache.h"
+#include "database.h"
+#include <QDateTime>
+#include <QDir>
+#include <QMutexLocker>
+
+namespace Remus {
+
+int ArchiveListingCache::load(Database &db)
+{
+    const QList<Database::ArchiveListingEntry> listings = db.getArchiveListings();
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_dirty.clear();
+    m_touched.clear();
+    m_hits = 0;
+    m_misses = 0;
+    m_entries.reserve(listings.size());
+
+    for (const Database::ArchiveListingEntry &listing : listings) {
+        Entry entry;
+        entry.size = listing.archiveSize;
+        entry.mtimeMs = listing.archiveMtimeMs;
+        entry.info.path = listing.archivePath;
+        entry.info.format = listing.format;
+        entry.info.compressedSize = listing.archiveSize;
+        entry.info.listedNatively = listing.listedNatively;
+        entry.info.members = listing.members;
+        for (const ArchiveMember &member : listing.members) {
+            entry.info.contents.append(member.path);
+            entry.info.uncompressedSize += qMax<qint64>(0, member.size);
+        }
+        entry.info.fileCount = listing.members.size();
+        m_entries.insert(listing.archivePath, entry);
+    }
+    return m_entries.size();
+}
+
+const ArchiveListingCache::Entry *ArchiveListingCache::findCurrent(const QFileInfo &archive) const
+{
+    const auto it = m_entries.constFind(archive.absoluteFilePath());
+    if (it == m_entries.constEnd()) {
+        return nullptr;
+    }
+    if (it->size != archive.size()
+        || it->mtimeMs != archive.lastModified().toMSecsSinceEpoch()) {
+        return nullptr;
+    }
+    return &it.value();
+}
+
+bool ArchiveListingCache::lookup(const QFileInfo &archive, ArchiveInfo &info)
+{
+    QMutexLocker locker(&m_mutex);
+    const Entry *entry = findCurrent(archive);
+    if (!entry) {
+        m_misses++;
+        return false;
+    }
+
+    // Keep the caller's spelling of the path; everything else comes from the cache
+    const QString path = info.path;
+    info = entry->info;
+    if (!path.isEmpty()) {
+        info.path = path;
+    }
+    m_touched.insert(archive.absoluteFilePath());
+    m_hits++;
+    return true;
+}
+
+void ArchiveListingCache::store(const QFileInfo &archive, const ArchiveInfo &info)
+{
+    const QString key = archive.absoluteFilePath();
+
+    Entry entry;
+    entry.size = archive.size();
+    entry.mtimeMs = archive.lastModified().toMSecsSinceEpoch();
+    entry.info = info;
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(key, entry);
+    m_dirty.insert(key);
+    m_touched.insert(key);
+}
+
+QString ArchiveListingCache::memberCrc32(const QFileInfo &archive, const QString &memberPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Entry *entry = findCurrent(archive);
+    if (!entry) {
+        return QString();
+    }
+    for (const ArchiveMember &member : entry->info.members) {
+        if (member.path == memberPath) {
+            return member.crc32;
+        }
+    }
+    return QString();
+}
+
+int ArchiveListingCache::flush(Database &db, const QString &pruneRoot)
+{
+    QList<Database::ArchiveListingEntry> pending;
+    QStringList stale;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &path : std::as_const(m_dirty)) {
+            const Entry &entry = m_entries[path];
+            Database::ArchiveListingEntry listing;
+            listing.archivePath = path;
+            listing.archiveSize = entry.size;
+            listing.archiveMtimeMs = entry.mtimeMs;
+            listing.format = entry.info.format;
+            listing.listedNatively = entry.info.listedNatively;
+            listing.members = entry.info.members;
+            pending.append(listing);
+        }
+        m_dirty.clear();
+
+        if (!pruneRoot.isEmpty()) {
+            const QString root = QDir::cleanPath(QFileInfo(pruneRoot).absoluteFilePath());
+            const QString prefix = root.endsWith(QLatin1Char('/')) ? root : root + QLatin1Char('/');
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                if (it.key().startsWith(prefix) && !m_touched.contains(it.key())) {
+                    stale.append(it.key());
+                    it = m_entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    int rows = 0;
+    WriteBatch batch(db);
+    for (const Database::ArchiveListingEntry &listing : std::as_const(pending)) {
+        const int written = db.saveArchiveListing(listing);
+        batch.recordWrite(written);
+        rows += written;
+    }
+    for (const QString &path : std::as_const(stale)) {
+        if (db.removeArchiveListing(path)) {
+            batch.recordWrite();
+            rows++;
+        }
+    }
+    batch.finish();
+    return rows;
+}
+
+int ArchiveListingCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+int ArchiveListingCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+int ArchiveListingCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+} // namespace Remus
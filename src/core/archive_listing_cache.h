@@ -0,0 +1,86 @@
+#ifndef REMUS_ARCHIVE_LISTING_CACHE_H
+#define REMUS_ARCHIVE_LISTING_CACHE_H
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include "archive_extractor.h"
+
+namespace Remus {
+
+class Database;
+
+/**
+ * @brief Archive listings remembered across scans, keyed by path + size + mtime
+ *
+ * load() reads every stored listing in two queries; lookups are then pure
+ * in-memory hash probes, so an unchanged archive is never opened again.
+ * Listings recorded with store() are written back by flush(). An archive
+ * whose size or mtime changed simply misses and is listed afresh.
+ *
+ * load() and flush() touch the database and must run on its thread;
+ * lookup(), store() and memberCrc32() are safe from any thread.
+ */
+class ArchiveListingCache {
+public:
+    /**
+     * @brief Replace the in-memory cache with the database's listings
+     * @return Number of listings loaded
+     */
+    int load(Database &db);
+
+    /**
+     * @brief Fill @p info from the cache if the archive is unchanged
+     * @param archive Archive on disk (size and mtime are compared)
+     * @param info Receives the cached listing on a hit
+     * @return True on a hit
+     */
+    bool lookup(const QFileInfo &archive, ArchiveInfo &info);
+
+    /**
+     * @brief Remember a fresh listing (written on the next flush())
+     */
+    void store(const QFileInfo &archive, const ArchiveInfo &info);
+
+    /**
+     * @brief Stored CRC32 of one member of an unchanged archive
+     * @return Lowercase hex, or empty if unknown or the archive changed
+     */
+    QString memberCrc32(const QFileInfo &archive, const QString &memberPath) const;
+
+    /**
+     * @brief Write listings stored since load() and prune stale ones
+     *
+     * Listings under @p pruneRoot that were neither looked up nor stored
+     * since load() belong to archives the scan no longer found and are
+     * deleted. An empty root prunes nothing.
+     * @return Rows written or removed
+     */
+    int flush(Database &db, const QString &pruneRoot = QString());
+
+    int size() const;
+    int hits() const;
+    int misses() const;
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+        ArchiveInfo info;
+    };
+
+    const Entry *findCurrent(const QFileInfo &archive) const;
+
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_dirty;    // Stored since load(), not yet written
+    QSet<QString> m_touched;  // Looked up or stored since load()
+    int m_hits = 0;
+    int m_misses = 0;
+    mutable QMutex m_mutex;
+};
+
+} // namespace Remus
+
+#endif // REMUS_ARCHIVE_LISTING_CACHE_H
@@ -52,6 +52,12 @@ namespace Tables {
     
     /// Undo table name (organize operation history)
     inline constexpr const char* UNDO_HISTORY = "undo_history";
+
+    /// Archive listing cache (one row per archive, keyed by path)
+    inline constexpr const char* ARCHIVE_LISTINGS = "archive_listings";
+
+    /// Members of cached archive listings
+    inline constexpr const char* ARCHIVE_MEMBERS = "archive_members";
 }
 
 namespace Columns {
@@ -100,6 +106,12 @@ namespace Columns {
         inline constexpr const char* PROCESSING_STATUS = "processing_status";
         inline constexpr const char* LAST_MODIFIED = "last_modified";
         inline constexpr const char* SCANNED_AT = "scanned_at";
+        inline constexpr const char* FP_SIZE = "fp_size";
+        inline constexpr const char* FP_MTIME = "fp_mtime";
+        inline constexpr const char* FP_INODE = "fp_inode";
+        inline constexpr const char* FP_DEVICE = "fp_device";
+        inline constexpr const char* GROUP_DIR = "group_dir";
+        inline constexpr const char* GROUP_NAME = "group_name";
     }
     
     // Games columns
@@ -142,6 +154,23 @@ namespace Columns {
         inline constexpr const char* UNDO_DATA = "undo_data";
         inline constexpr const char* TIMESTAMP = "timestamp";
     }
+
+    // Archive listing columns
+    namespace ArchiveListings {
+        inline constexpr const char* ARCHIVE_PATH = "archive_path";
+        inline constexpr const char* ARCHIVE_SIZE = "archive_size";
+        inline constexpr const char* ARCHIVE_MTIME = "archive_mtime";
+        inline constexpr const char* FORMAT = "format";
+        inline constexpr const char* LISTED_NATIVELY = "listed_natively";
+    }
+
+    // Archive member columns
+    namespace ArchiveMembers {
+        inline constexpr const char* LISTING_ID = "listing_id";
+        inline constexpr const char* MEMBER_PATH = "member_path";
+        inline constexpr const char* SIZE = "size";
+        inline constexpr const char* CRC32 = "crc32";
+    }
 }
 
 // ============================================================================
@@ -154,6 +183,25 @@ inline constexpr const char* PRAGMA_FOREIGN_KEYS = "PRAGMA foreign_keys = ON";
 /// Check database integrity
 inline constexpr const char* PRAGMA_INTEGRITY_CHECK = "PRAGMA integrity_check";
 
+/// Write-ahead logging: readers don't block the writer and commits append instead of rewriting pages
+inline constexpr const char* PRAGMA_JOURNAL_MODE_WAL = "PRAGMA journal_mode = WAL";
+
+/// With WAL, NORMAL only fsyncs at checkpoints; a crash can lose the last commits but never corrupts
+inline constexpr const char* PRAGMA_SYNCHRONOUS_NORMAL = "PRAGMA synchronous = NORMAL";
+
+// ============================================================================
+// Bulk Writes
+// ============================================================================
+
+/// Rows written per transaction before WriteBatch commits
+inline constexpr int WRITE_BATCH_MAX_ROWS = 1000;
+
+/// Longest a WriteBatch keeps a transaction open (milliseconds)
+inline constexpr int WRITE_BATCH_MAX_INTERVAL_MS = 500;
+
+/// Times WriteBatch tries a COMMIT (each waits out the busy timeout) before rolling back
+inline constexpr int WRITE_BATCH_COMMIT_ATTEMPTS = 3;
+
 // ============================================================================
 // Index Names
 // ============================================================================
@@ -164,9 +212,12 @@ namespace Indexes {
     inline constexpr const char* FILES_HASHES = "idx_files_hashes";
     inline constexpr const char* FILES_ORIGINAL_PATH = "idx_files_original_path";
     inline constexpr const char* FILES_PROCESSED = "idx_files_processed";
+    inline constexpr const char* FILES_LIBRARY_ID = "idx_files_library_id";
+    inline constexpr const char* FILES_GROUP = "idx_files_group";
     inline constexpr const char* MATCHES_FILE_ID = "idx_matches_file_id";
     inline constexpr const char* MATCHES_GAME_ID = "idx_matches_game_id";
     inline constexpr const char* CACHE_KEY = "idx_cache_key";
+    inline constexpr const char* ARCHIVE_MEMBERS_LISTING_ID = "idx_archive_members_listing_id";
 }
 
 // ============================================================================
@@ -55,13 +55,25 @@ inline constexpr int IGDB_RATE_LIMIT_MS = 250;
 /// TheGamesDB minimum interval between requests (milliseconds)
 inline constexpr int THEGAMESDB_RATE_LIMIT_MS = 1000;
 
-/// Hasheous minimum interval between requests (milliseconds)
-/// Conservative despite fast service
+/// Hasheous sustained interval between requests (milliseconds)
+/// Conservative despite fast service; up to HASHEOUS_BATCH_IN_FLIGHT may burst
 inline constexpr int HASHEOUS_RATE_LIMIT_MS = 1000;
 
 /// Default rate limit for generic requests (milliseconds)
 inline constexpr int DEFAULT_RATE_LIMIT_MS = 1000;
 
+/// IGDB requests that may go back to back (the API allows 4 per second)
+inline constexpr int IGDB_RATE_BURST = 4;
+
+/// ScreenScraper requests per day for a registered member (0 = no cap)
+inline constexpr int SCREENSCRAPER_DAILY_QUOTA = 20000;
+
+/// Requests a rate limiter counts before writing its daily usage to settings
+inline constexpr int RATE_LIMIT_SAVE_BATCH = 25;
+
+/// Longest a rate limiter holds unsaved daily usage (milliseconds)
+inline constexpr int RATE_LIMIT_SAVE_INTERVAL_MS = 5000;
+
 // ============================================================================
 // Retry Policy
 // ============================================================================
@@ -92,6 +104,22 @@ inline constexpr int MAX_CONCURRENT_REQUESTS = 5;
 /// Thread pool size for network operations
 inline constexpr int NETWORK_THREAD_POOL_SIZE = 4;
 
+/// Artwork downloads running at once against one host
+inline constexpr int ARTWORK_DOWNLOADS_PER_HOST = 2;
+
+/// Times an interrupted artwork download is resumed before giving up
+inline constexpr int ARTWORK_DOWNLOAD_RETRIES = 2;
+
+/// Hasheous hash lookups kept open at once by a batch lookup
+inline constexpr int HASHEOUS_BATCH_IN_FLIGHT = 8;
+
+/// Delay before a concurrent lookup also asks the next provider (milliseconds)
+inline constexpr int PROVIDER_HEDGE_DELAY_MS = 500;
+
+/// Longest a concurrent lookup waits for a decidable result (milliseconds)
+/// Above the slowest provider timeout so a lone provider is never cut short
+inline constexpr int PROVIDER_LOOKUP_TIMEOUT_MS = 25000;
+
 // ============================================================================
 // Cache Control
 // ============================================================================
@@ -99,6 +127,12 @@ inline constexpr int NETWORK_THREAD_POOL_SIZE = 4;
 /// Metadata cache expiration (24 hours in seconds)
 inline constexpr int METADATA_CACHE_TTL_S = 86400;
 
+/// How long a provider's "no match" for a hash is trusted (7 days in seconds)
+inline constexpr int METADATA_NEGATIVE_TTL_S = 604800;
+
+/// Metadata cache entries kept in memory in front of SQLite
+inline constexpr int METADATA_MEMORY_CACHE_ENTRIES = 4096;
+
 /// Cache check interval (5 minutes in seconds)
 inline constexpr int CACHE_CHECK_INTERVAL_S = 300;
 
@@ -17,12 +17,16 @@ inline constexpr const char* THEGAMESDB_API_KEY = "thegamesdb/api_key";
 inline constexpr const char* IGDB_CLIENT_ID = "igdb/client_id";
 inline constexpr const char* IGDB_CLIENT_SECRET = "igdb/client_secret";
 inline constexpr const char* HASHEOUS_CLIENT_API_KEY = "hasheous/client_api_key";
+/// Group holding each provider's daily quota usage ("<group>/<provider>/day", ".../used")
+inline constexpr const char* RATE_LIMIT_USAGE_GROUP = "rate_limits";
 }
 
 namespace Metadata {
 inline constexpr const char* PROVIDER_PRIORITY = "metadata/provider_priority";
 inline constexpr const char* PROVIDER_PRIORITY_ORDER = "metadata/provider_priority_order";
 inline constexpr const char* PROVIDERS_ENABLED = "metadata/providers_enabled";
+inline constexpr const char* CONCURRENT_LOOKUPS = "metadata/concurrent_lookups";
+inline constexpr const char* HEDGE_DELAY_MS = "metadata/hedge_delay_ms";
 }
 
 namespace Organize {
@@ -38,6 +42,7 @@ inline constexpr const char* CONFIDENCE_THRESHOLD = "match/confidence_threshold"
 namespace Performance {
 inline constexpr const char* HASH_ALGORITHM = "performance/hash_algorithm";
 inline constexpr const char* PARALLEL_HASHING = "performance/parallel_hashing";
+inline constexpr const char* READ_STRATEGY = "performance/read_strategy";   ///< Hasher::readStrategyName() value
 }
 
 namespace Defaults {
@@ -47,6 +52,9 @@ inline const QString HASH_ALGORITHM = QStringLiteral("Auto (System Default)");
 inline const QString ORGANIZE_BY_SYSTEM = QStringLiteral("true");
 inline const QString PRESERVE_ORIGINALS = QStringLiteral("false");
 inline const QString PARALLEL_HASHING = QStringLiteral("true");
+inline const QString READ_STRATEGY = QStringLiteral("auto");
+inline const QString CONCURRENT_LOOKUPS = QStringLiteral("false");
+inline const QString HEDGE_DELAY_MS = QStringLiteral("500");   // Network::PROVIDER_HEDGE_DELAY_MS
 inline const QString CONFIDENCE_THRESHOLD = QStringLiteral("75");
 inline const QString TEMPLATE_VARIABLE_HINT = Templates::VARIABLE_HINT;
 }
@@ -60,6 +68,9 @@ inline constexpr const char* MARKER_SKIP_SCAN = ".remusdir";
 
 /// Subdirectory name (relative to the app data path) where downloaded artwork is stored
 inline constexpr const char* ARTWORK_SUBDIR = "artwork";
+
+/// Subdirectory of the artwork directory holding the content-addressed image store
+inline constexpr const char* ARTWORK_STORE_SUBDIR = "store";
 }
 
 } // Settings
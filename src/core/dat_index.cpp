@@ -0,0 +1,485 @@
+#include "dat_index.h"
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Remus {
+
+namespace {
+
+// Image layout (all integers little-endian):
+//   header      HEADER_SIZE bytes
+//   entries     entryCount * ENTRY_SIZE
+//   crc table   crcCount  * (4 + 4)   key, entry number
+//   md5 table   md5Count  * (16 + 4)
+//   sha1 table  sha1Count * (20 + 4)
+//   strings     stringsSize bytes of UTF-8
+// Hash keys are stored as raw digest bytes (CRC32 big-endian) so every
+// table sorts and searches with memcmp. String references are
+// (offset, length) pairs into the string table.
+constexpr char MAGIC[8] = {'R', 'M', 'D', 'A', 'T', 'I', 'D', 'X'};
+constexpr int HEADER_SIZE = 80;
+constexpr int STRING_REF_SIZE = 8;
+
+constexpr int H_VERSION = 8;
+constexpr int H_ENTRY_COUNT = 12;
+constexpr int H_SOURCE_SIZE = 16;
+constexpr int H_SOURCE_MTIME = 24;
+constexpr int H_CRC_COUNT = 32;
+constexpr int H_MD5_COUNT = 36;
+constexpr int H_SHA1_COUNT = 40;
+constexpr int H_STRINGS_SIZE = 44;
+constexpr int H_NAME = 48;
+constexpr int H_DAT_VERSION = 56;
+constexpr int H_DESCRIPTION = 64;
+constexpr int H_IMAGE_SIZE = 72;
+
+constexpr int E_GAME_NAME = 0;
+constexpr int E_DESCRIPTION = 8;
+constexpr int E_REGION = 16;
+constexpr int E_ROM_NAME = 24;
+constexpr int E_SERIAL = 32;
+constexpr int E_STATUS = 40;
+constexpr int E_SIZE = 48;
+constexpr int E_CRC32 = 56;
+constexpr int E_FLAGS = 60;
+constexpr int E_MD5 = 64;
+constexpr int E_SHA1 = 80;
+constexpr int ENTRY_SIZE = 100;
+
+constexpr quint32 HAS_CRC32 = 0x1;
+constexpr quint32 HAS_MD5 = 0x2;
+constexpr quint32 HAS_SHA1 = 0x4;
+
+constexpr int CRC_KEY = 4;
+constexpr int MD5_KEY = 16;
+constexpr int SHA1_KEY = 20;
+
+template <typename T>
+void put(QByteArray &image, int offset, T value)
+{
+    qToLittleEndian(value, image.data() + offset);
+}
+
+template <typename T>
+T get(const uchar *data, int offset)
+{
+    return qFromLittleEndian<T>(data + offset);
+}
+
+/// Deduplicating UTF-8 string table
+class StringTable {
+public:
+    void add(QByteArray &image, int refOffset, const QString &text)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        quint32 offset = 0;
+        const auto it = m_offsets.constFind(utf8);
+        if (it != m_offsets.constEnd()) {
+            offset = it.value();
+        } else {
+            offset = static_cast<quint32>(m_data.size());
+            m_data.append(utf8);
+            m_offsets.insert(utf8, offset);
+        }
+        put<quint32>(image, refOffset, offset);
+        put<quint32>(image, refOffset + 4, static_cast<quint32>(utf8.size()));
+    }
+
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+    QHash<QByteArray, quint32> m_offsets;
+};
+
+struct KeyRecord {
+    uchar key[SHA1_KEY];
+    quint32 entry;
+};
+
+void appendTable(QByteArray &image, std::vector<KeyRecord> &records, int keySize)
+{
+    // Equal keys stay in DAT order, so the last one found is the last in the DAT
+    std::stable_sort(records.begin(), records.end(), [keySize](const KeyRecord &a, const KeyRecord &b) {
+        return std::memcmp(a.key, b.key, static_cast<size_t>(keySize)) < 0;
+    });
+    char entryBytes[4];
+    for (const KeyRecord &record : records) {
+        image.append(reinterpret_cast<const char *>(record.key), keySize);
+        qToLittleEndian(record.entry, entryBytes);
+        image.append(entryBytes, 4);
+    }
+}
+
+int hexValue(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') return u - '0';
+    if (u >= 'a' && u <= 'f') return u - 'a' + 10;
+    if (u >= 'A' && u <= 'F') return u - 'A' + 10;
+    return -1;
+}
+
+QString hexString(const uchar *bytes, int count, bool upper)
+{
+    static const char lowerDigits[] = "0123456789abcdef";
+    static const char upperDigits[] = "0123456789ABCDEF";
+    const char *digits = upper ? upperDigits : lowerDigits;
+    QString text(count * 2, Qt::Uninitialized);
+    QChar *out = text.data();
+    for (int i = 0; i < count; ++i) {
+        out[2 * i] = QLatin1Char(digits[bytes[i] >> 4]);
+        out[2 * i + 1] = QLatin1Char(digits[bytes[i] & 0x0F]);
+    }
+    return text;
+}
+
+void setError(QString *error, const QString &message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+} // namespace
+
+DatIndex::~DatIndex() = default;
+
+QByteArray DatIndex::compile(const QList<DatRomEntry> &entries,
+                             const QMap<QString, QString> &header,
+                             const QFileInfo &source)
+{
+    QByteArray image(HEADER_SIZE + entries.size() * ENTRY_SIZE, '\0');
+    StringTable strings;
+    std::vector<KeyRecord> crcRecords;
+    std::vector<KeyRecord> md5Records;
+    std::vector<KeyRecord> sha1Records;
+
+    std::memcpy(image.data(), MAGIC, sizeof(MAGIC));
+    put<quint32>(image, H_VERSION, FORMAT_VERSION);
+    put<quint32>(image, H_ENTRY_COUNT, static_cast<quint32>(entries.size()));
+    put<qint64>(image, H_SOURCE_SIZE, source.size());
+    put<qint64>(image, H_SOURCE_MTIME, source.lastModified().toMSecsSinceEpoch());
+    strings.add(image, H_NAME, header.value("name"));
+    strings.add(image, H_DAT_VERSION, header.value("version"));
+    strings.add(image, H_DESCRIPTION, header.value("description"));
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const DatRomEntry &entry = entries.at(i);
+        const int base = HEADER_SIZE + i * ENTRY_SIZE;
+        strings.add(image, base + E_GAME_NAME, entry.gameName);
+        strings.add(image, base + E_DESCRIPTION, entry.description);
+        strings.add(image, base + E_REGION, entry.region);
+        strings.add(image, base + E_ROM_NAME, entry.romName);
+        strings.add(image, base + E_SERIAL, entry.serial);
+        strings.add(image, base + E_STATUS, entry.status);
+        put<qint64>(image, base + E_SIZE, entry.size);
+
+        quint32 flags = 0;
+        KeyRecord record{};
+        record.entry = static_cast<quint32>(i);
+        uchar *bytes = reinterpret_cast<uchar *>(image.data());
+        if (parseHexDigest(entry.crc32, record.key, CRC_KEY)) {
+            flags |= HAS_CRC32;
+            put<quint32>(image, base + E_CRC32, qFromBigEndian<quint32>(record.key));
+            crcRecords.push_back(record);
+        }
+        if (parseHexDigest(entry.md5, record.key, MD5_KEY)) {
+            flags |= HAS_MD5;
+            std::memcpy(bytes + base + E_MD5, record.key, MD5_KEY);
+            md5Records.push_back(record);
+        }
+        if (parseHexDigest(entry.sha1, record.key, SHA1_KEY)) {
+            flags |= HAS_SHA1;
+            std::memcpy(bytes + base + E_SHA1, record.key, SHA1_KEY);
+            sha1Records.push_back(record);
+        }
+        put<quint32>(image, base + E_FLAGS, flags);
+    }
+
+    put<quint32>(image, H_CRC_COUNT, static_cast<quint32>(crcRecords.size()));
+    put<quint32>(image, H_MD5_COUNT, static_cast<quint32>(md5Records.size()));
+    put<quint32>(image, H_SHA1_COUNT, static_cast<quint32>(sha1Records.size()));
+    put<quint32>(image, H_STRINGS_SIZE, static_cast<quint32>(strings.data().size()));
+
+    appendTable(image, crcRecords, CRC_KEY);
+    appendTable(image, md5Records, MD5_KEY);
+    appendTable(image, sha1Records, SHA1_KEY);
+    image.append(strings.data());
+    put<quint64>(image, H_IMAGE_SIZE, static_cast<quint64>(image.size()));
+    return image;
+}
+
+bool DatIndex::write(const QByteArray &image, const QString &indexPath, QString *error)
+{
+    if (!QDir().mkpath(QFileInfo(indexPath).absolutePath())) {
+        setError(error, QString("Cannot create directory for %1").arg(indexPath));
+        return false;
+    }
+
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+    if (file.write(image) != image.size() || !file.commit()) {
+        setError(error, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<DatIndex> DatIndex::map(const QString &indexPath, const QFileInfo &source,
+                                        QString *error)
+{
+    std::unique_ptr<DatIndex> index(new DatIndex());
+    index->m_file = std::make_unique<QFile>(indexPath);
+    if (!index->m_file->open(QIODevice::ReadOnly)) {
+        setError(error, index->m_file->errorString());
+        return nullptr;
+    }
+
+    const qint64 size = index->m_file->size();
+    const uchar *data = size > 0 ? index->m_file->map(0, size) : nullptr;
+    if (!data) {
+        setError(error, QString("Cannot map %1").arg(indexPath));
+        return nullptr;
+    }
+    if (!index->attach(data, size, error)) {
+        return nullptr;
+    }
+
+    if (get<qint64>(data, H_SOURCE_SIZE) != source.size()
+        || get<qint64>(data, H_SOURCE_MTIME) != source.lastModified().toMSecsSinceEpoch()) {
+        setError(error, QString("Index is older than %1").arg(source.fileName()));
+        return nullptr;
+    }
+    return index;
+}
+
+std::unique_ptr<DatIndex> DatIndex::fromImage(const QByteArray &image, QString *error)
+{
+    std::unique_ptr<DatIndex> index(new DatIndex());
+    index->m_image = image;
+    if (!index->attach(reinterpret_cast<const uchar *>(index->m_image.constData()),
+                       index->m_image.size(), error)) {
+        return nullptr;
+    }
+    return index;
+}
+
+bool DatIndex::attach(const uchar *data, qint64 size, QString *error)
+{
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        setError(error, "Not a DAT index");
+        return false;
+    }
+    if (get<quint32>(data, H_VERSION) != FORMAT_VERSION) {
+        setError(error, "DAT index format version mismatch");
+        return false;
+    }
+
+    m_entryCount = get<quint32>(data, H_ENTRY_COUNT);
+    m_crcCount = get<quint32>(data, H_CRC_COUNT);
+    m_md5Count = get<quint32>(data, H_MD5_COUNT);
+    m_sha1Count = get<quint32>(data, H_SHA1_COUNT);
+    m_stringsSize = get<quint32>(data, H_STRINGS_SIZE);
+
+    const quint64 expected = quint64(HEADER_SIZE)
+        + quint64(m_entryCount) * ENTRY_SIZE
+        + quint64(m_crcCount) * (CRC_KEY + 4)
+        + quint64(m_md5Count) * (MD5_KEY + 4)
+        + quint64(m_sha1Count) * (SHA1_KEY + 4)
+        + m_stringsSize;
+    if (expected != quint64(size) || get<quint64>(data, H_IMAGE_SIZE) != quint64(size)
+        || m_crcCount > m_entryCount || m_md5Count > m_entryCount || m_sha1Count > m_entryCount) {
+        setError(error, "DAT index is truncated or corrupt");
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_entries = data + HEADER_SIZE;
+    m_crcTable = m_entries + qint64(m_entryCount) * ENTRY_SIZE;
+    m_md5Table = m_crcTable + qint64(m_crcCount) * (CRC_KEY + 4);
+    m_sha1Table = m_md5Table + qint64(m_md5Count) * (MD5_KEY + 4);
+    m_strings = m_sha1Table + qint64(m_sha1Count) * (SHA1_KEY + 4);
+    return true;
+}
+
+QString DatIndex::string(const uchar *ref) const
+{
+    const quint32 offset = get<quint32>(ref, 0);
+    const quint32 length = get<quint32>(ref, 4);
+    if (quint64(offset) + length > m_stringsSize) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char *>(m_strings + offset),
+                             static_cast<qsizetype>(length));
+}
+
+const uchar *DatIndex::record(int index) const
+{
+    if (index < 0 || quint32(index) >= m_entryCount) {
+        return nullptr;
+    }
+    return m_entries + qint64(index) * ENTRY_SIZE;
+}
+
+QString DatIndex::datName() const
+{
+    return string(m_data + H_NAME);
+}
+
+QString DatIndex::datVersion() const
+{
+    return string(m_data + H_DAT_VERSION);
+}
+
+QString DatIndex::datDescription() const
+{
+    return string(m_data + H_DESCRIPTION);
+}
+
+int DatIndex::findKey(const uchar *table, quint32 count, int keySize, const uchar *key) const
+{
+    // Upper bound, then step back: the last of several equal keys wins
+    const int stride = keySize + 4;
+    quint32 low = 0;
+    quint32 high = count;
+    while (low < high) {
+        const quint32 mid = low + (high - low) / 2;
+        if (std::memcmp(table + qint64(mid) * stride, key, static_cast<size_t>(keySize)) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return -1;
+    }
+    const uchar *found = table + qint64(low - 1) * stride;
+    if (std::memcmp(found, key, static_cast<size_t>(keySize)) != 0) {
+        return -1;
+    }
+    const quint32 entry = get<quint32>(found, keySize);
+    return entry < m_entryCount ? static_cast<int>(entry) : -1;
+}
+
+int DatIndex::findCrc32(quint32 crc) const
+{
+    uchar key[CRC_KEY];
+    qToBigEndian(crc, key);
+    return findKey(m_crcTable, m_crcCount, CRC_KEY, key);
+}
+
+int DatIndex::findMd5(const uchar *digest) const
+{
+    return findKey(m_md5Table, m_md5Count, MD5_KEY, digest);
+}
+
+int DatIndex::findSha1(const uchar *digest) const
+{
+    return findKey(m_sha1Table, m_sha1Count, SHA1_KEY, digest);
+}
+
+int DatIndex::find(QStringView hash) const
+{
+    int digits = 0;
+    for (QChar c : hash) {
+        if (!c.isSpace()) {
+            digits++;
+        }
+    }
+
+    uchar key[SHA1_KEY];
+    switch (digits) {
+    case CRC_KEY * 2:
+        return parseHexDigest(hash, key, CRC_KEY) ? findKey(m_crcTable, m_crcCount, CRC_KEY, key) : -1;
+    case MD5_KEY * 2:
+        return parseHexDigest(hash, key, MD5_KEY) ? findMd5(key) : -1;
+    case SHA1_KEY * 2:
+        return parseHexDigest(hash, key, SHA1_KEY) ? findSha1(key) : -1;
+    default:
+        return -1;
+    }
+}
+
+DatRomEntry DatIndex::entry(int index) const
+{
+    DatRomEntry entry;
+    const uchar *rec = record(index);
+    if (!rec) {
+        return entry;
+    }
+
+    entry.gameName = string(rec + E_GAME_NAME);
+    entry.description = string(rec + E_DESCRIPTION);
+    entry.region = string(rec + E_REGION);
+    entry.romName = string(rec + E_ROM_NAME);
+    entry.serial = string(rec + E_SERIAL);
+    entry.status = string(rec + E_STATUS);
+    entry.size = get<qint64>(rec, E_SIZE);
+
+    // Same spelling the parser produces: CRC32 upper case, MD5/SHA1 lower case
+    const quint32 flags = get<quint32>(rec, E_FLAGS);
+    if (flags & HAS_CRC32) {
+        uchar crc[CRC_KEY];
+        qToBigEndian(get<quint32>(rec, E_CRC32), crc);
+        entry.crc32 = hexString(crc, CRC_KEY, true);
+    }
+    if (flags & HAS_MD5) {
+        entry.md5 = hexString(rec + E_MD5, MD5_KEY, false);
+    }
+    if (flags & HAS_SHA1) {
+        entry.sha1 = hexString(rec + E_SHA1, SHA1_KEY, false);
+    }
+    return entry;
+}
+
+QString DatIndex::gameName(int index) const
+{
+    const uchar *rec = record(index);
+    return rec ? string(rec + E_GAME_NAME) : QString();
+}
+
+QString DatIndex::romName(int index) const
+{
+    const uchar *rec = record(index);
+    return rec ? string(rec + E_ROM_NAME) : QString();
+}
+
+qint64 DatIndex::romSize(int index) const
+{
+    const uchar *rec = record(index);
+    return rec ? get<qint64>(rec, E_SIZE) : 0;
+}
+
+bool DatIndex::parseHexDigest(QStringView hex, uchar *out, int bytes)
+{
+    int digits = 0;
+    for (QChar c : hex) {
+        if (c.isSpace()) {
+            continue;
+        }
+        const int value = hexValue(c);
+        if (value < 0 || digits >= bytes * 2) {
+            return false;
+        }
+        if (digits % 2 == 0) {
+            out[digits / 2] = static_cast<uchar>(value << 4);
+        } else {
+            out[digits / 2] |= static_cast<uchar>(value);
+        }
+        digits++;
+    }
+    return digits == bytes * 2;
+}
+
+} // namespace Remus
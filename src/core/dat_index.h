@@ -0,0 +1,139 @@
+#ifndef REMUS_DAT_INDEX_H
+#define REMUS_DAT_INDEX_H
+
+#include "dat_parser.h"
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QString>
+#include <QStringView>
+#include <memory>
+
+namespace Remus {
+
+/**
+ * @brief Precompiled, memory-mappable index of one DAT
+ *
+ * compile() turns parsed DAT entries into a flat little-endian image:
+ * a header, one fixed-size record per entry, three sorted arrays of
+ * binary hash keys (CRC32, MD5, SHA1 -> entry number) and a UTF-8 string
+ * table. map() opens such an image with QFile::map() and checks its magic,
+ * format version and the source DAT's size and mtime; lookups are binary
+ * searches over the mapped bytes and only the entry that is returned is
+ * turned back into QStrings.
+ *
+ * Each entry is stored once with interned strings, so an index built in
+ * memory with fromImage() is also a compact replacement for hash-keyed
+ * maps of DatRomEntry (VerificationEngine keeps its DAT cache this way).
+ *
+ * Instances are immutable once created and safe to query from any thread.
+ */
+class DatIndex {
+public:
+    /// Bumped whenever the on-disk layout changes; older images are rebuilt
+    static constexpr quint32 FORMAT_VERSION = 2;
+
+    /// File suffix of compiled indexes
+    static constexpr const char *FILE_SUFFIX = ".rdi";
+
+    ~DatIndex();
+
+    DatIndex(const DatIndex &) = delete;
+    DatIndex &operator=(const DatIndex &) = delete;
+
+    /**
+     * @brief Build an index image from parsed DAT data
+     * @param entries Entries in DAT order (later duplicates win lookups)
+     * @param header DAT header fields (name, version, description)
+     * @param source The DAT file, recorded so stale images can be detected
+     */
+    static QByteArray compile(const QList<DatRomEntry> &entries,
+                              const QMap<QString, QString> &header,
+                              const QFileInfo &source);
+
+    /**
+     * @brief Write an image atomically (creating the directory if needed)
+     */
+    static bool write(const QByteArray &image, const QString &indexPath, QString *error = nullptr);
+
+    /**
+     * @brief Map a compiled index from disk
+     * @param indexPath Path of the .rdi file
+     * @param source DAT the index must have been compiled from
+     * @return Index, or nullptr if missing, corrupt, outdated or stale
+     */
+    static std::unique_ptr<DatIndex> map(const QString &indexPath, const QFileInfo &source,
+                                         QString *error = nullptr);
+
+    /**
+     * @brief Use an in-memory image (when the index could not be written)
+     */
+    static std::unique_ptr<DatIndex> fromImage(const QByteArray &image, QString *error = nullptr);
+
+    int entryCount() const { return static_cast<int>(m_entryCount); }
+    QString datName() const;
+    QString datVersion() const;
+    QString datDescription() const;
+
+    /// Whether the index is backed by a mapped file (rather than a heap image)
+    bool isMapped() const { return m_file != nullptr; }
+
+    /**
+     * @brief Find an entry by hash
+     *
+     * The algorithm is picked from the hex length (8 CRC32, 32 MD5, 40 SHA1);
+     * case and embedded spaces are ignored. No allocations are made.
+     * @return Entry number, or -1
+     */
+    int find(QStringView hash) const;
+
+    int findCrc32(quint32 crc) const;
+    int findMd5(const uchar *digest) const;
+    int findSha1(const uchar *digest) const;
+
+    /**
+     * @brief Materialize an entry
+     */
+    DatRomEntry entry(int index) const;
+
+    QString gameName(int index) const;
+    QString romName(int index) const;
+    qint64 romSize(int index) const;
+
+    /**
+     * @brief Parse a hex digest, skipping spaces
+     * @param hex Hex text (either case)
+     * @param out Receives @p bytes bytes
+     * @return False unless exactly 2 * @p bytes hex digits were found
+     */
+    static bool parseHexDigest(QStringView hex, uchar *out, int bytes);
+
+private:
+    DatIndex() = default;
+
+    bool attach(const uchar *data, qint64 size, QString *error);
+    QString string(const uchar *ref) const;
+    const uchar *record(int index) const;
+    int findKey(const uchar *table, quint32 count, int keySize, const uchar *key) const;
+
+    std::unique_ptr<QFile> m_file;  // Set when mapped
+    QByteArray m_image;             // Set when built in memory
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+
+    quint32 m_entryCount = 0;
+    quint32 m_crcCount = 0;
+    quint32 m_md5Count = 0;
+    quint32 m_sha1Count = 0;
+    const uchar *m_entries = nullptr;
+    const uchar *m_crcTable = nullptr;
+    const uchar *m_md5Table = nullptr;
+    const uchar *m_sha1Table = nullptr;
+    const uchar *m_strings = nullptr;
+    quint32 m_stringsSize = 0;
+};
+
+} // namespace Remus
+
+#endif // REMUS_DAT_INDEX_H
@@ -25,13 +25,17 @@ struct DatHeader {
 
 /**
  * @brief Individual ROM entry in a DAT file
+ *
+ * Shared by the Logiqx and ClrMamePro parsers (ClrMameProEntry is an alias)
+ * and stored compactly by DatIndex.
  */
 struct DatRomEntry {
     QString gameName;       // Parent game name
     QString description;    // Game description
+    QString region;         // Region (ClrMamePro DATs; e.g., "USA", "Europe")
     QString romName;        // ROM filename
     qint64 size = 0;        // File size in bytes
-    QString crc32;          // CRC32 hash (lowercase hex)
+    QString crc32;          // CRC32 hash (hex)
     QString md5;            // MD5 hash (lowercase hex)
     QString sha1;           // SHA1 hash (lowercase hex)
     QString status;         // "verified", "good", "bad", etc.
@@ -3,10 +3,16 @@
 #include "constants/constants.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QHash>
 #include <QVariant>
 #include <QDebug>
 #include <QFileInfo>
+#include <QRegularExpression>
 #include <QUuid>
+#include <QtConcurrent/QtConcurrentFilter>
+#include <algorithm>
+#include <iterator>
+#include <tuple>
 
 namespace Remus {
 
@@ -37,6 +43,11 @@ bool Database::initialize(const QString &dbPath, const QString &connectionName)
 
     qInfo() << "Database opened:" << dbPath;
 
+    // Bulk imports are dominated by fsyncs; WAL + NORMAL makes commits cheap
+    QSqlQuery pragma(m_db);
+    pragma.exec(Constants::DatabaseSchema::PRAGMA_JOURNAL_MODE_WAL);
+    pragma.exec(Constants::DatabaseSchema::PRAGMA_SYNCHRONOUS_NORMAL);
+
     // Check if schema exists
     QSqlQuery query(m_db);
     query.exec(QString("SELECT name FROM sqlite_master WHERE type='table' AND name='%1'")
@@ -66,6 +77,12 @@ bool Database::initialize(const QString &dbPath, const QString &connectionName)
 
 void Database::close()
 {
+    // Cached statements must go before the connection is removed
+    m_insertFileQuery.reset();
+    m_updateHashesQuery.reset();
+    m_allFilesCache.clear();
+    m_allFilesCacheValid = false;
+
     if (m_db.isOpen()) {
         m_db.close();
     }
@@ -86,6 +103,8 @@ void Database::runMigrations()
     bool hasIsCompressed = false;
     bool hasArchivePath = false;
     bool hasArchiveInternalPath = false;
+    bool hasFingerprint = false;
+    bool hasGroupKey = false;
     while (query.next()) {
         QString columnName = query.value(1).toString();
         if (columnName == Constants::DatabaseSchema::Columns::Files::IS_PROCESSED) hasIsProcessed = true;
@@ -93,6 +112,8 @@ void Database::runMigrations()
         if (columnName == Constants::DatabaseSchema::Columns::Files::IS_COMPRESSED) hasIsCompressed = true;
         if (columnName == Constants::DatabaseSchema::Columns::Files::ARCHIVE_PATH) hasArchivePath = true;
         if (columnName == Constants::DatabaseSchema::Columns::Files::ARCHIVE_INTERNAL_PATH) hasArchiveInternalPath = true;
+        if (columnName == Constants::DatabaseSchema::Columns::Files::FP_SIZE) hasFingerprint = true;
+        if (columnName == Constants::DatabaseSchema::Columns::Files::GROUP_DIR) hasGroupKey = true;
     }
     
     // Add is_processed column if missing
@@ -143,6 +164,70 @@ void Database::runMigrations()
         }
     }
 
+    if (!hasFingerprint) {
+        qInfo() << "Migration: Adding fingerprint columns to files table";
+        const char *fingerprintColumns[] = {
+            Constants::DatabaseSchema::Columns::Files::FP_SIZE,
+            Constants::DatabaseSchema::Columns::Files::FP_MTIME,
+            Constants::DatabaseSchema::Columns::Files::FP_INODE,
+            Constants::DatabaseSchema::Columns::Files::FP_DEVICE,
+        };
+        for (const char *column : fingerprintColumns) {
+            if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN %2 INTEGER")
+                .arg(Constants::DatabaseSchema::Tables::FILES, column))) {
+                logError(Constants::Errors::Database::MIGRATION_FAILED);
+            }
+        }
+    }
+
+    if (!hasGroupKey) {
+        qInfo() << "Migration: Adding group key columns to files table";
+        const char *groupColumns[] = {
+            Constants::DatabaseSchema::Columns::Files::GROUP_DIR,
+            Constants::DatabaseSchema::Columns::Files::GROUP_NAME,
+        };
+        for (const char *column : groupColumns) {
+            if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN %2 TEXT")
+                .arg(Constants::DatabaseSchema::Tables::FILES, column))) {
+                logError(Constants::Errors::Database::MIGRATION_FAILED);
+            }
+        }
+
+        // Existing rows get their keys once, here
+        QList<std::tuple<int, QString, QString>> keys;
+        query.setForwardOnly(true);
+        if (query.exec("SELECT id, original_path, filename FROM files")) {
+            while (query.next()) {
+                keys.append({query.value(0).toInt(),
+                             fileGroupDirectory(query.value(1).toString()),
+                             fileGroupName(query.value(2).toString())});
+            }
+        }
+        m_db.transaction();
+        QSqlQuery update(m_db);
+        update.prepare("UPDATE files SET group_dir = ?, group_name = ? WHERE id = ?");
+        for (const auto &[id, directory, name] : std::as_const(keys)) {
+            update.addBindValue(directory);
+            update.addBindValue(name);
+            update.addBindValue(id);
+            update.exec();
+        }
+        m_db.commit();
+    }
+
+    // The library view pages through groups in this order
+    query.exec(QString("CREATE INDEX IF NOT EXISTS %1 ON %2(%3, %4)")
+        .arg(Constants::DatabaseSchema::Indexes::FILES_GROUP,
+             Constants::DatabaseSchema::Tables::FILES,
+             Constants::DatabaseSchema::Columns::Files::GROUP_DIR,
+             Constants::DatabaseSchema::Columns::Files::GROUP_NAME));
+
+    // Rescans look up every file of a library
+    query.exec(QString("CREATE INDEX IF NOT EXISTS %1 ON %2(%3)")
+        .arg(Constants::DatabaseSchema::Indexes::FILES_LIBRARY_ID,
+             Constants::DatabaseSchema::Tables::FILES,
+             Constants::DatabaseSchema::Columns::Files::LIBRARY_ID));
+
     // ── Matches table migrations ──────────────────────────────────────────
     QSqlQuery matchesQuery(m_db);
     matchesQuery.exec(QString("PRAGMA table_info(%1)")
@@ -161,6 +246,37 @@ void Database::runMigrations()
             logError(Constants::Errors::Database::MIGRATION_FAILED);
         }
     }
+
+    // ── Archive listing cache ─────────────────────────────────────────────
+    // Created here rather than in createSchema() so existing databases get it
+    QSqlQuery archiveQuery(m_db);
+    const QString createArchiveListings = R"(
+        CREATE TABLE IF NOT EXISTS archive_listings (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            archive_path TEXT NOT NULL UNIQUE,
+            archive_size INTEGER NOT NULL,
+            archive_mtime INTEGER NOT NULL,
+            format INTEGER NOT NULL,
+            listed_natively BOOLEAN DEFAULT 0,
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+    const QString createArchiveMembers = R"(
+        CREATE TABLE IF NOT EXISTS archive_members (
+            listing_id INTEGER NOT NULL,
+            member_path TEXT NOT NULL,
+            size INTEGER,
+            crc32 TEXT,
+            FOREIGN KEY (listing_id) REFERENCES archive_listings(id) ON DELETE CASCADE
+        )
+    )";
+    if (!archiveQuery.exec(createArchiveListings) || !archiveQuery.exec(createArchiveMembers)) {
+        logError(Constants::Errors::Database::MIGRATION_FAILED);
+    }
+    archiveQuery.exec(QString("CREATE INDEX IF NOT EXISTS %1 ON %2(%3)")
+        .arg(Constants::DatabaseSchema::Indexes::ARCHIVE_MEMBERS_LISTING_ID,
+             Constants::DatabaseSchema::Tables::ARCHIVE_MEMBERS,
+             Constants::DatabaseSchema::Columns::ArchiveMembers::LISTING_ID));
 }
 
 bool Database::createSchema()
@@ -231,6 +347,12 @@ bool Database::createSchema()
             processing_status TEXT DEFAULT 'unprocessed',
             last_modified TIMESTAMP,
             scanned_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            fp_size INTEGER,
+            fp_mtime INTEGER,
+            fp_inode INTEGER,
+            fp_device INTEGER,
+            group_dir TEXT,
+            group_name TEXT,
             FOREIGN KEY (library_id) REFERENCES libraries(id) ON DELETE CASCADE,
             FOREIGN KEY (system_id) REFERENCES systems(id),
             FOREIGN KEY (parent_file_id) REFERENCES files(id) ON DELETE CASCADE
@@ -516,17 +638,34 @@ QString Database::getSystemDisplayName(int systemId)
     return SystemResolver::displayName(systemId);
 }
 
+QSqlQuery *Database::preparedQuery(std::unique_ptr<QSqlQuery> &slot, const char *sql)
+{
+    if (!slot) {
+        auto query = std::make_unique<QSqlQuery>(m_db);
+        if (!query->prepare(QString::fromLatin1(sql))) {
+            logError("Failed to prepare statement: " + query->lastError().text());
+            return nullptr;
+        }
+        slot = std::move(query);
+    }
+    return slot.get();
+}
+
 int Database::insertFile(const FileRecord &record)
 {
-    QSqlQuery query(m_db);
     // Use INSERT OR IGNORE to avoid duplicates based on original_path + filename
-    query.prepare(R"(
+    QSqlQuery *prepared = preparedQuery(m_insertFileQuery, R"(
         INSERT OR IGNORE INTO files 
         (library_id, original_path, current_path, filename, extension, 
          file_size, is_compressed, archive_path, archive_internal_path, 
-         system_id, is_primary, parent_file_id, last_modified)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+         system_id, is_primary, parent_file_id, last_modified, crc32,
+         fp_size, fp_mtime, fp_inode, fp_device, group_dir, group_name)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     )");
+    if (!prepared) {
+        return 0;
+    }
+    QSqlQuery &query = *prepared;
     query.addBindValue(record.libraryId);
     query.addBindValue(record.originalPath);
     query.addBindValue(record.currentPath);
@@ -540,6 +679,20 @@ int Database::insertFile(const FileRecord &record)
     query.addBindValue(record.isPrimary);
     query.addBindValue(record.parentFileId > 0 ? record.parentFileId : QVariant());
     query.addBindValue(record.lastModified);
+    // Archive listings carry a stored CRC32; hash_calculated stays 0 until hashed
+    query.addBindValue(record.crc32.isEmpty() ? QVariant() : record.crc32);
+    if (record.fingerprint.isValid()) {
+        query.addBindValue(record.fingerprint.size);
+        query.addBindValue(record.fingerprint.mtimeMs);
+        query.addBindValue(static_cast<qint64>(record.fingerprint.inode));
+        query.addBindValue(static_cast<qint64>(record.fingerprint.device));
+    } else {
+        for (int i = 0; i < 4; ++i) {
+            query.addBindValue(QVariant());
+        }
+    }
+    query.addBindValue(fileGroupDirectory(record.originalPath));
+    query.addBindValue(fileGroupName(record.filename));
 
     if (!query.exec()) {
         logError("Failed to insert file: " + query.lastError().text());
@@ -549,15 +702,227 @@ int Database::insertFile(const FileRecord &record)
     return query.lastInsertId().toInt();
 }
 
-bool Database::updateFileHashes(int fileId, const QString &crc32,
-                                 const QString &md5, const QString &sha1)
+QList<Database::FileFingerprintEntry> Database::getFileFingerprints(int libraryId)
 {
+    QList<FileFingerprintEntry> entries;
+
     QSqlQuery query(m_db);
+    query.setForwardOnly(true);
     query.prepare(R"(
+        SELECT id, original_path, filename, current_path,
+               fp_size, fp_mtime, fp_inode, fp_device
+        FROM files
+        WHERE library_id = ?
+    )");
+    query.addBindValue(libraryId);
+
+    if (!query.exec()) {
+        logError("Failed to query file fingerprints: " + query.lastError().text());
+        return entries;
+    }
+
+    while (query.next()) {
+        FileFingerprintEntry entry;
+        entry.fileId = query.value(0).toInt();
+        entry.originalPath = query.value(1).toString();
+        entry.filename = query.value(2).toString();
+        entry.currentPath = query.value(3).toString();
+        if (!query.value(4).isNull()) {
+            entry.fingerprint.size = query.value(4).toLongLong();
+            entry.fingerprint.mtimeMs = query.value(5).toLongLong();
+            entry.fingerprint.inode = static_cast<quint64>(query.value(6).toLongLong());
+            entry.fingerprint.device = static_cast<quint64>(query.value(7).toLongLong());
+        }
+        entries.append(entry);
+    }
+
+    return entries;
+}
+
+bool Database::updateFileFingerprint(int fileId, const FileRecord &record, bool invalidate)
+{
+    QSqlQuery query(m_db);
+    if (invalidate) {
+        query.prepare(R"(
+            UPDATE files
+            SET fp_size = ?, fp_mtime = ?, fp_inode = ?, fp_device = ?,
+                file_size = ?, last_modified = ?,
+                crc32 = ?, md5 = NULL, sha1 = NULL, hash_calculated = 0,
+                is_processed = 0, processing_status = 'unprocessed'
+            WHERE id = ?
+        )");
+    } else {
+        query.prepare(R"(
+            UPDATE files
+            SET fp_size = ?, fp_mtime = ?, fp_inode = ?, fp_device = ?
+            WHERE id = ?
+        )");
+    }
+    query.addBindValue(record.fingerprint.size);
+    query.addBindValue(record.fingerprint.mtimeMs);
+    query.addBindValue(static_cast<qint64>(record.fingerprint.inode));
+    query.addBindValue(static_cast<qint64>(record.fingerprint.device));
+    if (invalidate) {
+        query.addBindValue(record.fileSize);
+        query.addBindValue(record.lastModified);
+        query.addBindValue(record.crc32.isEmpty() ? QVariant() : record.crc32);
+    }
+    query.addBindValue(fileId);
+
+    if (!query.exec()) {
+        logError("Failed to update file fingerprint: " + query.lastError().text());
+        return false;
+    }
+
+    if (invalidate) {
+        // Hash-based matches no longer describe the file; keep user-confirmed ones
+        QSqlQuery matchQuery(m_db);
+        matchQuery.prepare("DELETE FROM matches WHERE file_id = ? AND is_confirmed = 0");
+        matchQuery.addBindValue(fileId);
+        if (!matchQuery.exec()) {
+            logError("Failed to drop stale match for file " + QString::number(fileId) + ": "
+                     + matchQuery.lastError().text());
+        }
+    }
+
+    return true;
+}
+
+QList<Database::ArchiveListingEntry> Database::getArchiveListings()
+{
+    QList<ArchiveListingEntry> listings;
+    QHash<qint64, int> indexById;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(R"(
+        SELECT id, archive_path, archive_size, archive_mtime, format, listed_natively
+        FROM archive_listings
+    )")) {
+        logError("Failed to query archive listings: " + query.lastError().text());
+        return listings;
+    }
+
+    while (query.next()) {
+        ArchiveListingEntry entry;
+        entry.archivePath = query.value(1).toString();
+        entry.archiveSize = query.value(2).toLongLong();
+        entry.archiveMtimeMs = query.value(3).toLongLong();
+        entry.format = static_cast<ArchiveFormat>(query.value(4).toInt());
+        entry.listedNatively = query.value(5).toBool();
+        indexById.insert(query.value(0).toLongLong(), listings.size());
+        listings.append(entry);
+    }
+
+    // rowid order is insertion order, i.e. the order the archive listed them in
+    QSqlQuery memberQuery(m_db);
+    memberQuery.setForwardOnly(true);
+    if (!memberQuery.exec(R"(
+        SELECT listing_id, member_path, size, crc32
+        FROM archive_members
+        ORDER BY rowid
+    )")) {
+        logError("Failed to query archive members: " + memberQuery.lastError().text());
+        return {};
+    }
+
+    while (memberQuery.next()) {
+        const auto it = indexById.constFind(memberQuery.value(0).toLongLong());
+        if (it == indexById.constEnd()) {
+            continue;
+        }
+        ArchiveMember member;
+        member.path = memberQuery.value(1).toString();
+        member.size = memberQuery.value(2).isNull() ? -1 : memberQuery.value(2).toLongLong();
+        member.crc32 = memberQuery.value(3).toString();
+        listings[it.value()].members.append(member);
+    }
+
+    return listings;
+}
+
+int Database::saveArchiveListing(const ArchiveListingEntry &entry)
+{
+    removeArchiveListing(entry.archivePath);
+
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        INSERT INTO archive_listings
+            (archive_path, archive_size, archive_mtime, format, listed_natively)
+        VALUES (?, ?, ?, ?, ?)
+    )");
+    query.addBindValue(entry.archivePath);
+    query.addBindValue(entry.archiveSize);
+    query.addBindValue(entry.archiveMtimeMs);
+    query.addBindValue(static_cast<int>(entry.format));
+    query.addBindValue(entry.listedNatively);
+    if (!query.exec()) {
+        logError("Failed to insert archive listing: " + query.lastError().text());
+        return 0;
+    }
+    const qint64 listingId = query.lastInsertId().toLongLong();
+
+    QSqlQuery memberQuery(m_db);
+    memberQuery.prepare(R"(
+        INSERT INTO archive_members (listing_id, member_path, size, crc32)
+        VALUES (?, ?, ?, ?)
+    )");
+    int rows = 1;
+    for (const ArchiveMember &member : entry.members) {
+        memberQuery.addBindValue(listingId);
+        memberQuery.addBindValue(member.path);
+        memberQuery.addBindValue(member.size >= 0 ? QVariant(member.size) : QVariant());
+        memberQuery.addBindValue(member.crc32.isEmpty() ? QVariant() : member.crc32);
+        if (!memberQuery.exec()) {
+            logError("Failed to insert archive member: " + memberQuery.lastError().text());
+            // A partial listing would hide members; drop it so the next scan re-lists
+            removeArchiveListing(entry.archivePath);
+            return 0;
+        }
+        rows++;
+    }
+
+    return rows;
+}
+
+bool Database::removeArchiveListing(const QString &archivePath)
+{
+    // Foreign keys are only enabled on connections that created the schema,
+    // so members are deleted explicitly instead of relying on the cascade
+    QSqlQuery memberQuery(m_db);
+    memberQuery.prepare(R"(
+        DELETE FROM archive_members
+        WHERE listing_id IN (SELECT id FROM archive_listings WHERE archive_path = ?)
+    )");
+    memberQuery.addBindValue(archivePath);
+    if (!memberQuery.exec()) {
+        logError("Failed to delete archive members: " + memberQuery.lastError().text());
+        return false;
+    }
+
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM archive_listings WHERE archive_path = ?");
+    query.addBindValue(archivePath);
+    if (!query.exec()) {
+        logError("Failed to delete archive listing: " + query.lastError().text());
+        return false;
+    }
+
+    return query.numRowsAffected() > 0;
+}
+
+bool Database::updateFileHashes(int fileId, const QString &crc32,
+                                 const QString &md5, const QString &sha1)
+{
+    QSqlQuery *prepared = preparedQuery(m_updateHashesQuery, R"(
         UPDATE files 
         SET crc32 = ?, md5 = ?, sha1 = ?, hash_calculated = 1
         WHERE id = ?
     )");
+    if (!prepared) {
+        return false;
+    }
+    QSqlQuery &query = *prepared;
     query.addBindValue(crc32);
     query.addBindValue(md5);
     query.addBindValue(sha1);
@@ -630,149 +995,271 @@ QMap<QString, int> Database::getFileCountBySystem()
     return counts;
 }
 
-FileRecord Database::getFileById(int fileId)
+namespace {
+
+// Column order shared by every FileRecord loader; see fileRecordFromQuery()
+const char *const FILE_RECORD_COLUMNS = R"(
+    id, library_id, original_path, current_path, filename, extension,
+    file_size, is_compressed, archive_path, archive_internal_path,
+    system_id, crc32, md5, sha1, hash_calculated,
+    is_primary, parent_file_id, is_processed, processing_status,
+    last_modified, scanned_at,
+    fp_size, fp_mtime, fp_inode, fp_device
+)";
+
+FileRecord fileRecordFromQuery(const QSqlQuery &query)
 {
     FileRecord record;
-    
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        SELECT id, library_id, original_path, current_path, filename, extension,
-               file_size, is_compressed, archive_path, archive_internal_path,
-               system_id, crc32, md5, sha1, hash_calculated, 
-               is_primary, parent_file_id, is_processed, processing_status,
-               last_modified, scanned_at
-        FROM files 
-        WHERE id = ?
-    )");
-    query.addBindValue(fileId);
-    
-    if (query.exec() && query.next()) {
-        record.id = query.value(0).toInt();
-        record.libraryId = query.value(1).toInt();
-        record.originalPath = query.value(2).toString();
-        record.currentPath = query.value(3).toString();
-        record.filename = query.value(4).toString();
-        record.extension = query.value(5).toString();
-        record.fileSize = query.value(6).toLongLong();
-        record.isCompressed = query.value(7).toBool();
-        record.archivePath = query.value(8).toString();
-        record.archiveInternalPath = query.value(9).toString();
-        record.systemId = query.value(10).toInt();
-        record.crc32 = query.value(11).toString();
-        record.md5 = query.value(12).toString();
-        record.sha1 = query.value(13).toString();
-        record.hashCalculated = query.value(14).toBool();
-        record.isPrimary = query.value(15).toBool();
-        record.parentFileId = query.value(16).toInt();
-        record.isProcessed = query.value(17).toBool();
-        record.processingStatus = query.value(18).toString();
-        record.lastModified = query.value(19).toDateTime();
-        record.scannedAt = query.value(20).toDateTime();
+    record.id = query.value(0).toInt();
+    record.libraryId = query.value(1).toInt();
+    record.originalPath = query.value(2).toString();
+    record.currentPath = query.value(3).toString();
+    record.filename = query.value(4).toString();
+    record.extension = query.value(5).toString();
+    record.fileSize = query.value(6).toLongLong();
+    record.isCompressed = query.value(7).toBool();
+    record.archivePath = query.value(8).toString();
+    record.archiveInternalPath = query.value(9).toString();
+    record.systemId = query.value(10).toInt();
+    record.crc32 = query.value(11).toString();
+    record.md5 = query.value(12).toString();
+    record.sha1 = query.value(13).toString();
+    record.hashCalculated = query.value(14).toBool();
+    record.isPrimary = query.value(15).toBool();
+    record.parentFileId = query.value(16).toInt();
+    record.isProcessed = query.value(17).toBool();
+    record.processingStatus = query.value(18).toString();
+    record.lastModified = query.value(19).toDateTime();
+    record.scannedAt = query.value(20).toDateTime();
+    if (!query.value(21).isNull()) {
+        record.fingerprint.size = query.value(21).toLongLong();
+        record.fingerprint.mtimeMs = query.value(22).toLongLong();
+        record.fingerprint.inode = static_cast<quint64>(query.value(23).toLongLong());
+        record.fingerprint.device = static_cast<quint64>(query.value(24).toLongLong());
     }
-    
     return record;
 }
 
-QList<FileRecord> Database::getAllFiles()
+// Below this, stat'ing on the calling thread beats fanning out
+constexpr int PARALLEL_EXISTS_THRESHOLD = 256;
+
+} // namespace
+
+QList<FileRecord> Database::selectFiles(const QString &whereClause, const QVariantList &bindValues)
 {
     QList<FileRecord> files;
 
     QSqlQuery query(m_db);
-    if (!query.exec("SELECT id FROM files")) {
-        logError("Failed to get all files: " + query.lastError().text());
+    query.setForwardOnly(true);
+    QString sql = QString("SELECT %1 FROM files").arg(QLatin1String(FILE_RECORD_COLUMNS));
+    if (!whereClause.isEmpty()) {
+        sql += " WHERE " + whereClause;
+    }
+    sql += " ORDER BY id";
+
+    if (!query.prepare(sql)) {
+        logError("Failed to prepare file query: " + query.lastError().text());
+        return files;
+    }
+    for (const QVariant &value : bindValues) {
+        query.addBindValue(value);
+    }
+    if (!query.exec()) {
+        logError("Failed to query files: " + query.lastError().text());
         return files;
     }
 
     while (query.next()) {
-        int fileId = query.value(0).toInt();
-        FileRecord record = getFileById(fileId);
-        if (record.id > 0) {
-            files.append(record);
-        }
+        files.append(fileRecordFromQuery(query));
     }
 
     return files;
 }
 
-QList<FileRecord> Database::getExistingFiles()
+Database::ChangeToken Database::changeToken()
 {
-    QList<FileRecord> files;
-
+    // total_changes() moves with our own writes, data_version with other connections'
+    ChangeToken token;
     QSqlQuery query(m_db);
-    if (!query.exec("SELECT id FROM files")) {
-        logError("Failed to get existing files: " + query.lastError().text());
-        return files;
+    if (query.exec("SELECT total_changes()") && query.next()) {
+        token.localChanges = query.value(0).toLongLong();
     }
+    if (query.exec("PRAGMA data_version") && query.next()) {
+        token.dataVersion = query.value(0).toLongLong();
+    }
+    return token;
+}
 
-    while (query.next()) {
-        int fileId = query.value(0).toInt();
-        FileRecord record = getFileById(fileId);
-        if (record.id > 0) {
-            QFileInfo pathInfo(record.currentPath);
-            if (pathInfo.exists()) {
-                files.append(record);
-            }
-        }
+FileRecord Database::getFileById(int fileId)
+{
+    const QList<FileRecord> files = selectFiles("id = ?", {fileId});
+    return files.isEmpty() ? FileRecord() : files.first();
+}
+
+QList<FileRecord> Database::getAllFiles()
+{
+    const ChangeToken token = changeToken();
+    if (m_allFilesCacheValid && token == m_allFilesCacheToken) {
+        return m_allFilesCache;
     }
 
-    return files;
+    m_allFilesCache = selectFiles(QString(), {});
+    m_allFilesCacheToken = token;
+    m_allFilesCacheValid = true;
+    return m_allFilesCache;
 }
 
-QList<FileRecord> Database::getFilesBySystem(const QString &systemName)
+QList<FileRecord> Database::getExistingFiles()
 {
-    QList<FileRecord> files;
-    
-    // First get system ID
-    int systemId = getSystemId(systemName);
-    if (systemId == 0) {
-        logError("System not found: " + systemName);
-        return files;
+    return filterExisting(getAllFiles());
+}
+
+QList<FileRecord> Database::getExistingFiles(int systemId, bool matchedOnly)
+{
+    if (systemId <= 0 && !matchedOnly) {
+        return getExistingFiles();
     }
-    
+    QVariantList bindValues;
+    const QString condition = fileFilterCondition(systemId, matchedOnly, bindValues);
+    return filterExisting(selectFiles(condition, bindValues));
+}
+
+QString Database::fileFilterCondition(int systemId, bool matchedOnly, QVariantList &bindValues)
+{
+    QStringList conditions;
+    if (systemId > 0) {
+        conditions << "files.system_id = ?";
+        bindValues << systemId;
+    }
+    if (matchedOnly) {
+        conditions << "files.id IN (SELECT file_id FROM matches)";
+    }
+    return conditions.isEmpty() ? QStringLiteral("1") : conditions.join(" AND ");
+}
+
+QString Database::fileGroupDirectory(const QString &originalPath)
+{
+    return QFileInfo(originalPath).path();
+}
+
+QString Database::fileGroupName(const QString &filename)
+{
+    // Tracks of a multi-bin game belong with its sheet
+    static const QRegularExpression trackPattern(R"(\s*\(Track\s*\d+\)$)",
+                                                 QRegularExpression::CaseInsensitiveOption);
+    QString baseName = QFileInfo(filename).completeBaseName();
+    baseName.remove(trackPattern);
+    return baseName.trimmed();
+}
+
+QHash<QString, int> Database::getFileGroupCountsByDirectory(int systemId, bool matchedOnly)
+{
+    QHash<QString, int> counts;
+    QVariantList bindValues;
+    const QString condition = fileFilterCondition(systemId, matchedOnly, bindValues);
+
     QSqlQuery query(m_db);
-    query.prepare("SELECT id FROM files WHERE system_id = ? AND is_primary = 1");
-    query.addBindValue(systemId);
-    
+    query.setForwardOnly(true);
+    query.prepare(QString("SELECT group_dir, COUNT(DISTINCT group_name) FROM files "
+                          "WHERE %1 GROUP BY group_dir").arg(condition));
+    for (const QVariant &value : std::as_const(bindValues)) {
+        query.addBindValue(value);
+    }
     if (!query.exec()) {
-        logError("Failed to get files by system: " + query.lastError().text());
-        return files;
+        logError("Failed to count file groups: " + query.lastError().text());
+        return counts;
     }
-    
     while (query.next()) {
-        int fileId = query.value(0).toInt();
-        FileRecord record = getFileById(fileId);
-        if (record.id > 0) {
-            files.append(record);
-        }
+        counts.insert(query.value(0).toString(), query.value(1).toInt());
     }
-    
-    return files;
+    return counts;
 }
 
-QList<FileRecord> Database::getFilesByParent(int parentId)
+QList<FileRecord> Database::getFileGroupPage(int systemId, bool matchedOnly, int offset, int limit)
 {
     QList<FileRecord> files;
-    
+    QVariantList bindValues;
+    const QString condition = fileFilterCondition(systemId, matchedOnly, bindValues);
+
+    // The page is chosen among groups, then joined back to their files
     QSqlQuery query(m_db);
-    query.prepare("SELECT id FROM files WHERE parent_file_id = ?");
-    query.addBindValue(parentId);
-    
+    query.setForwardOnly(true);
+    query.prepare(QString(R"(
+        SELECT %1 FROM files
+        JOIN (SELECT group_dir AS page_dir, group_name AS page_name FROM files
+              WHERE %2
+              GROUP BY group_dir, group_name
+              ORDER BY group_dir, group_name
+              LIMIT ? OFFSET ?) AS page
+          ON files.group_dir = page.page_dir AND files.group_name = page.page_name
+        WHERE %2
+        ORDER BY files.group_dir, files.group_name, files.id
+    )").arg(QLatin1String(FILE_RECORD_COLUMNS), condition));
+    for (const QVariant &value : std::as_const(bindValues)) {
+        query.addBindValue(value);
+    }
+    query.addBindValue(limit);
+    query.addBindValue(offset);
+    for (const QVariant &value : std::as_const(bindValues)) {
+        query.addBindValue(value);
+    }
     if (!query.exec()) {
-        logError("Failed to get files by parent: " + query.lastError().text());
+        logError("Failed to query file groups: " + query.lastError().text());
         return files;
     }
-    
     while (query.next()) {
-        int fileId = query.value(0).toInt();
-        FileRecord record = getFileById(fileId);
-        if (record.id > 0) {
-            files.append(record);
-        }
+        files.append(fileRecordFromQuery(query));
     }
-    
     return files;
 }
 
+QList<FileRecord> Database::getFileGroup(const QString &directory, const QString &name,
+                                         int systemId, bool matchedOnly)
+{
+    QVariantList bindValues{directory, name};
+    const QString condition = fileFilterCondition(systemId, matchedOnly, bindValues);
+    return selectFiles("group_dir = ? AND group_name = ? AND " + condition, bindValues);
+}
+
+QList<FileRecord> Database::filterExisting(const QList<FileRecord> &files) const
+{
+    auto exists = [](const FileRecord &record) {
+        return QFileInfo::exists(record.currentPath);
+    };
+
+    // Stats are latency bound (network shares); spread them over the pool
+    if (files.size() >= PARALLEL_EXISTS_THRESHOLD) {
+        return QtConcurrent::blockingFiltered(files, exists);
+    }
+
+    QList<FileRecord> existing;
+    existing.reserve(files.size());
+    std::copy_if(files.cbegin(), files.cend(), std::back_inserter(existing), exists);
+    return existing;
+}
+
+QList<FileRecord> Database::getFilesBySystem(const QString &systemName)
+{
+    // First get system ID
+    int systemId = getSystemId(systemName);
+    if (systemId == 0) {
+        logError("System not found: " + systemName);
+        return {};
+    }
+
+    return selectFiles("system_id = ? AND is_primary = 1", {systemId});
+}
+
+QList<FileRecord> Database::getFilesByParent(int parentId)
+{
+    return selectFiles("parent_file_id = ?", {parentId});
+}
+
+QList<FileRecord> Database::getUnmatchedFiles()
+{
+    return selectFiles("NOT EXISTS (SELECT 1 FROM matches WHERE matches.file_id = files.id)", {});
+}
+
 bool Database::updateFilePath(int fileId, const QString &newPath)
 {
     QSqlQuery query(m_db);
@@ -791,9 +1278,10 @@ bool Database::updateFilePath(int fileId, const QString &newPath)
 bool Database::updateFileOriginalPath(int fileId, const QString &newOriginalPath)
 {
     QSqlQuery query(m_db);
-    query.prepare("UPDATE files SET original_path = ?, current_path = ? WHERE id = ?");
+    query.prepare("UPDATE files SET original_path = ?, current_path = ?, group_dir = ? WHERE id = ?");
     query.addBindValue(newOriginalPath);
     query.addBindValue(newOriginalPath);
+    query.addBindValue(fileGroupDirectory(newOriginalPath));
     query.addBindValue(fileId);
     
     if (!query.exec()) {
@@ -805,9 +1293,33 @@ bool Database::updateFileOriginalPath(int fileId, const QString &newOriginalPath
 }
 
 QMap<int, Database::MatchResult> Database::getAllMatches()
+{
+    return queryBestMatches({});
+}
+
+QMap<int, Database::MatchResult> Database::getMatchesForFiles(const QList<int> &fileIds)
+{
+    if (fileIds.isEmpty()) {
+        return {};
+    }
+    return queryBestMatches(fileIds);
+}
+
+QMap<int, Database::MatchResult> Database::queryBestMatches(const QList<int> &fileIds)
 {
     QMap<int, MatchResult> results;
     QSqlQuery query(m_db);
+
+    // IDs are integers, so they can be inlined safely
+    QString fileFilter;
+    if (!fileIds.isEmpty()) {
+        QStringList ids;
+        ids.reserve(fileIds.size());
+        for (int id : fileIds) {
+            ids << QString::number(id);
+        }
+        fileFilter = QString("WHERE file_id IN (%1)").arg(ids.join(','));
+    }
     
     // Join matches with games to get full info including metadata
     // SELECT ONLY THE BEST MATCH per file using a CTE:
@@ -815,7 +1327,7 @@ QMap<int, Database::MatchResult> Database::getAllMatches()
     // 2. Prefer matches with higher confidence
     // 3. Prefer manual matches over automatic
     // 4. Use highest ID (most recent) as tiebreaker
-    query.prepare(R"(
+    query.prepare(QString(R"(
         WITH best_matches AS (
             SELECT file_id, MAX(
                 is_confirmed * 1000000 + 
@@ -829,6 +1341,7 @@ QMap<int, Database::MatchResult> Database::getAllMatches()
                 (id * 0.001)
             ) as score
             FROM matches
+            %1
             GROUP BY file_id
         )
         SELECT m.id, m.file_id, m.game_id, m.match_method, m.confidence, 
@@ -849,7 +1362,7 @@ QMap<int, Database::MatchResult> Database::getAllMatches()
             END +
             (m.id * 0.001)
         ) = bm.score
-    )");
+    )").arg(fileFilter));
     
     if (!query.exec()) {
         logError("Failed to get all matches: " + query.lastError().text());
@@ -1141,44 +1654,130 @@ bool Database::markFileUnprocessed(int fileId)
 
 QList<FileRecord> Database::getProcessedFiles()
 {
-    QList<FileRecord> files;
-    
-    QSqlQuery query(m_db);
-    if (!query.exec("SELECT id FROM files WHERE is_primary = 1 AND is_processed = 1")) {
-        logError("Failed to get processed files: " + query.lastError().text());
-        return files;
+    return selectFiles("is_primary = 1 AND is_processed = 1", {});
+}
+
+QList<FileRecord> Database::getUnprocessedFiles()
+{
+    return selectFiles("is_primary = 1 AND is_processed = 0", {});
+}
+
+bool Database::beginTransaction()
+{
+    if (!m_db.transaction()) {
+        logError("Failed to begin transaction: " + m_db.lastError().text());
+        return false;
     }
-    
-    while (query.next()) {
-        int fileId = query.value(0).toInt();
-        FileRecord record = getFileById(fileId);
-        if (record.id > 0) {
-            files.append(record);
-        }
+    return true;
+}
+
+bool Database::tryBeginTransaction()
+{
+    if (!m_db.transaction()) {
+        qDebug() << "Database: not opening a transaction:" << m_db.lastError().text();
+        return false;
     }
-    
-    return files;
+    return true;
 }
 
-QList<FileRecord> Database::getUnprocessedFiles()
+bool Database::commitTransaction()
 {
-    QList<FileRecord> files;
-    
-    QSqlQuery query(m_db);
-    if (!query.exec("SELECT id FROM files WHERE is_primary = 1 AND is_processed = 0")) {
-        logError("Failed to get unprocessed files: " + query.lastError().text());
-        return files;
+    if (!m_db.commit()) {
+        logError("Failed to commit transaction: " + m_db.lastError().text());
+        return false;
     }
-    
-    while (query.next()) {
-        int fileId = query.value(0).toInt();
-        FileRecord record = getFileById(fileId);
-        if (record.id > 0) {
-            files.append(record);
+    return true;
+}
+
+void Database::rollbackTransaction()
+{
+    if (!m_db.rollback()) {
+        logError("Failed to roll back transaction: " + m_db.lastError().text());
+    }
+}
+
+// ── WriteBatch ───────────────────────────────────────────────────────────────
+
+WriteBatch::WriteBatch(Database &db, int maxRows, int maxIntervalMs)
+    : m_db(db)
+    , m_maxRows(qMax(1, maxRows))
+    , m_maxIntervalMs(maxIntervalMs)
+{
+    m_total.start();
+    m_sinceCommit.start();
+    // Without a transaction of our own (e.g. the caller has one open),
+    // writes simply join the caller's or autocommit
+    m_open = m_db.tryBeginTransaction();
+}
+
+WriteBatch::~WriteBatch()
+{
+    finish();
+}
+
+void WriteBatch::recordWrite(int rows)
+{
+    if (m_finished) {
+        return;
+    }
+
+    m_rows += rows;
+    m_pending += rows;
+    if (m_pending >= m_maxRows || m_sinceCommit.elapsed() >= m_maxIntervalMs) {
+        commit();
+        m_open = m_db.tryBeginTransaction();
+    }
+}
+
+bool WriteBatch::finish()
+{
+    if (m_finished) {
+        return m_rowsLost == 0;
+    }
+    commit();
+    m_finished = true;
+    m_finishedMs = m_total.elapsed();
+    return m_rowsLost == 0;
+}
+
+bool WriteBatch::commit()
+{
+    bool committed = true;
+    if (m_open) {
+        // A failed COMMIT keeps the transaction open, so it can be retried
+        committed = m_db.commitTransaction();
+        for (int attempt = 1;
+             !committed && attempt < Constants::DatabaseSchema::WRITE_BATCH_COMMIT_ATTEMPTS;
+             ++attempt) {
+            committed = m_db.commitTransaction();
         }
+
+        if (committed) {
+            if (m_pending > 0) {
+                m_commits++;
+            }
+        } else {
+            m_lastError = m_db.database().lastError().text();
+            m_rowsLost += m_pending;
+            qCritical() << "WriteBatch: rolling back" << m_pending << "rows:" << m_lastError;
+            m_db.rollbackTransaction();
+        }
+        m_open = false;
     }
-    
-    return files;
+    m_pending = 0;
+    m_sinceCommit.restart();
+    return committed;
+}
+
+qint64 WriteBatch::elapsedMs() const
+{
+    return m_finished ? m_finishedMs : m_total.elapsed();
+}
+
+double WriteBatch::rowsPerSecond() const
+{
+    const qint64 ms = elapsedMs();
+    return ms > 0 ? m_rows * 1000.0 / ms : static_cast<double>(m_rows);
 }
 
 void Database::logError(const QString &message)
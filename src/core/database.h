@@ -2,12 +2,20 @@
 #define REMUS_DATABASE_H
 
 #include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QSqlDatabase>
 #include <QString>
+#include <QVariantList>
+#include <memory>
+#include "archive_extractor.h"
 #include "scanner.h"
 #include "system_detector.h"
+#include "constants/database_schema.h"
 #include "system_resolver.h"
 
+class QSqlQuery;
+
 namespace Remus {
 
 /**
@@ -35,6 +43,7 @@ struct FileRecord {
     QString processingStatus = "unprocessed";
     QDateTime lastModified;
     QDateTime scannedAt;
+    FileFingerprint fingerprint;  // Invalid for rows scanned before fingerprinting
 };
 
 /**
@@ -146,6 +155,67 @@ public:
      */
     int insertFile(const FileRecord &record);
 
+    /**
+     * @brief Stored scan state of a file, used to reconcile a rescan
+     */
+    struct FileFingerprintEntry {
+        int fileId = 0;
+        QString originalPath;
+        QString filename;
+        QString currentPath;
+        FileFingerprint fingerprint;
+    };
+
+    /**
+     * @brief Get the stored fingerprints of every file in a library
+     * @param libraryId Library ID
+     * @return One entry per file row (fingerprint invalid for legacy rows)
+     */
+    QList<FileFingerprintEntry> getFileFingerprints(int libraryId);
+
+    /**
+     * @brief Store a new fingerprint for an existing file
+     *
+     * When @p invalidate is true the file changed on disk: size and mtime are
+     * refreshed, hashes are cleared (crc32 takes the record's stored archive
+     * CRC, if any), the file is marked unprocessed and any unconfirmed match
+     * is dropped so the pipeline picks it up again.
+     * @param fileId File ID
+     * @param record Fresh scan data (fileSize, lastModified, fingerprint, crc32)
+     * @param invalidate Whether to reset hashes and processing state
+     * @return True if successful
+     */
+    bool updateFileFingerprint(int fileId, const FileRecord &record, bool invalidate);
+
+    /**
+     * @brief Cached listing of one archive, valid while its size and mtime hold
+     */
+    struct ArchiveListingEntry {
+        QString archivePath;
+        qint64 archiveSize = 0;
+        qint64 archiveMtimeMs = 0;
+        ArchiveFormat format = ArchiveFormat::Unknown;
+        bool listedNatively = false;
+        QList<ArchiveMember> members;  ///< In archive order
+    };
+
+    /**
+     * @brief Load every cached archive listing (two queries, no per-archive lookups)
+     */
+    QList<ArchiveListingEntry> getArchiveListings();
+
+    /**
+     * @brief Store an archive listing, replacing any previous one for its path
+     * @return Rows written (listing + members), 0 on failure
+     */
+    int saveArchiveListing(const ArchiveListingEntry &entry);
+
+    /**
+     * @brief Drop the cached listing of an archive
+     * @return True if a listing was removed
+     */
+    bool removeArchiveListing(const QString &archivePath);
+
     /**
      * @brief Update file hashes
      * @param fileId File ID
@@ -178,16 +248,72 @@ public:
 
     /**
      * @brief Get all files from database (includes stale entries with non-existent paths)
+     *
+     * Loaded in a single query and cached until this or another connection
+     * next writes to the database, so repeated refreshes are cheap.
      * @return List of all file records
      */
     QList<FileRecord> getAllFiles();
 
     /**
      * @brief Get files whose currentPath exists on disk
+     *
+     * Filters getAllFiles(); existence is re-checked on every call, in
+     * parallel for large libraries.
      * @return List of file records with valid paths only
      */
     QList<FileRecord> getExistingFiles();
 
+    /**
+     * @brief Get existing files with the filter applied in SQL
+     * @param systemId Only files of this system (0 for all)
+     * @param matchedOnly Only files that have at least one match
+     * @return List of file records with valid paths only
+     */
+    QList<FileRecord> getExistingFiles(int systemId, bool matchedOnly);
+
+    /**
+     * @brief Directory part of a file's group (see getFileGroupPage)
+     */
+    static QString fileGroupDirectory(const QString &originalPath);
+
+    /**
+     * @brief Name part of a file's group: base name without extension or "(Track N)"
+     */
+    static QString fileGroupName(const QString &filename);
+
+    /**
+     * @brief Number of file groups in each directory, filter applied in SQL
+     *
+     * A group is the files sharing a directory and fileGroupName() - a
+     * .cue with its .bin tracks, say - and is one row of the library view.
+     * Missing files are counted too; nothing is stat'ed.
+     */
+    QHash<QString, int> getFileGroupCountsByDirectory(int systemId, bool matchedOnly);
+
+    /**
+     * @brief Files of one page of groups
+     *
+     * Groups are ordered by directory, then name, and paged with
+     * LIMIT/OFFSET in SQL, so only the page's files are loaded. Nothing is
+     * stat'ed; pass the result through filterExisting() for that.
+     * @param offset Groups to skip
+     * @param limit Groups in the page
+     * @return Files of the page's groups, in group order
+     */
+    QList<FileRecord> getFileGroupPage(int systemId, bool matchedOnly, int offset, int limit);
+
+    /**
+     * @brief Files of one group, filter applied in SQL
+     */
+    QList<FileRecord> getFileGroup(const QString &directory, const QString &name,
+                                   int systemId, bool matchedOnly);
+
+    /**
+     * @brief Keep records whose currentPath exists (stats in parallel for large lists)
+     */
+    QList<FileRecord> filterExisting(const QList<FileRecord> &files) const;
+
     /**
      * @brief Get files by system name
      * @param systemName System name
@@ -202,6 +328,15 @@ public:
      */
     QList<FileRecord> getFilesByParent(int parentId);
 
+    /**
+     * @brief Get files that have no match yet
+     *
+     * Includes files whose matches were dropped because a rescan found
+     * their content changed.
+     * @return List of file records
+     */
+    QList<FileRecord> getUnmatchedFiles();
+
     /**
      * @brief Update file's current path (for organize/rename)
      * @param fileId File ID
@@ -246,6 +381,13 @@ public:
      * @return Map of fileId -> MatchResult
      */
     QMap<int, MatchResult> getAllMatches();
+
+    /**
+     * @brief Best match for each of the given files (same ranking as getAllMatches)
+     * @param fileIds File IDs to look up
+     * @return Map of fileId -> MatchResult (files without a match are absent)
+     */
+    QMap<int, MatchResult> getMatchesForFiles(const QList<int> &fileIds);
     
     /**
      * @brief Get match for a specific file
@@ -354,6 +496,33 @@ public:
      */
     QList<FileRecord> getUnprocessedFiles();
 
+    /**
+     * @brief Begin an explicit transaction (prefer WriteBatch for bulk writes)
+     * @return True if a transaction was opened
+     */
+    bool beginTransaction();
+
+    /**
+     * @brief Begin a transaction if none is open yet
+     *
+     * For callers that work either way (WriteBatch): an already open
+     * transaction is expected, so it is only logged at debug level and
+     * does not emit databaseError().
+     * @return True if a transaction was opened
+     */
+    bool tryBeginTransaction();
+
+    /**
+     * @brief Commit the open transaction
+     * @return True if successful
+     */
+    bool commitTransaction();
+
+    /**
+     * @brief Roll back the open transaction
+     */
+    void rollbackTransaction();
+
 signals:
     void databaseError(const QString &error);
 
@@ -361,9 +530,115 @@ private:
     bool executeSqlFile(const QString &filePath);
     void logError(const QString &message);
 
+    /**
+     * @brief Prepare @p sql once and hand back the same statement afterwards
+     * @return Prepared query, or nullptr if preparation failed
+     */
+    QSqlQuery *preparedQuery(std::unique_ptr<QSqlQuery> &slot, const char *sql);
+
+    /**
+     * @brief Load full FileRecords in one query
+     * @param whereClause SQL condition without WHERE (empty for all rows)
+     * @param bindValues Positional values for the condition
+     * @return Records ordered by ID
+     */
+    QList<FileRecord> selectFiles(const QString &whereClause, const QVariantList &bindValues);
+
+    /// SQL condition for the file list filters, appending its values to @p bindValues
+    static QString fileFilterCondition(int systemId, bool matchedOnly, QVariantList &bindValues);
+
+    /// Best match per file, optionally restricted to @p fileIds
+    QMap<int, MatchResult> queryBestMatches(const QList<int> &fileIds);
+
+    /// Identifies a database state; changes whenever any connection writes
+    struct ChangeToken {
+        qint64 localChanges = -1;
+        qint64 dataVersion = -1;
+        bool operator==(const ChangeToken &other) const {
+            return localChanges == other.localChanges && dataVersion == other.dataVersion;
+        }
+    };
+    ChangeToken changeToken();
+
     QSqlDatabase m_db;
     QString m_dbPath;
     QString m_connectionName;
+
+    // Hot per-row statements, reused across calls (released in close())
+    std::unique_ptr<QSqlQuery> m_insertFileQuery;
+    std::unique_ptr<QSqlQuery> m_updateHashesQuery;
+
+    // getAllFiles() result, valid while changeToken() is unchanged
+    QList<FileRecord> m_allFilesCache;
+    ChangeToken m_allFilesCacheToken;
+    bool m_allFilesCacheValid = false;
+};
+
+/**
+ * @brief Groups many small writes into a few transactions
+ *
+ * Opens a transaction on construction and commits it every @p maxRows
+ * recorded writes or @p maxIntervalMs, whichever comes first, so a
+ * 100k-row import costs a handful of fsyncs instead of one per row. The
+ * final commit happens in finish() or the destructor. Use on the thread
+ * that owns the Database.
+ *
+ * A COMMIT that fails (e.g. SQLITE_BUSY past the busy timeout) leaves the
+ * transaction open, so it is retried; after WRITE_BATCH_COMMIT_ATTEMPTS
+ * the transaction is rolled back and its rows are counted in rowsLost().
+ */
+class WriteBatch {
+public:
+    explicit WriteBatch(Database &db,
+                        int maxRows = Constants::DatabaseSchema::WRITE_BATCH_MAX_ROWS,
+                        int maxIntervalMs = Constants::DatabaseSchema::WRITE_BATCH_MAX_INTERVAL_MS);
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch &) = delete;
+    WriteBatch &operator=(const WriteBatch &) = delete;
+
+    /**
+     * @brief Count writes made through the Database; may commit
+     * @param rows Number of rows just written
+     */
+    void recordWrite(int rows = 1);
+
+    /**
+     * @brief Commit outstanding writes and stop batching
+     * @return False if any transaction of the batch was rolled back
+     */
+    bool finish();
+
+    /// Recorded rows whose transaction failed to commit and was rolled back
+    int rowsLost() const { return m_rowsLost; }
+
+    /// Error of the last failed commit (empty if every commit succeeded)
+    QString lastError() const { return m_lastError; }
+
+    int rowsWritten() const { return m_rows; }
+    int commitCount() const { return m_commits; }
+    qint64 elapsedMs() const;
+
+    /// Write throughput since construction (rows per second)
+    double rowsPerSecond() const;
+
+private:
+    /// Commit the open transaction, retrying, else roll it back
+    bool commit();
+
+    Database &m_db;
+    int m_maxRows;
+    int m_maxIntervalMs;
+    int m_rows = 0;
+    int m_pending = 0;
+    int m_commits = 0;
+    int m_rowsLost = 0;
+    QString m_lastError;
+    bool m_open = false;            // A transaction of ours is open
+    bool m_finished = false;
+    qint64 m_finishedMs = 0;
+    QElapsedTimer m_total;
+    QElapsedTimer m_sinceCommit;
 };
 
 } // namespace Remus
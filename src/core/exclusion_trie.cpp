@@ -0,0 +1,91 @@
+#include "exclusion_trie.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QStringList>
+
+namespace Remus {
+
+ExclusionTrie::ExclusionTrie(const QString &markerName)
+    : m_markerName(markerName)
+{
+}
+
+ExclusionTrie::Node *ExclusionTrie::findOrCreate(const QStringList &components, int depth)
+{
+    Node *node = &m_root;
+    for (int i = 0; i < depth; ++i) {
+        auto &child = node->children[components.at(i)];
+        if (!child) {
+            child = std::make_unique<Node>();
+        }
+        node = child.get();
+    }
+    return node;
+}
+
+bool ExclusionTrie::isExcluded(const QString &dirPath)
+{
+    const bool absoluteUnix = dirPath.startsWith(QLatin1Char('/'));
+    const QStringList components = dirPath.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+
+    for (;;) {
+        int unresolvedDepth = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            Node *node = &m_root;
+            for (int i = 0; i < components.size(); ++i) {
+                auto it = node->children.find(components.at(i));
+                if (it == node->children.end()) {
+                    unresolvedDepth = i + 1;
+                    break;
+                }
+                node = it->second.get();
+                if (node->state == Node::State::Excluded) {
+                    return true;
+                }
+                if (node->state == Node::State::Unknown) {
+                    unresolvedDepth = i + 1;
+                    break;
+                }
+            }
+            if (unresolvedDepth == 0) {
+                return false;
+            }
+        }
+
+        // Resolve the shallowest unknown directory without holding the lock
+        const QStringList prefix = components.mid(0, unresolvedDepth);
+        QString prefixPath = prefix.join(QLatin1Char('/'));
+        if (absoluteUnix) {
+            prefixPath.prepend(QLatin1Char('/'));
+        }
+
+        // Filesystem roots (including Windows drive roots) are never checked
+        const bool isDriveRoot = !absoluteUnix && unresolvedDepth == 1;
+        const bool excluded = !isDriveRoot &&
+            QFile::exists(prefixPath + QLatin1Char('/') + m_markerName);
+
+        QMutexLocker locker(&m_mutex);
+        Node *node = findOrCreate(components, unresolvedDepth);
+        if (node->state == Node::State::Unknown) {
+            node->state = excluded ? Node::State::Excluded : Node::State::Clear;
+            m_cachedCount++;
+        }
+    }
+}
+
+void ExclusionTrie::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_root.children.clear();
+    m_cachedCount = 0;
+}
+
+int ExclusionTrie::cachedDirectoryCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cachedCount;
+}
+
+} // namespace Remus
@@ -0,0 +1,58 @@
+#ifndef REMUS_EXCLUSION_TRIE_H
+#define REMUS_EXCLUSION_TRIE_H
+
+#include <QMutex>
+#include <QString>
+#include <memory>
+#include <unordered_map>
+
+namespace Remus {
+
+/**
+ * @brief Per-scan cache of which directories are excluded by a marker file
+ *
+ * A directory is excluded when it, or any ancestor, contains the marker
+ * (`.remusdir`). Directories are stored as a path-component trie, so each
+ * directory's marker is checked on disk at most once per trie lifetime and
+ * a lookup costs O(depth) in-memory steps. Safe to query from several
+ * threads; the filesystem check runs outside the lock.
+ */
+class ExclusionTrie {
+public:
+    explicit ExclusionTrie(const QString &markerName);
+
+    /**
+     * @brief Check whether a directory is excluded
+     * @param dirPath Absolute, clean directory path
+     * @return True if the directory or an ancestor holds the marker
+     */
+    bool isExcluded(const QString &dirPath);
+
+    /**
+     * @brief Forget all cached answers (call at the start of each scan)
+     */
+    void clear();
+
+    /**
+     * @brief Number of directories whose marker state is cached
+     */
+    int cachedDirectoryCount() const;
+
+private:
+    struct Node {
+        enum class State { Unknown, Clear, Excluded };
+        State state = State::Unknown;
+        std::unordered_map<QString, std::unique_ptr<Node>> children;
+    };
+
+    Node *findOrCreate(const QStringList &components, int depth);
+
+    QString m_markerName;
+    Node m_root;
+    int m_cachedCount = 0;
+    mutable QMutex m_mutex;
+};
+
+} // namespace Remus
+
+#endif // REMUS_EXCLUSION_TRIE_H
@@ -0,0 +1,297 @@
+#include "fuzzy_matcher.h"
+#include <QVarLengthArray>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace Remus {
+
+namespace {
+
+constexpr int WORD_BITS = 64;
+constexpr quint64 HIGH_BIT = quint64(1) << (WORD_BITS - 1);
+
+/**
+ * @brief Per-character match masks of a pattern ("Peq" in Myers' paper)
+ *
+ * Bit i of block b is set when pattern[b * 64 + i] is the character.
+ * Rows 0-127 are ASCII, then one row per other character of the pattern
+ * (sorted), then an all-zero row for characters not in the pattern.
+ */
+class PatternMasks
+{
+public:
+    PatternMasks(const QChar *pattern, int length)
+        : m_length(length)
+        , m_blocks(qMax(1, (length + WORD_BITS - 1) / WORD_BITS))
+    {
+        for (int i = 0; i < length; ++i) {
+            const char16_t c = pattern[i].unicode();
+            if (c >= 128) {
+                m_others.push_back(c);
+            }
+        }
+        std::sort(m_others.begin(), m_others.end());
+        m_others.erase(std::unique(m_others.begin(), m_others.end()), m_others.end());
+
+        m_masks.assign((128 + m_others.size() + 1) * m_blocks, 0);
+        for (int i = 0; i < length; ++i) {
+            m_masks[row(pattern[i].unicode()) * m_blocks + i / WORD_BITS]
+                |= quint64(1) << (i % WORD_BITS);
+        }
+    }
+
+    int length() const { return m_length; }
+    int blocks() const { return m_blocks; }
+
+    const quint64 *masks(char16_t c) const { return &m_masks[row(c) * m_blocks]; }
+
+private:
+    size_t row(char16_t c) const
+    {
+        if (c < 128) {
+            return c;
+        }
+        const auto it = std::lower_bound(m_others.begin(), m_others.end(), c);
+        if (it == m_others.end() || *it != c) {
+            return 128 + m_others.size();
+        }
+        return 128 + size_t(it - m_others.begin());
+    }
+
+    int m_length;
+    int m_blocks;
+    std::vector<char16_t> m_others;
+    std::vector<quint64> m_masks;
+};
+
+/**
+ * @brief Advance one 64-row block by one text column
+ * @param hin Horizontal delta entering the block's top row (-1, 0 or +1)
+ * @param outBit Row whose horizontal delta is returned
+ */
+inline int advanceBlock(quint64 &pv, quint64 &mv, quint64 eq, int hin, quint64 outBit)
+{
+    const quint64 xv = eq | mv;
+    if (hin < 0) {
+        eq |= 1;
+    }
+    const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+    quint64 ph = mv | ~(xh | pv);
+    quint64 mh = pv & xh;
+
+    const int hout = (ph & outBit) ? 1 : ((mh & outBit) ? -1 : 0);
+
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) {
+        mh |= 1;
+    } else if (hin > 0) {
+        ph |= 1;
+    }
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+/**
+ * @brief Levenshtein distance of a prepared pattern to a text
+ * @return The distance; stops early with maxDistance + 1 once the distance
+ *         is certain to exceed maxDistance
+ */
+int patternDistance(const PatternMasks &pattern, const QChar *text, int length, int maxDistance)
+{
+    const int m = pattern.length();
+    if (m == 0) {
+        return length;
+    }
+
+    const int blocks = pattern.blocks();
+    const quint64 lastBit = quint64(1) << ((m - 1) % WORD_BITS);
+    QVarLengthArray<quint64, 4> pv(blocks);
+    QVarLengthArray<quint64, 4> mv(blocks);
+    std::fill(pv.begin(), pv.end(), ~quint64(0));
+    std::fill(mv.begin(), mv.end(), 0);
+
+    int score = m;
+    for (int j = 0; j < length; ++j) {
+        const quint64 *eq = pattern.masks(text[j].unicode());
+        // Row 0 is D[0][j] = j, so every column enters the first block with +1
+        int carry = 1;
+        for (int b = 0; b < blocks; ++b) {
+            carry = advanceBlock(pv[b], mv[b], eq[b], carry,
+                                 b == blocks - 1 ? lastBit : HIGH_BIT);
+        }
+        score += carry;
+
+        // Each remaining column can lower the score by at most one
+        if (score - (length - j - 1) > maxDistance) {
+            return maxDistance + 1;
+        }
+    }
+    return score;
+}
+
+QList<quint32> bigramsOf(const QString &text)
+{
+    QList<quint32> bigrams;
+    if (text.size() < 2) {
+        return bigrams;
+    }
+    bigrams.reserve(text.size() - 1);
+    for (qsizetype i = 0; i + 1 < text.size(); ++i) {
+        bigrams.append((quint32(text.at(i).unicode()) << 16) | text.at(i + 1).unicode());
+    }
+    std::sort(bigrams.begin(), bigrams.end());
+    return bigrams;
+}
+
+int sharedBigrams(const QList<quint32> &a, const QList<quint32> &b)
+{
+    int shared = 0;
+    auto ia = a.cbegin();
+    auto ib = b.cbegin();
+    while (ia != a.cend() && ib != b.cend()) {
+        if (*ia < *ib) {
+            ++ia;
+        } else if (*ib < *ia) {
+            ++ib;
+        } else {
+            ++shared;
+            ++ia;
+            ++ib;
+        }
+    }
+    return shared;
+}
+
+} // namespace
+
+FuzzyMatcher::FuzzyMatcher(const QStringList &titles)
+{
+    m_titles.reserve(titles.size());
+    m_bigrams.reserve(titles.size());
+    for (const QString &title : titles) {
+        m_titles.append(normalize(title));
+        m_bigrams.append(bigramsOf(m_titles.last()));
+    }
+
+    m_byLength.resize(m_titles.size());
+    std::iota(m_byLength.begin(), m_byLength.end(), 0);
+    std::stable_sort(m_byLength.begin(), m_byLength.end(), [this](int a, int b) {
+        return m_titles.at(a).size() < m_titles.at(b).size();
+    });
+}
+
+QString FuzzyMatcher::normalize(const QString &name)
+{
+    return name.toLower().simplified();
+}
+
+int FuzzyMatcher::editDistance(QStringView a, QStringView b)
+{
+    // The shorter string is the pattern: fewer blocks per column
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    const PatternMasks pattern(a.data(), int(a.size()));
+    return patternDistance(pattern, b.data(), int(b.size()), int(b.size()));
+}
+
+float FuzzyMatcher::similarity(const QString &a, const QString &b)
+{
+    const QString normA = normalize(a);
+    const QString normB = normalize(b);
+    if (normA.isEmpty() || normB.isEmpty()) {
+        return 0.0f;
+    }
+    if (normA == normB) {
+        return 1.0f;
+    }
+
+    const int distance = editDistance(normA, normB);
+    const int maxLength = qMax(normA.size(), normB.size());
+    return qMax(0.0f, 1.0f - float(distance) / float(maxLength));
+}
+
+QList<FuzzyMatcher::Candidate> FuzzyMatcher::bestMatches(const QString &name, int k,
+                                                         float minSimilarity) const
+{
+    const QString normalized = normalize(name);
+    if (k <= 0 || normalized.isEmpty() || m_titles.isEmpty()) {
+        return {};
+    }
+
+    const PatternMasks pattern(normalized.constData(), int(normalized.size()));
+    const QList<quint32> bigrams = bigramsOf(normalized);
+    const int nameLength = int(normalized.size());
+
+    // Kept best first; ties go to the lower title index
+    QList<Candidate> best;
+    auto better = [](const Candidate &a, const Candidate &b) {
+        return a.similarity > b.similarity
+               || (a.similarity == b.similarity && a.index < b.index);
+    };
+
+    // Shorter titles than nameLength * minSimilarity can never reach it
+    const int minLength = int(float(nameLength) * minSimilarity);
+    auto it = std::lower_bound(m_byLength.cbegin(), m_byLength.cend(), minLength,
+                               [this](int index, int length) {
+                                   return m_titles.at(index).size() < length;
+                               });
+
+    for (; it != m_byLength.cend(); ++it) {
+        const int index = *it;
+        const QString &title = m_titles.at(index);
+        const int titleLength = int(title.size());
+        const int maxLength = qMax(nameLength, titleLength);
+
+        // Once k results are held, only a better one is worth computing
+        const float bar = best.size() < k ? minSimilarity : best.last().similarity;
+
+        // Longer titles are sorted later and only get less similar
+        if (titleLength > nameLength && float(nameLength) < bar * float(titleLength)) {
+            break;
+        }
+
+        // Largest distance that still reaches the bar
+        const int maxDistance = int((1.0f - bar) * float(maxLength) + 1e-4f);
+        if (qAbs(nameLength - titleLength) > maxDistance) {
+            continue;
+        }
+
+        // q-gram lemma: within distance d, at least max - 1 - 2d bigrams are shared
+        const int requiredBigrams = maxLength - 1 - 2 * maxDistance;
+        if (requiredBigrams > 0 && sharedBigrams(bigrams, m_bigrams.at(index)) < requiredBigrams) {
+            continue;
+        }
+
+        const int distance = patternDistance(pattern, title.constData(), titleLength, maxDistance);
+        if (distance > maxDistance) {
+            continue;
+        }
+
+        const Candidate candidate{index, 1.0f - float(distance) / float(maxLength)};
+        if (candidate.similarity < minSimilarity
+            || (best.size() >= k && !better(candidate, best.last()))) {
+            continue;
+        }
+        best.insert(std::upper_bound(best.begin(), best.end(), candidate, better), candidate);
+        if (best.size() > k) {
+            best.removeLast();
+        }
+    }
+    return best;
+}
+
+QList<QList<FuzzyMatcher::Candidate>> FuzzyMatcher::bestMatches(const QStringList &names, int k,
+                                                                float minSimilarity) const
+{
+    return QtConcurrent::blockingMapped<QList<QList<Candidate>>>(names,
+        [this, k, minSimilarity](const QString &name) {
+            return bestMatches(name, k, minSimilarity);
+        });
+}
+
+} // namespace Remus
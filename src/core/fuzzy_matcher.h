@@ -0,0 +1,86 @@
+#ifndef REMUS_FUZZY_MATCHER_H
+#define REMUS_FUZZY_MATCHER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+namespace Remus {
+
+/**
+ * @brief Edit-distance name similarity shared by the matchers
+ *
+ * Distances use the bit-parallel algorithm of Myers/Hyyrö: the shorter
+ * string is turned into per-character bit masks and each character of the
+ * other string advances one machine word per 64 pattern characters, so a
+ * comparison costs O(n * ceil(m / 64)) word operations and allocates
+ * nothing for names of up to 64 characters.
+ *
+ * A FuzzyMatcher instance holds a prepared set of titles and answers "best
+ * k titles for this name" queries. Titles are pruned before any distance
+ * is computed: by length (sorted once), then by a bigram count filter, and
+ * the similarity bar rises to the k-th best result found so far. Batches
+ * of names are spread across the global thread pool.
+ *
+ * Similarity is 1 - distance / max(length) of the normalised strings,
+ * as the matchers have always computed it.
+ */
+class FuzzyMatcher
+{
+public:
+    /**
+     * @brief One title ranked for a name
+     */
+    struct Candidate {
+        int index = -1;             // Index into the titles given to the constructor
+        float similarity = 0.0f;    // 0.0 to 1.0
+    };
+
+    FuzzyMatcher() = default;
+
+    /**
+     * @brief Prepare titles for best-match queries
+     */
+    explicit FuzzyMatcher(const QStringList &titles);
+
+    /**
+     * @brief Best @p k titles for a name, most similar first
+     * @param minSimilarity Titles below this similarity are never returned
+     */
+    QList<Candidate> bestMatches(const QString &name, int k, float minSimilarity = 0.0f) const;
+
+    /**
+     * @brief Best @p k titles for each name, computed in parallel
+     * @return One list per name, in the order of @p names
+     */
+    QList<QList<Candidate>> bestMatches(const QStringList &names, int k,
+                                        float minSimilarity = 0.0f) const;
+
+    int titleCount() const { return m_titles.size(); }
+
+    /**
+     * @brief Form names are compared in: lower case, whitespace simplified
+     */
+    static QString normalize(const QString &name);
+
+    /**
+     * @brief Levenshtein distance between two strings (case-sensitive)
+     */
+    static int editDistance(QStringView a, QStringView b);
+
+    /**
+     * @brief Similarity of two names after normalize()
+     * @return 1.0 for equal names, 0.0 if either is empty
+     */
+    static float similarity(const QString &a, const QString &b);
+
+private:
+    QStringList m_titles;               // normalize()d
+    QList<QList<quint32>> m_bigrams;    // Sorted bigram keys per title (with repeats)
+    QList<int> m_byLength;              // Title indexes sorted by normalised length
+};
+
+} // namespace Remus
+
+#endif // REMUS_FUZZY_MATCHER_H
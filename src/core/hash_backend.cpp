@@ -0,0 +1,374 @@
+#include "hash_backend.h"
+
+#include <atomic>
+#include <cstring>
+#include <zlib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define REMUS_HASH_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace Remus {
+
+namespace {
+
+std::atomic<bool> s_accelerationEnabled{true};
+
+/// PCLMUL folding needs at least four 16-byte lanes to start
+constexpr qint64 CRC32_FOLD_MINIMUM = 64;
+
+const HashBackend::CpuFeatures &detectedFeatures()
+{
+    static const HashBackend::CpuFeatures features = [] {
+        HashBackend::CpuFeatures f;
+#ifdef REMUS_HASH_X86
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            f.ssse3 = (ecx & bit_SSSE3) != 0;
+            f.sse41 = (ecx & bit_SSE4_1) != 0;
+            f.pclmul = (ecx & bit_PCLMUL) != 0;
+        }
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            f.shaNi = (ebx & (1u << 29)) != 0;
+        }
+#endif
+        return f;
+    }();
+    return features;
+}
+
+#ifdef REMUS_HASH_X86
+
+/**
+ * CRC32 by carry-less multiplication folding (Gopal et al., "Fast CRC
+ * Computation for Generic Polynomials Using PCLMULQDQ", Intel 2009).
+ * Works on the bit-reflected, pre-inverted CRC register; @p len must be a
+ * multiple of 16 and at least 64.
+ */
+__attribute__((target("pclmul,sse4.1")))
+quint32 crc32FoldPclmul(const unsigned char *buf, qint64 len, quint32 crc)
+{
+    alignas(16) static const quint64 k1k2[] = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+    alignas(16) static const quint64 k3k4[] = { 0x01751997d0ULL, 0x00ccaa009eULL };
+    alignas(16) static const quint64 k5k0[] = { 0x0163cd6124ULL, 0x0000000000ULL };
+    alignas(16) static const quint64 poly[] = { 0x01db710641ULL, 0x01f7011641ULL };
+
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x00));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x10));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x20));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+    __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+    buf += 64;
+    len -= 64;
+
+    // Fold four lanes in parallel, 64 bytes per iteration
+    while (len >= 64) {
+        const __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        const __m128i x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        const __m128i x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        const __m128i x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 0x30)));
+
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+    const __m128i lanes[] = { x2, x3, x4 };
+    for (const __m128i &lane : lanes) {
+        const __m128i lo = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, lane), lo);
+    }
+
+    // Remaining 16-byte blocks
+    while (len >= 16) {
+        const __m128i lo = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf))), lo);
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 -> 64 bits
+    __m128i x2r = _mm_clmulepi64_si128(x1, x0, 0x10);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2r);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+    x2r = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+    x2r = _mm_and_si128(x1, mask32);
+    x2r = _mm_clmulepi64_si128(x2r, x0, 0x10);
+    x2r = _mm_and_si128(x2r, mask32);
+    x2r = _mm_clmulepi64_si128(x2r, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+
+    return static_cast<quint32>(_mm_extract_epi32(x1, 1));
+}
+
+/**
+ * SHA1 block compression with the SHA-NI extensions. Processes
+ * @p blockCount consecutive 64-byte blocks into @p state.
+ */
+__attribute__((target("sha,ssse3,sse4.1")))
+void sha1CompressShaNi(quint32 state[5], const unsigned char *data, qint64 blockCount)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1B);
+    __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; blockCount > 0; --blockCount, data += 64) {
+        const __m128i abcdSave = abcd;
+        const __m128i eSave = e0;
+
+        // Message schedule kept in four rotating registers: w[i % 4] holds
+        // W[4i .. 4i+3]. Rounds are issued four at a time.
+        __m128i w[4];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i)), byteSwap);
+        }
+
+        __m128i e = _mm_add_epi32(e0, w[0]);
+        __m128i previous = abcd;
+
+        // Groups from 4 on extend the schedule in place:
+        // W[t] = rol(W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16], 1), four lanes at a time.
+        // rnds4 needs the round function as an immediate, hence the macro.
+#define REMUS_SHA1_ROUNDS(firstGroup, func)                                        \
+        for (int group = (firstGroup); group < (firstGroup) + 5; ++group) {         \
+            if (group >= 4) {                                                       \
+                __m128i next = _mm_sha1msg1_epu32(w[group % 4], w[(group + 1) % 4]); \
+                next = _mm_xor_si128(next, w[(group + 2) % 4]);                     \
+                w[group % 4] = _mm_sha1msg2_epu32(next, w[(group + 3) % 4]);        \
+            }                                                                       \
+            if (group > 0) {                                                        \
+                e = _mm_sha1nexte_epu32(previous, w[group % 4]);                    \
+            }                                                                       \
+            previous = abcd;                                                        \
+            abcd = _mm_sha1rnds4_epu32(abcd, e, func);                              \
+        }
+
+        REMUS_SHA1_ROUNDS(0, 0)
+        REMUS_SHA1_ROUNDS(5, 1)
+        REMUS_SHA1_ROUNDS(10, 2)
+        REMUS_SHA1_ROUNDS(15, 3)
+
+#undef REMUS_SHA1_ROUNDS
+
+        e0 = _mm_sha1nexte_epu32(previous, eSave);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), abcd);
+    state[4] = static_cast<quint32>(_mm_extract_epi32(e0, 3));
+}
+
+#endif // REMUS_HASH_X86
+
+} // namespace
+
+// ============================================================================
+// HashBackend
+// ============================================================================
+
+HashBackend::CpuFeatures HashBackend::cpuFeatures()
+{
+    return detectedFeatures();
+}
+
+void HashBackend::setAccelerationEnabled(bool enabled)
+{
+    s_accelerationEnabled.store(enabled);
+}
+
+bool HashBackend::accelerationEnabled()
+{
+    return s_accelerationEnabled.load();
+}
+
+bool HashBackend::hasAcceleratedCrc32()
+{
+#ifdef REMUS_HASH_X86
+    const CpuFeatures &f = detectedFeatures();
+    return accelerationEnabled() && f.pclmul && f.sse41;
+#else
+    return false;
+#endif
+}
+
+bool HashBackend::hasAcceleratedSha1()
+{
+#ifdef REMUS_HASH_X86
+    const CpuFeatures &f = detectedFeatures();
+    return accelerationEnabled() && f.shaNi && f.ssse3 && f.sse41;
+#else
+    return false;
+#endif
+}
+
+QString HashBackend::crc32BackendName()
+{
+    return hasAcceleratedCrc32() ? QStringLiteral("pclmul") : QStringLiteral("zlib");
+}
+
+QString HashBackend::sha1BackendName()
+{
+    return hasAcceleratedSha1() ? QStringLiteral("sha-ni") : QStringLiteral("qt");
+}
+
+// ============================================================================
+// Crc32Digest
+// ============================================================================
+
+Crc32Digest::Crc32Digest()
+    : m_crc(static_cast<quint32>(crc32(0L, Z_NULL, 0)))
+    , m_accelerated(HashBackend::hasAcceleratedCrc32())
+{
+}
+
+void Crc32Digest::addData(const char *data, qint64 size)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+
+#ifdef REMUS_HASH_X86
+    if (m_accelerated && size >= CRC32_FOLD_MINIMUM) {
+        const qint64 folded = size & ~qint64(15);
+        m_crc = ~crc32FoldPclmul(bytes, folded, ~m_crc);
+        bytes += folded;
+        size -= folded;
+    }
+#endif
+
+    // zlib takes uInt lengths; feed oversized buffers in slices
+    while (size > 0) {
+        const uInt slice = static_cast<uInt>(qMin<qint64>(size, 1 << 30));
+        m_crc = static_cast<quint32>(crc32(m_crc, bytes, slice));
+        bytes += slice;
+        size -= slice;
+    }
+}
+
+QString Crc32Digest::hex() const
+{
+    return QString("%1").arg(m_crc, 8, 16, QChar('0')).toLower();
+}
+
+// ============================================================================
+// Sha1Digest
+// ============================================================================
+
+Sha1Digest::Sha1Digest()
+    : m_accelerated(HashBackend::hasAcceleratedSha1())
+    , m_fallback(QCryptographicHash::Sha1)
+    , m_state{0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u}
+{
+}
+
+void Sha1Digest::addData(const char *data, qint64 size)
+{
+    if (!m_accelerated) {
+        m_fallback.addData(QByteArrayView(data, size));
+        return;
+    }
+
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    m_length += static_cast<quint64>(size);
+
+    if (m_blockFill > 0) {
+        const int take = static_cast<int>(qMin<qint64>(size, 64 - m_blockFill));
+        std::memcpy(m_block + m_blockFill, bytes, static_cast<size_t>(take));
+        m_blockFill += take;
+        bytes += take;
+        size -= take;
+        if (m_blockFill < 64) {
+            return;
+        }
+        compress(m_block, 1);
+        m_blockFill = 0;
+    }
+
+    const qint64 blocks = size / 64;
+    if (blocks > 0) {
+        compress(bytes, blocks);
+        bytes += blocks * 64;
+        size -= blocks * 64;
+    }
+
+    if (size > 0) {
+        std::memcpy(m_block, bytes, static_cast<size_t>(size));
+        m_blockFill = static_cast<int>(size);
+    }
+}
+
+QByteArray Sha1Digest::result()
+{
+    if (!m_accelerated) {
+        return m_fallback.result();
+    }
+    if (m_finished) {
+        return m_result;
+    }
+
+    // Standard padding: 0x80, zeros, then the bit length big-endian
+    const quint64 bitLength = m_length * 8;
+    m_block[m_blockFill++] = 0x80;
+    if (m_blockFill > 56) {
+        std::memset(m_block + m_blockFill, 0, static_cast<size_t>(64 - m_blockFill));
+        compress(m_block, 1);
+        m_blockFill = 0;
+    }
+    std::memset(m_block + m_blockFill, 0, static_cast<size_t>(56 - m_blockFill));
+    for (int i = 0; i < 8; ++i) {
+        m_block[56 + i] = static_cast<unsigned char>(bitLength >> (56 - 8 * i));
+    }
+    compress(m_block, 1);
+
+    m_result.resize(20);
+    for (int i = 0; i < 5; ++i) {
+        m_result[4 * i + 0] = static_cast<char>(m_state[i] >> 24);
+        m_result[4 * i + 1] = static_cast<char>(m_state[i] >> 16);
+        m_result[4 * i + 2] = static_cast<char>(m_state[i] >> 8);
+        m_result[4 * i + 3] = static_cast<char>(m_state[i]);
+    }
+    m_finished = true;
+    return m_result;
+}
+
+void Sha1Digest::compress(const unsigned char *blocks, qint64 blockCount)
+{
+#ifdef REMUS_HASH_X86
+    sha1CompressShaNi(m_state, blocks, blockCount);
+#else
+    Q_UNUSED(blocks);
+    Q_UNUSED(blockCount);
+#endif
+}
+
+} // namespace Remus
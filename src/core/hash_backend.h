@@ -0,0 +1,96 @@
+#ifndef REMUS_HASH_BACKEND_H
+#define REMUS_HASH_BACKEND_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+
+namespace Remus {
+
+/**
+ * @brief Runtime-dispatched digest kernels used by Hasher
+ *
+ * On x86-64 the CPU is probed once per process: CRC32 uses PCLMULQDQ
+ * carry-less folding and SHA1 uses the SHA-NI instructions when present.
+ * Everything else (and every other architecture) falls back to zlib's
+ * crc32() and QCryptographicHash, which remain the reference results.
+ */
+class HashBackend {
+public:
+    struct CpuFeatures {
+        bool ssse3 = false;
+        bool sse41 = false;
+        bool pclmul = false;
+        bool shaNi = false;
+    };
+
+    /**
+     * @brief CPU features relevant to hashing (cached after first call)
+     */
+    static CpuFeatures cpuFeatures();
+
+    /**
+     * @brief Enable or disable hardware kernels process-wide
+     *
+     * Digests created afterwards use the scalar fallbacks when disabled.
+     * Intended for tests and benchmarks comparing both paths.
+     */
+    static void setAccelerationEnabled(bool enabled);
+    static bool accelerationEnabled();
+
+    static bool hasAcceleratedCrc32();
+    static bool hasAcceleratedSha1();
+
+    /// Kernel in use for CRC32 ("pclmul" or "zlib")
+    static QString crc32BackendName();
+
+    /// Kernel in use for SHA1 ("sha-ni" or "qt")
+    static QString sha1BackendName();
+};
+
+/**
+ * @brief Incremental CRC32 (IEEE 802.3, as used by zlib and DAT files)
+ */
+class Crc32Digest {
+public:
+    Crc32Digest();
+
+    void addData(const char *data, qint64 size);
+    quint32 value() const { return m_crc; }
+
+    /// Lowercase 8-character hex, zero padded
+    QString hex() const;
+
+private:
+    quint32 m_crc = 0;
+    bool m_accelerated = false;
+};
+
+/**
+ * @brief Incremental SHA1 with SHA-NI block compression when available
+ */
+class Sha1Digest {
+public:
+    Sha1Digest();
+
+    void addData(const char *data, qint64 size);
+
+    /// Raw 20-byte digest; finalises the digest
+    QByteArray result();
+
+private:
+    void compress(const unsigned char *blocks, qint64 blockCount);
+
+    bool m_accelerated = false;
+    QCryptographicHash m_fallback;
+    quint32 m_state[5];
+    unsigned char m_block[64];
+    int m_blockFill = 0;
+    quint64 m_length = 0;
+    bool m_finished = false;
+    QByteArray m_result;
+};
+
+} // namespace Remus
+
+#endif // REMUS_HASH_BACKEND_H
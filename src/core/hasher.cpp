@@ -1,123 +1,551 @@
 #include "hasher.h"
+#include "hash_backend.h"
+#include "zip_reader.h"
 #include <QFile>
+#include <QFileInfo>
+#include <QStorageInfo>
 #include <QCryptographicHash>
 #include <QDebug>
-#include <zlib.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Remus {
 
+#ifdef Q_OS_UNIX
+namespace {
+
+#ifdef Q_OS_LINUX
+/// Alignment required for O_DIRECT buffers and offsets
+constexpr qint64 DIRECT_IO_ALIGNMENT = 4096;
+#endif
+
+bool isNetworkFileSystem(const QByteArray &type)
+{
+    const QByteArray fs = type.toLower();
+    return fs.startsWith("nfs") || fs.startsWith("cifs") || fs.startsWith("smb") ||
+           fs == "fuse.sshfs" || fs == "9p" || fs == "afs" || fs == "ceph" ||
+           fs == "fuse.glusterfs";
+}
+
+QString systemError()
+{
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+} // namespace
+#endif
+
 Hasher::Hasher(QObject *parent)
     : QObject(parent)
 {
 }
 
 HashResult Hasher::calculateHashes(const QString &filePath, bool stripHeader, int headerSize)
+{
+    return hashStream(filePath, stripHeader, headerSize, true, true, true);
+}
+
+QString Hasher::calculateHash(const QString &filePath, const QString &algorithm,
+                               bool stripHeader, int headerSize)
+{
+    const bool wantCrc32 = algorithm == "CRC32";
+    const bool wantMd5 = algorithm == "MD5";
+    const bool wantSha1 = algorithm == "SHA1";
+    if (!wantCrc32 && !wantMd5 && !wantSha1) {
+        return QString();
+    }
+
+    HashResult result = hashStream(filePath, stripHeader, headerSize,
+                                   wantCrc32, wantMd5, wantSha1);
+    if (!result.success) {
+        return QString();
+    }
+
+    if (wantCrc32) return result.crc32;
+    if (wantMd5) return result.md5;
+    return result.sha1;
+}
+
+Hasher::ReadStrategy Hasher::effectiveReadStrategy(const QString &filePath) const
+{
+    if (m_readStrategy != ReadStrategy::Auto) {
+        return m_readStrategy;
+    }
+
+#ifdef Q_OS_UNIX
+    const QFileInfo info(filePath);
+    if (!info.isFile() || info.size() < MMAP_THRESHOLD) {
+        // Cartridge-sized ROMs: one buffered read is cheaper than mapping
+        return ReadStrategy::Buffered;
+    }
+
+    // A mapping on a network share turns server hiccups into SIGBUS
+    if (isNetworkFileSystem(QStorageInfo(info.absolutePath()).fileSystemType())) {
+        return ReadStrategy::Buffered;
+    }
+
+    return ReadStrategy::MemoryMapped;
+#else
+    Q_UNUSED(filePath);
+    return ReadStrategy::Buffered;
+#endif
+}
+
+QString Hasher::readStrategyName(ReadStrategy strategy)
+{
+    switch (strategy) {
+        case ReadStrategy::Auto: return QStringLiteral("auto");
+        case ReadStrategy::Buffered: return QStringLiteral("buffered");
+        case ReadStrategy::Positional: return QStringLiteral("pread");
+        case ReadStrategy::MemoryMapped: return QStringLiteral("mmap");
+        case ReadStrategy::Direct: return QStringLiteral("direct");
+    }
+    return QStringLiteral("auto");
+}
+
+Hasher::ReadStrategy Hasher::readStrategyFromName(const QString &name)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "buffered") return ReadStrategy::Buffered;
+    if (key == "pread") return ReadStrategy::Positional;
+    if (key == "mmap") return ReadStrategy::MemoryMapped;
+    if (key == "direct") return ReadStrategy::Direct;
+    return ReadStrategy::Auto;
+}
+
+HashResult Hasher::hashStream(const QString &filePath, bool stripHeader, int headerSize,
+                              bool wantCrc32, bool wantMd5, bool wantSha1)
 {
     HashResult result;
 
-    QByteArray data = readFileData(filePath, stripHeader, headerSize);
-    if (data.isEmpty()) {
-        result.success = false;
+    const qint64 offset = (stripHeader && headerSize > 0) ? headerSize : 0;
+    const qint64 total = qMax<qint64>(0, QFileInfo(filePath).size() - offset);
+
+    Crc32Digest crc;
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    Sha1Digest sha1;
+    qint64 processed = 0;
+    int lastPercentage = -1;
+
+    const ChunkSink sink = [&](const char *data, qint64 size) {
+        if (wantCrc32) {
+            crc.addData(data, size);
+        }
+        if (wantMd5) {
+            md5.addData(QByteArrayView(data, size));
+        }
+        if (wantSha1) {
+            sha1.addData(data, size);
+        }
+
+        processed += size;
+        if (total > 0) {
+            const int percentage = static_cast<int>(qMin<qint64>(100, processed * 100 / total));
+            if (percentage != lastPercentage) {
+                lastPercentage = percentage;
+                emit hashProgress(filePath, percentage);
+            }
+        }
+    };
+
+    bool ok = false;
+    switch (effectiveReadStrategy(filePath)) {
+        case ReadStrategy::Positional:
+            ok = readPositional(filePath, offset, sink, result.error);
+            break;
+        case ReadStrategy::MemoryMapped:
+            ok = readMapped(filePath, offset, sink, result.error);
+            break;
+        case ReadStrategy::Direct:
+            ok = readDirect(filePath, offset, sink, result.error);
+            break;
+        case ReadStrategy::Auto:
+        case ReadStrategy::Buffered:
+            ok = readBuffered(filePath, offset, sink, result.error);
+            break;
+    }
+
+    if (!ok) {
+        qWarning() << "Failed to hash file:" << filePath << result.error;
+        return result;
+    }
+
+    if (processed == 0) {
         result.error = "Failed to read file or file is empty";
         return result;
     }
 
-    result.crc32 = calculateCRC32(data);
-    result.md5 = calculateMD5(data);
-    result.sha1 = calculateSHA1(data);
+    if (wantCrc32) {
+        result.crc32 = crc.hex();
+    }
+    if (wantMd5) {
+        result.md5 = QString(md5.result().toHex()).toLower();
+    }
+    if (wantSha1) {
+        result.sha1 = QString(sha1.result().toHex()).toLower();
+    }
     result.success = true;
 
     return result;
 }
 
-QString Hasher::calculateHash(const QString &filePath, const QString &algorithm,
-                               bool stripHeader, int headerSize)
+HashResult Hasher::calculateZipMemberHashes(const QString &archivePath, const QString &memberName,
+                                            const QString &extension, bool crcOnly)
 {
-    QByteArray data = readFileData(filePath, stripHeader, headerSize);
-    if (data.isEmpty()) {
-        return QString();
+    HashResult result;
+
+    ZipReader zip(archivePath);
+    if (!zip.open()) {
+        result.error = zip.errorString();
+        return result;
+    }
+
+    const ZipEntry *entry = zip.resolveEntry(memberName, extension);
+    if (!entry) {
+        result.error = "No file found in archive";
+        return result;
+    }
+    if (!entry->isSupported()) {
+        result.error = QString("Unsupported ZIP member %1 (method %2%3)")
+                           .arg(entry->name).arg(entry->method)
+                           .arg(entry->isEncrypted() ? ", encrypted" : "");
+        return result;
+    }
+    if (entry->uncompressedSize == 0) {
+        result.error = "Failed to read file or file is empty";
+        return result;
+    }
+
+    if (crcOnly && !extensionMayHaveHeader(extension)) {
+        // The central directory already records the CRC32 of the whole member
+        result.crc32 = QString("%1").arg(entry->crc32, 8, 16, QLatin1Char('0'));
+        result.success = true;
+        return result;
     }
 
-    if (algorithm == "CRC32") {
-        return calculateCRC32(data);
-    } else if (algorithm == "MD5") {
-        return calculateMD5(data);
-    } else if (algorithm == "SHA1") {
-        return calculateSHA1(data);
+    const qint64 total = static_cast<qint64>(entry->uncompressedSize);
+    Crc32Digest crc;
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    Sha1Digest sha1;
+    QByteArray head;
+    int headerSize = -1;  // Unknown until HEADER_PEEK_SIZE bytes (or the whole member) arrive
+    qint64 processed = 0;
+    int lastPercentage = -1;
+
+    auto feed = [&](const char *data, qint64 size) {
+        crc.addData(data, size);
+        if (!crcOnly) {
+            md5.addData(QByteArrayView(data, size));
+            sha1.addData(data, size);
+        }
+    };
+    auto resolveHeader = [&]() {
+        headerSize = detectHeaderSize(head, total, extension);
+        if (head.size() > headerSize) {
+            feed(head.constData() + headerSize, head.size() - headerSize);
+        }
+        head.clear();
+    };
+
+    const ZipReader::ChunkSink sink = [&](const char *data, qint64 size) {
+        processed += size;
+        const int percentage = static_cast<int>(qMin<qint64>(100, processed * 100 / total));
+        if (percentage != lastPercentage) {
+            lastPercentage = percentage;
+            emit hashProgress(archivePath, percentage);
+        }
+
+        if (headerSize < 0) {
+            const qint64 take = qMin<qint64>(size, HEADER_PEEK_SIZE - head.size());
+            head.append(data, take);
+            data += take;
+            size -= take;
+            if (head.size() < HEADER_PEEK_SIZE) {
+                return;
+            }
+            resolveHeader();
+        }
+        if (size > 0) {
+            feed(data, size);
+        }
+    };
+
+    if (!zip.readEntry(*entry, sink, result.error)) {
+        qWarning() << "Failed to hash ZIP member:" << archivePath << entry->name << result.error;
+        return result;
+    }
+    if (headerSize < 0) {
+        resolveHeader();
+    }
+
+    if (total <= headerSize) {
+        result.error = "Failed to read file or file is empty";
+        return result;
+    }
+    // Without a stripped header the stored CRC covers exactly what was hashed
+    if (headerSize == 0 && crc.value() != entry->crc32) {
+        result.error = "CRC mismatch for " + entry->name + " (corrupt archive?)";
+        return result;
+    }
+
+    result.crc32 = crc.hex();
+    if (!crcOnly) {
+        result.md5 = QString(md5.result().toHex()).toLower();
+        result.sha1 = QString(sha1.result().toHex()).toLower();
     }
+    result.success = true;
 
-    return QString();
+    return result;
 }
 
-QByteArray Hasher::readFileData(const QString &filePath, bool stripHeader, int headerSize)
+bool Hasher::readBuffered(const QString &filePath, qint64 offset,
+                          const ChunkSink &sink, QString &error)
 {
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open file for hashing:" << filePath;
-        return QByteArray();
+        error = "Failed to open file: " + file.errorString();
+        return false;
     }
 
-    if (stripHeader && headerSize > 0) {
-        file.seek(headerSize);
+    if (offset > 0 && !file.seek(offset)) {
+        error = "Failed to skip header: " + file.errorString();
+        return false;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
+    // One reusable buffer per call keeps memory bounded for multi-GB disc
+    // images; small cartridge ROMs only allocate what they need.
+    const qint64 bufferSize = qBound<qint64>(1, file.size() - offset, CHUNK_SIZE);
+    QByteArray buffer(bufferSize, Qt::Uninitialized);
+    while (true) {
+        const qint64 bytesRead = file.read(buffer.data(), bufferSize);
+        if (bytesRead < 0) {
+            error = "Read error: " + file.errorString();
+            return false;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        sink(buffer.constData(), bytesRead);
+    }
 
-    return data;
+    return true;
 }
 
-QString Hasher::calculateCRC32(const QByteArray &data)
+bool Hasher::readPositional(const QString &filePath, qint64 offset,
+                            const ChunkSink &sink, QString &error)
 {
-    uLong crc = crc32(0L, Z_NULL, 0);
-    crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), data.size());
-    return QString("%1").arg(crc, 8, 16, QChar('0')).toLower();
+#ifdef Q_OS_UNIX
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Failed to open file: " + systemError();
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    ::posix_fadvise(fd, offset, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    QByteArray buffer(CHUNK_SIZE, Qt::Uninitialized);
+    qint64 position = offset;
+    while (true) {
+        const ssize_t bytesRead = ::pread(fd, buffer.data(), static_cast<size_t>(CHUNK_SIZE), position);
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = "Read error: " + systemError();
+            ::close(fd);
+            return false;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+
+        sink(buffer.constData(), bytesRead);
+
+#ifdef Q_OS_LINUX
+        // Hashed pages will not be read again; keep them from evicting hotter data
+        ::posix_fadvise(fd, position, bytesRead, POSIX_FADV_DONTNEED);
+#endif
+        position += bytesRead;
+    }
+
+    ::close(fd);
+    return true;
+#else
+    return readBuffered(filePath, offset, sink, error);
+#endif
 }
 
-QString Hasher::calculateMD5(const QByteArray &data)
+bool Hasher::readMapped(const QString &filePath, qint64 offset,
+                        const ChunkSink &sink, QString &error)
 {
-    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Md5);
-    return QString(hash.toHex()).toLower();
+#ifdef Q_OS_UNIX
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Failed to open file: " + systemError();
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        // Pipes and devices cannot be mapped reliably
+        ::close(fd);
+        return readBuffered(filePath, offset, sink, error);
+    }
+
+    const qint64 fileSize = static_cast<qint64>(st.st_size);
+    const qint64 pageSize = static_cast<qint64>(::sysconf(_SC_PAGESIZE));
+
+    // Map fixed windows rather than the whole image so address space and
+    // resident pages stay bounded; each window is dropped once hashed.
+    qint64 position = offset;
+    while (position < fileSize) {
+        const qint64 windowStart = position - (position % pageSize);
+        const qint64 windowLength = qMin(MAP_WINDOW_SIZE, fileSize - windowStart);
+
+        void *mapped = ::mmap(nullptr, static_cast<size_t>(windowLength), PROT_READ,
+                              MAP_PRIVATE, fd, static_cast<off_t>(windowStart));
+        if (mapped == MAP_FAILED) {
+            error = "Failed to map file: " + systemError();
+            ::close(fd);
+            return false;
+        }
+        ::madvise(mapped, static_cast<size_t>(windowLength), MADV_SEQUENTIAL);
+
+        const char *base = static_cast<const char *>(mapped);
+        for (qint64 cursor = position - windowStart; cursor < windowLength; cursor += CHUNK_SIZE) {
+            sink(base + cursor, qMin(CHUNK_SIZE, windowLength - cursor));
+        }
+
+        ::munmap(mapped, static_cast<size_t>(windowLength));
+#ifdef Q_OS_LINUX
+        ::posix_fadvise(fd, windowStart, windowLength, POSIX_FADV_DONTNEED);
+#endif
+        position = windowStart + windowLength;
+    }
+
+    ::close(fd);
+    return true;
+#else
+    return readBuffered(filePath, offset, sink, error);
+#endif
 }
 
-QString Hasher::calculateSHA1(const QByteArray &data)
+bool Hasher::readDirect(const QString &filePath, qint64 offset,
+                        const ChunkSink &sink, QString &error)
 {
-    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
-    return QString(hash.toHex()).toLower();
+#ifdef Q_OS_LINUX
+    const int fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+    if (fd < 0) {
+        if (errno == EINVAL) {
+            // Filesystem does not support O_DIRECT (e.g. tmpfs)
+            return readPositional(filePath, offset, sink, error);
+        }
+        error = "Failed to open file: " + systemError();
+        return false;
+    }
+
+    void *raw = nullptr;
+    if (::posix_memalign(&raw, static_cast<size_t>(DIRECT_IO_ALIGNMENT),
+                         static_cast<size_t>(CHUNK_SIZE)) != 0) {
+        ::close(fd);
+        error = "Failed to allocate aligned read buffer";
+        return false;
+    }
+    std::unique_ptr<char, decltype(&std::free)> buffer(static_cast<char *>(raw), &std::free);
+
+    // O_DIRECT offsets must be aligned: start at the block holding the header
+    // end and discard the leading bytes of the first read.
+    qint64 position = offset - (offset % DIRECT_IO_ALIGNMENT);
+    qint64 skip = offset - position;
+    while (true) {
+        const ssize_t bytesRead = ::pread(fd, buffer.get(), static_cast<size_t>(CHUNK_SIZE), position);
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EINVAL && position == offset - (offset % DIRECT_IO_ALIGNMENT)) {
+                // Accepted at open() but rejected on read by this filesystem
+                ::close(fd);
+                return readPositional(filePath, offset, sink, error);
+            }
+            error = "Read error: " + systemError();
+            ::close(fd);
+            return false;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+
+        if (bytesRead > skip) {
+            sink(buffer.get() + skip, bytesRead - skip);
+            skip = 0;
+        } else {
+            skip -= bytesRead;
+        }
+
+        position += bytesRead;
+        if (bytesRead < CHUNK_SIZE) {
+            // Short read is EOF; the next unaligned offset would be rejected
+            break;
+        }
+    }
+
+    ::close(fd);
+    return true;
+#else
+    return readPositional(filePath, offset, sink, error);
+#endif
+}
+
+bool Hasher::extensionMayHaveHeader(const QString &extension)
+{
+    return extension == ".nes" || extension == ".lnx" || extension == ".smc";
 }
 
 int Hasher::detectHeaderSize(const QString &filePath, const QString &extension)
+{
+    if (!extensionMayHaveHeader(extension)) {
+        return 0;  // No header
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return extension == ".lnx" ? 64 : 0;
+    }
+    return detectHeaderSize(file.read(HEADER_PEEK_SIZE), file.size(), extension);
+}
+
+int Hasher::detectHeaderSize(const QByteArray &head, qint64 totalSize, const QString &extension)
 {
     if (extension == ".nes") {
-        // iNES header detection
-        QFile file(filePath);
-        if (file.open(QIODevice::ReadOnly)) {
-            QByteArray header = file.read(4);
-            file.close();
-            
-            // Check for "NES\x1A" magic
-            if (header.size() == 4 && 
-                header[0] == 'N' && 
-                header[1] == 'E' && 
-                header[2] == 'S' && 
-                header[3] == 0x1A) {
-                return 16;  // iNES header is 16 bytes
-            }
+        // iNES header detection: "NES\x1A" magic
+        if (head.size() >= 4 &&
+            head[0] == 'N' &&
+            head[1] == 'E' &&
+            head[2] == 'S' &&
+            head[3] == 0x1A) {
+            return 16;  // iNES header is 16 bytes
         }
     } else if (extension == ".lnx") {
         // Atari Lynx header is always 64 bytes
         return 64;
     } else if (extension == ".smc") {
         // SNES SMC copier header (rare)
-        QFile file(filePath);
-        if (file.open(QIODevice::ReadOnly)) {
-            qint64 size = file.size();
-            file.close();
-            
-            // If file size is not a power of 2, likely has 512-byte header
-            if ((size & (size - 1)) != 0 && (size % 512) == 0) {
-                return 512;
-            }
+        // If file size is not a power of 2, likely has 512-byte header
+        if ((totalSize & (totalSize - 1)) != 0 && (totalSize % 512) == 0) {
+            return 512;
         }
     }
 
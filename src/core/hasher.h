@@ -1,8 +1,10 @@
 #ifndef REMUS_HASHER_H
 #define REMUS_HASHER_H
 
+#include <QByteArray>
 #include <QString>
 #include <QObject>
+#include <functional>
 
 namespace Remus {
 
@@ -21,13 +23,67 @@ struct HashResult {
  * @brief Calculates file hashes (CRC32, MD5, SHA1)
  * 
  * Supports header stripping for systems that require it (NES, Lynx).
+ * Files are streamed in fixed-size chunks and every requested digest is
+ * updated in the same pass, so memory use per hasher is bounded by
+ * CHUNK_SIZE regardless of image size. CRC32 and SHA1 come from
+ * HashBackend, which uses PCLMULQDQ/SHA-NI kernels when the CPU has them.
+ * How the bytes are read is selectable
+ * per hasher (see ReadStrategy) so the fastest path can be picked per
+ * storage type.
  */
 class Hasher : public QObject {
     Q_OBJECT
 
 public:
+    /// Read size for streaming hashes (bytes)
+    static constexpr qint64 CHUNK_SIZE = 1024 * 1024;
+
+    /// Length of each mmap window in MemoryMapped mode (bytes, page aligned)
+    static constexpr qint64 MAP_WINDOW_SIZE = 64 * 1024 * 1024;
+
+    /// Files at least this large are memory-mapped in Auto mode (bytes)
+    static constexpr qint64 MMAP_THRESHOLD = 16 * 1024 * 1024;
+
+    /// Leading bytes needed to detect any supported copier header
+    static constexpr int HEADER_PEEK_SIZE = 512;
+
+    /**
+     * @brief How file bytes are pulled into the digests
+     *
+     * Non-Buffered strategies need POSIX APIs; on other platforms, or when
+     * the filesystem rejects them, hashing falls back to Buffered.
+     */
+    enum class ReadStrategy {
+        Auto,          ///< MemoryMapped for large files on local disks, Buffered otherwise
+        Buffered,      ///< QFile reads into a reusable chunk buffer
+        Positional,    ///< pread() with sequential readahead, pages dropped behind the cursor
+        MemoryMapped,  ///< Windowed mmap + madvise(MADV_SEQUENTIAL), no copy into userspace
+        Direct         ///< O_DIRECT reads that bypass the page cache (Linux only)
+    };
+
     explicit Hasher(QObject *parent = nullptr);
 
+    void setReadStrategy(ReadStrategy strategy) { m_readStrategy = strategy; }
+    ReadStrategy readStrategy() const { return m_readStrategy; }
+
+    /**
+     * @brief Strategy actually used for a file once Auto is resolved
+     * @param filePath Path to file
+     * @return Concrete strategy (never Auto)
+     */
+    ReadStrategy effectiveReadStrategy(const QString &filePath) const;
+
+    /**
+     * @brief Stable lowercase name for a strategy ("auto", "buffered", "pread", "mmap", "direct")
+     */
+    static QString readStrategyName(ReadStrategy strategy);
+
+    /**
+     * @brief Parse a strategy name as produced by readStrategyName()
+     * @return Matching strategy, or Auto if the name is unknown
+     */
+    static ReadStrategy readStrategyFromName(const QString &name);
+
     /**
      * @brief Calculate all hashes for a file
      * @param filePath Path to file
@@ -60,14 +116,65 @@ public:
      */
     static int detectHeaderSize(const QString &filePath, const QString &extension);
 
+    /**
+     * @brief Whether files with this extension may carry a copier header
+     *
+     * Hashes of such files can't be taken from a container's stored CRC32,
+     * since DATs describe the image without its header.
+     */
+    static bool extensionMayHaveHeader(const QString &extension);
+
+    /**
+     * @brief Detect header size from the leading bytes of a stream
+     * @param head First bytes of the image (up to HEADER_PEEK_SIZE)
+     * @param totalSize Full image size in bytes
+     * @param extension File extension
+     * @return Header size in bytes (0 if no header)
+     */
+    static int detectHeaderSize(const QByteArray &head, qint64 totalSize, const QString &extension);
+
+    /**
+     * @brief Calculate hashes for a ZIP member without extracting it
+     *
+     * The member is inflated in-process and streamed straight into the
+     * digests; headers are detected from the first bytes of the stream.
+     * Unstripped results are checked against the stored CRC32. With
+     * @p crcOnly set and an extension that never carries a header, the CRC32
+     * from the central directory is returned without reading member data.
+     * @param archivePath Path to the .zip file
+     * @param memberName Member name (resolved like ZipReader::resolveEntry)
+     * @param extension Member extension, used for header detection
+     * @param crcOnly Fill in only crc32
+     * @return Hash results; on failure callers may fall back to extraction
+     */
+    HashResult calculateZipMemberHashes(const QString &archivePath,
+                                        const QString &memberName,
+                                        const QString &extension,
+                                        bool crcOnly = false);
+
 signals:
     void hashProgress(const QString &filePath, int percentage);
 
 private:
-    QByteArray readFileData(const QString &filePath, bool stripHeader, int headerSize);
-    QString calculateCRC32(const QByteArray &data);
-    QString calculateMD5(const QByteArray &data);
-    QString calculateSHA1(const QByteArray &data);
+    using ChunkSink = std::function<void(const char *data, qint64 size)>;
+
+    /**
+     * @brief Stream a file once, feeding each requested digest per chunk
+     * @return Result with only the requested digests filled in
+     */
+    HashResult hashStream(const QString &filePath, bool stripHeader, int headerSize,
+                          bool wantCrc32, bool wantMd5, bool wantSha1);
+
+    static bool readBuffered(const QString &filePath, qint64 offset,
+                             const ChunkSink &sink, QString &error);
+    static bool readPositional(const QString &filePath, qint64 offset,
+                               const ChunkSink &sink, QString &error);
+    static bool readMapped(const QString &filePath, qint64 offset,
+                           const ChunkSink &sink, QString &error);
+    static bool readDirect(const QString &filePath, qint64 offset,
+                           const ChunkSink &sink, QString &error);
+
+    ReadStrategy m_readStrategy = ReadStrategy::Auto;
 };
 
 } // namespace Remus
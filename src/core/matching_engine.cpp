@@ -1,4 +1,5 @@
 #include "matching_engine.h"
+#include "fuzzy_matcher.h"
 #include <QFileInfo>
 #include <QDebug>
 #include <QRegularExpression>
@@ -115,61 +116,9 @@ QString MatchingEngine::extractGameTitle(const QString &fileName)
     return title;
 }
 
-int MatchingEngine::levenshteinDistance(const QString &s1, const QString &s2)
-{
-    const int len1 = s1.length();
-    const int len2 = s2.length();
-    
-    // Create distance matrix
-    QVector<QVector<int>> d(len1 + 1, QVector<int>(len2 + 1));
-    
-    // Initialize first row and column
-    for (int i = 0; i <= len1; ++i) {
-        d[i][0] = i;
-    }
-    for (int j = 0; j <= len2; ++j) {
-        d[0][j] = j;
-    }
-    
-    // Calculate minimum edit distance
-    for (int i = 1; i <= len1; ++i) {
-        for (int j = 1; j <= len2; ++j) {
-            int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            
-            d[i][j] = std::min({
-                d[i - 1][j] + 1,      // deletion
-                d[i][j - 1] + 1,      // insertion
-                d[i - 1][j - 1] + cost // substitution
-            });
-        }
-    }
-    
-    return d[len1][len2];
-}
-
 float MatchingEngine::calculateNameSimilarity(const QString &s1, const QString &s2)
 {
-    if (s1.isEmpty() || s2.isEmpty()) {
-        return 0.0f;
-    }
-    
-    // Normalize both strings for comparison
-    QString norm1 = s1.toLower().simplified();
-    QString norm2 = s2.toLower().simplified();
-    
-    // Exact match
-    if (norm1 == norm2) {
-        return 1.0f;
-    }
-    
-    // Calculate Levenshtein distance
-    int distance = levenshteinDistance(norm1, norm2);
-    int maxLen = std::max(norm1.length(), norm2.length());
-    
-    // Convert distance to similarity score (0.0 to 1.0)
-    float similarity = 1.0f - (static_cast<float>(distance) / maxLen);
-    
-    return std::max(0.0f, similarity);
+    return FuzzyMatcher::similarity(s1, s2);
 }
 
 } // namespace Remus
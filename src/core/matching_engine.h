@@ -87,7 +87,9 @@ public:
     static int calculateConfidence(const QString &method, float nameMatchScore = 0.0f);
     
     /**
-     * @brief Calculate Levenshtein distance between two strings
+     * @brief Similarity of two names from their Levenshtein distance
+     *
+     * Case-insensitive; see FuzzyMatcher::similarity().
      * @param s1 First string
      * @param s2 Second string
      * @return Similarity score (0.0 = completely different, 1.0 = identical)
@@ -139,15 +141,6 @@ signals:
      * @brief Emitted when no match found
      */
     void noMatchFound();
-
-private:
-    /**
-     * @brief Calculate Levenshtein distance (edit distance) between strings
-     * @param s1 First string
-     * @param s2 Second string
-     * @return Edit distance (lower = more similar)
-     */
-    static int levenshteinDistance(const QString &s1, const QString &s2);
 };
 
 } // namespace Remus
@@ -1,13 +1,22 @@
 #include "scanner.h"
 #include <QDir>
-#include <QDirIterator>
 #include <QFile>
+#include <QHash>
 #include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 #include <QDebug>
+#include "hasher.h"
 #include "logging_categories.h"
 #include "constants/settings.h"
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
 #undef qDebug
 #undef qInfo
 #undef qWarning
@@ -19,8 +28,30 @@
 
 namespace Remus {
 
+FileFingerprint FileFingerprint::fromFileInfo(const QFileInfo &fileInfo)
+{
+    FileFingerprint fingerprint;
+    if (!fileInfo.exists()) {
+        return fingerprint;
+    }
+
+    fingerprint.size = fileInfo.size();
+    fingerprint.mtimeMs = fileInfo.lastModified().toMSecsSinceEpoch();
+
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(fileInfo.absoluteFilePath()).constData(), &st) == 0) {
+        fingerprint.inode = static_cast<quint64>(st.st_ino);
+        fingerprint.device = static_cast<quint64>(st.st_dev);
+    }
+#endif
+
+    return fingerprint;
+}
+
 Scanner::Scanner(QObject *parent)
     : QObject(parent)
+    , m_exclusions(QString::fromLatin1(Constants::Settings::Files::MARKER_SKIP_SCAN))
 {
 }
 
@@ -29,16 +60,35 @@ void Scanner::setExtensions(const QStringList &extensions)
     m_extensions = extensions;
 }
 
+int Scanner::walkerThreadCount() const
+{
+    if (m_walkerThreads > 0) {
+        return qMin(m_walkerThreads, MAX_WALKER_THREADS);
+    }
+    // Oversubscribe: walker threads mostly wait on readdir/stat round trips
+    const int ideal = QThread::idealThreadCount();
+    return qBound(2, (ideal > 0 ? ideal : 1) * 2, MAX_WALKER_THREADS);
+}
+
 QList<ScanResult> Scanner::scan(const QString &libraryPath)
 {
     QList<ScanResult> results;
     m_filesProcessed = 0;
     m_cancelRequested = false;
     m_cancelled = false;
+    m_lastError.clear();
+    m_unlistedPaths.clear();
+    m_exclusions.clear();  // Markers may have been added or removed since last scan
 
     QDir dir(libraryPath);
     if (!dir.exists()) {
-        emit scanError(QString("Directory does not exist: %1").arg(libraryPath));
+        m_lastError = QString("Directory does not exist: %1").arg(libraryPath);
+        emit scanError(m_lastError);
+        return results;
+    }
+    if (!dir.isReadable()) {
+        m_lastError = QString("Directory is not readable: %1").arg(libraryPath);
+        emit scanError(m_lastError);
         return results;
     }
 
@@ -70,43 +120,123 @@ QList<ScanResult> Scanner::scan(const QString &libraryPath)
 
 void Scanner::scanDirectory(const QString &dirPath, QList<ScanResult> &results)
 {
-    QDirIterator it(dirPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
-                    QDirIterator::Subdirectories);
+    const QString rootPath = QDir(dirPath).absolutePath();
+
+    // Phase 1: list directories in parallel. Each task lists one directory and
+    // fans its subdirectories out as new tasks to whichever thread is idle.
+    QHash<QString, DirListing> listings;
+    QMutex listingsMutex;
+    std::atomic<int> filesFound{0};
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(walkerThreadCount());
 
-    while (it.hasNext()) {
+    std::function<void(const QString &)> visit = [&](const QString &path) {
         if (m_cancelRequested) {
             return;
         }
 
-        QString path = it.next();
-        QFileInfo fileInfo(path);
-        
-        // Skip files in directories marked with .remusdir
-        if (isInExcludedDirectory(fileInfo.absolutePath())) {
-            continue;
+        // The parent is already resolved in the trie, so this costs one
+        // marker check for the new directory (the root also resolves its ancestors)
+        DirListing listing;
+        if (!isInExcludedDirectory(path)) {
+            listDirectory(path, listing);
         }
 
-        if (fileInfo.isFile()) {
-            QString extension = "." + fileInfo.suffix().toLower();
-            
-            // Check if it's an archive and archive scanning is enabled
-            if (m_archiveScanning && isArchiveExtension(extension)) {
-                processArchive(path, results);
-                m_filesProcessed++;
-                emit fileFound(path);
+        for (const QString &subdir : std::as_const(listing.subdirs)) {
+            pool.start([&visit, subdir]() { visit(subdir); });
+        }
+        filesFound += listing.files.size();
+
+        QMutexLocker locker(&listingsMutex);
+        listings.insert(path, std::move(listing));
+    };
+
+    pool.start([&visit, rootPath]() { visit(rootPath); });
+    while (!pool.waitForDone(100)) {
+        emit scanProgress(filesFound.load(), -1);
+    }
+
+    if (m_cancelRequested) {
+        return;
+    }
+
+    // Phase 2: merge on this thread in sorted pre-order, so results and
+    // signals are identical whatever the thread count or timing was
+    QStringList stack{rootPath};
+    while (!stack.isEmpty()) {
+        const QString path = stack.takeLast();
+        const DirListing listing = listings.take(path);
+        if (!listing.readable) {
+            qWarning() << "Cannot read directory:" << path;
+            m_unlistedPaths.append(path);
+        }
+
+        for (const DirEntry &entry : listing.files) {
+            if (m_cancelRequested) {
+                return;
             }
-            // Check if it's a regular ROM file
-            else if (isValidExtension(extension)) {
-                ScanResult result = createScanResult(fileInfo);
-                results.append(result);
-                
-                m_filesProcessed++;
-                emit fileFound(path);
-                
-                if (m_filesProcessed % 100 == 0) {
-                    emit scanProgress(m_filesProcessed, -1);
-                }
+
+            if (entry.isArchive) {
+                processArchive(entry.path, results);
+            } else {
+                results.append(entry.result);
             }
+
+            m_filesProcessed++;
+            emit fileFound(entry.path);
+
+            if (m_filesProcessed % 100 == 0) {
+                emit scanProgress(m_filesProcessed, -1);
+            }
+        }
+
+        for (auto it = listing.subdirs.crbegin(); it != listing.subdirs.crend(); ++it) {
+            stack.append(*it);
+        }
+    }
+}
+
+void Scanner::listDirectory(const QString &dirPath, DirListing &listing) const
+{
+    const QDir dir(dirPath);
+    if (!dir.isReadable()) {
+        listing.readable = false;
+        return;
+    }
+
+    // Sorted by name so the merge order does not depend on the filesystem
+    const QFileInfoList entries = dir.entryInfoList(
+        QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+
+    for (const QFileInfo &fileInfo : entries) {
+        if (fileInfo.isDir()) {
+            // Like QDirIterator without FollowSymlinks: never recurse through links
+            if (!fileInfo.isSymLink()) {
+                listing.subdirs.append(fileInfo.absoluteFilePath());
+            }
+            continue;
+        }
+
+        if (!fileInfo.isFile()) {
+            continue;
+        }
+
+        const QString extension = "." + fileInfo.suffix().toLower();
+
+        // Check if it's an archive and archive scanning is enabled
+        if (m_archiveScanning && isArchiveExtension(extension)) {
+            DirEntry entry;
+            entry.path = fileInfo.absoluteFilePath();
+            entry.isArchive = true;
+            listing.files.append(entry);
+        }
+        // Check if it's a regular ROM file
+        else if (isValidExtension(extension)) {
+            DirEntry entry;
+            entry.path = fileInfo.absoluteFilePath();
+            entry.result = createScanResult(fileInfo);
+            listing.files.append(entry);
         }
     }
 }
@@ -127,39 +257,10 @@ bool Scanner::isArchiveExtension(const QString &extension) const
     return archiveExtensions.contains(extension, Qt::CaseInsensitive);
 }
 
-bool Scanner::isInExcludedDirectory(const QString &dirPath) const
+bool Scanner::isInExcludedDirectory(const QString &dirPath)
 {
     // Check if this directory or any parent contains .remusdir marker
-    QDir dir(dirPath);
-    
-    // Cache to avoid repeated filesystem checks
-    static QSet<QString> excludedDirs;
-    static QSet<QString> checkedDirs;
-    
-    // Quick check if we already know this path is excluded
-    QString absPath = dir.absolutePath();
-    if (excludedDirs.contains(absPath)) {
-        return true;
-    }
-    if (checkedDirs.contains(absPath)) {
-        return false;
-    }
-    
-    // Walk up the directory tree looking for .remusdir
-    QDir checkDir(absPath);
-    while (!checkDir.isRoot()) {
-        QString markerPath = checkDir.absolutePath() + "/" + Constants::Settings::Files::MARKER_SKIP_SCAN;
-        if (QFile::exists(markerPath)) {
-            excludedDirs.insert(absPath);  // Cache this path as excluded
-            return true;
-        }
-        if (!checkDir.cdUp()) {
-            break;
-        }
-    }
-    
-    checkedDirs.insert(absPath);  // Cache as not excluded
-    return false;
+    return m_exclusions.isExcluded(QDir(dirPath).absolutePath());
 }
 
 void Scanner::processArchive(const QString &archivePath, QList<ScanResult> &results)
@@ -168,24 +269,32 @@ void Scanner::processArchive(const QString &archivePath, QList<ScanResult> &resu
     
     if (archiveInfo.format == ArchiveFormat::Unknown) {
         qWarning() << "Unknown archive format:" << archivePath;
+        m_unlistedPaths.append(archivePath);
         return;
     }
     
-    // Check if we can extract this format
-    if (!m_archiveExtractor.canExtract(archiveInfo.format)) {
+    // Native listings don't need a tool; tool listings are empty without one
+    if (!archiveInfo.listedNatively && !m_archiveExtractor.canExtract(archiveInfo.format)) {
         qWarning() << "Cannot extract archive (missing tool):" << archivePath 
                    << "- Format:" << static_cast<int>(archiveInfo.format);
+        m_unlistedPaths.append(archivePath);
         return;
     }
     
     // Warn if archive appears empty (tool may have failed)
-    if (archiveInfo.contents.isEmpty()) {
+    if (archiveInfo.members.isEmpty()) {
         qWarning() << "Archive appears empty or tool failed:" << archivePath;
+        m_unlistedPaths.append(archivePath);
         return;
     }
 
+    // Members are fingerprinted by their archive: any change to it rescans them all
+    const QFileInfo archiveFileInfo(archivePath);
+    const FileFingerprint archiveFingerprint = FileFingerprint::fromFileInfo(archiveFileInfo);
+
     // Process each file in the archive
-    for (const QString &internalPath : archiveInfo.contents) {
+    for (const ArchiveMember &member : archiveInfo.members) {
+        const QString &internalPath = member.path;
         QString extension = "." + QFileInfo(internalPath).suffix().toLower();
         
         // Skip if it's not a ROM file we care about
@@ -197,11 +306,16 @@ void Scanner::processArchive(const QString &archivePath, QList<ScanResult> &resu
         result.path = archivePath;  // Archive path is the main file
         result.filename = QFileInfo(internalPath).fileName();
         result.extension = extension;
-        result.fileSize = 0;  // We don't know individual file size in archive
-        result.lastModified = QFileInfo(archivePath).lastModified();
+        result.fileSize = qMax<qint64>(0, member.size);
+        result.lastModified = archiveFileInfo.lastModified();
         result.isCompressed = true;
         result.archivePath = archivePath;
         result.archiveInternalPath = internalPath;
+        result.fingerprint = archiveFingerprint;
+        // DATs hash headerless images, so a stored CRC only stands in for unheadered ones
+        if (!Hasher::extensionMayHaveHeader(extension)) {
+            result.crc32 = member.crc32;
+        }
         
         results.append(result);
         emit fileFound(archivePath + "::" + internalPath);
@@ -212,7 +326,7 @@ void Scanner::processArchive(const QString &archivePath, QList<ScanResult> &resu
     }
 }
 
-ScanResult Scanner::createScanResult(const QFileInfo &fileInfo)
+ScanResult Scanner::createScanResult(const QFileInfo &fileInfo) const
 {
     ScanResult result;
     result.path = fileInfo.absoluteFilePath();
@@ -220,6 +334,7 @@ ScanResult Scanner::createScanResult(const QFileInfo &fileInfo)
     result.extension = "." + fileInfo.suffix().toLower();
     result.fileSize = fileInfo.size();
     result.lastModified = fileInfo.lastModified();
+    result.fingerprint = FileFingerprint::fromFileInfo(fileInfo);
     return result;
 }
 
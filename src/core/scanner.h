@@ -5,11 +5,42 @@
 #include <QString>
 #include <QStringList>
 #include <QFileInfo>
+#include <atomic>
 #include <functional>
 #include "archive_extractor.h"
+#include "exclusion_trie.h"
 
 namespace Remus {
 
+/**
+ * @brief On-disk identity of a file, used to detect changes between scans
+ *
+ * Size and mtime catch in-place edits; inode/device catch a file being
+ * replaced by a different one with the same name and timestamp. Inode and
+ * device are 0 on platforms that do not expose them.
+ */
+struct FileFingerprint {
+    qint64 size = -1;
+    qint64 mtimeMs = 0;
+    quint64 inode = 0;
+    quint64 device = 0;
+
+    bool isValid() const { return size >= 0; }
+
+    bool operator==(const FileFingerprint &other) const {
+        return size == other.size && mtimeMs == other.mtimeMs &&
+               inode == other.inode && device == other.device;
+    }
+    bool operator!=(const FileFingerprint &other) const { return !(*this == other); }
+
+    /**
+     * @brief Build a fingerprint from already-stat'ed file info
+     * @param fileInfo File info (size/mtime are taken from its cache)
+     * @return Fingerprint (invalid if the file does not exist)
+     */
+    static FileFingerprint fromFileInfo(const QFileInfo &fileInfo);
+};
+
 /**
  * @brief Represents a scanned file before database insertion
  */
@@ -25,6 +56,8 @@ struct ScanResult {
     bool isCompressed = false;  // File is inside an archive
     QString archivePath;  // Path to archive containing this file
     QString archiveInternalPath;  // Path within archive (if compressed)
+    FileFingerprint fingerprint;  // Of the file itself, or of the containing archive
+    QString crc32;  // Stored CRC32 of an archive member (empty if unknown or header-bearing)
 };
 
 /**
@@ -37,6 +70,9 @@ class Scanner : public QObject {
     Q_OBJECT
 
 public:
+    /// Upper bound for directory-walker threads (listing is latency bound on network shares)
+    static constexpr int MAX_WALKER_THREADS = 16;
+
     explicit Scanner(QObject *parent = nullptr);
 
     /**
@@ -62,6 +98,24 @@ public:
      */
     void setArchiveScanning(bool enabled) { m_archiveScanning = enabled; }
 
+    /**
+     * @brief Reuse archive listings from earlier scans (not owned; nullptr disables)
+     *
+     * Unchanged archives (same path, size and mtime) are then not opened.
+     */
+    void setArchiveListingCache(ArchiveListingCache *cache) { m_archiveExtractor.setListingCache(cache); }
+
+    /**
+     * @brief Set how many threads list directories in parallel
+     * @param threads Thread count; 0 picks a default from the CPU count
+     */
+    void setWalkerThreadCount(int threads) { m_walkerThreads = threads; }
+
+    /**
+     * @brief Thread count the next scan will use for directory listing
+     */
+    int walkerThreadCount() const;
+
     /**
      * @brief Request cancellation of an active scan
      */
@@ -72,6 +126,23 @@ public:
      */
     bool wasCancelled() const { return m_cancelled; }
 
+    /**
+     * @brief Why the last scan could not start (empty if it ran)
+     *
+     * Set when the root directory is missing or unreadable; the scan then
+     * returns no results, which must not be read as "every file is gone".
+     */
+    QString lastError() const { return m_lastError; }
+
+    /**
+     * @brief Directories and archives whose contents the last scan could not list
+     *
+     * Unreadable subdirectories, archives of unknown format, archives without
+     * an extraction tool and archives whose listing came back empty. Their
+     * files are absent from the results although they may still exist.
+     */
+    QStringList unlistedPaths() const { return m_unlistedPaths; }
+
 signals:
     void scanStarted(const QString &path);
     void fileFound(const QString &path);
@@ -80,11 +151,26 @@ signals:
     void scanError(const QString &error);
 
 private:
+    /// A file of interest found while listing one directory
+    struct DirEntry {
+        QString path;
+        bool isArchive = false;
+        ScanResult result;  // Pre-built for plain ROM files
+    };
+
+    /// Contents of one directory, names sorted
+    struct DirListing {
+        QList<DirEntry> files;
+        QStringList subdirs;
+        bool readable = true;
+    };
+
     void scanDirectory(const QString &dirPath, QList<ScanResult> &results);
+    void listDirectory(const QString &dirPath, DirListing &listing) const;
     bool isValidExtension(const QString &extension) const;
     bool isArchiveExtension(const QString &extension) const;
-    bool isInExcludedDirectory(const QString &dirPath) const;
-    ScanResult createScanResult(const QFileInfo &fileInfo);
+    bool isInExcludedDirectory(const QString &dirPath);
+    ScanResult createScanResult(const QFileInfo &fileInfo) const;
     void processArchive(const QString &archivePath, QList<ScanResult> &results);
     void detectMultiFileSets(QList<ScanResult> &results);
     void linkBinToCue(QList<ScanResult> &results);
@@ -96,9 +182,13 @@ private:
     bool m_multiFileDetection = true;
     bool m_archiveScanning = true;
     int m_filesProcessed = 0;
-    bool m_cancelRequested = false;
+    int m_walkerThreads = 0;
+    std::atomic<bool> m_cancelRequested{false};
     bool m_cancelled = false;
+    QString m_lastError;
+    QStringList m_unlistedPaths;
     ArchiveExtractor m_archiveExtractor;
+    ExclusionTrie m_exclusions;  // Rebuilt every scan; shared by walker threads
 };
 
 } // namespace Remus
@@ -0,0 +1,823 @@
+#include "seven_zip_reader.h"
+
+#include <QFile>
+#include <QtEndian>
+
+#include <cstdlib>
+#include <string>
+#include <zlib.h>
+
+#ifdef REMUS_HAVE_LZMA
+#include <lzma.h>
+#endif
+
+namespace Remus {
+
+namespace {
+
+constexpr char SIGNATURE[6] = {'7', 'z', '\xBC', '\xAF', '\x27', '\x1C'};
+constexpr int SIGNATURE_HEADER_SIZE = 32;
+
+// Property IDs from 7zFormat.txt
+enum PropertyId : quint64 {
+    kEnd = 0x00,
+    kHeader = 0x01,
+    kArchiveProperties = 0x02,
+    kAdditionalStreamsInfo = 0x03,
+    kMainStreamsInfo = 0x04,
+    kFilesInfo = 0x05,
+    kPackInfo = 0x06,
+    kUnPackInfo = 0x07,
+    kSubStreamsInfo = 0x08,
+    kSize = 0x09,
+    kCRC = 0x0A,
+    kFolder = 0x0B,
+    kCodersUnPackSize = 0x0C,
+    kNumUnPackStream = 0x0D,
+    kEmptyStream = 0x0E,
+    kEmptyFile = 0x0F,
+    kName = 0x11,
+    kEncodedHeader = 0x17
+};
+
+/// Sanity bound on counts read from the header before allocating for them
+constexpr quint64 MAX_ITEMS = 1u << 24;
+
+struct Coder {
+    QByteArray methodId;
+    quint64 numInStreams = 1;
+    quint64 numOutStreams = 1;
+    QByteArray properties;
+};
+
+struct Folder {
+    QList<Coder> coders;
+    QList<QPair<quint64, quint64>> bindPairs;  // (inIndex, outIndex)
+    QList<quint64> unpackSizes;                // One per coder output stream
+    quint64 numSubstreams = 1;
+    bool hasCrc = false;
+    quint32 crc = 0;
+
+    /// Size of the one output stream not consumed by another coder
+    quint64 unpackSize() const
+    {
+        for (int i = unpackSizes.size() - 1; i >= 0; --i) {
+            bool bound = false;
+            for (const auto &pair : bindPairs) {
+                if (pair.second == static_cast<quint64>(i)) {
+                    bound = true;
+                    break;
+                }
+            }
+            if (!bound) {
+                return unpackSizes.at(i);
+            }
+        }
+        return 0;
+    }
+};
+
+struct StreamsInfo {
+    quint64 packPos = 0;
+    QList<quint64> packSizes;
+    QList<Folder> folders;
+    QList<quint64> substreamSizes;
+    QList<bool> substreamHasCrc;
+    QList<quint32> substreamCrcs;
+};
+
+/**
+ * Bounds-checked cursor over header bytes. Any out-of-range read marks the
+ * reader failed and returns zeros, so parsers check failed() at the end
+ * instead of after every field.
+ */
+class HeaderReader {
+public:
+    explicit HeaderReader(const QByteArray &data) : m_data(data) {}
+
+    bool failed() const { return m_failed; }
+    void fail() { m_failed = true; }
+
+    quint8 byte()
+    {
+        if (!require(1)) return 0;
+        return static_cast<quint8>(m_data.at(m_pos++));
+    }
+
+    quint32 uint32()
+    {
+        if (!require(4)) return 0;
+        const quint32 value = qFromLittleEndian<quint32>(m_data.constData() + m_pos);
+        m_pos += 4;
+        return value;
+    }
+
+    /// 7z variable-length NUMBER: leading one bits of the first byte count extra bytes
+    quint64 number()
+    {
+        const quint8 first = byte();
+        quint8 mask = 0x80;
+        quint64 value = 0;
+        for (int i = 0; i < 8; ++i) {
+            if ((first & mask) == 0) {
+                const quint64 high = first & (mask - 1u);
+                return value | (high << (8 * i));
+            }
+            value |= static_cast<quint64>(byte()) << (8 * i);
+            mask >>= 1;
+        }
+        return value;
+    }
+
+    /// NUMBER used as a count; fails on values no sane archive would hold
+    quint64 count()
+    {
+        const quint64 value = number();
+        if (value > MAX_ITEMS) {
+            m_failed = true;
+            return 0;
+        }
+        return value;
+    }
+
+    QByteArray bytes(quint64 size)
+    {
+        if (!require(size)) return QByteArray();
+        const QByteArray out = m_data.mid(static_cast<qsizetype>(m_pos), static_cast<qsizetype>(size));
+        m_pos += static_cast<qint64>(size);
+        return out;
+    }
+
+    void skip(quint64 size)
+    {
+        if (require(size)) {
+            m_pos += static_cast<qint64>(size);
+        }
+    }
+
+    /// Skip a property body of the form NUMBER(size) + bytes
+    void skipData() { skip(number()); }
+
+    qint64 position() const { return m_pos; }
+    quint64 remaining() const { return static_cast<quint64>(m_data.size() - m_pos); }
+    void seek(qint64 pos)
+    {
+        if (pos < m_pos || pos > m_data.size()) {
+            m_failed = true;
+            return;
+        }
+        m_pos = pos;
+    }
+
+private:
+    bool require(quint64 size)
+    {
+        if (m_failed || size > static_cast<quint64>(m_data.size() - m_pos)) {
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    const QByteArray &m_data;
+    qint64 m_pos = 0;
+    bool m_failed = false;
+};
+
+QList<bool> readBitVector(HeaderReader &r, quint64 count)
+{
+    QList<bool> bits;
+    bits.reserve(static_cast<qsizetype>(count));
+    quint8 current = 0;
+    for (quint64 i = 0; i < count; ++i) {
+        if (i % 8 == 0) {
+            current = r.byte();
+        }
+        bits.append((current & (0x80 >> (i % 8))) != 0);
+    }
+    return bits;
+}
+
+void readDigests(HeaderReader &r, quint64 count, QList<bool> &defined, QList<quint32> &crcs)
+{
+    const bool allDefined = r.byte() != 0;
+    defined = allDefined ? QList<bool>(static_cast<qsizetype>(count), true) : readBitVector(r, count);
+    crcs = QList<quint32>(static_cast<qsizetype>(count), 0);
+    for (quint64 i = 0; i < count && !r.failed(); ++i) {
+        if (defined.at(static_cast<qsizetype>(i))) {
+            crcs[static_cast<qsizetype>(i)] = r.uint32();
+        }
+    }
+}
+
+void readPackInfo(HeaderReader &r, StreamsInfo &info)
+{
+    info.packPos = r.number();
+    const quint64 numPackStreams = r.count();
+
+    quint64 id = r.number();
+    while (id != kSize && id != kEnd && !r.failed()) {
+        r.skipData();
+        id = r.number();
+    }
+    if (id == kSize) {
+        // Each size takes at least one byte; a count the header cannot back is forged
+        if (numPackStreams > r.remaining()) {
+            r.fail();
+            return;
+        }
+        for (quint64 i = 0; i < numPackStreams && !r.failed(); ++i) {
+            info.packSizes.append(r.number());
+        }
+        id = r.number();
+    }
+    // Packed-stream CRCs aren't needed for listing
+    while (id != kEnd && !r.failed()) {
+        if (id == kCRC) {
+            QList<bool> defined;
+            QList<quint32> crcs;
+            readDigests(r, numPackStreams, defined, crcs);
+        } else {
+            r.skipData();
+        }
+        id = r.number();
+    }
+}
+
+void readFolder(HeaderReader &r, Folder &folder)
+{
+    const quint64 numCoders = r.count();
+    quint64 totalIn = 0;
+    quint64 totalOut = 0;
+    for (quint64 i = 0; i < numCoders && !r.failed(); ++i) {
+        const quint8 flags = r.byte();
+        if (flags & 0x80) {
+            r.fail();  // Alternative methods are reserved and never written
+            return;
+        }
+        Coder coder;
+        coder.methodId = r.bytes(flags & 0x0F);
+        if (flags & 0x10) {
+            coder.numInStreams = r.count();
+            coder.numOutStreams = r.count();
+        }
+        if (flags & 0x20) {
+            coder.properties = r.bytes(r.number());
+        }
+        totalIn += coder.numInStreams;
+        totalOut += coder.numOutStreams;
+        folder.coders.append(coder);
+    }
+
+    if (totalOut == 0) {
+        r.fail();
+        return;
+    }
+    for (quint64 i = 0; i + 1 < totalOut && !r.failed(); ++i) {
+        const quint64 inIndex = r.number();
+        const quint64 outIndex = r.number();
+        folder.bindPairs.append(qMakePair(inIndex, outIndex));
+    }
+
+    const quint64 numPacked = totalIn - qMin<quint64>(totalIn, totalOut - 1);
+    if (numPacked > 1) {
+        if (numPacked > r.remaining()) {
+            r.fail();
+            return;
+        }
+        for (quint64 i = 0; i < numPacked && !r.failed(); ++i) {
+            r.number();
+        }
+    }
+}
+
+void readUnpackInfo(HeaderReader &r, StreamsInfo &info)
+{
+    if (r.number() != kFolder) {
+        r.fail();
+        return;
+    }
+    const quint64 numFolders = r.count();
+    if (r.byte() != 0) {
+        r.fail();  // Folders stored in an additional stream
+        return;
+    }
+    for (quint64 i = 0; i < numFolders && !r.failed(); ++i) {
+        Folder folder;
+        readFolder(r, folder);
+        info.folders.append(folder);
+    }
+
+    if (r.number() != kCodersUnPackSize) {
+        r.fail();
+        return;
+    }
+    for (Folder &folder : info.folders) {
+        quint64 outStreams = 0;
+        for (const Coder &coder : folder.coders) {
+            outStreams += coder.numOutStreams;
+        }
+        if (outStreams > r.remaining()) {
+            r.fail();
+            return;
+        }
+        for (quint64 i = 0; i < outStreams && !r.failed(); ++i) {
+            folder.unpackSizes.append(r.number());
+        }
+    }
+
+    quint64 id = r.number();
+    while (id != kEnd && !r.failed()) {
+        if (id == kCRC) {
+            QList<bool> defined;
+            QList<quint32> crcs;
+            readDigests(r, numFolders, defined, crcs);
+            for (int i = 0; i < info.folders.size() && i < defined.size(); ++i) {
+                info.folders[i].hasCrc = defined.at(i);
+                info.folders[i].crc = crcs.at(i);
+            }
+        } else {
+            r.skipData();
+        }
+        id = r.number();
+    }
+}
+
+/// Without SubStreamsInfo every folder holds exactly one stream
+void defaultSubstreams(StreamsInfo &info)
+{
+    for (const Folder &folder : info.folders) {
+        info.substreamSizes.append(folder.unpackSize());
+        info.substreamHasCrc.append(folder.hasCrc);
+        info.substreamCrcs.append(folder.crc);
+    }
+}
+
+void readSubStreamsInfo(HeaderReader &r, StreamsInfo &info)
+{
+    quint64 id = r.number();
+    while (!r.failed()) {
+        if (id == kNumUnPackStream) {
+            for (Folder &folder : info.folders) {
+                folder.numSubstreams = r.count();
+                if (r.failed()) {
+                    return;
+                }
+            }
+        } else if (id == kCRC || id == kSize || id == kEnd) {
+            break;
+        } else {
+            r.skipData();
+        }
+        id = r.number();
+    }
+
+    if (r.failed()) {
+        return;
+    }
+
+    // Every listed size takes at least one header byte, so counts the
+    // remaining header cannot back are forged; refuse them before they
+    // drive any allocation
+    quint64 totalSubstreams = 0;
+    quint64 listedSizes = 0;
+    for (const Folder &folder : info.folders) {
+        totalSubstreams += folder.numSubstreams;
+        if (folder.numSubstreams > 1) {
+            listedSizes += folder.numSubstreams - 1;
+        }
+    }
+    if (totalSubstreams > MAX_ITEMS || listedSizes > r.remaining()) {
+        r.fail();
+        return;
+    }
+    info.substreamSizes.reserve(info.substreamSizes.size() + static_cast<qsizetype>(totalSubstreams));
+
+    // Sizes: all but the last stream of a folder are listed; the last is the remainder
+    for (const Folder &folder : info.folders) {
+        if (folder.numSubstreams == 0) {
+            continue;
+        }
+        if (id != kSize && folder.numSubstreams > 1) {
+            r.fail();  // Split sizes are mandatory for multi-stream folders
+            return;
+        }
+        quint64 sum = 0;
+        if (id == kSize) {
+            for (quint64 i = 1; i < folder.numSubstreams && !r.failed(); ++i) {
+                const quint64 size = r.number();
+                info.substreamSizes.append(size);
+                sum += size;
+            }
+        }
+        info.substreamSizes.append(folder.unpackSize() - qMin(sum, folder.unpackSize()));
+    }
+    if (r.failed()) {
+        return;
+    }
+    if (id == kSize) {
+        id = r.number();
+    }
+
+    // CRCs are listed only for streams whose CRC the folder doesn't already give
+    quint64 numDigests = 0;
+    for (const Folder &folder : info.folders) {
+        if (folder.numSubstreams != 1 || !folder.hasCrc) {
+            numDigests += folder.numSubstreams;
+        }
+    }
+
+    QList<bool> defined;
+    QList<quint32> crcs;
+    while (id != kEnd && !r.failed()) {
+        if (id == kCRC) {
+            readDigests(r, numDigests, defined, crcs);
+        } else {
+            r.skipData();
+        }
+        id = r.number();
+    }
+    if (r.failed()) {
+        return;
+    }
+
+    int digestIndex = 0;
+    for (const Folder &folder : info.folders) {
+        if (folder.numSubstreams == 1 && folder.hasCrc) {
+            info.substreamHasCrc.append(true);
+            info.substreamCrcs.append(folder.crc);
+            continue;
+        }
+        for (quint64 i = 0; i < folder.numSubstreams; ++i, ++digestIndex) {
+            const bool known = digestIndex < defined.size() && defined.at(digestIndex);
+            info.substreamHasCrc.append(known);
+            info.substreamCrcs.append(known ? crcs.at(digestIndex) : 0);
+        }
+    }
+}
+
+void readStreamsInfo(HeaderReader &r, StreamsInfo &info)
+{
+    quint64 id = r.number();
+    if (id == kPackInfo) {
+        readPackInfo(r, info);
+        id = r.number();
+    }
+    if (id == kUnPackInfo) {
+        readUnpackInfo(r, info);
+        id = r.number();
+    }
+    if (id == kSubStreamsInfo) {
+        readSubStreamsInfo(r, info);
+        id = r.number();
+    } else {
+        defaultSubstreams(info);
+    }
+    if (id != kEnd) {
+        r.fail();
+    }
+}
+
+void readFilesInfo(HeaderReader &r, const StreamsInfo &streams, QList<SevenZipEntry> &entries)
+{
+    const quint64 numFiles = r.count();
+    QList<bool> emptyStream(static_cast<qsizetype>(numFiles), false);
+    QList<bool> emptyFile;
+    QList<QString> names;
+    quint64 numEmptyStreams = 0;
+
+    while (!r.failed()) {
+        const quint64 type = r.number();
+        if (type == kEnd) {
+            break;
+        }
+        const quint64 size = r.number();
+        const qint64 end = r.position() + static_cast<qint64>(qMin<quint64>(size, SevenZipReader::MAX_HEADER_SIZE));
+
+        switch (type) {
+            case kEmptyStream:
+                emptyStream = readBitVector(r, numFiles);
+                numEmptyStreams = 0;
+                for (bool empty : emptyStream) {
+                    numEmptyStreams += empty ? 1 : 0;
+                }
+                break;
+            case kEmptyFile:
+                emptyFile = readBitVector(r, numEmptyStreams);
+                break;
+            case kName: {
+                if (r.byte() != 0) {
+                    r.fail();  // Names stored in an additional stream
+                    break;
+                }
+                // UTF-16LE, each name NUL terminated
+                std::u16string current;
+                while (r.position() + 2 <= end && static_cast<quint64>(names.size()) < numFiles) {
+                    const quint8 lo = r.byte();
+                    const quint8 hi = r.byte();
+                    const char16_t ch = static_cast<char16_t>(lo | (hi << 8));
+                    if (ch == 0) {
+                        names.append(QString::fromStdU16String(current));
+                        current.clear();
+                    } else {
+                        current.push_back(ch);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        r.seek(end);
+    }
+
+    if (r.failed()) {
+        return;
+    }
+
+    int streamIndex = 0;
+    int emptyIndex = 0;
+    for (quint64 i = 0; i < numFiles; ++i) {
+        const int fileIndex = static_cast<int>(i);
+        SevenZipEntry entry;
+        entry.name = fileIndex < names.size() ? names.at(fileIndex) : QString();
+        entry.name.replace(QLatin1Char('\\'), QLatin1Char('/'));
+
+        if (emptyStream.at(fileIndex)) {
+            const bool isFile = emptyIndex < emptyFile.size() && emptyFile.at(emptyIndex);
+            entry.isDirectory = !isFile;
+            emptyIndex++;
+        } else {
+            if (streamIndex >= streams.substreamSizes.size()) {
+                r.fail();
+                return;
+            }
+            entry.size = streams.substreamSizes.at(streamIndex);
+            if (streamIndex < streams.substreamHasCrc.size() && streams.substreamHasCrc.at(streamIndex)) {
+                entry.hasCrc32 = true;
+                entry.crc32 = streams.substreamCrcs.at(streamIndex);
+            }
+            streamIndex++;
+        }
+        entries.append(entry);
+    }
+}
+
+bool methodIs(const QByteArray &id, std::initializer_list<quint8> bytes)
+{
+    if (id.size() != static_cast<qsizetype>(bytes.size())) {
+        return false;
+    }
+    int i = 0;
+    for (quint8 b : bytes) {
+        if (static_cast<quint8>(id.at(i++)) != b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool inflateRaw(const QByteArray &packed, QByteArray &out, QString &error)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        error = "Failed to initialise inflate";
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(packed.constData()));
+    stream.avail_in = static_cast<uInt>(packed.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int status = inflate(&stream, Z_FINISH);
+    const bool ok = (status == Z_STREAM_END || status == Z_OK) &&
+                    stream.total_out == static_cast<uLong>(out.size());
+    inflateEnd(&stream);
+    if (!ok) {
+        error = "Failed to inflate 7z header";
+    }
+    return ok;
+}
+
+#ifdef REMUS_HAVE_LZMA
+bool decodeLzma(lzma_vli filterId, const QByteArray &properties, const QByteArray &packed,
+                QByteArray &out, QString &error)
+{
+    lzma_filter filters[2];
+    filters[0].id = filterId;
+    filters[0].options = nullptr;
+    filters[1].id = LZMA_VLI_UNKNOWN;
+    filters[1].options = nullptr;
+
+    if (lzma_properties_decode(&filters[0], nullptr,
+                               reinterpret_cast<const uint8_t *>(properties.constData()),
+                               static_cast<size_t>(properties.size())) != LZMA_OK) {
+        error = "Invalid LZMA properties in 7z header";
+        return false;
+    }
+
+    lzma_stream stream = LZMA_STREAM_INIT;
+    const lzma_ret init = lzma_raw_decoder(&stream, filters);
+    free(filters[0].options);
+    if (init != LZMA_OK) {
+        error = "Failed to initialise LZMA decoder";
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<const uint8_t *>(packed.constData());
+    stream.avail_in = static_cast<size_t>(packed.size());
+    stream.next_out = reinterpret_cast<uint8_t *>(out.data());
+    stream.avail_out = static_cast<size_t>(out.size());
+    // LZMA1 streams in 7z usually carry no end marker: stop once the known size is out
+    const lzma_ret status = lzma_code(&stream, LZMA_FINISH);
+    const bool ok = (status == LZMA_OK || status == LZMA_STREAM_END || status == LZMA_BUF_ERROR) &&
+                    stream.total_out == static_cast<uint64_t>(out.size());
+    lzma_end(&stream);
+    if (!ok) {
+        error = "Failed to decode LZMA 7z header";
+    }
+    return ok;
+}
+#endif
+
+/// Decode the single-coder folder holding an encoded header
+bool decodeHeader(QFile &file, const StreamsInfo &streams, QByteArray &header, QString &error)
+{
+    if (streams.folders.isEmpty() || streams.packSizes.isEmpty()) {
+        error = "Encoded 7z header has no streams";
+        return false;
+    }
+    const Folder &folder = streams.folders.first();
+    if (folder.coders.size() != 1) {
+        error = "Unsupported 7z header coder chain (filtered or encrypted header)";
+        return false;
+    }
+
+    const quint64 packSize = streams.packSizes.first();
+    const quint64 unpackSize = folder.unpackSize();
+    if (packSize > SevenZipReader::MAX_HEADER_SIZE || unpackSize > SevenZipReader::MAX_HEADER_SIZE) {
+        error = "7z header too large";
+        return false;
+    }
+    const qint64 offset = SIGNATURE_HEADER_SIZE + static_cast<qint64>(streams.packPos);
+    if (!file.seek(offset)) {
+        error = "Cannot seek to 7z header stream";
+        return false;
+    }
+    const QByteArray packed = file.read(static_cast<qint64>(packSize));
+    if (packed.size() != static_cast<qsizetype>(packSize)) {
+        error = "Truncated 7z header stream";
+        return false;
+    }
+
+    const Coder &coder = folder.coders.first();
+    QByteArray out(static_cast<qsizetype>(unpackSize), Qt::Uninitialized);
+    bool ok = false;
+    if (methodIs(coder.methodId, {0x00})) {
+        out = packed.left(static_cast<qsizetype>(unpackSize));
+        ok = out.size() == static_cast<qsizetype>(unpackSize);
+    } else if (methodIs(coder.methodId, {0x04, 0x01, 0x08})) {
+        ok = inflateRaw(packed, out, error);
+#ifdef REMUS_HAVE_LZMA
+    } else if (methodIs(coder.methodId, {0x03, 0x01, 0x01})) {
+        ok = decodeLzma(LZMA_FILTER_LZMA1, coder.properties, packed, out, error);
+    } else if (methodIs(coder.methodId, {0x21})) {
+        ok = decodeLzma(LZMA_FILTER_LZMA2, coder.properties, packed, out, error);
+#endif
+    } else {
+        error = QString("Unsupported 7z header method %1").arg(QString(coder.methodId.toHex()));
+    }
+    if (!ok) {
+        return false;
+    }
+
+    if (folder.hasCrc &&
+        static_cast<quint32>(crc32(0L, reinterpret_cast<const Bytef *>(out.constData()),
+                                   static_cast<uInt>(out.size()))) != folder.crc) {
+        error = "7z header CRC mismatch";
+        return false;
+    }
+    header = out;
+    return true;
+}
+
+} // namespace
+
+SevenZipReader::SevenZipReader(const QString &archivePath)
+    : m_path(archivePath)
+{
+}
+
+bool SevenZipReader::isSevenZipPath(const QString &path)
+{
+    return path.endsWith(QLatin1String(".7z"), Qt::CaseInsensitive);
+}
+
+bool SevenZipReader::hasLzmaSupport()
+{
+#ifdef REMUS_HAVE_LZMA
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SevenZipReader::open()
+{
+    m_entries.clear();
+    m_error.clear();
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = "Cannot open archive: " + file.errorString();
+        return false;
+    }
+
+    const QByteArray start = file.read(SIGNATURE_HEADER_SIZE);
+    if (start.size() != SIGNATURE_HEADER_SIZE ||
+        !start.startsWith(QByteArray::fromRawData(SIGNATURE, sizeof(SIGNATURE)))) {
+        m_error = "Not a 7z archive";
+        return false;
+    }
+    const quint64 nextHeaderOffset = qFromLittleEndian<quint64>(start.constData() + 12);
+    const quint64 nextHeaderSize = qFromLittleEndian<quint64>(start.constData() + 20);
+    const quint32 nextHeaderCrc = qFromLittleEndian<quint32>(start.constData() + 28);
+
+    if (nextHeaderSize == 0) {
+        return true;  // Empty archive
+    }
+    if (nextHeaderSize > MAX_HEADER_SIZE ||
+        SIGNATURE_HEADER_SIZE + nextHeaderOffset + nextHeaderSize > static_cast<quint64>(file.size())) {
+        m_error = "7z header lies outside the archive";
+        return false;
+    }
+    if (!file.seek(SIGNATURE_HEADER_SIZE + static_cast<qint64>(nextHeaderOffset))) {
+        m_error = "Cannot seek to 7z header";
+        return false;
+    }
+    QByteArray header = file.read(static_cast<qint64>(nextHeaderSize));
+    if (header.size() != static_cast<qsizetype>(nextHeaderSize) ||
+        static_cast<quint32>(crc32(0L, reinterpret_cast<const Bytef *>(header.constData()),
+                                   static_cast<uInt>(header.size()))) != nextHeaderCrc) {
+        m_error = "Corrupt 7z header";
+        return false;
+    }
+
+    // An encoded header decodes to another header, which may itself be encoded
+    for (int depth = 0; depth < 4; ++depth) {
+        HeaderReader r(header);
+        const quint64 id = r.number();
+
+        if (id == kEncodedHeader) {
+            StreamsInfo streams;
+            readStreamsInfo(r, streams);
+            if (r.failed()) {
+                m_error = "Corrupt 7z encoded header";
+                return false;
+            }
+            QByteArray decoded;
+            if (!decodeHeader(file, streams, decoded, m_error)) {
+                return false;
+            }
+            header = decoded;
+            continue;
+        }
+
+        if (id != kHeader) {
+            m_error = "Unexpected 7z header type";
+            return false;
+        }
+
+        StreamsInfo main;
+        quint64 type = r.number();
+        if (type == kArchiveProperties) {
+            while (!r.failed() && r.number() != kEnd) {
+                r.skipData();
+            }
+            type = r.number();
+        }
+        if (type == kAdditionalStreamsInfo) {
+            StreamsInfo additional;
+            readStreamsInfo(r, additional);
+            type = r.number();
+        }
+        if (type == kMainStreamsInfo) {
+            readStreamsInfo(r, main);
+            type = r.number();
+        }
+        if (type == kFilesInfo) {
+            readFilesInfo(r, main, m_entries);
+        }
+
+        if (r.failed()) {
+            m_entries.clear();
+            m_error = "Corrupt or unsupported 7z header";
+            return false;
+        }
+        return true;
+    }
+
+    m_error = "7z header nesting too deep";
+    return false;
+}
+
+} // namespace Remus
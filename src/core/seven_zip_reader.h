@@ -0,0 +1,68 @@
+#ifndef REMUS_SEVEN_ZIP_READER_H
+#define REMUS_SEVEN_ZIP_READER_H
+
+#include <QList>
+#include <QString>
+
+namespace Remus {
+
+/**
+ * @brief One file as described by a 7z archive header
+ */
+struct SevenZipEntry {
+    QString name;            ///< Path inside the archive ('/' separated)
+    quint64 size = 0;        ///< Uncompressed size
+    quint32 crc32 = 0;       ///< CRC32 of the uncompressed data (if hasCrc32)
+    bool hasCrc32 = false;
+    bool isDirectory = false;
+};
+
+/**
+ * @brief In-process 7z header reader (listing only)
+ *
+ * Reads the signature header and the archive header to recover member
+ * names, sizes and stored CRC32s without spawning 7z. Headers are usually
+ * LZMA-compressed ("encoded"); those are decoded with liblzma when the build
+ * has it (LZMA, LZMA2), or with zlib (Deflate) and copied verbatim (Copy).
+ * Anything else, including encrypted headers, makes open() fail so callers
+ * can fall back to the external tool. Member data is never decoded.
+ */
+class SevenZipReader {
+public:
+    /// Largest header (packed or unpacked) that will be loaded into memory
+    static constexpr quint64 MAX_HEADER_SIZE = 64 * 1024 * 1024;
+
+    explicit SevenZipReader(const QString &archivePath);
+
+    /**
+     * @brief Check whether a path names a 7z archive (by extension)
+     */
+    static bool isSevenZipPath(const QString &path);
+
+    /**
+     * @brief Whether LZMA/LZMA2-encoded headers can be decoded in this build
+     */
+    static bool hasLzmaSupport();
+
+    /**
+     * @brief Open the archive and parse its header
+     * @return False if the file is not a 7z archive or its header can't be read
+     */
+    bool open();
+
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief Files and directories in header order (valid after open())
+     */
+    const QList<SevenZipEntry> &entries() const { return m_entries; }
+
+private:
+    QString m_path;
+    QList<SevenZipEntry> m_entries;
+    QString m_error;
+};
+
+} // namespace Remus
+
+#endif // REMUS_SEVEN_ZIP_READER_H
@@ -1,5 +1,6 @@
 #include "system_resolver.h"
 #include "constants/providers.h"
+#include <QHash>
 
 namespace Remus {
 
@@ -42,6 +43,47 @@ int SystemResolver::systemIdByName(const QString &internalName)
     return Constants::Systems::getSystemIdByName(internalName);
 }
 
+QString SystemResolver::libretroName(int systemId)
+{
+    // Names of libretro-database DATs (and RetroArch playlists)
+    using namespace Constants::Systems;
+    static const QHash<int, QString> mapping = {
+        {ID_NES, QStringLiteral("Nintendo - Nintendo Entertainment System")},
+        {ID_SNES, QStringLiteral("Nintendo - Super Nintendo Entertainment System")},
+        {ID_N64, QStringLiteral("Nintendo - Nintendo 64")},
+        {ID_GB, QStringLiteral("Nintendo - Game Boy")},
+        {ID_GBC, QStringLiteral("Nintendo - Game Boy Color")},
+        {ID_GBA, QStringLiteral("Nintendo - Game Boy Advance")},
+        {ID_NDS, QStringLiteral("Nintendo - Nintendo DS")},
+        {ID_GAMECUBE, QStringLiteral("Nintendo - GameCube")},
+        {ID_WII, QStringLiteral("Nintendo - Wii")},
+        {ID_GENESIS, QStringLiteral("Sega - Mega Drive - Genesis")},
+        {ID_MASTER_SYSTEM, QStringLiteral("Sega - Master System - Mark III")},
+        {ID_GAME_GEAR, QStringLiteral("Sega - Game Gear")},
+        {ID_SATURN, QStringLiteral("Sega - Saturn")},
+        {ID_DREAMCAST, QStringLiteral("Sega - Dreamcast")},
+        {ID_SEGA_CD, QStringLiteral("Sega - Mega-CD - Sega CD")},
+        {ID_32X, QStringLiteral("Sega - 32X")},
+        {ID_PSX, QStringLiteral("Sony - PlayStation")},
+        {ID_PS2, QStringLiteral("Sony - PlayStation 2")},
+        {ID_PSP, QStringLiteral("Sony - PlayStation Portable")},
+        {ID_PSVITA, QStringLiteral("Sony - PlayStation Vita")},
+        {ID_TURBOGRAFX16, QStringLiteral("NEC - PC Engine - TurboGrafx 16")},
+        {ID_TURBOGRAFX_CD, QStringLiteral("NEC - PC Engine CD - TurboGrafx-CD")},
+        {ID_NEO_GEO, QStringLiteral("SNK - Neo Geo")},
+        {ID_NGP, QStringLiteral("SNK - Neo Geo Pocket")},
+        {ID_ARCADE, QStringLiteral("MAME")},
+        {ID_ATARI_2600, QStringLiteral("Atari - 2600")},
+        {ID_ATARI_7800, QStringLiteral("Atari - 7800")},
+        {ID_LYNX, QStringLiteral("Atari - Lynx")},
+        {ID_ATARI_JAGUAR, QStringLiteral("Atari - Jaguar")},
+        {ID_WONDERSWAN, QStringLiteral("Bandai - WonderSwan")},
+        {ID_VIRTUAL_BOY, QStringLiteral("Nintendo - Virtual Boy")}
+    };
+
+    return mapping.value(systemId);
+}
+
 bool SystemResolver::isValidSystem(int systemId)
 {
     return Constants::Systems::getSystem(systemId) != nullptr;
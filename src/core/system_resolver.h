@@ -46,6 +46,14 @@ public:
      *   - SystemResolver::providerName(10, "igdb") → "genesis" (IGDB platform slug)
      */
     static QString providerName(int systemId, const QString &providerId);
+
+    /**
+     * @brief Get the libretro name of a system
+     * @param systemId System ID from database
+     * @return Name like "Sega - Mega Drive - Genesis", as used for libretro DAT
+     *         files and RetroArch playlists, or empty string if not mapped
+     */
+    static QString libretroName(int systemId);
     
     /**
      * @brief Get system ID by internal name (reverse lookup)
@@ -243,7 +243,7 @@ void VerificationEngine::loadDatCache(const QString &systemName)
         return;
     }
 
-    QMap<QString, DatRomEntry> entries;
+    QList<DatRomEntry> entries;
     QString hashType = getPreferredHashType(systemName);
 
     while (query.next()) {
@@ -256,26 +256,21 @@ void VerificationEngine::loadDatCache(const QString &systemName)
         entry.sha1 = query.value(5).toString();
         entry.description = query.value(6).toString();
         entry.status = query.value(7).toString();
+        entries.append(entry);
+    }
 
-        // Index by preferred hash type
-        QString hash;
-        if (hashType == "sha1" && !entry.sha1.isEmpty()) {
-            hash = entry.sha1;
-        } else if (hashType == "md5" && !entry.md5.isEmpty()) {
-            hash = entry.md5;
-        } else if (!entry.crc32.isEmpty()) {
-            hash = entry.crc32;
-        }
-
-        if (!hash.isEmpty()) {
-            entries.insert(hash.toLower(), entry);
-        }
+    // Lookups pick the table from the hash length, so one index serves
+    // whichever hash type the system prefers
+    std::shared_ptr<const DatIndex> index = DatIndex::fromImage(DatIndex::compile(entries, {}, QFileInfo()));
+    if (!index) {
+        qWarning() << "Failed to index DAT entries for" << systemName;
+        return;
     }
 
-    m_datCache.insert(systemName, entries);
+    m_datCache.insert(systemName, index);
     m_datHashTypes.insert(systemName, hashType);
 
-    qDebug() << "Loaded" << entries.size() << "DAT entries for" << systemName;
+    qDebug() << "Loaded" << index->entryCount() << "DAT entries for" << systemName;
 }
 
 QString VerificationEngine::getPreferredHashType(const QString &systemName)
@@ -405,9 +400,10 @@ QList<VerificationResult> VerificationEngine::verifyLibrary(const QString &syste
         result.fileHash = fileHash;
 
         // Look up in DAT
-        const auto &datEntries = m_datCache.value(fd.system);
-        if (datEntries.contains(fileHash)) {
-            const DatRomEntry &entry = datEntries.value(fileHash);
+        const DatIndex &datIndex = *m_datCache.value(fd.system);
+        const int match = datIndex.find(fileHash);
+        if (match >= 0) {
+            const DatRomEntry entry = datIndex.entry(match);
             result.status = VerificationStatus::Verified;
             result.datName = entry.gameName;
             result.datRomName = entry.romName;
@@ -503,9 +499,10 @@ VerificationResult VerificationEngine::verifyFile(int fileId)
     result.hashType = hashType;
     result.fileHash = fileHash;
 
-    const auto &datEntries = m_datCache.value(result.system);
-    if (datEntries.contains(fileHash)) {
-        const DatRomEntry &entry = datEntries.value(fileHash);
+    const std::shared_ptr<const DatIndex> datIndex = m_datCache.value(result.system);
+    const int match = datIndex ? datIndex->find(fileHash) : -1;
+    if (match >= 0) {
+        const DatRomEntry entry = datIndex->entry(match);
         result.status = VerificationStatus::Verified;
         result.datName = entry.gameName;
         result.datRomName = entry.romName;
@@ -527,7 +524,10 @@ QList<DatRomEntry> VerificationEngine::getMissingGames(const QString &systemName
     }
 
     loadDatCache(systemName);
-    const auto &datEntries = m_datCache.value(systemName);
+    const std::shared_ptr<const DatIndex> datIndex = m_datCache.value(systemName);
+    if (!datIndex) {
+        return missing;
+    }
 
     // Get all verified hashes for this system
     QSet<QString> verifiedHashes;
@@ -549,8 +549,11 @@ QList<DatRomEntry> VerificationEngine::getMissingGames(const QString &systemName
     }
 
     // Find entries not in library
-    for (auto it = datEntries.begin(); it != datEntries.end(); ++it) {
-        const DatRomEntry &entry = it.value();
+    for (int i = 0; i < datIndex->entryCount(); ++i) {
+        const DatRomEntry entry = datIndex->entry(i);
+        if (entry.crc32.isEmpty() && entry.md5.isEmpty() && entry.sha1.isEmpty()) {
+            continue;  // Can't tell whether it is in the library
+        }
         bool found = verifiedHashes.contains(entry.crc32.toLower()) ||
                      verifiedHashes.contains(entry.md5.toLower()) ||
                      verifiedHashes.contains(entry.sha1.toLower());
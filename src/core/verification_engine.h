@@ -6,7 +6,9 @@
 #include <QList>
 #include <QMap>
 #include "dat_parser.h"
+#include "dat_index.h"
 #include "database.h"
+#include <memory>
 
 namespace Remus {
 
@@ -159,8 +161,9 @@ private:
     Database *m_database;
     VerificationSummary m_lastSummary;
     
-    // In-memory cache of loaded DAT entries (indexed by hash)
-    QMap<QString, QMap<QString, DatRomEntry>> m_datCache;  // system -> (hash -> entry)
+    // In-memory cache of loaded DAT entries: one compact index per system,
+    // each entry stored once and keyed by binary CRC32/MD5/SHA1 digests
+    QMap<QString, std::shared_ptr<const DatIndex>> m_datCache;  // system -> index
     QMap<QString, QString> m_datHashTypes;                  // system -> preferred hash type
     
     bool createVerificationSchema();
@@ -0,0 +1,383 @@
+#include "zip_reader.h"
+
+#include <QtEndian>
+
+#include <zlib.h>
+
+namespace Remus {
+
+namespace {
+
+constexpr quint32 EOCD_SIGNATURE = 0x06054b50;
+constexpr quint32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+constexpr quint32 ZIP64_EOCD_SIGNATURE = 0x06064b50;
+constexpr quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+
+constexpr int EOCD_SIZE = 22;
+constexpr int ZIP64_LOCATOR_SIZE = 20;
+constexpr int ZIP64_EOCD_SIZE = 56;
+constexpr int CENTRAL_HEADER_SIZE = 46;
+constexpr int LOCAL_HEADER_SIZE = 30;
+constexpr int MAX_COMMENT_SIZE = 0xFFFF;
+
+constexpr quint16 ZIP64_EXTRA_ID = 0x0001;
+constexpr quint16 FLAG_UTF8_NAMES = 0x0800;
+constexpr quint16 METHOD_STORED = 0;
+constexpr quint16 METHOD_DEFLATE = 8;
+
+quint16 le16(const char *p)
+{
+    return qFromLittleEndian<quint16>(p);
+}
+
+quint32 le32(const char *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+quint64 le64(const char *p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+} // namespace
+
+bool ZipEntry::isSupported() const
+{
+    return !isEncrypted() && (method == METHOD_STORED || method == METHOD_DEFLATE);
+}
+
+ZipReader::ZipReader(const QString &archivePath)
+    : m_path(archivePath)
+    , m_file(archivePath)
+{
+}
+
+bool ZipReader::isZipPath(const QString &path)
+{
+    return path.endsWith(QLatin1String(".zip"), Qt::CaseInsensitive);
+}
+
+bool ZipReader::open()
+{
+    m_entries.clear();
+    m_error.clear();
+
+    if (!m_file.isOpen() && !m_file.open(QIODevice::ReadOnly)) {
+        m_error = "Cannot open archive: " + m_file.errorString();
+        return false;
+    }
+    return readCentralDirectory();
+}
+
+bool ZipReader::readCentralDirectory()
+{
+    const qint64 fileSize = m_file.size();
+    if (fileSize < EOCD_SIZE) {
+        m_error = "Not a ZIP archive (file too small)";
+        return false;
+    }
+
+    // The EOCD record sits at the very end, followed only by the archive comment
+    const qint64 tailSize = qMin<qint64>(fileSize, EOCD_SIZE + MAX_COMMENT_SIZE);
+    const qint64 tailStart = fileSize - tailSize;
+    if (!m_file.seek(tailStart)) {
+        m_error = "Cannot seek in archive";
+        return false;
+    }
+    const QByteArray tail = m_file.read(tailSize);
+    if (tail.size() != tailSize) {
+        m_error = "Cannot read archive trailer";
+        return false;
+    }
+
+    qint64 eocdPos = -1;
+    for (qint64 i = tailSize - EOCD_SIZE; i >= 0; --i) {
+        if (le32(tail.constData() + i) == EOCD_SIGNATURE) {
+            eocdPos = i;
+            break;
+        }
+    }
+    if (eocdPos < 0) {
+        m_error = "Not a ZIP archive (no end of central directory)";
+        return false;
+    }
+
+    const char *eocd = tail.constData() + eocdPos;
+    quint64 entryCount = le16(eocd + 10);
+    quint64 cdSize = le32(eocd + 12);
+    quint64 cdOffset = le32(eocd + 16);
+
+    // ZIP64: the locator immediately precedes the classic EOCD
+    const qint64 locatorPos = eocdPos - ZIP64_LOCATOR_SIZE;
+    if (locatorPos >= 0 && le32(tail.constData() + locatorPos) == ZIP64_LOCATOR_SIGNATURE) {
+        const quint64 zip64EocdOffset = le64(tail.constData() + locatorPos + 8);
+        if (!m_file.seek(static_cast<qint64>(zip64EocdOffset))) {
+            m_error = "Cannot seek to ZIP64 end of central directory";
+            return false;
+        }
+        const QByteArray zip64 = m_file.read(ZIP64_EOCD_SIZE);
+        if (zip64.size() != ZIP64_EOCD_SIZE || le32(zip64.constData()) != ZIP64_EOCD_SIGNATURE) {
+            m_error = "Corrupt ZIP64 end of central directory";
+            return false;
+        }
+        entryCount = le64(zip64.constData() + 32);
+        cdSize = le64(zip64.constData() + 40);
+        cdOffset = le64(zip64.constData() + 48);
+    }
+
+    if (cdOffset + cdSize > static_cast<quint64>(fileSize)) {
+        m_error = "Central directory lies outside the archive";
+        return false;
+    }
+    if (!m_file.seek(static_cast<qint64>(cdOffset))) {
+        m_error = "Cannot seek to central directory";
+        return false;
+    }
+    const QByteArray cd = m_file.read(static_cast<qint64>(cdSize));
+    if (cd.size() != static_cast<qint64>(cdSize)) {
+        m_error = "Cannot read central directory";
+        return false;
+    }
+
+    m_entries.reserve(static_cast<int>(qMin<quint64>(entryCount, 65536)));
+    qint64 pos = 0;
+    for (quint64 n = 0; n < entryCount; ++n) {
+        if (pos + CENTRAL_HEADER_SIZE > cd.size() ||
+            le32(cd.constData() + pos) != CENTRAL_HEADER_SIGNATURE) {
+            m_error = "Corrupt central directory entry";
+            m_entries.clear();
+            return false;
+        }
+        const char *h = cd.constData() + pos;
+        const int nameLength = le16(h + 28);
+        const int extraLength = le16(h + 30);
+        const int commentLength = le16(h + 32);
+        if (pos + CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength > cd.size()) {
+            m_error = "Truncated central directory entry";
+            m_entries.clear();
+            return false;
+        }
+
+        ZipEntry entry;
+        entry.flags = le16(h + 8);
+        entry.method = le16(h + 10);
+        entry.crc32 = le32(h + 16);
+        entry.compressedSize = le32(h + 20);
+        entry.uncompressedSize = le32(h + 24);
+        entry.localHeaderOffset = le32(h + 42);
+
+        const char *name = h + CENTRAL_HEADER_SIZE;
+        // Without the UTF-8 flag names are nominally CP437; Latin-1 keeps ASCII intact
+        entry.name = (entry.flags & FLAG_UTF8_NAMES)
+            ? QString::fromUtf8(name, nameLength)
+            : QString::fromLatin1(name, nameLength);
+
+        // ZIP64 extra field carries only the values saturated in the fixed header
+        const char *extra = name + nameLength;
+        const char *extraEnd = extra + extraLength;
+        while (extra + 4 <= extraEnd) {
+            const quint16 id = le16(extra);
+            const quint16 size = le16(extra + 2);
+            const char *field = extra + 4;
+            if (field + size > extraEnd) {
+                break;
+            }
+            if (id == ZIP64_EXTRA_ID) {
+                const char *p = field;
+                const char *end = field + size;
+                if (entry.uncompressedSize == 0xFFFFFFFFu && p + 8 <= end) {
+                    entry.uncompressedSize = le64(p);
+                    p += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFFu && p + 8 <= end) {
+                    entry.compressedSize = le64(p);
+                    p += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFFu && p + 8 <= end) {
+                    entry.localHeaderOffset = le64(p);
+                }
+            }
+            extra = field + size;
+        }
+
+        m_entries.append(entry);
+        pos += CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+    }
+
+    return true;
+}
+
+const ZipEntry *ZipReader::findEntry(const QString &name) const
+{
+    for (const ZipEntry &entry : m_entries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const ZipEntry *ZipReader::resolveEntry(const QString &name, const QString &extension) const
+{
+    if (const ZipEntry *exact = findEntry(name)) {
+        return exact;
+    }
+
+    const ZipEntry *firstFile = nullptr;
+    for (const ZipEntry &entry : m_entries) {
+        if (entry.isDirectory()) {
+            continue;
+        }
+        if (!extension.isEmpty() && entry.name.endsWith(extension, Qt::CaseInsensitive)) {
+            return &entry;
+        }
+        if (!firstFile) {
+            firstFile = &entry;
+        }
+    }
+    return firstFile;
+}
+
+qint64 ZipReader::dataOffset(const ZipEntry &entry, QString &error)
+{
+    // Name/extra lengths in the local header may differ from the central copy
+    if (!m_file.seek(static_cast<qint64>(entry.localHeaderOffset))) {
+        error = "Cannot seek to local header";
+        return -1;
+    }
+    const QByteArray local = m_file.read(LOCAL_HEADER_SIZE);
+    if (local.size() != LOCAL_HEADER_SIZE || le32(local.constData()) != LOCAL_HEADER_SIGNATURE) {
+        error = "Corrupt local header for " + entry.name;
+        return -1;
+    }
+    return static_cast<qint64>(entry.localHeaderOffset) + LOCAL_HEADER_SIZE +
+           le16(local.constData() + 26) + le16(local.constData() + 28);
+}
+
+bool ZipReader::readEntry(const ZipEntry &entry, const ChunkSink &sink, QString &error)
+{
+    if (!m_file.isOpen()) {
+        error = "Archive is not open";
+        return false;
+    }
+    if (entry.isEncrypted()) {
+        error = "Encrypted ZIP members are not supported";
+        return false;
+    }
+
+    const qint64 offset = dataOffset(entry, error);
+    if (offset < 0) {
+        return false;
+    }
+    if (offset + static_cast<qint64>(entry.compressedSize) > m_file.size()) {
+        error = "Member data lies outside the archive";
+        return false;
+    }
+
+    switch (entry.method) {
+        case METHOD_STORED:
+            return readStored(entry, offset, sink, error);
+        case METHOD_DEFLATE:
+            return readDeflated(entry, offset, sink, error);
+        default:
+            error = QString("Unsupported ZIP compression method %1").arg(entry.method);
+            return false;
+    }
+}
+
+bool ZipReader::readStored(const ZipEntry &entry, qint64 offset, const ChunkSink &sink,
+                           QString &error)
+{
+    if (entry.compressedSize != entry.uncompressedSize) {
+        error = "Stored member size mismatch for " + entry.name;
+        return false;
+    }
+    if (!m_file.seek(offset)) {
+        error = "Cannot seek to member data";
+        return false;
+    }
+
+    QByteArray buffer(static_cast<int>(OUTPUT_CHUNK_SIZE), Qt::Uninitialized);
+    quint64 remaining = entry.uncompressedSize;
+    while (remaining > 0) {
+        const qint64 want = static_cast<qint64>(qMin<quint64>(remaining, OUTPUT_CHUNK_SIZE));
+        const qint64 got = m_file.read(buffer.data(), want);
+        if (got <= 0) {
+            error = "Unexpected end of member data";
+            return false;
+        }
+        sink(buffer.constData(), got);
+        remaining -= static_cast<quint64>(got);
+    }
+    return true;
+}
+
+bool ZipReader::readDeflated(const ZipEntry &entry, qint64 offset, const ChunkSink &sink,
+                             QString &error)
+{
+    if (!m_file.seek(offset)) {
+        error = "Cannot seek to member data";
+        return false;
+    }
+
+    z_stream stream{};
+    // Negative window bits: raw deflate data, no zlib/gzip wrapper
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        error = "Failed to initialise inflate";
+        return false;
+    }
+
+    QByteArray input(static_cast<int>(INPUT_CHUNK_SIZE), Qt::Uninitialized);
+    QByteArray output(static_cast<int>(OUTPUT_CHUNK_SIZE), Qt::Uninitialized);
+    quint64 remainingInput = entry.compressedSize;
+    quint64 produced = 0;
+    int status = Z_OK;
+
+    while (status != Z_STREAM_END) {
+        if (stream.avail_in == 0) {
+            if (remainingInput == 0) {
+                break;
+            }
+            const qint64 want = static_cast<qint64>(qMin<quint64>(remainingInput, INPUT_CHUNK_SIZE));
+            const qint64 got = m_file.read(input.data(), want);
+            if (got <= 0) {
+                break;
+            }
+            remainingInput -= static_cast<quint64>(got);
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = static_cast<uInt>(got);
+        }
+
+        stream.next_out = reinterpret_cast<Bytef *>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+            error = QString("Inflate failed for %1: %2")
+                        .arg(entry.name, QString::fromLatin1(stream.msg ? stream.msg : "data error"));
+            inflateEnd(&stream);
+            return false;
+        }
+
+        const qint64 have = output.size() - static_cast<qint64>(stream.avail_out);
+        if (have > 0) {
+            sink(output.constData(), have);
+            produced += static_cast<quint64>(have);
+        }
+    }
+    inflateEnd(&stream);
+
+    if (status != Z_STREAM_END) {
+        error = "Truncated deflate stream for " + entry.name;
+        return false;
+    }
+    if (produced != entry.uncompressedSize) {
+        error = QString("Size mismatch for %1: expected %2 bytes, got %3")
+                    .arg(entry.name).arg(entry.uncompressedSize).arg(produced);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Remus
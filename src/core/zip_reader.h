@@ -0,0 +1,108 @@
+#ifndef REMUS_ZIP_READER_H
+#define REMUS_ZIP_READER_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <functional>
+
+namespace Remus {
+
+/**
+ * @brief One member as described by the ZIP central directory
+ */
+struct ZipEntry {
+    QString name;                  ///< Path inside the archive ('/' separated)
+    quint64 compressedSize = 0;
+    quint64 uncompressedSize = 0;
+    quint32 crc32 = 0;             ///< CRC32 of the uncompressed data
+    quint16 method = 0;            ///< 0 = stored, 8 = deflate
+    quint16 flags = 0;             ///< General purpose bit flags
+    quint64 localHeaderOffset = 0;
+
+    bool isDirectory() const { return name.endsWith(QLatin1Char('/')); }
+    bool isEncrypted() const { return (flags & 0x0001) != 0; }
+
+    /// True if readEntry() can decode this member in-process
+    bool isSupported() const;
+};
+
+/**
+ * @brief Minimal in-process ZIP reader (central directory + stored/deflate)
+ *
+ * Parses the end-of-central-directory record (including ZIP64) and streams
+ * member data through zlib's raw inflate, so a member can be hashed or
+ * inspected without spawning unzip/7z or writing it to disk. Encrypted
+ * members and methods other than stored/deflate are reported as
+ * unsupported; callers fall back to ArchiveExtractor for those.
+ */
+class ZipReader {
+public:
+    using ChunkSink = std::function<void(const char *data, qint64 size)>;
+
+    /// Uncompressed bytes handed to the sink per call
+    static constexpr qint64 OUTPUT_CHUNK_SIZE = 1024 * 1024;
+
+    /// Compressed bytes read from disk per call
+    static constexpr qint64 INPUT_CHUNK_SIZE = 256 * 1024;
+
+    explicit ZipReader(const QString &archivePath);
+
+    /**
+     * @brief Check whether a path names a ZIP archive (by extension)
+     */
+    static bool isZipPath(const QString &path);
+
+    /**
+     * @brief Open the archive and read its central directory
+     * @return False if the file is missing or not a readable ZIP
+     */
+    bool open();
+
+    QString errorString() const { return m_error; }
+    QString archivePath() const { return m_path; }
+
+    /**
+     * @brief Central directory entries in archive order (valid after open())
+     */
+    const QList<ZipEntry> &entries() const { return m_entries; }
+
+    /**
+     * @brief Find a member by exact name
+     * @return Entry, or nullptr if not present
+     */
+    const ZipEntry *findEntry(const QString &name) const;
+
+    /**
+     * @brief Resolve the member a file record refers to
+     *
+     * Tries the exact name first, then the first file with the expected
+     * extension, then the first file, mirroring how extraction picks a file.
+     * @return Entry, or nullptr if the archive holds no files
+     */
+    const ZipEntry *resolveEntry(const QString &name, const QString &extension) const;
+
+    /**
+     * @brief Stream a member's uncompressed bytes into a sink
+     * @param entry Entry from entries()
+     * @param sink Receives consecutive chunks of at most OUTPUT_CHUNK_SIZE
+     * @param error Set on failure
+     * @return True if the whole member was decoded and its size matched
+     */
+    bool readEntry(const ZipEntry &entry, const ChunkSink &sink, QString &error);
+
+private:
+    bool readCentralDirectory();
+    qint64 dataOffset(const ZipEntry &entry, QString &error);
+    bool readStored(const ZipEntry &entry, qint64 offset, const ChunkSink &sink, QString &error);
+    bool readDeflated(const ZipEntry &entry, qint64 offset, const ChunkSink &sink, QString &error);
+
+    QString m_path;
+    QFile m_file;
+    QList<ZipEntry> m_entries;
+    QString m_error;
+};
+
+} // namespace Remus
+
+#endif // REMUS_ZIP_READER_H
@@ -1,19 +1,58 @@
 #include "artwork_downloader.h"
-#include <QNetworkReply>
+#include "network_client.h"
 #include <QNetworkRequest>
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
-#include <QEventLoop>
-#include <QTimer>
+#include <QStandardPaths>
 #include <QDebug>
 #include "../core/constants/constants.h"
 
 namespace Remus {
 
+namespace {
+
+/**
+ * @brief What a partial body can be resumed against: a strong ETag, else Last-Modified
+ */
+QByteArray resumeValidator(const NetworkResponse &response)
+{
+    const QByteArray etag = response.header("ETag");
+    if (!etag.isEmpty() && !etag.startsWith("W/")) {
+        return etag;
+    }
+    return response.header("Last-Modified");
+}
+
+/**
+ * @brief Parse "bytes <first>-<last>/<size>"
+ * @param size Set to -1 when the server gives "*"
+ */
+bool parseContentRange(const QByteArray &value, qint64 *first, qint64 *size)
+{
+    const QByteArray trimmed = value.trimmed();
+    if (!trimmed.startsWith("bytes ")) {
+        return false;
+    }
+    const int dash = trimmed.indexOf('-');
+    const int slash = trimmed.indexOf('/');
+    if (dash < 0 || slash < dash) {
+        return false;
+    }
+    bool ok = false;
+    *first = trimmed.mid(6, dash - 6).trimmed().toLongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    const QByteArray total = trimmed.mid(slash + 1).trimmed();
+    *size = total == "*" ? -1 : total.toLongLong(&ok);
+    return ok;
+}
+
+} // namespace
+
 ArtworkDownloader::ArtworkDownloader(QObject *parent)
     : QObject(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
 {
 }
 
@@ -57,41 +96,298 @@ QByteArray ArtworkDownloader::downloadToMemory(const QUrl &url)
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, 
                          QNetworkRequest::NoLessSafeRedirectPolicy);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-    
-    // Connect progress signal
-    connect(reply, &QNetworkReply::downloadProgress, this,
-            [this, url](qint64 bytesReceived, qint64 bytesTotal) {
-                emit downloadProgress(url, bytesReceived, bytesTotal);
-            });
+    // Progress arrives on the network thread; we block until the end, so
+    // this object outlives every call
+    const NetworkResponse reply = NetworkClient::wait(NetworkClient::shared().get(
+        request, Constants::Network::ARTWORK_TIMEOUT_MS,
+        [this, url](qint64 bytesReceived, qint64 bytesTotal) {
+            emit downloadProgress(url, bytesReceived, bytesTotal);
+        }));
 
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::ARTWORK_TIMEOUT_MS);
+    QByteArray data;
 
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    if (reply.success) {
+        data = reply.data;
+    } else if (reply.timedOut) {
+        emit downloadFailed(url, "Download timeout");
+    } else {
+        emit downloadFailed(url, reply.error);
+    }
 
-    timeout.start();
-    loop.exec();
+    return data;
+}
 
-    QByteArray data;
+ArtworkDownloader::~ArtworkDownloader()
+{
+    // Abort transfers quietly; nobody is left to tell
+    for (const DownloadPtr &download : std::as_const(m_byUrl)) {
+        if (download->watcher) {
+            download->watcher->disconnect(this);
+            download->watcher->future().cancel();
+        }
+    }
+}
+
+void ArtworkDownloader::setStorePath(const QString &path)
+{
+    m_storePath = path;
+    m_store.reset();
+}
+
+QString ArtworkDownloader::storePath() const
+{
+    if (!m_storePath.isEmpty()) {
+        return m_storePath;
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/"
+           + Constants::Settings::Files::ARTWORK_SUBDIR + "/"
+           + Constants::Settings::Files::ARTWORK_STORE_SUBDIR;
+}
+
+ArtworkStore *ArtworkDownloader::store()
+{
+    if (!m_store) {
+        m_store = std::make_unique<ArtworkStore>(storePath());
+    }
+    return m_store.get();
+}
+
+void ArtworkDownloader::enqueue(const QUrl &url, const QString &destPath)
+{
+    const QString key = url.toString(QUrl::FullyEncoded);
+    DownloadPtr &download = m_byUrl[key];
+    if (!download) {
+        download = std::make_shared<QueuedDownload>();
+        download->url = url;
+        m_queue.append(download);
+    }
+    if (!download->destinations.contains(destPath)) {
+        download->destinations.append(destPath);
+    }
+    postSchedule();
+}
+
+void ArtworkDownloader::cancelAll()
+{
+    const QList<DownloadPtr> queued = m_queue;
+    m_queue.clear();
+    for (const DownloadPtr &download : queued) {
+        fail(download, "Cancelled");
+    }
+
+    // Running ones report back through finish()
+    for (const DownloadPtr &download : std::as_const(m_byUrl)) {
+        if (download->watcher) {
+            download->watcher->future().cancel();
+        }
+    }
+    checkIdle();
+}
+
+void ArtworkDownloader::postSchedule()
+{
+    if (m_schedulePosted) {
+        return;
+    }
+    m_schedulePosted = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_schedulePosted = false;
+        schedule();
+        checkIdle();
+    }, Qt::QueuedConnection);
+}
 
-    if (timeout.isActive()) {
-        timeout.stop();
-        
-        if (reply->error() == QNetworkReply::NoError) {
-            data = reply->readAll();
+void ArtworkDownloader::schedule()
+{
+    for (auto it = m_queue.begin(); it != m_queue.end();) {
+        const DownloadPtr download = *it;
+
+        if (!download->url.isValid() || (!download->url.isLocalFile() && download->url.host().isEmpty())) {
+            it = m_queue.erase(it);
+            fail(download, "Invalid URL");
+            continue;
+        }
+
+        // Fetched before, maybe for another game: link only
+        const QString hash = store()->hashForUrl(download->url);
+        if (!hash.isEmpty()) {
+            it = m_queue.erase(it);
+            deliver(download, hash);
+            continue;
+        }
+
+        if (m_activeDownloads >= m_maxConcurrent
+            || m_activeByHost.value(download->url.host()) >= m_maxPerHost) {
+            ++it;
+            continue;
+        }
+        it = m_queue.erase(it);
+        start(download);
+    }
+}
+
+void ArtworkDownloader::start(const DownloadPtr &download)
+{
+    ++download->attempts;
+    ++m_activeDownloads;
+    ++m_activeByHost[download->url.host()];
+
+    QNetworkRequest request(download->url);
+    request.setHeader(QNetworkRequest::UserAgentHeader, Constants::API::USER_AGENT);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+
+    // Pick up where an earlier attempt (or run) stopped. If-Range makes the
+    // server send the whole image instead if it changed since.
+    download->resumeFrom = 0;
+    const QFileInfo partial(store()->partialPath(download->url));
+    if (partial.exists() && partial.size() > 0) {
+        const QByteArray validator = store()->partialValidator(download->url);
+        if (validator.isEmpty()) {
+            store()->discardPartial(download->url);
         } else {
-            emit downloadFailed(url, reply->errorString());
+            download->resumeFrom = partial.size();
+            request.setRawHeader("Range", "bytes=" + QByteArray::number(partial.size()) + "-");
+            request.setRawHeader("If-Range", validator);
+        }
+    }
+
+    auto *watcher = new QFutureWatcher<NetworkResponse>(this);
+    download->watcher = watcher;
+    connect(watcher, &QFutureWatcher<NetworkResponse>::finished, this, [this, download, watcher]() {
+        finish(download, NetworkClient::wait(watcher->future()));
+    });
+    watcher->setFuture(NetworkClient::shared().get(request, Constants::Network::ARTWORK_TIMEOUT_MS));
+}
+
+void ArtworkDownloader::finish(const DownloadPtr &download, const NetworkResponse &response)
+{
+    --m_activeDownloads;
+    const QString host = download->url.host();
+    if (--m_activeByHost[host] <= 0) {
+        m_activeByHost.remove(host);
+    }
+    download->watcher->deleteLater();
+    download->watcher = nullptr;
+
+    const QString partialPath = store()->partialPath(download->url);
+    const qint64 resumeFrom = download->resumeFrom;
+    download->resumeFrom = 0;
+    const bool resumed = response.statusCode == 206;
+
+    qint64 rangeFirst = -1;
+    qint64 rangeSize = -1;
+    if (resumed && (resumeFrom <= 0
+                    || !parseContentRange(response.header("Content-Range"), &rangeFirst, &rangeSize)
+                    || rangeFirst != resumeFrom)) {
+        // Not the rest of the kept bytes; splicing them would corrupt the image
+        qWarning() << "ArtworkDownloader: Unexpected Content-Range" << response.header("Content-Range")
+                   << "for" << download->url.toString() << "- fetching it whole";
+        store()->discardPartial(download->url);
+        retry(download, QStringLiteral("Unexpected partial response"));
+        schedule();
+        checkIdle();
+        return;
+    }
+    if (resumeFrom > 0 && !resumed && response.statusCode != 0) {
+        // If-Range did not match (or Range was ignored): the body starts from byte 0
+        store()->discardPartial(download->url);
+    }
+
+    if (response.success) {
+        QByteArray data = response.data;
+        if (resumed) {
+            QFile partial(partialPath);
+            if (partial.open(QIODevice::ReadOnly)) {
+                data.prepend(partial.readAll());
+            }
         }
+        store()->discardPartial(download->url);
+
+        if (rangeSize >= 0 && data.size() != rangeSize) {
+            qWarning() << "ArtworkDownloader: Resumed" << download->url.toString() << "is"
+                       << data.size() << "bytes, expected" << rangeSize << "- fetching it whole";
+            retry(download, QStringLiteral("Resumed download has the wrong size"));
+            schedule();
+            checkIdle();
+            return;
+        }
+
+        const QString hash = store()->put(data);
+        if (hash.isEmpty()) {
+            fail(download, "Failed to store artwork");
+        } else {
+            store()->recordUrl(download->url, hash);
+            deliver(download, hash);
+        }
+    } else if (!response.cancelled && (response.statusCode == 200 || resumed)) {
+        // Cut off mid-body: keep what arrived and ask for the rest, if the
+        // server gave us something to check the rest against
+        const QByteArray validator = resumed ? store()->partialValidator(download->url)
+                                             : resumeValidator(response);
+        if (!response.data.isEmpty() && !validator.isEmpty()) {
+            QDir().mkpath(QFileInfo(partialPath).absolutePath());
+            QFile partial(partialPath);
+            if (partial.open(resumed ? QIODevice::Append : QIODevice::WriteOnly)) {
+                partial.write(response.data);
+                if (!resumed) {
+                    store()->setPartialValidator(download->url, validator);
+                }
+            }
+        }
+        retry(download, response.timedOut ? QStringLiteral("Download timeout") : response.error);
+    } else if (response.statusCode == 416) {
+        // The kept bytes do not fit what the server has now
+        store()->discardPartial(download->url);
+        retry(download, response.error);
     } else {
-        emit downloadFailed(url, "Download timeout");
+        fail(download, response.timedOut ? QStringLiteral("Download timeout") : response.error);
     }
 
-    reply->deleteLater();
-    return data;
+    schedule();
+    checkIdle();
+}
+
+void ArtworkDownloader::deliver(const DownloadPtr &download, const QString &hash)
+{
+    m_byUrl.remove(download->url.toString(QUrl::FullyEncoded));
+    for (const QString &destPath : std::as_const(download->destinations)) {
+        if (store()->link(hash, destPath)) {
+            ++m_completed;
+            emit downloadCompleted(download->url, destPath);
+        } else {
+            ++m_failed;
+            emit downloadFailed(download->url, QString("Failed to write file: %1").arg(destPath));
+        }
+    }
+}
+
+void ArtworkDownloader::fail(const DownloadPtr &download, const QString &error)
+{
+    m_byUrl.remove(download->url.toString(QUrl::FullyEncoded));
+    m_failed += download->destinations.size();
+    emit downloadFailed(download->url, error);
+}
+
+void ArtworkDownloader::retry(const DownloadPtr &download, const QString &error)
+{
+    if (download->attempts <= Constants::Network::ARTWORK_DOWNLOAD_RETRIES) {
+        m_queue.prepend(download);
+    } else {
+        fail(download, error);
+    }
+}
+
+void ArtworkDownloader::checkIdle()
+{
+    if (!m_byUrl.isEmpty() || m_schedulePosted || (m_completed == 0 && m_failed == 0)) {
+        return;
+    }
+    const int completed = m_completed;
+    const int failed = m_failed;
+    m_completed = 0;
+    m_failed = 0;
+    emit queueFinished(completed, failed);
 }
 
 } // namespace Remus
@@ -2,20 +2,36 @@
 #define REMUS_ARTWORK_DOWNLOADER_H
 
 #include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
-#include <QNetworkAccessManager>
+#include <memory>
+#include "artwork_store.h"
+#include "network_client.h"
 
 namespace Remus {
 
 /**
  * @brief Downloads and saves artwork files
+ *
+ * download() fetches one file and blocks. enqueue() feeds a scheduler
+ * instead: up to maxConcurrent() transfers run at once, at most
+ * maxPerHost() against one host; a URL queued for several destinations
+ * is fetched once; interrupted transfers are kept and resumed with a
+ * Range/If-Range request when the server sent a validator for them; and
+ * files land in an ArtworkStore, so identical images
+ * are stored once and destinations link to them. Queue results are
+ * delivered on this object's thread, which needs an event loop.
  */
 class ArtworkDownloader : public QObject {
     Q_OBJECT
 
 public:
     explicit ArtworkDownloader(QObject *parent = nullptr);
+    ~ArtworkDownloader() override;
 
     /**
      * @brief Download artwork to file
@@ -35,17 +51,93 @@ public:
     /**
      * @brief Set maximum parallel downloads
      */
-    void setMaxConcurrent(int max) { m_maxConcurrent = max; }
+    void setMaxConcurrent(int max) { m_maxConcurrent = qMax(1, max); }
+    int maxConcurrent() const { return m_maxConcurrent; }
+
+    /**
+     * @brief Set maximum parallel downloads from one host
+     */
+    void setMaxPerHost(int max) { m_maxPerHost = qMax(1, max); }
+    int maxPerHost() const { return m_maxPerHost; }
+
+    /**
+     * @brief Where queued downloads are stored (see ArtworkStore)
+     */
+    void setStorePath(const QString &path);
+    QString storePath() const;
+
+    /**
+     * @brief Queue a download to @p destPath
+     *
+     * Emits downloadCompleted() or downloadFailed() for it from the event
+     * loop (never from inside this call), then queueFinished() once nothing
+     * is left. A URL already in the store is only linked, without a
+     * request. downloadProgress() is not emitted for queued downloads.
+     */
+    void enqueue(const QUrl &url, const QString &destPath);
+
+    /**
+     * @brief Drop queued downloads and abort running ones
+     */
+    void cancelAll();
+
+    /**
+     * @brief URLs queued or downloading
+     */
+    int pendingCount() const { return m_byUrl.size(); }
 
 signals:
     void downloadProgress(const QUrl &url, qint64 bytesReceived, qint64 bytesTotal);
     void downloadCompleted(const QUrl &url, const QString &filePath);
     void downloadFailed(const QUrl &url, const QString &error);
 
+    /**
+     * @brief The queue ran empty
+     * @param completed Destinations written since the queue was last empty
+     * @param failed Destinations not written (failed or cancelled) in that time
+     */
+    void queueFinished(int completed, int failed);
+
 private:
-    QNetworkAccessManager *m_networkManager;
+    /**
+     * @brief One URL in the queue, with everywhere it should end up
+     */
+    struct QueuedDownload {
+        QUrl url;
+        QStringList destinations;
+        int attempts = 0;
+        qint64 resumeFrom = 0;      // Bytes the current attempt asked to skip
+        QFutureWatcher<NetworkResponse> *watcher = nullptr;
+    };
+    using DownloadPtr = std::shared_ptr<QueuedDownload>;
+
+    /// Start queued downloads while there is room
+    void schedule();
+    void start(const DownloadPtr &download);
+    void finish(const DownloadPtr &download, const NetworkResponse &response);
+    /// Link every destination to a stored blob
+    void deliver(const DownloadPtr &download, const QString &hash);
+    void fail(const DownloadPtr &download, const QString &error);
+    /// Queue another attempt, or fail once the retries are spent
+    void retry(const DownloadPtr &download, const QString &error);
+    /// Run schedule() from the event loop, once however often asked
+    void postSchedule();
+    /// Emit queueFinished() if nothing is left
+    void checkIdle();
+    ArtworkStore *store();
+
     int m_maxConcurrent = 4;
+    int m_maxPerHost = Constants::Network::ARTWORK_DOWNLOADS_PER_HOST;
     int m_activeDownloads = 0;
+
+    QString m_storePath;
+    std::unique_ptr<ArtworkStore> m_store;          // Created on first use
+    QList<DownloadPtr> m_queue;                     // Waiting, in order
+    QHash<QString, DownloadPtr> m_byUrl;            // Queued or running, by URL
+    QHash<QString, int> m_activeByHost;
+    bool m_schedulePosted = false;
+    int m_completed = 0;
+    int m_failed = 0;
 };
 
 } // namespace Remus
@@ -0,0 +1,135 @@
+#include "artwork_store.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+
+namespace Remus {
+
+ArtworkStore::ArtworkStore(const QString &rootPath)
+    : m_rootPath(rootPath)
+{
+}
+
+QString ArtworkStore::urlKey(const QUrl &url)
+{
+    return QString::fromLatin1(
+        QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex());
+}
+
+QString ArtworkStore::put(const QByteArray &data)
+{
+    const QString hash = QString::fromLatin1(
+        QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+    if (contains(hash)) {
+        return hash;
+    }
+
+    const QString path = blobPath(hash);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // Written aside and renamed, so a blob is never seen half-written
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "ArtworkStore: Failed to write blob" << path << file.errorString();
+        return QString();
+    }
+    return hash;
+}
+
+QString ArtworkStore::blobPath(const QString &hash) const
+{
+    return m_rootPath + "/blobs/" + hash.left(2) + "/" + hash;
+}
+
+bool ArtworkStore::contains(const QString &hash) const
+{
+    return !hash.isEmpty() && QFile::exists(blobPath(hash));
+}
+
+bool ArtworkStore::link(const QString &hash, const QString &destPath) const
+{
+    if (!contains(hash)) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(destPath).absolutePath());
+    // exists() follows links, so check the link itself too
+    if (QFileInfo(destPath).isSymLink() || QFile::exists(destPath)) {
+        QFile::remove(destPath);
+    }
+
+#ifdef Q_OS_WIN
+    // QFile::link makes .lnk shortcuts here, which images cannot be read through
+    return QFile::copy(blobPath(hash), destPath);
+#else
+    return QFile::link(QFileInfo(blobPath(hash)).absoluteFilePath(), destPath)
+           || QFile::copy(blobPath(hash), destPath);
+#endif
+}
+
+QString ArtworkStore::hashForUrl(const QUrl &url) const
+{
+    QFile file(m_rootPath + "/urls/" + urlKey(url));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QString hash = QString::fromLatin1(file.readAll().trimmed());
+    return contains(hash) ? hash : QString();
+}
+
+void ArtworkStore::recordUrl(const QUrl &url, const QString &hash)
+{
+    QDir().mkpath(m_rootPath + "/urls");
+    QSaveFile file(m_rootPath + "/urls/" + urlKey(url));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(hash.toLatin1());
+        file.commit();
+    }
+}
+
+QString ArtworkStore::partialPath(const QUrl &url) const
+{
+    return m_rootPath + "/partial/" + urlKey(url);
+}
+
+QByteArray ArtworkStore::partialValidator(const QUrl &url) const
+{
+    QFile file(partialPath(url) + ".validator");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll().trimmed();
+}
+
+void ArtworkStore::setPartialValidator(const QUrl &url, const QByteArray &validator)
+{
+    QDir().mkpath(m_rootPath + "/partial");
+    QSaveFile file(partialPath(url) + ".validator");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(validator);
+        file.commit();
+    }
+}
+
+void ArtworkStore::discardPartial(const QUrl &url)
+{
+    QFile::remove(partialPath(url));
+    QFile::remove(partialPath(url) + ".validator");
+}
+
+int ArtworkStore::blobCount() const
+{
+    int count = 0;
+    QDirIterator it(m_rootPath + "/blobs", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        ++count;
+    }
+    return count;
+}
+
+} // namespace Remus
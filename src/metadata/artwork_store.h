@@ -0,0 +1,87 @@
+#ifndef REMUS_ARTWORK_STORE_H
+#define REMUS_ARTWORK_STORE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+namespace Remus {
+
+/**
+ * @brief Content-addressed storage for downloaded artwork
+ *
+ * Images are kept once, named by the SHA-1 of their bytes, under
+ * blobs/ab/abcdef...; a game's artwork path is a symlink to its blob, so
+ * box art shared by regional releases (or served from different URLs)
+ * takes the space of one file. Also remembers which blob a URL produced
+ * and keeps partial downloads so they can be resumed.
+ *
+ * Layout under the root:
+ *   blobs/<2 hex>/<sha1>             image data
+ *   urls/<sha1 of URL>               blob hash the URL downloaded to
+ *   partial/<sha1 of URL>            bytes received so far
+ *   partial/<sha1 of URL>.validator  ETag or Last-Modified they came with
+ */
+class ArtworkStore
+{
+public:
+    explicit ArtworkStore(const QString &rootPath);
+
+    QString rootPath() const { return m_rootPath; }
+
+    /**
+     * @brief Add image data (no-op if the same bytes are already stored)
+     * @return Blob hash, empty on write failure
+     */
+    QString put(const QByteArray &data);
+
+    QString blobPath(const QString &hash) const;
+    bool contains(const QString &hash) const;
+
+    /**
+     * @brief Point a file path at a blob
+     *
+     * Replaces whatever is at @p destPath. Uses a symlink, or a copy where
+     * symlinks are not available.
+     */
+    bool link(const QString &hash, const QString &destPath) const;
+
+    /**
+     * @brief Blob a URL downloaded to before (empty if none, or gone)
+     */
+    QString hashForUrl(const QUrl &url) const;
+    void recordUrl(const QUrl &url, const QString &hash);
+
+    /**
+     * @brief Where the bytes of an unfinished download of @p url are kept
+     */
+    QString partialPath(const QUrl &url) const;
+
+    /**
+     * @brief Validator (strong ETag or Last-Modified) of the partial bytes
+     *
+     * Sent as If-Range on resume, so a changed image is fetched whole
+     * instead of being spliced onto the old bytes. Empty if none was kept.
+     */
+    QByteArray partialValidator(const QUrl &url) const;
+    void setPartialValidator(const QUrl &url, const QByteArray &validator);
+
+    /**
+     * @brief Drop the partial bytes of @p url and their validator
+     */
+    void discardPartial(const QUrl &url);
+
+    /**
+     * @brief Number of distinct images stored
+     */
+    int blobCount() const;
+
+private:
+    static QString urlKey(const QUrl &url);
+
+    QString m_rootPath;
+};
+
+} // namespace Remus
+
+#endif // REMUS_ARTWORK_STORE_H
@@ -1,239 +1,437 @@
 #include "clrmamepro_parser.h"
+#include "../core/zip_reader.h"
 #include <QFile>
-#include <QTextStream>
-#include <QRegularExpression>
 #include <QDebug>
+#include <zlib.h>
 
 namespace Remus {
 
-QList<ClrMameProEntry> ClrMameProParser::parse(const QString &filePath)
+namespace {
+
+inline bool isSpace(char c)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "ClrMameProParser: Failed to open file:" << filePath;
-        return QList<ClrMameProEntry>();
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline QString toString(QByteArrayView text)
+{
+    return QString::fromUtf8(text);
+}
+
+/**
+ * @brief Skip the rest of a block whose "(" has already been consumed
+ */
+void skipBlock(ClrMameProTokenizer &tokens)
+{
+    using Token = ClrMameProTokenizer::Token;
+    int depth = 1;
+    while (depth > 0) {
+        switch (tokens.next()) {
+        case Token::Open:  ++depth; break;
+        case Token::Close: --depth; break;
+        case Token::End:   return;
+        default:           break;
+        }
+    }
+}
+
+/**
+ * @brief Read "key value" pairs until the block's ")"
+ * @param assign Called with each key and its Word/String value
+ */
+template <typename Assign>
+void readPairs(ClrMameProTokenizer &tokens, Assign assign)
+{
+    using Token = ClrMameProTokenizer::Token;
+    for (;;) {
+        Token token = tokens.next();
+        if (token == Token::Close || token == Token::End) {
+            return;
+        }
+        if (token == Token::Open) {
+            skipBlock(tokens);
+            continue;
+        }
+        const QByteArrayView key = tokens.text();
+        token = tokens.next();
+        if (token == Token::Word || token == Token::String) {
+            assign(key, tokens.text());
+        } else if (token == Token::Open) {
+            skipBlock(tokens);
+        } else {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Parse a game block body (after "game (") into a view
+ */
+void readGame(ClrMameProTokenizer &tokens, ClrMameProGameView &game)
+{
+    using Token = ClrMameProTokenizer::Token;
+    for (;;) {
+        Token token = tokens.next();
+        if (token == Token::Close || token == Token::End) {
+            return;
+        }
+        if (token == Token::Open) {
+            skipBlock(tokens);
+            continue;
+        }
+        const QByteArrayView key = tokens.text();
+        token = tokens.next();
+        if (token == Token::Open) {
+            if (key == "rom" || key == "disk") {
+                ClrMameProRomView rom;
+                readPairs(tokens, [&rom](QByteArrayView k, QByteArrayView value) {
+                    if (k == "name") rom.name = value;
+                    else if (k == "size") rom.size = value;
+                    else if (k == "crc") rom.crc = value;
+                    else if (k == "md5") rom.md5 = value;
+                    else if (k == "sha1") rom.sha1 = value;
+                    else if (k == "serial") rom.serial = value;
+                });
+                game.roms.append(rom);
+            } else {
+                skipBlock(tokens);
+            }
+        } else if (token == Token::Word || token == Token::String) {
+            const QByteArrayView value = tokens.text();
+            if (key == "name") game.name = value;
+            else if (key == "description") game.description = value;
+            else if (key == "region") game.region = value;
+            else if (key == "serial") game.serial = value;
+        } else {
+            return;
+        }
+    }
+}
+
+qint64 parseSize(QByteArrayView text)
+{
+    qint64 size = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return 0;
+        }
+        size = size * 10 + (c - '0');
+    }
+    return size;
+}
+
+bool inflateGzip(const QByteArray &compressed, QByteArray &out)
+{
+    z_stream stream = {};
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        return false;
+    }
+
+    out.resize(qMax<qsizetype>(compressed.size() * 4, 64 * 1024));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.constData()));
+    stream.avail_in = static_cast<uInt>(compressed.size());
+
+    int status = Z_OK;
+    while (status == Z_OK) {
+        if (stream.total_out == static_cast<uLong>(out.size())) {
+            out.resize(out.size() * 2);
+        }
+        stream.next_out = reinterpret_cast<Bytef *>(out.data()) + stream.total_out;
+        stream.avail_out = static_cast<uInt>(out.size() - static_cast<qsizetype>(stream.total_out));
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status == Z_BUF_ERROR && stream.avail_in == 0) {
+            break;  // Truncated input
+        }
+        if (status == Z_BUF_ERROR) {
+            status = Z_OK;
+        }
+    }
+    out.resize(static_cast<qsizetype>(stream.total_out));
+    inflateEnd(&stream);
+    return status == Z_STREAM_END;
+}
+
+bool readZippedDat(const QString &filePath, QByteArray &out)
+{
+    ZipReader reader(filePath);
+    if (!reader.open()) {
+        qWarning() << "ClrMameProParser: Failed to open zip:" << reader.errorString();
+        return false;
+    }
+    const ZipEntry *entry = reader.resolveEntry(QString(), QStringLiteral(".dat"));
+    if (!entry) {
+        qWarning() << "ClrMameProParser: No DAT inside" << filePath;
+        return false;
+    }
+
+    out.clear();
+    out.reserve(static_cast<qsizetype>(entry->uncompressedSize));
+    QString error;
+    if (!reader.readEntry(*entry, [&out](const char *data, qint64 size) {
+            out.append(data, static_cast<qsizetype>(size));
+        }, error)) {
+        qWarning() << "ClrMameProParser: Failed to read" << entry->name << "-" << error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ── ClrMameProTokenizer ──────────────────────────────────────────────
+
+ClrMameProTokenizer::ClrMameProTokenizer(QByteArrayView data)
+    : m_data(data)
+{
+    if (m_data.startsWith("\xEF\xBB\xBF")) {
+        m_pos = 3;
+    }
+}
+
+ClrMameProTokenizer::Token ClrMameProTokenizer::next()
+{
+    const char *data = m_data.data();
+    const qsizetype size = m_data.size();
+
+    while (m_pos < size && isSpace(data[m_pos])) {
+        ++m_pos;
+    }
+    if (m_pos >= size) {
+        m_text = QByteArrayView();
+        return Token::End;
     }
-    
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
-    
-    return parseGameBlocks(content);
+
+    const char c = data[m_pos];
+    if (c == '(') {
+        ++m_pos;
+        return Token::Open;
+    }
+    if (c == ')') {
+        ++m_pos;
+        return Token::Close;
+    }
+    if (c == '"') {
+        const qsizetype start = ++m_pos;
+        while (m_pos < size && data[m_pos] != '"') {
+            ++m_pos;
+        }
+        m_text = QByteArrayView(data + start, m_pos - start);
+        if (m_pos < size) {
+            ++m_pos;  // Closing quote
+        }
+        return Token::String;
+    }
+
+    const qsizetype start = m_pos;
+    while (m_pos < size && !isSpace(data[m_pos]) && data[m_pos] != '(' && data[m_pos] != ')') {
+        ++m_pos;
+    }
+    m_text = QByteArrayView(data + start, m_pos - start);
+    return Token::Word;
+}
+
+// ── ClrMameProParser ─────────────────────────────────────────────────
+
+QList<ClrMameProEntry> ClrMameProParser::parse(const QString &filePath,
+                                               QMap<QString, QString> *header,
+                                               const ProgressCallback &progress)
+{
+    QList<ClrMameProEntry> entries;
+    int games = 0;
+    parseFile(filePath, [&](const ClrMameProGameView &game) {
+        ++games;
+        appendEntries(game, entries);
+    }, header, progress);
+
+    qDebug() << "ClrMameProParser: Found" << games << "game blocks, parsed" << entries.size() << "entries";
+    return entries;
 }
 
 QMap<QString, QString> ClrMameProParser::parseHeader(const QString &filePath)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return QMap<QString, QString>();
-    }
-    
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
-    
     QMap<QString, QString> header;
-    
-    // Extract clrmamepro header block
-    QRegularExpression headerRegex(R"(clrmamepro\s*\(([\s\S]*?)\n\))");
-    QRegularExpressionMatch match = headerRegex.match(content);
-    
-    if (match.hasMatch()) {
-        QString headerBlock = match.captured(1);
-        header = extractKeyValues(headerBlock);
-    }
-    
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return header;
+    }
+
+    // Compressed DATs have to be inflated anyway; take the full path
+    const QByteArray magic = file.peek(4);
+    if (magic.startsWith("\x1f\x8b") || magic.startsWith("PK\x03\x04")) {
+        file.close();
+        parseFile(filePath, nullptr, &header);
+        return header;
+    }
+
+    const qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped) {
+        parseBuffer(QByteArrayView(mapped, size), nullptr, &header, nullptr, true);
+        file.unmap(mapped);
+    } else {
+        const QByteArray data = file.readAll();
+        parseBuffer(data, nullptr, &header, nullptr, true);
+    }
     return header;
 }
 
-QList<ClrMameProEntry> ClrMameProParser::parseGameBlocks(const QString &content)
+bool ClrMameProParser::parseFile(const QString &filePath, const GameVisitor &visitor,
+                                 QMap<QString, QString> *header,
+                                 const ProgressCallback &progress)
 {
-    QList<ClrMameProEntry> entries;
-    
-    qDebug() << "ClrMameProParser: Content length:" << content.length();
-    
-    // Match game blocks: game (\n ... \n)
-    // The closing paren is on its own line
-    QRegularExpression gameRegex(R"(game\s*\(([^{}]*?)\n\s*\))");
-    gameRegex.setPatternOptions(QRegularExpression::DotMatchesEverythingOption);
-    
-    qDebug() << "ClrMameProParser: Regex pattern:" << gameRegex.pattern();
-    qDebug() << "ClrMameProParser: Searching for game blocks...";
-    
-    QRegularExpressionMatchIterator it = gameRegex.globalMatch(content);
-    
-    int matchCount = 0;
-    while (it.hasNext()) {
-        QRegularExpressionMatch match = it.next();
-        matchCount++;
-        QString gameBlock = match.captured(1);
-        
-        // Parse game metadata (multi-line format)
-        QMap<QString, QString> gameData = extractKeyValues(gameBlock);
-        
-        // Extract ROM block: rom ( ... )
-        // ROM blocks are single-line with space-separated attributes
-        int romStart = gameBlock.indexOf("rom (");
-        
-        if (romStart != -1) {
-            int parenCount = 0;
-            int i = romStart + 5; // Start after "rom ("
-            int romEnd = -1;
-            
-            bool inQuote = false;
-            for (; i < gameBlock.length(); i++) {
-                QChar c = gameBlock[i];
-                
-                if (c == '"') {
-                    inQuote = !inQuote;
-                } else if (!inQuote) {
-                    if (c == '(') {
-                        parenCount++;
-                    } else if (c == ')') {
-                        if (parenCount == 0) {
-                            romEnd = i;
-                            break;
-                        }
-                        parenCount--;
-                    }
-                }
-            }
-            
-            if (romEnd != -1) {
-                QString romBlock = gameBlock.mid(romStart + 5, romEnd - romStart - 5).trimmed();
-                QMap<QString, QString> romData = parseInlineAttributes(romBlock);
-                
-                // Create entry
-                ClrMameProEntry entry;
-                entry.gameName = gameData.value("name");
-                entry.description = gameData.value("description", gameData.value("name"));
-                entry.serial = gameData.value("serial");
-                entry.romName = romData.value("name");
-                entry.size = romData.value("size").toLongLong();
-                entry.crc32 = romData.value("crc").toUpper();
-                entry.md5 = romData.value("md5").toLower();
-                entry.sha1 = romData.value("sha1").toLower();
-                
-                // Use game-level region if present, otherwise extract from name
-                entry.region = gameData.value("region");
-                if (entry.region.isEmpty()) {
-                    QRegularExpression regionRegex(R"(\(([^)]+)\))");
-                    QRegularExpressionMatch regionMatch = regionRegex.match(entry.gameName);
-                    if (regionMatch.hasMatch()) {
-                        QString regionText = regionMatch.captured(1);
-                        // Take first region if comma-separated
-                        if (regionText.contains(',')) {
-                            entry.region = regionText.split(',').first().trimmed();
-                        } else {
-                            entry.region = regionText.trimmed();
-                        }
-                    }
-                }
-                
-                if (!entry.gameName.isEmpty() && !entry.crc32.isEmpty()) {
-                    entries.append(entry);
-                    
-                    if (matchCount <= 3) {
-                        qDebug() << "ClrMameProParser: Entry" << matchCount 
-                                 << "game:" << entry.gameName.left(30)
-                                 << "crc32:" << entry.crc32
-                                 << "size:" << entry.size;
-                    }
-                }
-            }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "ClrMameProParser: Failed to open file:" << filePath;
+        return false;
+    }
+
+    const QByteArray magic = file.peek(4);
+    if (magic.startsWith("\x1f\x8b")) {
+        QByteArray text;
+        if (!inflateGzip(file.readAll(), text)) {
+            qWarning() << "ClrMameProParser: Corrupt gzip DAT:" << filePath;
+            return false;
         }
+        parseData(text, visitor, header, progress);
+        return true;
     }
-    
-    qDebug() << "ClrMameProParser: Found" << matchCount << "game blocks, parsed" << entries.size() << "entries";
-    return entries;
+    if (magic.startsWith("PK\x03\x04")) {
+        file.close();
+        QByteArray text;
+        if (!readZippedDat(filePath, text)) {
+            return false;
+        }
+        parseData(text, visitor, header, progress);
+        return true;
+    }
+
+    const qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped) {
+        parseData(QByteArrayView(mapped, size), visitor, header, progress);
+        file.unmap(mapped);
+    } else {
+        const QByteArray data = file.readAll();
+        parseData(data, visitor, header, progress);
+    }
+    return true;
+}
+
+int ClrMameProParser::parseData(QByteArrayView data, const GameVisitor &visitor,
+                                QMap<QString, QString> *header,
+                                const ProgressCallback &progress)
+{
+    return parseBuffer(data, visitor, header, progress, false);
 }
 
-QMap<QString, QString> ClrMameProParser::extractKeyValues(const QString &block)
-{
-    QMap<QString, QString> data;
-    
-    // Match key-value pairs: key "value" or key value
-    QRegularExpression kvRegex(R"((\w+)\s+([^\n]+))");
-    QRegularExpressionMatchIterator it = kvRegex.globalMatch(block);
-    
-    while (it.hasNext()) {
-        QRegularExpressionMatch match = it.next();
-        QString key = match.captured(1).trimmed();
-        QString value = match.captured(2).trimmed();
-        
-        // Remove quotes if present
-        if (value.startsWith('"') && value.endsWith('"')) {
-            value = value.mid(1, value.length() - 2);
-        }
-        
-        data[key] = value;
-    }
-    
-    return data;
-}
-
-QMap<QString, QString> ClrMameProParser::parseInlineAttributes(const QString &line)
-{
-    QMap<QString, QString> data;
-    
-    int i = 0;
-    while (i < line.length()) {
-        // Skip whitespace
-        while (i < line.length() && line[i].isSpace()) {
-            i++;
-        }
-        
-        if (i >= line.length()) break;
-        
-        // Extract key (alphanumeric word)
-        int keyStart = i;
-        while (i < line.length() && (line[i].isLetterOrNumber() || line[i] == '_')) {
-            i++;
-        }
-        QString key = line.mid(keyStart, i - keyStart);
-        
-        // Skip whitespace after key
-        while (i < line.length() && line[i].isSpace()) {
-            i++;
-        }
-        
-        if (i >= line.length()) break;
-        
-        // Extract value (quoted string or unquoted word)
-        QString value;
-        if (line[i] == '"') {
-            // Quoted string
-            i++; // Skip opening quote
-            int valueStart = i;
-            while (i < line.length() && line[i] != '"') {
-                i++;
+int ClrMameProParser::parseBuffer(QByteArrayView data, const GameVisitor &visitor,
+                                  QMap<QString, QString> *header,
+                                  const ProgressCallback &progress, bool headerOnly)
+{
+    using Token = ClrMameProTokenizer::Token;
+    ClrMameProTokenizer tokens(data);
+    const qint64 total = data.size();
+    qint64 nextProgress = PROGRESS_INTERVAL;
+    int games = 0;
+
+    ClrMameProGameView game;
+    for (Token token = tokens.next(); token != Token::End; token = tokens.next()) {
+        if (token != Token::Word) {
+            continue;  // Stray value or parenthesis at top level
+        }
+        const QByteArrayView key = tokens.text();
+        if (tokens.next() != Token::Open) {
+            continue;
+        }
+
+        if (key == "clrmamepro") {
+            if (header) {
+                readPairs(tokens, [header](QByteArrayView k, QByteArrayView value) {
+                    header->insert(toString(k), toString(value));
+                });
+            } else {
+                skipBlock(tokens);
             }
-            value = line.mid(valueStart, i - valueStart);
-            if (i < line.length()) i++; // Skip closing quote
-        } else {
-            // Unquoted value (number or hex)
-            int valueStart = i;
-            while (i < line.length() && !line[i].isSpace()) {
-                i++;
+            if (headerOnly) {
+                break;
             }
-            value = line.mid(valueStart, i - valueStart);
+        } else if (key == "game" || key == "machine" || key == "resource") {
+            if (headerOnly) {
+                break;  // The header always precedes the first game
+            }
+            game.name = game.description = game.region = game.serial = QByteArrayView();
+            game.roms.clear();
+            readGame(tokens, game);
+            ++games;
+            if (visitor) {
+                visitor(game);
+            }
+        } else {
+            skipBlock(tokens);
         }
-        
-        if (!key.isEmpty()) {
-            data[key] = value;
+
+        if (progress && tokens.position() >= nextProgress) {
+            progress(tokens.position(), total);
+            nextProgress = tokens.position() + PROGRESS_INTERVAL;
         }
     }
-    
-    return data;
+
+    if (progress && !headerOnly) {
+        progress(total, total);
+    }
+    return games;
 }
 
-QString ClrMameProParser::extractQuoted(const QString &text)
+void ClrMameProParser::appendEntries(const ClrMameProGameView &game, QList<ClrMameProEntry> &entries)
 {
-    QString trimmed = text.trimmed();
-    if (trimmed.startsWith('"') && trimmed.endsWith('"')) {
-        return trimmed.mid(1, trimmed.length() - 2);
+    if (game.name.isEmpty()) {
+        return;
+    }
+
+    const QString gameName = toString(game.name);
+    const QString description = game.description.isEmpty() ? gameName : toString(game.description);
+    const QString region = game.region.isEmpty() ? regionFromName(gameName) : toString(game.region);
+    const QString gameSerial = toString(game.serial);
+
+    for (const ClrMameProRomView &rom : game.roms) {
+        if (rom.crc.isEmpty() && rom.md5.isEmpty() && rom.sha1.isEmpty()) {
+            continue;  // Nothing to match against
+        }
+
+        ClrMameProEntry entry;
+        entry.gameName = gameName;
+        entry.description = description;
+        entry.region = region;
+        entry.serial = gameSerial.isEmpty() ? toString(rom.serial) : gameSerial;
+        entry.romName = toString(rom.name);
+        entry.size = parseSize(rom.size);
+        entry.crc32 = QString::fromLatin1(rom.crc).toUpper();
+        entry.md5 = QString::fromLatin1(rom.md5).toLower();
+        entry.sha1 = QString::fromLatin1(rom.sha1).toLower();
+        entries.append(entry);
+    }
+}
+
+QString ClrMameProParser::regionFromName(const QString &gameName)
+{
+    qsizetype open = gameName.indexOf(QLatin1Char('('));
+    while (open != -1) {
+        const qsizetype close = gameName.indexOf(QLatin1Char(')'), open + 1);
+        if (close == -1) {
+            break;
+        }
+        if (close > open + 1) {
+            // Take first region if comma-separated
+            QStringView inside = QStringView(gameName).mid(open + 1, close - open - 1);
+            const qsizetype comma = inside.indexOf(QLatin1Char(','));
+            if (comma != -1) {
+                inside = inside.left(comma);
+            }
+            return inside.trimmed().toString();
+        }
+        open = gameName.indexOf(QLatin1Char('('), close + 1);
     }
-    return trimmed;
+    return QString();
 }
 
 } // namespace Remus
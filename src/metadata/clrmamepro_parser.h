@@ -1,30 +1,87 @@
 #ifndef REMUS_CLRMAMEPRO_PARSER_H
 #define REMUS_CLRMAMEPRO_PARSER_H
 
+#include "../core/dat_parser.h"
+#include <QByteArrayView>
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QVarLengthArray>
+#include <functional>
 
 namespace Remus {
 
 /**
  * @brief ClrMamePro DAT entry (used by libretro-database)
+ *
+ * The parser fills region (from the game or its name) and serial; CRC32 is
+ * upper case and MD5/SHA1 lower case. status is not used.
  */
-struct ClrMameProEntry {
-    QString gameName;       // Game name
-    QString description;    // Description
-    QString region;         // Extracted from name (e.g., "USA", "Europe")
-    QString romName;        // ROM filename
-    qint64 size = 0;        // File size
-    QString crc32;          // CRC32 hash
-    QString md5;            // MD5 hash
-    QString sha1;           // SHA1 hash
-    QString serial;         // Serial number
+using ClrMameProEntry = DatRomEntry;
+
+/**
+ * @brief One rom (or disk) line of a game block, as views into the DAT bytes
+ */
+struct ClrMameProRomView {
+    QByteArrayView name;
+    QByteArrayView size;
+    QByteArrayView crc;
+    QByteArrayView md5;
+    QByteArrayView sha1;
+    QByteArrayView serial;
+};
+
+/**
+ * @brief One game block, as views into the DAT bytes
+ *
+ * Views point into the buffer being parsed and are only valid for the
+ * duration of the visitor call that receives them.
+ */
+struct ClrMameProGameView {
+    QByteArrayView name;
+    QByteArrayView description;
+    QByteArrayView region;
+    QByteArrayView serial;
+    QVarLengthArray<ClrMameProRomView, 8> roms;
+};
+
+/**
+ * @brief Single-pass tokenizer for ClrMamePro text
+ *
+ * Splits the input into parentheses, bare words and quoted strings
+ * (returned without their quotes). Never copies: text() views the input.
+ */
+class ClrMameProTokenizer
+{
+public:
+    enum class Token { End, Open, Close, Word, String };
+
+    explicit ClrMameProTokenizer(QByteArrayView data);
+
+    /**
+     * @brief Advance to the next token
+     */
+    Token next();
+
+    /**
+     * @brief Text of the current Word or String token
+     */
+    QByteArrayView text() const { return m_text; }
+
+    /**
+     * @brief Byte offset just past the current token
+     */
+    qsizetype position() const { return m_pos; }
+
+private:
+    QByteArrayView m_data;
+    QByteArrayView m_text;
+    qsizetype m_pos = 0;
 };
 
 /**
  * @brief Parser for ClrMamePro format DAT files
- * 
+ *
  * Used by libretro-database (GitHub: libretro/libretro-database)
  * Format:
  *   clrmamepro (
@@ -36,17 +93,31 @@ struct ClrMameProEntry {
  *     description "..."
  *     rom ( name "file.bin" size 524288 crc F9394E97 md5 ... sha1 ... )
  *   )
+ *
+ * Files are tokenized in one pass straight from a memory mapping; gzip
+ * (.dat.gz) and zipped DATs are decompressed in memory first. Every rom of
+ * a game is reported, so multi-track games keep all their tracks.
  */
 class ClrMameProParser
 {
 public:
+    using GameVisitor = std::function<void(const ClrMameProGameView &game)>;
+    using ProgressCallback = std::function<void(qint64 bytesParsed, qint64 totalBytes)>;
+
+    /// Bytes parsed between progress callbacks
+    static constexpr qint64 PROGRESS_INTERVAL = 1024 * 1024;
+
     /**
      * @brief Parse a ClrMamePro DAT file
-     * @param filePath Path to .dat file
-     * @return List of game entries
+     * @param filePath Path to .dat, .dat.gz or .zip file
+     * @param header Optional; receives the clrmamepro header fields
+     * @param progress Optional progress callback
+     * @return One entry per rom that carries a hash
      */
-    static QList<ClrMameProEntry> parse(const QString &filePath);
-    
+    static QList<ClrMameProEntry> parse(const QString &filePath,
+                                        QMap<QString, QString> *header = nullptr,
+                                        const ProgressCallback &progress = nullptr);
+
     /**
      * @brief Parse header section
      * @param filePath Path to .dat file
@@ -54,34 +125,36 @@ public:
      */
     static QMap<QString, QString> parseHeader(const QString &filePath);
 
-private:
     /**
-     * @brief Parse game blocks from content
-     * @param content DAT file content
-     * @return List of entries
+     * @brief Stream every game of a DAT file to a visitor
+     * @return False if the file could not be opened or decompressed
      */
-    static QList<ClrMameProEntry> parseGameBlocks(const QString &content);
-    
+    static bool parseFile(const QString &filePath, const GameVisitor &visitor,
+                          QMap<QString, QString> *header = nullptr,
+                          const ProgressCallback &progress = nullptr);
+
     /**
-     * @brief Extract values from a parenthetical block
-     * @param block Text between parentheses
-     * @return Map of key->value pairs
+     * @brief Stream every game of in-memory DAT text to a visitor
+     * @return Number of game blocks visited
      */
-    static QMap<QString, QString> extractKeyValues(const QString &block);
-    
+    static int parseData(QByteArrayView data, const GameVisitor &visitor,
+                         QMap<QString, QString> *header = nullptr,
+                         const ProgressCallback &progress = nullptr);
+
     /**
-     * @brief Parse inline attributes from a single line (for ROM blocks)
-     * @param line Single-line attribute string (e.g., 'name "file.md" size 524288 crc ABC123')
-     * @return Map of key->value pairs
+     * @brief Turn each hashed rom of a game into an entry
      */
-    static QMap<QString, QString> parseInlineAttributes(const QString &line);
-    
+    static void appendEntries(const ClrMameProGameView &game, QList<ClrMameProEntry> &entries);
+
     /**
-     * @brief Extract quoted string value
-     * @param text Input text with quotes
-     * @return String without quotes
+     * @brief Region from a No-Intro style name: first item of the first "(...)"
      */
-    static QString extractQuoted(const QString &text);
+    static QString regionFromName(const QString &gameName);
+
+private:
+    static int parseBuffer(QByteArrayView data, const GameVisitor &visitor,
+                           QMap<QString, QString> *header, const ProgressCallback &progress,
+                           bool headerOnly);
 };
 
 } // namespace Remus
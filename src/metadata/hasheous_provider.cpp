@@ -1,16 +1,14 @@
 #include "hasheous_provider.h"
+#include "network_client.h"
 #include "../core/constants/providers.h"
 #include "../core/constants/settings.h"
 #include "../core/constants/api.h"
 #include "../core/system_resolver.h"
 #include "../core/constants/systems.h"
 #include <QNetworkRequest>
-#include <QNetworkReply>
 #include <QUrlQuery>
 #include <QJsonDocument>
 #include <QJsonArray>
-#include <QEventLoop>
-#include <QTimer>
 #include <QDebug>
 #include <QSet>
 #include <QTimeZone>
@@ -34,14 +32,17 @@ constexpr const char *DEFAULT_CLIENT_API_KEY = "yFCtSh1zpMqwdOx27SB9huyyMPMGqLLX
 
 HasheousProvider::HasheousProvider(QObject *parent)
     : MetadataProvider(parent)
-    , m_network(new QNetworkAccessManager(this))
-    , m_rateLimiter(new RateLimiter(this))
+    , m_rateLimiter(RateLimiter::shared(Constants::Providers::HASHEOUS))
+    , m_baseUrl(QString::fromLatin1(Constants::API::HASHEOUS_BASE_URL))
 {
     QSettings settings;
     m_clientApiKey = settings.value(Constants::Settings::Providers::HASHEOUS_CLIENT_API_KEY,
                                     QString::fromLatin1(DEFAULT_CLIENT_API_KEY)).toString();
 
-    m_rateLimiter->setInterval(Constants::Network::HASHEOUS_RATE_LIMIT_MS);
+    // A batch keeps HASHEOUS_BATCH_IN_FLIGHT lookups open; the burst lets
+    // them start together while the sustained rate stays the same
+    m_rateLimiter->setRate(1000.0 / Constants::Network::HASHEOUS_RATE_LIMIT_MS,
+                           Constants::Network::HASHEOUS_BATCH_IN_FLIGHT);
     qInfo() << "Hasheous provider initialized (no auth required)";
 }
 
@@ -52,9 +53,12 @@ QString HasheousProvider::detectHashType(const QString &hash) const
 
 QJsonObject HasheousProvider::makeRequest(const QString &endpoint, const QUrlQuery &params)
 {
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return QJsonObject();
+    }
     
-    QUrl url(QString(Constants::API::HASHEOUS_BASE_URL) + endpoint);
+    QUrl url(m_baseUrl + endpoint);
     url.setQuery(params);
     
     QNetworkRequest request(url);
@@ -64,52 +68,42 @@ QJsonObject HasheousProvider::makeRequest(const QString &endpoint, const QUrlQue
         request.setRawHeader("X-Client-API-Key", m_clientApiKey.toUtf8());
     }
     
-    QNetworkReply *reply = m_network->get(request);
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::HASHEOUS_TIMEOUT_MS);
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
-    timeout.start();
-    loop.exec();
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().get(request, Constants::Network::HASHEOUS_TIMEOUT_MS));
     
     QJsonObject result;
     
-    if (!timeout.isActive()) {
+    if (reply.timedOut) {
         qWarning() << "Hasheous GET timeout:" << url.toString();
         emit errorOccurred("Hasheous request timeout");
-        reply->deleteLater();
         return result;
     }
-    timeout.stop();
     
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (reply.success) {
+        QJsonDocument doc = QJsonDocument::fromJson(reply.data);
         result = doc.object();
     } else {
-        int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-        if (statusCode == 404) {
+        if (reply.statusCode == 404) {
             qDebug() << "Hasheous API 404 (expected miss):" << url.toString();
         } else {
-            qWarning() << "Hasheous API error:" << reply->errorString()
-                        << "Status:" << statusCode
+            qWarning() << "Hasheous API error:" << reply.error
+                        << "Status:" << reply.statusCode
                         << "URL:" << url.toString();
-            emit errorOccurred("Hasheous API error: " + reply->errorString());
+            emit errorOccurred("Hasheous API error: " + reply.error);
         }
     }
     
-    reply->deleteLater();
     return result;
 }
 
 QJsonObject HasheousProvider::makePostRequest(const QString &endpoint, const QJsonObject &body, const QUrlQuery &params)
 {
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return QJsonObject();
+    }
     
-    QUrl url(QString(Constants::API::HASHEOUS_BASE_URL) + endpoint);
+    QUrl url(m_baseUrl + endpoint);
     if (!params.isEmpty()) {
         url.setQuery(params);
     }
@@ -119,46 +113,34 @@ QJsonObject HasheousProvider::makePostRequest(const QString &endpoint, const QJs
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
     QByteArray postData = QJsonDocument(body).toJson(QJsonDocument::Compact);
-    QNetworkReply *reply = m_network->post(request, postData);
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::HASHEOUS_TIMEOUT_MS);
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
-    timeout.start();
-    loop.exec();
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().post(request, postData, Constants::Network::HASHEOUS_TIMEOUT_MS));
+    m_lastStatusCode = reply.timedOut ? 0 : reply.statusCode;
     
     QJsonObject result;
     
-    if (!timeout.isActive()) {
+    if (reply.timedOut) {
         qWarning() << "Hasheous POST timeout:" << url.toString();
         emit errorOccurred("Hasheous request timeout");
-        reply->deleteLater();
         return result;
     }
-    timeout.stop();
     
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (reply.success) {
+        QJsonDocument doc = QJsonDocument::fromJson(reply.data);
         if (doc.isObject()) {
             result = doc.object();
         }
     } else {
-        int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-        if (statusCode == 404) {
+        if (reply.statusCode == 404) {
             qDebug() << "Hasheous POST 404 (expected miss):" << url.toString();
         } else {
-            qWarning() << "Hasheous POST error:" << reply->errorString()
-                        << "Status:" << statusCode
+            qWarning() << "Hasheous POST error:" << reply.error
+                        << "Status:" << reply.statusCode
                         << "URL:" << url.toString();
-            emit errorOccurred("Hasheous API error: " + reply->errorString());
+            emit errorOccurred("Hasheous API error: " + reply.error);
         }
     }
     
-    reply->deleteLater();
     return result;
 }
 
@@ -515,30 +497,33 @@ GameMetadata HasheousProvider::getByHashes(const QString &crc32,
         return GameMetadata();
     }
 
-    qInfo() << "Hasheous: Looking up hash set"
-            << "crc32=" << (crc32.isEmpty() ? "-" : crc32)
-            << "md5=" << (md5.isEmpty() ? "-" : md5)
-            << "sha1=" << (sha1.isEmpty() ? "-" : sha1);
-
-    QJsonObject body;
-    if (!crc32.isEmpty()) body["crc"] = crc32.toLower();
-    if (!md5.isEmpty()) body["mD5"] = md5.toLower();
-    if (!sha1.isEmpty()) body["shA1"] = sha1.toLower();
+    const QString key = hashSetKey({crc32, md5, sha1});
+    if (m_knownMisses.contains(key)) {
+        qDebug() << "Hasheous: Skipping hash set that missed before";
+        return GameMetadata();
+    }
 
-    QUrlQuery params;
-    params.addQueryItem("returnAllSources", "true");
-    params.addQueryItem("returnFields", "Signatures,Metadata,Attributes");
+    GameMetadata metadata = m_prefetched.take(key);
+    if (!metadata.title.isEmpty()) {
+        qDebug() << "Hasheous: Using batch lookup result for" << metadata.title;
+    } else {
+        qInfo() << "Hasheous: Looking up hash set"
+                << "crc32=" << (crc32.isEmpty() ? "-" : crc32)
+                << "md5=" << (md5.isEmpty() ? "-" : md5)
+                << "sha1=" << (sha1.isEmpty() ? "-" : sha1);
 
-    QJsonObject response = makePostRequest(Constants::API::HASHEOUS_LOOKUP_ENDPOINT, body, params);
+        m_lastStatusCode = 0;
+        QJsonObject response = makePostRequest(Constants::API::HASHEOUS_LOOKUP_ENDPOINT,
+                                               lookupBody(crc32, md5, sha1), lookupParams());
 
-    if (response.isEmpty()) {
-        qInfo() << "Hasheous: No match found for provided hashes";
-        return GameMetadata();
+        metadata = parseGameJson(response);
     }
 
-    GameMetadata metadata = parseGameJson(response);
-
     if (metadata.title.isEmpty()) {
+        // As in the batch path, only a definite answer is remembered
+        if (m_lastStatusCode == 404 || (m_lastStatusCode >= 200 && m_lastStatusCode < 300)) {
+            m_knownMisses.insert(key);
+        }
         qInfo() << "Hasheous: No match found for provided hashes";
         return GameMetadata();
     }
@@ -569,6 +554,120 @@ GameMetadata HasheousProvider::getByHashes(const QString &crc32,
     return metadata;
 }
 
+QJsonObject HasheousProvider::lookupBody(const QString &crc32, const QString &md5, const QString &sha1)
+{
+    QJsonObject body;
+    if (!crc32.isEmpty()) body["crc"] = crc32.toLower();
+    if (!md5.isEmpty()) body["mD5"] = md5.toLower();
+    if (!sha1.isEmpty()) body["shA1"] = sha1.toLower();
+    return body;
+}
+
+QUrlQuery HasheousProvider::lookupParams()
+{
+    QUrlQuery params;
+    params.addQueryItem("returnAllSources", "true");
+    params.addQueryItem("returnFields", "Signatures,Metadata,Attributes");
+    return params;
+}
+
+QString HasheousProvider::hashSetKey(const HashSet &hashes)
+{
+    return hashes.crc32.toLower() + QLatin1Char(':') + hashes.md5.toLower()
+           + QLatin1Char(':') + hashes.sha1.toLower();
+}
+
+QList<GameMetadata> HasheousProvider::getByHashesBatch(const QList<HashSet> &hashSets, int maxInFlight)
+{
+    QList<GameMetadata> results(hashSets.size());
+
+    // One request per distinct, not yet missed hash set
+    QHash<QString, QList<int>> indexesByKey;
+    QStringList keys;
+    QList<HashSet> toSend;
+    for (int i = 0; i < hashSets.size(); ++i) {
+        const HashSet &hashes = hashSets.at(i);
+        if (hashes.crc32.isEmpty() && hashes.md5.isEmpty() && hashes.sha1.isEmpty()) {
+            continue;
+        }
+        const QString key = hashSetKey(hashes);
+        if (m_knownMisses.contains(key)) {
+            continue;
+        }
+        QList<int> &indexes = indexesByKey[key];
+        if (indexes.isEmpty()) {
+            keys.append(key);
+            toSend.append(hashes);
+        }
+        indexes.append(i);
+    }
+
+    qInfo() << "Hasheous: Batch lookup of" << hashSets.size() << "files,"
+            << toSend.size() << "distinct hash sets to send";
+
+    QUrl url(m_baseUrl + Constants::API::HASHEOUS_LOOKUP_ENDPOINT);
+    url.setQuery(lookupParams());
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::UserAgentHeader, Constants::API::USER_AGENT);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    int hits = 0;
+    int misses = 0;
+    int errors = 0;
+    auto collect = [&](int sent, const NetworkResponse &reply) {
+        GameMetadata metadata;
+        if (reply.success) {
+            const QJsonDocument doc = QJsonDocument::fromJson(reply.data);
+            if (doc.isObject()) {
+                metadata = parseGameJson(doc.object());
+            }
+        } else if (reply.statusCode != 404) {
+            ++errors;
+            qWarning() << "Hasheous: Batch lookup error:" << reply.error << "Status:" << reply.statusCode;
+            return;
+        }
+
+        if (metadata.title.isEmpty()) {
+            // Only a definite answer is remembered; errors are retried next time
+            ++misses;
+            m_knownMisses.insert(keys.at(sent));
+            return;
+        }
+
+        ++hits;
+        metadata.providerId = Constants::Providers::HASHEOUS;
+        metadata.fetchedAt = QDateTime::currentDateTime();
+        m_prefetched.insert(keys.at(sent), metadata);
+        for (int index : indexesByKey.value(keys.at(sent))) {
+            results[index] = metadata;
+        }
+    };
+
+    // Sliding window: answers arrive in roughly the order asked
+    QList<QPair<int, QFuture<NetworkResponse>>> window;
+    for (int sent = 0; sent < toSend.size(); ++sent) {
+        if (window.size() >= qMax(1, maxInFlight)) {
+            const auto oldest = window.takeFirst();
+            collect(oldest.first, NetworkClient::wait(oldest.second));
+        }
+        if (!m_rateLimiter->waitIfNeeded()) {
+            emit rateLimitReached();
+            break;
+        }
+        const HashSet &hashes = toSend.at(sent);
+        const QByteArray body = QJsonDocument(lookupBody(hashes.crc32, hashes.md5, hashes.sha1))
+                                    .toJson(QJsonDocument::Compact);
+        window.append({sent, NetworkClient::shared().post(request, body,
+                                                          Constants::Network::HASHEOUS_TIMEOUT_MS)});
+    }
+    for (const auto &pending : std::as_const(window)) {
+        collect(pending.first, NetworkClient::wait(pending.second));
+    }
+
+    qInfo() << "Hasheous: Batch done:" << hits << "hits," << misses << "misses," << errors << "errors";
+    return results;
+}
+
 GameMetadata HasheousProvider::getById(const QString &id)
 {
     Q_UNUSED(id);
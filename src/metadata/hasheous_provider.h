@@ -5,10 +5,12 @@
 #include "../core/constants/hash_algorithms.h"
 #include "../core/constants/api.h"
 #include "../core/constants/providers.h"
-#include <QNetworkAccessManager>
+#include "../core/constants/network.h"
 #include <QJsonObject>
 #include <QUrlQuery>
+#include <QHash>
 #include <QMap>
+#include <QSet>
 #include <QSettings>
 
 namespace Remus {
@@ -51,11 +53,57 @@ public:
     GameMetadata getById(const QString &id) override;
     ArtworkUrls getArtwork(const QString &id) override;
 
+    /**
+     * @brief Hashes of one file (any may be empty)
+     */
+    struct HashSet {
+        QString crc32;
+        QString md5;
+        QString sha1;
+    };
+
+    /**
+     * @brief Look up many files at once
+     *
+     * The API takes one hash set per request, so lookups are pipelined
+     * instead: up to @p maxInFlight requests are kept open through the
+     * shared network client (one connection set, HTTP/2 multiplexing where
+     * the server offers it), identical hash sets are sent once, and hash
+     * sets that missed before are not sent at all. Each request still
+     * takes a rate-limiter token.
+     *
+     * Results carry the Hasheous match (title, external IDs, DAT sources,
+     * logo) without the per-game IGDB metadata fetch getByHashes() does.
+     * Hits are also kept for getByHashes(): its next lookup of the same
+     * hash set sends no lookup request and only fetches the IGDB metadata.
+     * ProviderOrchestrator::prefetchHashes() batches the match pipeline
+     * this way.
+     *
+     * @return One entry per hash set, in order; empty title for a miss or error
+     */
+    QList<GameMetadata> getByHashesBatch(const QList<HashSet> &hashSets,
+                                         int maxInFlight = Constants::Network::HASHEOUS_BATCH_IN_FLIGHT);
+
+    /**
+     * @brief Hash sets the service answered "not found" for (this session)
+     *
+     * Shared by getByHashes() and getByHashesBatch(); neither asks again.
+     */
+    int knownMissCount() const { return m_knownMisses.size(); }
+
+    /**
+     * @brief Point the provider at another server (for local test servers)
+     */
+    void setBaseUrl(const QString &baseUrl) { m_baseUrl = baseUrl; }
+
 protected:
-    QNetworkAccessManager *m_network;
     RateLimiter *m_rateLimiter;
     QString m_clientApiKey;
+    QString m_baseUrl;
     QMap<int, QString> m_companyCache;
+    QSet<QString> m_knownMisses;       // hashSetKey()s answered 404 or empty
+    QHash<QString, GameMetadata> m_prefetched;  // Batch hits by hashSetKey(), until getByHashes() takes them
+    int m_lastStatusCode = 0;          // HTTP status of the last request (0: none or timeout)
 
     /**
      * @brief Detect hash type from hash string length
@@ -96,6 +144,16 @@ protected:
     virtual GameMetadata fetchIgdbMetadata(int igdbId);
 
 private:
+    /**
+     * @brief Request body and query of a hash lookup
+     */
+    static QJsonObject lookupBody(const QString &crc32, const QString &md5, const QString &sha1);
+    static QUrlQuery lookupParams();
+
+    /**
+     * @brief Identity of a hash set for deduplication and the miss set
+     */
+    static QString hashSetKey(const HashSet &hashes);
 };
 
 } // namespace Remus
@@ -1,14 +1,12 @@
 #include "igdb_provider.h"
+#include "network_client.h"
 #include "../core/system_resolver.h"
 #include "../core/constants/providers.h"
 #include <QNetworkRequest>
-#include <QNetworkReply>
 #include <QUrlQuery>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QEventLoop>
-#include <QTimer>
 #include <QDebug>
 #include "../core/constants/constants.h"
 
@@ -16,10 +14,10 @@ namespace Remus {
 
 IGDBProvider::IGDBProvider(QObject *parent)
     : MetadataProvider(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
-    , m_rateLimiter(new RateLimiter(this))
+    , m_rateLimiter(RateLimiter::shared(Constants::Providers::IGDB))
 {
-    m_rateLimiter->setInterval(Constants::Network::IGDB_RATE_LIMIT_MS);
+    m_rateLimiter->setRate(1000.0 / Constants::Network::IGDB_RATE_LIMIT_MS,
+                           Constants::Network::IGDB_RATE_BURST);
 }
 
 void IGDBProvider::setCredentials(const QString &clientId, const QString &clientSecret)
@@ -46,37 +44,25 @@ bool IGDBProvider::authenticate()
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
 
-    QNetworkReply *reply = m_networkManager->post(request, query.toString().toUtf8());
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::IGDB_TIMEOUT_MS);
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
-    timeout.start();
-    loop.exec();
-
-    if (!timeout.isActive()) {
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().post(request, query.toString().toUtf8(), Constants::Network::IGDB_TIMEOUT_MS));
+
+    if (reply.timedOut) {
         qWarning() << "IGDB: authentication request timed out";
-        reply->deleteLater();
         return false;
     }
-    timeout.stop();
 
-    if (reply->error() == QNetworkReply::NoError) {
-        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+    if (reply.success) {
+        QJsonDocument doc = QJsonDocument::fromJson(reply.data);
         QJsonObject obj = doc.object();
         
         m_accessToken = obj["access_token"].toString();
         int expiresIn = obj["expires_in"].toInt();
         m_tokenExpiry = QDateTime::currentDateTime().addSecs(expiresIn);
         
-        reply->deleteLater();
         return true;
     }
 
-    reply->deleteLater();
     return false;
 }
 
@@ -91,7 +77,10 @@ QList<SearchResult> IGDBProvider::searchByName(const QString &title,
         return results;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return results;
+    }
 
     // Build IGDB query (using Apicalypse query language)
     QString body = QString("search \"%1\"; fields name,first_release_date,platforms; limit 10;")
@@ -145,7 +134,10 @@ GameMetadata IGDBProvider::getById(const QString &id)
         return metadata;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return metadata;
+    }
 
     QString body = QString("fields name,summary,genres.name,first_release_date,"
                            "involved_companies.company.name,involved_companies.developer,"
@@ -176,7 +168,10 @@ ArtworkUrls IGDBProvider::getArtwork(const QString &id)
         return artwork;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return artwork;
+    }
 
     QString body = QString("fields cover.url,screenshots.url,artworks.url; where id = %1;").arg(id);
 
@@ -223,35 +218,22 @@ IGDBProvider::ApiResponse IGDBProvider::makeRequest(const QString &endpoint, con
     request.setRawHeader("Authorization", QString("Bearer %1").arg(m_accessToken).toUtf8());
     request.setHeader(QNetworkRequest::ContentTypeHeader, "text/plain");
 
-    QNetworkReply *reply = m_networkManager->post(request, body.toUtf8());
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::IGDB_TIMEOUT_MS);
-
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
-
-    timeout.start();
-    loop.exec();
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().post(request, body.toUtf8(), Constants::Network::IGDB_TIMEOUT_MS));
 
-    if (timeout.isActive()) {
-        timeout.stop();
-        
-        if (reply->error() == QNetworkReply::NoError) {
+    if (!reply.timedOut) {
+        if (reply.success) {
             response.success = true;
-            response.data = reply->readAll();
+            response.data = reply.data;
         } else {
             response.success = false;
-            response.error = reply->errorString();
+            response.error = reply.error;
         }
     } else {
         response.success = false;
         response.error = Constants::Errors::MetadataProvider::REQUEST_TIMEOUT;
     }
 
-    reply->deleteLater();
     return response;
 }
 
@@ -4,7 +4,6 @@
 #include "metadata_provider.h"
 #include "rate_limiter.h"
 #include "../core/constants/providers.h"
-#include <QNetworkAccessManager>
 
 namespace Remus {
 
@@ -49,7 +48,6 @@ private:
     GameMetadata parseGameJson(const QJsonObject &game);
     QString mapSystemToIGDB(const QString &system);
 
-    QNetworkAccessManager *m_networkManager;
     RateLimiter *m_rateLimiter;
     QString m_clientId;
     QString m_clientSecret;
@@ -1,7 +1,13 @@
 #include "local_database_provider.h"
+#include "../core/system_resolver.h"
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFileInfo>
 #include <QRegularExpression>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
 #include <QDebug>
 
 namespace Remus {
@@ -9,6 +15,10 @@ namespace Remus {
 LocalDatabaseProvider::LocalDatabaseProvider(QObject *parent)
     : MetadataProvider(parent)
 {
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty()) {
+        m_indexDirectory = cacheDir + "/" + INDEX_DIRECTORY_NAME;
+    }
     qDebug() << "LocalDatabaseProvider: Initialized";
 }
 
@@ -26,23 +36,22 @@ int LocalDatabaseProvider::loadDatabases(const QString &directory)
     }
     
     QStringList filters;
-    filters << "*.dat";
+    filters << "*.dat" << "*.dat.gz" << "*.zip";
     QFileInfoList datFiles = dir.entryInfoList(filters, QDir::Files);
     
     qDebug() << "LocalDatabaseProvider: Found" << datFiles.size() << "DAT files in" << directory;
     
-    int totalLoaded = 0;
-    int current = 0;
-    int total = datFiles.size();
-    
-    for (const QFileInfo &fileInfo : datFiles) {
-        current++;
-        emit loadingProgress(current, total);
-        
-        int loaded = loadDatabase(fileInfo.absoluteFilePath());
-        totalLoaded += loaded;
+    if (lazyLoading()) {
+        QMutexLocker locker(&m_mutex);
+        for (const QFileInfo &fileInfo : datFiles) {
+            m_pendingDats.insert(fileInfo.baseName(), fileInfo.absoluteFilePath());
+        }
+        qDebug() << "LocalDatabaseProvider: Deferred" << datFiles.size() << "databases until first use";
+        return 0;
     }
     
+    int totalLoaded = loadFiles(datFiles);
+    
     qDebug() << "LocalDatabaseProvider: Loaded" << totalLoaded << "total entries from" << datFiles.size() << "databases";
     return totalLoaded;
 }
@@ -50,45 +59,262 @@ int LocalDatabaseProvider::loadDatabases(const QString &directory)
 int LocalDatabaseProvider::loadDatabase(const QString &filePath)
 {
     QFileInfo fileInfo(filePath);
-    QString systemName = fileInfo.baseName(); // e.g., "Sega - Mega Drive - Genesis"
+    qDebug() << "LocalDatabaseProvider: Loading" << fileInfo.baseName() << "from" << filePath;
+    return registerDat(fileInfo, openDat(fileInfo));
+}
+
+int LocalDatabaseProvider::loadFiles(const QFileInfoList &files)
+{
+    if (files.isEmpty()) {
+        return 0;
+    }
     
-    qDebug() << "LocalDatabaseProvider: Loading" << systemName << "from" << filePath;
+    // Indexes are opened (or compiled) on the pool and registered here in
+    // list order, so DAT precedence and signals do not depend on timing
+    QThreadPool pool;
+    pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), MAX_LOAD_THREADS));
+    QFuture<LoadedDat> opened = QtConcurrent::mapped(&pool, files,
+        [this](const QFileInfo &fileInfo) { return openDat(fileInfo); });
     
-    // Parse ClrMamePro DAT file
-    QMap<QString, QString> header = ClrMameProParser::parseHeader(filePath);
-    QList<ClrMameProEntry> entries = ClrMameProParser::parse(filePath);
+    int totalLoaded = 0;
+    for (int i = 0; i < files.size(); ++i) {
+        totalLoaded += registerDat(files.at(i), opened.resultAt(i));
+        emit loadingProgress(i + 1, files.size());
+    }
+    return totalLoaded;
+}
+
+int LocalDatabaseProvider::registerDat(const QFileInfo &fileInfo, const LoadedDat &dat)
+{
+    const QString filePath = fileInfo.absoluteFilePath();
+    const QString systemName = dat.systemName; // e.g., "Sega - Mega Drive - Genesis"
+    const std::shared_ptr<const DatIndex> &index = dat.index;
     
-    if (entries.isEmpty()) {
+    if (!index || index->entryCount() == 0) {
         qWarning() << "LocalDatabaseProvider: No entries parsed from" << filePath;
+        // Don't retry an unusable DAT on every lookup
+        QMutexLocker locker(&m_mutex);
+        if (m_pendingDats.value(systemName) == filePath) {
+            m_pendingDats.remove(systemName);
+        }
         return 0;
     }
-    
-    // Index entries
-    indexEntries(entries, systemName);
-    
-    // Update statistics
-    m_systemStats[systemName] = entries.size();
-    m_totalEntries += entries.size();
+    const int entryCount = index->entryCount();
     
     // Store DAT metadata
     DatMetadata metadata;
-    metadata.name = header.value("name", systemName);
-    metadata.version = header.value("version", "unknown");
-    metadata.description = header.value("description", "");
+    metadata.name = index->datName().isEmpty() ? systemName : index->datName();
+    metadata.version = index->datVersion().isEmpty() ? QString("unknown") : index->datVersion();
+    metadata.description = index->datDescription();
     metadata.filePath = filePath;
     metadata.loadedAt = QDateTime::currentDateTime();
-    metadata.entryCount = entries.size();
+    metadata.entryCount = entryCount;
     
     QMutexLocker locker(&m_mutex);
+    // A reload replaces the system's previous index
+    bool replaced = false;
+    for (LoadedDat &loaded : m_dats) {
+        if (loaded.systemName == systemName) {
+            m_totalEntries -= loaded.index->entryCount();
+            loaded = dat;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        m_dats.append(dat);
+    }
+    m_pendingDats.remove(systemName);
+    m_systemStats[systemName] = entryCount;
+    m_totalEntries += entryCount;
     m_datMetadata[systemName] = metadata;
     locker.unlock();
     
-    emit databaseLoaded(systemName, entries.size());
+    emit databaseLoaded(systemName, entryCount);
+    
+    qDebug() << "LocalDatabaseProvider: Indexed" << entryCount << "entries for" << systemName
+             << "(Version:" << metadata.version << ", mapped:" << index->isMapped() << ")";
+    
+    return entryCount;
+}
+
+void LocalDatabaseProvider::setLazyLoading(bool lazy)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lazyLoading = lazy;
+}
+
+bool LocalDatabaseProvider::lazyLoading() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lazyLoading;
+}
+
+QStringList LocalDatabaseProvider::pendingSystems() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pendingDats.keys();
+}
+
+void LocalDatabaseProvider::loadPending(const QString &system)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_pendingDats.isEmpty()) {
+            return;
+        }
+    }
+    
+    // Whoever waited here finds the DATs it needs already opened
+    QMutexLocker loadLocker(&m_pendingLoadMutex);
+    QFileInfoList files;
+    {
+        QMutexLocker locker(&m_mutex);
+        const QString datSystem = datSystemFor(system);
+        if (!datSystem.isEmpty()) {
+            if (m_pendingDats.contains(datSystem)) {
+                files.append(QFileInfo(m_pendingDats.value(datSystem)));
+            }
+        } else {
+            for (const QString &path : std::as_const(m_pendingDats)) {
+                files.append(QFileInfo(path));
+            }
+        }
+    }
+    if (files.isEmpty()) {
+        return;
+    }
+    
+    qDebug() << "LocalDatabaseProvider: Opening" << files.size() << "deferred databases for"
+             << (system.isEmpty() ? QString("all systems") : system);
+    loadFiles(files);
+}
+
+QString LocalDatabaseProvider::datSystemFor(const QString &system) const
+{
+    if (system.isEmpty()) {
+        return QString();
+    }
     
-    qDebug() << "LocalDatabaseProvider: Indexed" << entries.size() << "entries for" << systemName
-             << "(Version:" << metadata.version << ")";
+    const QString libretroName = SystemResolver::libretroName(SystemResolver::systemIdByName(system));
+    for (const QString &candidate : {system, libretroName}) {
+        if (candidate.isEmpty()) {
+            continue;
+        }
+        for (auto it = m_pendingDats.cbegin(); it != m_pendingDats.cend(); ++it) {
+            if (it.key().compare(candidate, Qt::CaseInsensitive) == 0) {
+                return it.key();
+            }
+        }
+        for (const LoadedDat &dat : m_dats) {
+            if (dat.systemName.compare(candidate, Qt::CaseInsensitive) == 0) {
+                return dat.systemName;
+            }
+        }
+    }
+    return QString();
+}
+
+void LocalDatabaseProvider::setIndexDirectory(const QString &directory)
+{
+    QMutexLocker locker(&m_mutex);
+    m_indexDirectory = directory;
+}
+
+QString LocalDatabaseProvider::indexDirectory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_indexDirectory;
+}
+
+QString LocalDatabaseProvider::indexPathFor(const QFileInfo &datFile) const
+{
+    const QString directory = indexDirectory();
+    if (directory.isEmpty()) {
+        return QString();
+    }
+    // DATs of the same name in different directories get separate indexes
+    const QByteArray pathHash = QCryptographicHash::hash(
+        datFile.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+    return directory + "/" + datFile.completeBaseName() + "-" + QString::fromLatin1(pathHash)
+           + DatIndex::FILE_SUFFIX;
+}
+
+std::shared_ptr<const DatIndex> LocalDatabaseProvider::openIndex(const QFileInfo &datFile) const
+{
+    const QString indexPath = indexPathFor(datFile);
+    QString error;
+    if (!indexPath.isEmpty() && QFileInfo::exists(indexPath)) {
+        if (std::shared_ptr<const DatIndex> mapped = DatIndex::map(indexPath, datFile, &error)) {
+            return mapped;
+        }
+        qDebug() << "LocalDatabaseProvider: Recompiling" << indexPath << "-" << error;
+    }
+
+    const QString datPath = datFile.absoluteFilePath();
+    QMap<QString, QString> header;
+    const QList<ClrMameProEntry> entries = ClrMameProParser::parse(datPath, &header);
+    if (entries.isEmpty()) {
+        return nullptr;
+    }
+    const QByteArray image = DatIndex::compile(entries, header, datFile);
+
+    if (!indexPath.isEmpty()) {
+        if (DatIndex::write(image, indexPath, &error)) {
+            if (std::shared_ptr<const DatIndex> mapped = DatIndex::map(indexPath, datFile, &error)) {
+                return mapped;
+            }
+        }
+        qWarning() << "LocalDatabaseProvider: Index cache unavailable, keeping"
+                   << datFile.fileName() << "in memory:" << error;
+    }
+    return DatIndex::fromImage(image);
+}
+
+LocalDatabaseProvider::LoadedDat LocalDatabaseProvider::openDat(const QFileInfo &datFile) const
+{
+    LoadedDat dat;
+    dat.systemName = datFile.baseName();
+    dat.index = openIndex(datFile);
+    if (dat.index) {
+        dat.titles = TitleIndex::build(*dat.index);
+    }
+    return dat;
+}
+
+bool LocalDatabaseProvider::findByHash(const QString &hash, ClrMameProEntry &entry,
+                                       const QString &datSystem) const
+{
+    auto search = [&hash, &entry](const LoadedDat &dat) {
+        const int index = dat.index->find(hash);
+        if (index >= 0) {
+            entry = dat.index->entry(index);
+            return true;
+        }
+        return false;
+    };
+    
+    if (!datSystem.isEmpty()) {
+        for (const LoadedDat &dat : m_dats) {
+            if (dat.systemName == datSystem) {
+                if (search(dat)) {
+                    return true;
+                }
+                break;
+            }
+        }
+    }
     
-    return entries.size();
+    // Otherwise later DATs take precedence, as they did when all shared one hash table
+    for (auto it = m_dats.crbegin(); it != m_dats.crend(); ++it) {
+        if (!datSystem.isEmpty() && it->systemName == datSystem) {
+            continue;
+        }
+        if (search(*it)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 QMap<QString, int> LocalDatabaseProvider::getDatabaseStats() const
@@ -101,98 +327,80 @@ QList<SearchResult> LocalDatabaseProvider::searchByName(const QString &title,
                                                          const QString &system,
                                                          const QString &region)
 {
-    QMutexLocker locker(&m_mutex);
-    QList<SearchResult> results;
+    loadPending(system);
     
     // Name-based search in local database is less accurate
     // We primarily rely on hash-based matching
     // This is a fallback for when no hash is available
     
-    QString searchLower = title.toLower();
-    
-    // Search CRC32 index (most entries)
-    for (auto it = m_crc32Index.constBegin(); it != m_crc32Index.constEnd(); ++it) {
-        const ClrMameProEntry &entry = it.value();
-        
-        // Simple substring matching
-        if (entry.gameName.toLower().contains(searchLower)) {
-            SearchResult result;
-            result.id = entry.crc32; // Use CRC32 as ID
-            result.title = entry.gameName;
-            result.system = system;
-            
-            // Calculate match score
-            if (entry.gameName.toLower() == searchLower) {
-                result.matchScore = 1.0f; // Exact match
-            } else if (entry.gameName.toLower().startsWith(searchLower)) {
-                result.matchScore = 0.9f; // Starts with
-            } else {
-                result.matchScore = 0.7f; // Contains
-            }
-            
-            // Filter by region if specified (extract from gameName)
-            if (!region.isEmpty()) {
-                if (!entry.gameName.contains(region, Qt::CaseInsensitive)) {
-                    continue; // Skip non-matching regions
-                }
-            }
-            
-            results.append(result);
-            
-            if (results.size() >= 10) {
-                break; // Limit results
+    // Indexes are immutable once loaded, so search them outside the lock
+    QList<LoadedDat> dats;
+    {
+        QMutexLocker locker(&m_mutex);
+        const QString datSystem = datSystemFor(system);
+        for (const LoadedDat &dat : std::as_const(m_dats)) {
+            if (datSystem.isEmpty() || dat.systemName == datSystem) {
+                dats.append(dat);
             }
         }
     }
     
-    // Sort by match score
-    std::sort(results.begin(), results.end(), [](const SearchResult &a, const SearchResult &b) {
-        return a.matchScore > b.matchScore;
+    TitleIndex::Filter regionFilter;
+    if (!region.isEmpty()) {
+        regionFilter = [&region](const QString &gameName) {
+            return gameName.contains(region, Qt::CaseInsensitive);
+        };
+    }
+    
+    // Best titles of each DAT, then the best of those overall
+    struct RankedMatch {
+        TitleIndex::Match match;
+        const LoadedDat *dat;
+    };
+    QList<RankedMatch> ranked;
+    for (const LoadedDat &dat : std::as_const(dats)) {
+        for (const TitleIndex::Match &match : dat.titles->search(title, MAX_SEARCH_RESULTS, regionFilter)) {
+            ranked.append({match, &dat});
+        }
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const RankedMatch &a, const RankedMatch &b) {
+        return a.match.score > b.match.score;
     });
     
+    QList<SearchResult> results;
+    for (const RankedMatch &ranking : std::as_const(ranked)) {
+        if (results.size() >= MAX_SEARCH_RESULTS) {
+            break;
+        }
+        const ClrMameProEntry entry = ranking.dat->index->entry(ranking.match.entry);
+        SearchResult result;
+        result.id = entry.crc32; // Use CRC32 as ID
+        result.title = entry.gameName;
+        result.system = system.isEmpty() ? ranking.dat->systemName : system;
+        result.region = entry.region;
+        result.matchScore = ranking.match.score;
+        results.append(result);
+    }
+    
     qDebug() << "LocalDatabaseProvider: Name search for" << title << "found" << results.size() << "results";
     return results;
 }
 
 GameMetadata LocalDatabaseProvider::getByHash(const QString &hash, const QString &system)
 {
+    // Lazy mode: open the system's DAT on first use
+    loadPending(system);
     QMutexLocker locker(&m_mutex);
     
-    QString normalizedHash = normalizeHash(hash);
+    // The hex length selects CRC32 (8), MD5 (32) or SHA1 (40)
     ClrMameProEntry entry;
-    bool found = false;
-    
-    // Try CRC32 first (most common for cartridges)
-    if (normalizedHash.length() == 8) {
-        if (m_crc32Index.contains(normalizedHash)) {
-            entry = m_crc32Index.value(normalizedHash);
-            found = true;
-            qDebug() << "LocalDatabaseProvider: CRC32 match found:" << entry.gameName;
-        }
-    }
-    // Try MD5 (32 chars)
-    else if (normalizedHash.length() == 32) {
-        if (m_md5Index.contains(normalizedHash)) {
-            entry = m_md5Index.value(normalizedHash);
-            found = true;
-            qDebug() << "LocalDatabaseProvider: MD5 match found:" << entry.gameName;
-        }
-    }
-    // Try SHA1 (40 chars)
-    else if (normalizedHash.length() == 40) {
-        if (m_sha1Index.contains(normalizedHash)) {
-            entry = m_sha1Index.value(normalizedHash);
-            found = true;
-            qDebug() << "LocalDatabaseProvider: SHA1 match found:" << entry.gameName;
-        }
-    }
-    
-    if (found) {
+    if (findByHash(hash, entry, datSystemFor(system))) {
+        qDebug() << "LocalDatabaseProvider: Hash match found:" << entry.gameName;
         return datEntryToMetadata(entry);
     }
     
     // Not found
-    qDebug() << "LocalDatabaseProvider: No hash match for" << normalizedHash.left(8) << "...";
+    qDebug() << "LocalDatabaseProvider: No hash match for" << hash.trimmed().left(8) << "...";
     return GameMetadata();
 }
 
@@ -210,41 +418,6 @@ ArtworkUrls LocalDatabaseProvider::getArtwork(const QString &id)
     return ArtworkUrls();
 }
 
-void LocalDatabaseProvider::indexEntries(const QList<ClrMameProEntry> &entries, const QString &systemName)
-{
-    QMutexLocker locker(&m_mutex);
-    
-    int crc32Count = 0, md5Count = 0, sha1Count = 0;
-    
-    for (const ClrMameProEntry &entry : entries) {
-        // Index by CRC32 (primary for cartridges)
-        if (!entry.crc32.isEmpty()) {
-            QString normalized = normalizeHash(entry.crc32);
-            m_crc32Index[normalized] = entry;
-            crc32Count++;
-        }
-        
-        // Index by MD5 (discs)
-        if (!entry.md5.isEmpty()) {
-            QString normalized = normalizeHash(entry.md5);
-            m_md5Index[normalized] = entry;
-            md5Count++;
-        }
-        
-        // Index by SHA1 (discs)
-        if (!entry.sha1.isEmpty()) {
-            QString normalized = normalizeHash(entry.sha1);
-            m_sha1Index[normalized] = entry;
-            sha1Count++;
-        }
-    }
-    
-    qDebug() << "LocalDatabaseProvider:" << systemName 
-             << "- CRC32:" << crc32Count 
-             << "MD5:" << md5Count 
-             << "SHA1:" << sha1Count;
-}
-
 GameMetadata LocalDatabaseProvider::datEntryToMetadata(const ClrMameProEntry &entry) const
 {
     GameMetadata metadata;
@@ -296,12 +469,6 @@ GameMetadata LocalDatabaseProvider::datEntryToMetadata(const ClrMameProEntry &en
     return metadata;
 }
 
-QString LocalDatabaseProvider::normalizeHash(const QString &hash) const
-{
-    // Remove spaces, convert to uppercase
-    return hash.trimmed().toUpper().remove(' ');
-}
-
 QList<DatMetadata> LocalDatabaseProvider::getLoadedDats() const
 {
     QMutexLocker locker(&m_mutex);
@@ -354,25 +521,16 @@ int LocalDatabaseProvider::reloadDatabase(const QString &filePath)
         return -1;
     }
     
-    // Clear existing entries for this system
-    QMutexLocker locker(&m_mutex);
-    if (m_datMetadata.contains(systemName)) {
-        int oldCount = m_datMetadata[systemName].entryCount;
-        m_totalEntries -= oldCount;
-        
-        // Remove from indexes (would need to track system per entry for proper cleanup)
-        // For now, we'll just reload everything
-        qWarning() << "LocalDatabaseProvider: Clearing" << oldCount << "old entries";
-    }
-    locker.unlock();
-    
-    // Load new version
+    // Load new version; it replaces the system's current index
     return loadDatabase(filePath);
 }
 
 QList<MultiSignalMatch> LocalDatabaseProvider::matchROM(const ROMSignals &input) const
 {
+    // Opening a deferred DAT only adds to the DAT set, which m_mutex guards
+    const_cast<LocalDatabaseProvider *>(this)->loadPending(input.system);
     QMutexLocker locker(&m_mutex);
+    const QString datSystem = datSystemFor(input.system);
     QList<MultiSignalMatch> matches;
     
     qDebug() << "LocalDatabaseProvider: Multi-signal matching for" << input.filename;
@@ -381,32 +539,22 @@ QList<MultiSignalMatch> LocalDatabaseProvider::matchROM(const ROMSignals &input)
     
     // Pass 1: Hash-based matching (highest confidence)
     QList<ClrMameProEntry> hashCandidates;
-    
-    // Try CRC32
-    if (!input.crc32.isEmpty()) {
-        QString normalizedCrc = normalizeHash(input.crc32);
-        if (m_crc32Index.contains(normalizedCrc)) {
-            hashCandidates.append(m_crc32Index.value(normalizedCrc));
-            qDebug() << "  Hash match (CRC32):" << m_crc32Index.value(normalizedCrc).gameName;
-        }
-    }
-    
-    // Try MD5
-    if (!input.md5.isEmpty() && hashCandidates.isEmpty()) {
-        QString normalizedMd5 = normalizeHash(input.md5);
-        if (m_md5Index.contains(normalizedMd5)) {
-            hashCandidates.append(m_md5Index.value(normalizedMd5));
-            qDebug() << "  Hash match (MD5):" << m_md5Index.value(normalizedMd5).gameName;
-        }
-    }
-    
-    // Try SHA1
-    if (!input.sha1.isEmpty() && hashCandidates.isEmpty()) {
-        QString normalizedSha1 = normalizeHash(input.sha1);
-        if (m_sha1Index.contains(normalizedSha1)) {
-            hashCandidates.append(m_sha1Index.value(normalizedSha1));
-            qDebug() << "  Hash match (SHA1):" << m_sha1Index.value(normalizedSha1).gameName;
-        }
+    QString matchedHash;
+    ClrMameProEntry hashEntry;
+    
+    // Try CRC32, then MD5, then SHA1
+    if (!input.crc32.isEmpty() && findByHash(input.crc32, hashEntry, datSystem)) {
+        hashCandidates.append(hashEntry);
+        matchedHash = "CRC32:" + hashEntry.crc32;
+        qDebug() << "  Hash match (CRC32):" << hashEntry.gameName;
+    } else if (!input.md5.isEmpty() && findByHash(input.md5, hashEntry, datSystem)) {
+        hashCandidates.append(hashEntry);
+        matchedHash = "MD5:" + hashEntry.md5;
+        qDebug() << "  Hash match (MD5):" << hashEntry.gameName;
+    } else if (!input.sha1.isEmpty() && findByHash(input.sha1, hashEntry, datSystem)) {
+        hashCandidates.append(hashEntry);
+        matchedHash = "SHA1:" + hashEntry.sha1;
+        qDebug() << "  Hash match (SHA1):" << hashEntry.gameName;
     }
     
     // If we have hash matches, score them with additional signals
@@ -419,13 +567,7 @@ QList<MultiSignalMatch> LocalDatabaseProvider::matchROM(const ROMSignals &input)
             match.matchSignalCount = 1;
             
             // Track which hash matched
-            if (!input.crc32.isEmpty() && normalizeHash(input.crc32) == normalizeHash(entry.crc32)) {
-                match.matchedHash = "CRC32:" + entry.crc32;
-            } else if (!input.md5.isEmpty() && normalizeHash(input.md5) == normalizeHash(entry.md5)) {
-                match.matchedHash = "MD5:" + entry.md5;
-            } else if (!input.sha1.isEmpty() && normalizeHash(input.sha1) == normalizeHash(entry.sha1)) {
-                match.matchedHash = "SHA1:" + entry.sha1;
-            }
+            match.matchedHash = matchedHash;
             
             // Check filename match (case-insensitive, ignore extension)
             QString signalBase = QFileInfo(input.filename).completeBaseName().toLower();
@@ -463,32 +605,24 @@ QList<MultiSignalMatch> LocalDatabaseProvider::matchROM(const ROMSignals &input)
         
         QString signalBase = QFileInfo(input.filename).completeBaseName().toLower();
         
-        // Search through all entries in all indexes
-        // Use a set to avoid duplicates since same entry might be in multiple hash indexes
-        QSet<QString> seenEntries;
-        
-        // Search CRC32 index
-        for (auto it = m_crc32Index.constBegin(); it != m_crc32Index.constEnd(); ++it) {
-            const ClrMameProEntry &entry = it.value();
-            
-            // Skip if we've already checked this entry
-            QString entryKey = entry.gameName + "|" + entry.romName;
-            if (seenEntries.contains(entryKey)) {
-                continue;
-            }
-            seenEntries.insert(entryKey);
-            
-            QString entryBase = QFileInfo(entry.romName).completeBaseName().toLower();
-            
-            // Check exact filename match
-            bool filenameExact = (signalBase == entryBase);
-            
-            // Check size match
-            qint64 sizeDiff = qAbs(input.fileSize - entry.size);
-            bool sizeMatch = (sizeDiff <= 1024);
-            
-            // Only consider if both filename and size match
-            if (filenameExact && sizeMatch) {
+        // Sizes are read straight from the index; names are only decoded
+        // for entries whose size is already within tolerance
+        bool found = false;
+        for (const LoadedDat &dat : m_dats) {
+            for (int i = 0; i < dat.index->entryCount(); ++i) {
+                // Check size match
+                qint64 sizeDiff = qAbs(input.fileSize - dat.index->romSize(i));
+                if (sizeDiff > 1024) {
+                    continue;
+                }
+                
+                // Check exact filename match
+                QString entryBase = QFileInfo(dat.index->romName(i)).completeBaseName().toLower();
+                if (signalBase != entryBase) {
+                    continue;
+                }
+                
+                const ClrMameProEntry entry = dat.index->entry(i);
                 MultiSignalMatch match;
                 match.entry = entry;
                 match.filenameMatch = true;
@@ -507,8 +641,12 @@ QList<MultiSignalMatch> LocalDatabaseProvider::matchROM(const ROMSignals &input)
                 
                 matches.append(match);
                 qDebug() << "  Filename+size match:" << entry.gameName << "score:" << match.confidenceScore;
+                found = true;
                 break; // Found a match, stop searching
             }
+            if (found) {
+                break;
+            }
         }
     }
     
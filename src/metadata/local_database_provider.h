@@ -3,10 +3,14 @@
 
 #include "metadata_provider.h"
 #include "clrmamepro_parser.h"
+#include "title_index.h"
+#include "../core/dat_index.h"
 #include <QMap>
 #include <QHash>
 #include <QMutex>
 #include <QDateTime>
+#include <QFileInfo>
+#include <memory>
 
 namespace Remus {
 
@@ -56,6 +60,7 @@ struct ROMSignals {
     QString filename;           // ROM filename (required)
     qint64 fileSize = 0;        // File size in bytes (required)
     QString serial;             // Serial number (optional)
+    QString system;             // System name (optional; its DAT is searched first)
 };
 
 
@@ -67,25 +72,74 @@ struct ROMSignals {
  * 
  * Priority: 100 (highest - checked first, before online APIs)
  * 
- * DAT files location: data/databases/*.dat
+ * DAT files location: data/databases/*.dat (also *.dat.gz and zipped DATs)
  * 
  * Matching methods:
  * - CRC32 hash (cartridge-based systems)
  * - MD5/SHA1 hash (disc-based systems)
  * - File size + filename (fallback)
+ *
+ * Each DAT is compiled once into a binary DatIndex kept in the index
+ * directory; later loads map that file instead of re-parsing the DAT,
+ * as long as the DAT's size and mtime are unchanged.
+ *
+ * loadDatabases() opens the DATs of a directory in parallel. In lazy mode
+ * it only records which DATs exist, and a system's index is opened on the
+ * first lookup that names that system (lookups that name no known system
+ * open every pending DAT). databaseLoaded and loadingProgress are emitted
+ * when indexes are actually opened, whichever mode is used.
+ *
+ * Each opened DAT also gets a TitleIndex over its game names, which
+ * searchByName() queries instead of scanning entries.
  */
 class LocalDatabaseProvider : public MetadataProvider
 {
     Q_OBJECT
     
 public:
+    /// Subdirectory of the cache location holding compiled DAT indexes
+    static constexpr const char *INDEX_DIRECTORY_NAME = "dat-index";
+
+    /// Upper bound on DATs opened at once (compiling a DAT is memory-heavy)
+    static constexpr int MAX_LOAD_THREADS = 4;
+
+    /// Results returned by searchByName()
+    static constexpr int MAX_SEARCH_RESULTS = 10;
+
     explicit LocalDatabaseProvider(QObject *parent = nullptr);
     ~LocalDatabaseProvider() override;
+
+    /**
+     * @brief Directory compiled DAT indexes are written to and mapped from
+     *
+     * Defaults to the application cache location. An empty path disables
+     * the on-disk indexes; DATs are then compiled in memory on every load.
+     */
+    void setIndexDirectory(const QString &directory);
+    QString indexDirectory() const;
+
+    /**
+     * @brief Path of the compiled index for a DAT (empty if disabled)
+     */
+    QString indexPathFor(const QFileInfo &datFile) const;
     
+    /**
+     * @brief Defer opening DATs until a lookup needs them
+     *
+     * Off by default. Applies to later loadDatabases() calls.
+     */
+    void setLazyLoading(bool lazy);
+    bool lazyLoading() const;
+
+    /**
+     * @brief Systems whose DAT was found but not opened yet (lazy mode)
+     */
+    QStringList pendingSystems() const;
+
     /**
      * @brief Load DAT files from directory
      * @param directory Path to directory containing .dat files
-     * @return Number of entries loaded
+     * @return Number of entries loaded (0 in lazy mode, where nothing is opened yet)
      */
     int loadDatabases(const QString &directory);
     
@@ -134,6 +188,13 @@ public:
     QList<MultiSignalMatch> matchROM(const ROMSignals &input) const;
     
     // MetadataProvider interface
+
+    /**
+     * @brief Ranked title search (exact > prefix > word overlap > fuzzy)
+     *
+     * Only the DAT serving @p system is searched when one does; otherwise
+     * every loaded DAT is. @p region must appear in the game name.
+     */
     QList<SearchResult> searchByName(const QString &title,
                                      const QString &system,
                                      const QString &region = QString()) override;
@@ -156,11 +217,61 @@ signals:
     
 private:
     /**
-     * @brief Index DAT entries for fast lookup
-     * @param entries List of DAT entries
-     * @param systemName System name for this database
+     * @brief One loaded DAT, its index and its title search index
      */
-    void indexEntries(const QList<ClrMameProEntry> &entries, const QString &systemName);
+    struct LoadedDat {
+        QString systemName;
+        std::shared_ptr<const DatIndex> index;
+        std::shared_ptr<const TitleIndex> titles;
+    };
+
+    /**
+     * @brief Map the DAT's compiled index, compiling it first if missing or stale
+     * @return Index, or nullptr if the DAT has no entries
+     */
+    std::shared_ptr<const DatIndex> openIndex(const QFileInfo &datFile) const;
+
+    /**
+     * @brief Open a DAT's index and build its title index
+     * @return Loaded DAT; index is nullptr if the DAT has no entries
+     */
+    LoadedDat openDat(const QFileInfo &datFile) const;
+
+    /**
+     * @brief Find an entry by hash across all DATs
+     *
+     * The DAT of @p datSystem is searched first; after it, later DATs win.
+     */
+    bool findByHash(const QString &hash, ClrMameProEntry &entry,
+                    const QString &datSystem = QString()) const;
+
+    /**
+     * @brief Open DATs in parallel and register them in list order
+     * @return Total entries loaded
+     */
+    int loadFiles(const QFileInfoList &files);
+
+    /**
+     * @brief Register an opened DAT (replacing the system's previous one)
+     * @return Entry count, or 0 if the index is empty
+     */
+    int registerDat(const QFileInfo &datFile, const LoadedDat &dat);
+
+    /**
+     * @brief Open the pending DATs a lookup for @p system needs (lazy mode)
+     *
+     * Only the system's DAT if it is known, otherwise every pending DAT.
+     */
+    void loadPending(const QString &system);
+
+    /**
+     * @brief System name of the DAT (loaded or pending) that serves @p system
+     *
+     * Accepts DAT names ("Sega - Mega Drive - Genesis") and internal system
+     * names ("Genesis"). Caller must hold m_mutex.
+     * @return DAT system name, or empty string if none matches
+     */
+    QString datSystemFor(const QString &system) const;
     
     /**
      * @brief Convert ClrMameProEntry to GameMetadata
@@ -169,17 +280,13 @@ private:
      */
     GameMetadata datEntryToMetadata(const ClrMameProEntry &entry) const;
     
-    /**
-     * @brief Normalize hash for lookup (uppercase, no spaces)
-     * @param hash Input hash
-     * @return Normalized hash
-     */
-    QString normalizeHash(const QString &hash) const;
-    
-    // Hash indexes for O(1) lookup
-    QHash<QString, ClrMameProEntry> m_crc32Index;   // CRC32 -> ClrMameProEntry
-    QHash<QString, ClrMameProEntry> m_md5Index;     // MD5 -> ClrMameProEntry
-    QHash<QString, ClrMameProEntry> m_sha1Index;    // SHA1 -> ClrMameProEntry
+    // Loaded DATs in load order (mapped indexes, queried in place)
+    QList<LoadedDat> m_dats;
+    QString m_indexDirectory;
+
+    // Lazy mode: system name -> DAT path of DATs not opened yet
+    bool m_lazyLoading = false;
+    QMap<QString, QString> m_pendingDats;
     
     // System statistics
     QMap<QString, int> m_systemStats;
@@ -189,6 +296,7 @@ private:
     
     // Thread safety
     mutable QMutex m_mutex;
+    QMutex m_pendingLoadMutex;  // Serializes lazy loads so none is opened twice
     
     int m_totalEntries = 0;
 };
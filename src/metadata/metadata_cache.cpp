@@ -5,8 +5,11 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QDataStream>
 #include <QDateTime>
+#include <QTimeZone>
 #include <QDebug>
+#include "../core/constants/network.h"
 #include "../core/logging_categories.h"
 
 #undef qDebug
@@ -20,200 +23,309 @@
 
 namespace Remus {
 
+namespace {
+
+/// Leading bytes of a binary row; JSON rows start with '{'
+constexpr quint32 BINARY_MAGIC = 0x524D4331;    // "RMC1"
+
+/// Positive entries effectively never expire
+constexpr int METADATA_EXPIRY_DAYS = 3650;
+
+/// datetime() modifier for METADATA_EXPIRY_DAYS
+QString metadataExpiryModifier()
+{
+    return QString("+%1 days").arg(METADATA_EXPIRY_DAYS);
+}
+
+QByteArray encodeMetadata(const GameMetadata &metadata)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << BINARY_MAGIC
+        << metadata.id << metadata.title << metadata.system << metadata.region
+        << metadata.publisher << metadata.developer << metadata.genres
+        << metadata.releaseDate << metadata.description
+        << qint32(metadata.players) << metadata.rating << metadata.ratingSource
+        << metadata.boxArtUrl << metadata.screenshotUrls << metadata.externalIds
+        << metadata.providerId << metadata.fetchedAt
+        << metadata.matchScore << metadata.matchMethod;
+    return data;
+}
+
+/**
+ * @brief Rows written before the binary format
+ */
+bool decodeLegacyJson(const QByteArray &data, GameMetadata &metadata)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (doc.isNull() || !doc.isObject()) {
+        return false;
+    }
+    QJsonObject json = doc.object();
+
+    metadata.id = json["id"].toString();
+    metadata.title = json["title"].toString();
+    metadata.system = json["system"].toString();
+    metadata.region = json["region"].toString();
+    metadata.publisher = json["publisher"].toString();
+    metadata.developer = json["developer"].toString();
+    metadata.releaseDate = json["releaseDate"].toString();
+    metadata.description = json["description"].toString();
+    metadata.players = json["players"].toInt();
+    metadata.rating = static_cast<float>(json["rating"].toDouble());
+    metadata.providerId = json["providerId"].toString();
+    metadata.boxArtUrl = json["boxArtUrl"].toString();
+    metadata.matchMethod = json["matchMethod"].toString();
+    metadata.matchScore = static_cast<float>(json["matchScore"].toDouble());
+
+    // Deserialize genres
+    QJsonArray genresArray = json["genres"].toArray();
+    for (const QJsonValue &genre : genresArray) {
+        metadata.genres.append(genre.toString());
+    }
+
+    // Deserialize external IDs
+    QJsonObject externalIds = json["externalIds"].toObject();
+    for (auto it = externalIds.begin(); it != externalIds.end(); ++it) {
+        metadata.externalIds[it.key()] = it.value().toString();
+    }
+
+    // Deserialize timestamp
+    QString fetchedAtStr = json["fetchedAt"].toString();
+    if (!fetchedAtStr.isEmpty()) {
+        metadata.fetchedAt = QDateTime::fromString(fetchedAtStr, Qt::ISODate);
+    }
+    return true;
+}
+
+bool decodeMetadata(const QByteArray &data, GameMetadata &metadata)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    in >> magic;
+    if (magic != BINARY_MAGIC) {
+        return decodeLegacyJson(data, metadata);
+    }
+
+    qint32 players = 0;
+    in >> metadata.id >> metadata.title >> metadata.system >> metadata.region
+       >> metadata.publisher >> metadata.developer >> metadata.genres
+       >> metadata.releaseDate >> metadata.description
+       >> players >> metadata.rating >> metadata.ratingSource
+       >> metadata.boxArtUrl >> metadata.screenshotUrls >> metadata.externalIds
+       >> metadata.providerId >> metadata.fetchedAt
+       >> metadata.matchScore >> metadata.matchMethod;
+    metadata.players = players;
+    return in.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief SQLite datetime() text (UTC) to QDateTime
+ */
+QDateTime parseSqliteTime(const QString &text)
+{
+    QDateTime time = QDateTime::fromString(text, QStringLiteral("yyyy-MM-dd HH:mm:ss"));
+    time.setTimeZone(QTimeZone::utc());
+    return time;
+}
+
+QString hashKey(const QString &hash, const QString &system)
+{
+    return QString("metadata:hash:%1:%2").arg(system, hash);
+}
+
+/// Miss keys of one hash share this prefix, whatever the provider
+QString missPrefix(const QString &hash, const QString &system)
+{
+    return QString("miss:%1:%2:").arg(system, hash);
+}
+
+} // namespace
+
 MetadataCache::MetadataCache(QSqlDatabase &db, QObject *parent)
     : QObject(parent)
     , m_db(db)
 {
+    m_memory.setMaxCost(Constants::Network::METADATA_MEMORY_CACHE_ENTRIES);
 }
 
-GameMetadata MetadataCache::getByHash(const QString &hash, const QString &system)
+bool MetadataCache::lookup(const QString &cacheKey, GameMetadata *metadata)
 {
-    GameMetadata metadata;
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    if (const MemoryEntry *entry = m_memory.object(cacheKey)) {
+        if (entry->expiresAt > now) {
+            ++m_memoryHits;
+            if (metadata) {
+                *metadata = entry->metadata;
+            }
+            return true;
+        }
+        m_memory.remove(cacheKey);
+    }
 
     QSqlQuery query(m_db);
     query.prepare(R"(
-        SELECT cache_value FROM cache 
+        SELECT cache_value, expiry FROM cache 
         WHERE cache_key = ? AND expiry > datetime('now')
     )");
-    
-    QString cacheKey = QString("metadata:hash:%1:%2").arg(system, hash);
     query.addBindValue(cacheKey);
 
-    if (query.exec() && query.next()) {
-        QByteArray data = query.value(0).toByteArray();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (!doc.isNull() && doc.isObject()) {
-            QJsonObject json = doc.object();
-            
-            metadata.id = json["id"].toString();
-            metadata.title = json["title"].toString();
-            metadata.system = json["system"].toString();
-            metadata.region = json["region"].toString();
-            metadata.publisher = json["publisher"].toString();
-            metadata.developer = json["developer"].toString();
-            metadata.releaseDate = json["releaseDate"].toString();
-            metadata.description = json["description"].toString();
-            metadata.players = json["players"].toInt();
-            metadata.rating = static_cast<float>(json["rating"].toDouble());
-            metadata.providerId = json["providerId"].toString();
-            metadata.boxArtUrl = json["boxArtUrl"].toString();
-            metadata.matchMethod = json["matchMethod"].toString();
-            metadata.matchScore = static_cast<float>(json["matchScore"].toDouble());
-            
-            // Deserialize genres
-            QJsonArray genresArray = json["genres"].toArray();
-            for (const QJsonValue &genre : genresArray) {
-                metadata.genres.append(genre.toString());
-            }
-            
-            // Deserialize external IDs
-            QJsonObject externalIds = json["externalIds"].toObject();
-            for (auto it = externalIds.begin(); it != externalIds.end(); ++it) {
-                metadata.externalIds[it.key()] = it.value().toString();
-            }
-            
-            // Deserialize timestamp
-            QString fetchedAtStr = json["fetchedAt"].toString();
-            if (!fetchedAtStr.isEmpty()) {
-                metadata.fetchedAt = QDateTime::fromString(fetchedAtStr, Qt::ISODate);
-            }
-            
-            qCDebug(logMetadata) << "Cache hit for hash:" << hash << "- Title:" << metadata.title;
-        } else {
-            qCWarning(logMetadata) << "Failed to parse cached metadata JSON for hash:" << hash;
-        }
+    if (!query.exec() || !query.next()) {
+        ++m_misses;
+        return false;
+    }
+
+    GameMetadata decoded;
+    if (metadata && !decodeMetadata(query.value(0).toByteArray(), decoded)) {
+        qCWarning(logMetadata) << "Failed to decode cached metadata for key:" << cacheKey;
+        ++m_misses;
+        return false;
+    }
+
+    ++m_diskHits;
+    remember(cacheKey, decoded, parseSqliteTime(query.value(1).toString()));
+    if (metadata) {
+        *metadata = decoded;
+    }
+    return true;
+}
+
+void MetadataCache::remember(const QString &cacheKey, const GameMetadata &metadata,
+                             const QDateTime &expiresAt)
+{
+    if (m_memory.maxCost() > 0) {
+        m_memory.insert(cacheKey, new MemoryEntry{metadata, expiresAt});
     }
+}
 
+GameMetadata MetadataCache::getByHash(const QString &hash, const QString &system)
+{
+    GameMetadata metadata;
+    if (lookup(hashKey(hash, system), &metadata)) {
+        qCDebug(logMetadata) << "Cache hit for hash:" << hash << "- Title:" << metadata.title;
+    }
     return metadata;
 }
 
 GameMetadata MetadataCache::getByProviderId(const QString &providerId, const QString &gameId)
 {
     GameMetadata metadata;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        SELECT cache_value FROM cache 
-        WHERE cache_key = ? AND expiry > datetime('now')
-    )");
-    
-    QString cacheKey = QString("metadata:%1:%2").arg(providerId, gameId);
-    query.addBindValue(cacheKey);
-
-    if (query.exec() && query.next()) {
-        QByteArray data = query.value(0).toByteArray();
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (!doc.isNull() && doc.isObject()) {
-            QJsonObject json = doc.object();
-            
-            metadata.id = json["id"].toString();
-            metadata.title = json["title"].toString();
-            metadata.system = json["system"].toString();
-            metadata.region = json["region"].toString();
-            metadata.publisher = json["publisher"].toString();
-            metadata.developer = json["developer"].toString();
-            metadata.releaseDate = json["releaseDate"].toString();
-            metadata.description = json["description"].toString();
-            metadata.players = json["players"].toInt();
-            metadata.rating = static_cast<float>(json["rating"].toDouble());
-            metadata.providerId = json["providerId"].toString();
-            metadata.boxArtUrl = json["boxArtUrl"].toString();
-            metadata.matchMethod = json["matchMethod"].toString();
-            metadata.matchScore = static_cast<float>(json["matchScore"].toDouble());
-            
-            // Deserialize genres
-            QJsonArray genresArray = json["genres"].toArray();
-            for (const QJsonValue &genre : genresArray) {
-                metadata.genres.append(genre.toString());
-            }
-            
-            // Deserialize external IDs
-            QJsonObject externalIds = json["externalIds"].toObject();
-            for (auto it = externalIds.begin(); it != externalIds.end(); ++it) {
-                metadata.externalIds[it.key()] = it.value().toString();
-            }
-            
-            // Deserialize timestamp
-            QString fetchedAtStr = json["fetchedAt"].toString();
-            if (!fetchedAtStr.isEmpty()) {
-                metadata.fetchedAt = QDateTime::fromString(fetchedAtStr, Qt::ISODate);
-            }
-            
-            qCDebug(logMetadata) << "Cache hit for" << providerId << "ID:" << gameId << "- Title:" << metadata.title;
-        } else {
-            qCWarning(logMetadata) << "Failed to parse cached metadata JSON for" << providerId << gameId;
-        }
+    if (lookup(QString("metadata:%1:%2").arg(providerId, gameId), &metadata)) {
+        qCDebug(logMetadata) << "Cache hit for" << providerId << "ID:" << gameId << "- Title:" << metadata.title;
     }
-
     return metadata;
 }
 
 bool MetadataCache::store(const GameMetadata &metadata, const QString &hash, const QString &system)
 {
-    // Serialize metadata to JSON
-    QJsonObject json;
-    json["id"] = metadata.id;
-    json["title"] = metadata.title;
-    json["system"] = metadata.system;
-    json["region"] = metadata.region;
-    json["publisher"] = metadata.publisher;
-    json["developer"] = metadata.developer;
-    json["genres"] = QJsonArray::fromStringList(metadata.genres);
-    json["releaseDate"] = metadata.releaseDate;
-    json["description"] = metadata.description;
-    json["players"] = metadata.players;
-    json["rating"] = metadata.rating;
-    json["providerId"] = metadata.providerId;
-    json["boxArtUrl"] = metadata.boxArtUrl;
-    json["matchMethod"] = metadata.matchMethod;
-    json["matchScore"] = metadata.matchScore;
-    
-    // Serialize external IDs
-    QJsonObject externalIds;
-    for (auto it = metadata.externalIds.begin(); it != metadata.externalIds.end(); ++it) {
-        externalIds[it.key()] = it.value();
-    }
-    json["externalIds"] = externalIds;
-    
-    // Serialize timestamp
-    if (metadata.fetchedAt.isValid()) {
-        json["fetchedAt"] = metadata.fetchedAt.toString(Qt::ISODate);
-    }
-
-    QByteArray data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    QByteArray data = encodeMetadata(metadata);
+    const QDateTime expiresAt = QDateTime::currentDateTimeUtc().addDays(METADATA_EXPIRY_DAYS);
 
     // Store with provider ID as key
     QSqlQuery query(m_db);
     query.prepare(R"(
         INSERT OR REPLACE INTO cache (cache_key, cache_value, expiry)
-        VALUES (?, ?, datetime('now', '+3650 days'))
+        VALUES (?, ?, datetime('now', ?))
     )");
 
     QString cacheKey = QString("metadata:%1:%2").arg(metadata.providerId, metadata.id);
     query.addBindValue(cacheKey);
     query.addBindValue(data);
+    query.addBindValue(metadataExpiryModifier());
 
     if (!query.exec()) {
         qCWarning(logMetadata) << "Failed to store metadata in cache:" << query.lastError().text();
         return false;
     }
+    remember(cacheKey, metadata, expiresAt);
 
     // Also store by hash if provided
     if (!hash.isEmpty() && !system.isEmpty()) {
         query.prepare(R"(
             INSERT OR REPLACE INTO cache (cache_key, cache_value, expiry)
-            VALUES (?, ?, datetime('now', '+3650 days'))
+            VALUES (?, ?, datetime('now', ?))
         )");
 
-        QString hashKey = QString("metadata:hash:%1:%2").arg(system, hash);
-        query.addBindValue(hashKey);
+        const QString key = hashKey(hash, system);
+        query.addBindValue(key);
         query.addBindValue(data);
-        query.exec();
+        query.addBindValue(metadataExpiryModifier());
+        if (query.exec()) {
+            remember(key, metadata, expiresAt);
+        }
+        forgetMisses(hash, system);
     }
 
     return true;
 }
 
+bool MetadataCache::storeMiss(const QString &providerId, const QString &hash, const QString &system)
+{
+    const int ttl = negativeTtl(providerId);
+    const QString cacheKey = missPrefix(hash, system) + providerId;
+
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        INSERT OR REPLACE INTO cache (cache_key, cache_value, expiry)
+        VALUES (?, ?, datetime('now', ?))
+    )");
+    query.addBindValue(cacheKey);
+    query.addBindValue(QByteArray(""));
+    query.addBindValue(QString("+%1 seconds").arg(ttl));
+
+    if (!query.exec()) {
+        qCWarning(logMetadata) << "Failed to store cache miss:" << query.lastError().text();
+        return false;
+    }
+    remember(cacheKey, GameMetadata(), QDateTime::currentDateTimeUtc().addSecs(ttl));
+    return true;
+}
+
+bool MetadataCache::isKnownMiss(const QString &providerId, const QString &hash, const QString &system)
+{
+    return lookup(missPrefix(hash, system) + providerId, nullptr);
+}
+
+void MetadataCache::forgetMisses(const QString &hash, const QString &system)
+{
+    const QString prefix = missPrefix(hash, system);
+
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM cache WHERE substr(cache_key, 1, ?) = ?");
+    query.addBindValue(prefix.size());
+    query.addBindValue(prefix);
+    query.exec();
+
+    const QList<QString> keys = m_memory.keys();
+    for (const QString &key : keys) {
+        if (key.startsWith(prefix)) {
+            m_memory.remove(key);
+        }
+    }
+}
+
+void MetadataCache::setNegativeTtl(const QString &providerId, int seconds)
+{
+    m_negativeTtls.insert(providerId, qMax(0, seconds));
+}
+
+int MetadataCache::negativeTtl(const QString &providerId) const
+{
+    return m_negativeTtls.value(providerId, Constants::Network::METADATA_NEGATIVE_TTL_S);
+}
+
+void MetadataCache::setMemoryCapacity(int entries)
+{
+    m_memory.setMaxCost(qMax(0, entries));
+}
+
+int MetadataCache::memoryCapacity() const
+{
+    return m_memory.maxCost();
+}
+
 bool MetadataCache::storeArtwork(const QString &gameId, const ArtworkUrls &artwork)
 {
     QJsonObject json;
@@ -231,12 +343,13 @@ bool MetadataCache::storeArtwork(const QString &gameId, const ArtworkUrls &artwo
     QSqlQuery query(m_db);
     query.prepare(R"(
         INSERT OR REPLACE INTO cache (cache_key, cache_value, expiry)
-        VALUES (?, ?, datetime('now', '+3650 days'))
+        VALUES (?, ?, datetime('now', ?))
     )");
 
     QString cacheKey = QString("artwork:%1").arg(gameId);
     query.addBindValue(cacheKey);
     query.addBindValue(data);
+    query.addBindValue(metadataExpiryModifier());
 
     if (!query.exec()) {
         qCWarning(logMetadata) << "Failed to store artwork in cache:" << query.lastError().text();
@@ -287,6 +400,7 @@ int MetadataCache::clearOldCache(int days)
     query.addBindValue(-days);
 
     if (query.exec()) {
+        m_memory.clear();
         return query.numRowsAffected();
     }
 
@@ -321,6 +435,16 @@ MetadataCache::CacheStats MetadataCache::getStats()
         stats.totalSizeBytes = query.value(0).toLongLong();
     }
 
+    query.exec("SELECT COUNT(*) FROM cache WHERE cache_key LIKE 'miss:%' AND expiry > datetime('now')");
+    if (query.next()) {
+        stats.negativeEntries = query.value(0).toInt();
+    }
+
+    stats.memoryEntries = m_memory.size();
+    stats.memoryHits = m_memoryHits;
+    stats.diskHits = m_diskHits;
+    stats.misses = m_misses;
+
     return stats;
 }
 
@@ -2,6 +2,8 @@
 #define REMUS_METADATA_CACHE_H
 
 #include <QObject>
+#include <QCache>
+#include <QHash>
 #include <QSqlDatabase>
 #include "metadata_provider.h"
 
@@ -11,6 +13,15 @@ namespace Remus {
  * @brief Local cache for metadata and artwork
  * 
  * Stores fetched metadata in SQLite to avoid redundant API calls.
+ * Lookups go through an in-memory LRU first, so repeated hits skip the
+ * query and the decode. Rows are stored in a compact binary form; rows
+ * written as JSON by older versions are still read.
+ *
+ * Also remembers "no match" answers per provider (negative entries), each
+ * provider with its own TTL, so files no provider knows are not asked
+ * about again on every run.
+ *
+ * Not thread-safe, like the QSqlDatabase connection it uses.
  */
 class MetadataCache : public QObject {
     Q_OBJECT
@@ -45,6 +56,31 @@ public:
                const QString &hash = QString(),
                const QString &system = QString());
 
+    /**
+     * @brief Remember that a provider has no match for a hash
+     *
+     * Expires after negativeTtl(providerId). Storing a match for the same
+     * hash and system drops it.
+     */
+    bool storeMiss(const QString &providerId, const QString &hash, const QString &system);
+
+    /**
+     * @brief Whether a provider recently had no match for a hash
+     */
+    bool isKnownMiss(const QString &providerId, const QString &hash, const QString &system);
+
+    /**
+     * @brief How long a provider's "no match" is trusted (seconds)
+     */
+    void setNegativeTtl(const QString &providerId, int seconds);
+    int negativeTtl(const QString &providerId) const;
+
+    /**
+     * @brief Number of entries kept in memory (0 disables the memory layer)
+     */
+    void setMemoryCapacity(int entries);
+    int memoryCapacity() const;
+
     /**
      * @brief Store artwork URLs in cache
      * @param gameId Provider game ID
@@ -72,11 +108,39 @@ public:
         int totalEntries = 0;
         int entriesThisWeek = 0;
         qint64 totalSizeBytes = 0;
+        int negativeEntries = 0;    // Unexpired "no match" entries
+        int memoryEntries = 0;      // Entries in the LRU (either kind)
+        int memoryHits = 0;         // Lookups answered from memory
+        int diskHits = 0;           // ... from SQLite
+        int misses = 0;             // ... not answered
     };
     CacheStats getStats();
 
 private:
+    /**
+     * @brief One LRU entry: metadata, or a "no match" marker
+     */
+    struct MemoryEntry {
+        GameMetadata metadata;      // Empty for a miss marker
+        QDateTime expiresAt;        // UTC
+    };
+
+    /**
+     * @brief Memory, then SQLite; counts the outcome
+     * @param metadata Decoded into if given (null for miss markers)
+     * @return True if an unexpired entry exists
+     */
+    bool lookup(const QString &cacheKey, GameMetadata *metadata);
+    void remember(const QString &cacheKey, const GameMetadata &metadata, const QDateTime &expiresAt);
+    /// Drop every provider's miss for this hash
+    void forgetMisses(const QString &hash, const QString &system);
+
     QSqlDatabase &m_db;
+    QCache<QString, MemoryEntry> m_memory;
+    QHash<QString, int> m_negativeTtls;
+    int m_memoryHits = 0;
+    int m_diskHits = 0;
+    int m_misses = 0;
 };
 
 } // namespace Remus
@@ -1,10 +1,7 @@
 #include "metadata_provider.h"
+#include "network_client.h"
 #include "../core/constants/constants.h"
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QNetworkRequest>
-#include <QEventLoop>
-#include <QTimer>
 
 namespace Remus {
 
@@ -22,34 +19,12 @@ void MetadataProvider::setCredentials(const QString &username, const QString &pa
 
 QByteArray MetadataProvider::downloadImage(const QUrl &url)
 {
-    QNetworkAccessManager manager;
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, Constants::API::USER_AGENT);
 
-    QNetworkReply *reply = manager.get(request);
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::METADATA_TIMEOUT_MS);
-
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
-
-    timeout.start();
-    loop.exec();
-
-    if (timeout.isActive()) {
-        timeout.stop();
-        if (reply->error() == QNetworkReply::NoError) {
-            QByteArray data = reply->readAll();
-            reply->deleteLater();
-            return data;
-        }
-    }
-
-    reply->deleteLater();
-    return QByteArray();
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().get(request, Constants::Network::METADATA_TIMEOUT_MS));
+    return reply.success ? reply.data : QByteArray();
 }
 
 bool MetadataProvider::isAvailable()
@@ -0,0 +1,330 @@
+#include "network_client.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFutureWatcher>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPromise>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <utility>
+
+namespace Remus {
+
+QByteArray NetworkResponse::header(const QByteArray &name) const
+{
+    for (const auto &pair : headers) {
+        if (pair.first.compare(name, Qt::CaseInsensitive) == 0) {
+            return pair.second;
+        }
+    }
+    return QByteArray();
+}
+
+/**
+ * @brief One request in flight, shared by every caller that asked for it
+ */
+struct NetworkClient::InFlight {
+    QByteArray key;
+    QPromise<NetworkResponse> promise;
+    QFuture<NetworkResponse> future;
+    QList<ProgressCallback> progress;   // Guarded by the client's mutex
+};
+
+/**
+ * @brief Owner of one network thread's QNetworkAccessManager
+ */
+class NetworkClient::Worker : public QObject
+{
+public:
+    /**
+     * @brief The manager, created on first use so it belongs to this thread
+     */
+    QNetworkAccessManager *manager()
+    {
+        if (!m_manager) {
+            m_manager = new QNetworkAccessManager(this);
+        }
+        return m_manager;
+    }
+
+    /**
+     * @brief Abort every transfer; their finished handlers run before this returns
+     */
+    void abortAll()
+    {
+        if (m_manager) {
+            for (QNetworkReply *reply : m_manager->findChildren<QNetworkReply *>()) {
+                reply->abort();
+            }
+        }
+    }
+
+private:
+    QNetworkAccessManager *m_manager = nullptr;
+};
+
+namespace {
+
+/**
+ * @brief What makes two requests interchangeable
+ */
+QByteArray requestKey(const QByteArray &verb, const QNetworkRequest &request, const QByteArray &body)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(verb);
+    hash.addData(QByteArrayView("\n"));
+    hash.addData(request.url().toEncoded());
+    hash.addData(QByteArrayView("\n"));
+
+    QList<QByteArray> headers = request.rawHeaderList();
+    std::sort(headers.begin(), headers.end());
+    for (const QByteArray &header : std::as_const(headers)) {
+        hash.addData(header);
+        hash.addData(QByteArrayView(":"));
+        hash.addData(request.rawHeader(header));
+        hash.addData(QByteArrayView("\n"));
+    }
+    hash.addData(body);
+    return hash.result();
+}
+
+QBasicMutex sharedClientMutex;
+NetworkClient *sharedClient = nullptr;
+bool sharedTeardownRegistered = false;
+
+} // namespace
+
+NetworkClient::NetworkClient(int workers)
+{
+    for (int i = 0; i < qMax(1, workers); ++i) {
+        auto *thread = new QThread();
+        thread->setObjectName(QStringLiteral("network-%1").arg(i));
+        auto *worker = new Worker();
+        worker->moveToThread(thread);
+        thread->start();
+        m_threads.append(thread);
+        m_workers.append(worker);
+    }
+}
+
+NetworkClient::~NetworkClient()
+{
+    for (int i = 0; i < m_workers.size(); ++i) {
+        Worker *worker = m_workers.at(i);
+        QMetaObject::invokeMethod(worker, [worker]() {
+            worker->abortAll();
+            delete worker;
+        }, Qt::BlockingQueuedConnection);
+
+        m_threads.at(i)->quit();
+        m_threads.at(i)->wait();
+        delete m_threads.at(i);
+    }
+
+    // Requests queued but never started
+    QMutexLocker locker(&m_mutex);
+    const QList<std::shared_ptr<InFlight>> pending = m_inFlight.values();
+    m_inFlight.clear();
+    locker.unlock();
+    for (const std::shared_ptr<InFlight> &job : pending) {
+        job->promise.future().cancel();
+        job->promise.finish();
+    }
+}
+
+NetworkClient &NetworkClient::shared()
+{
+    QMutexLocker locker(&sharedClientMutex);
+    if (!sharedClient) {
+        sharedClient = new NetworkClient();
+    }
+
+    // A function-local static would be destroyed after QCoreApplication,
+    // and the destructor's blocking calls into the network threads with it
+    if (!sharedTeardownRegistered) {
+        if (QCoreApplication *app = QCoreApplication::instance()) {
+            QObject::connect(app, &QCoreApplication::aboutToQuit, &NetworkClient::shutdownShared);
+            qAddPostRoutine(&NetworkClient::shutdownShared);
+            sharedTeardownRegistered = true;
+        }
+    }
+    return *sharedClient;
+}
+
+void NetworkClient::shutdownShared()
+{
+    QMutexLocker locker(&sharedClientMutex);
+    NetworkClient *client = std::exchange(sharedClient, nullptr);
+    locker.unlock();
+    delete client;
+}
+
+QFuture<NetworkResponse> NetworkClient::get(const QNetworkRequest &request, int timeoutMs,
+                                            const ProgressCallback &progress)
+{
+    return send(QByteArrayLiteral("GET"), request, QByteArray(), timeoutMs, progress);
+}
+
+QFuture<NetworkResponse> NetworkClient::post(const QNetworkRequest &request, const QByteArray &body,
+                                             int timeoutMs)
+{
+    return send(QByteArrayLiteral("POST"), request, body, timeoutMs, {});
+}
+
+NetworkResponse NetworkClient::wait(QFuture<NetworkResponse> future)
+{
+    future.waitForFinished();
+    if (future.isCanceled() || future.resultCount() == 0) {
+        NetworkResponse response;
+        response.cancelled = true;
+        response.error = QStringLiteral("Request cancelled");
+        return response;
+    }
+    return future.result();
+}
+
+void NetworkClient::cancelAll()
+{
+    QList<QFuture<NetworkResponse>> futures;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const std::shared_ptr<InFlight> &job : std::as_const(m_inFlight)) {
+            futures.append(job->future);
+        }
+    }
+    for (QFuture<NetworkResponse> &future : futures) {
+        future.cancel();
+    }
+}
+
+int NetworkClient::inFlightCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inFlight.size();
+}
+
+int NetworkClient::requestsStarted() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_requestsStarted;
+}
+
+QFuture<NetworkResponse> NetworkClient::send(const QByteArray &verb, const QNetworkRequest &request,
+                                             const QByteArray &body, int timeoutMs,
+                                             const ProgressCallback &progress)
+{
+    QNetworkRequest prepared(request);
+    prepared.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    const QByteArray key = requestKey(verb, prepared, body);
+
+    auto job = std::make_shared<InFlight>();
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto existing = m_inFlight.constFind(key);
+        if (existing != m_inFlight.cend() && !(*existing)->future.isCanceled()) {
+            if (progress) {
+                (*existing)->progress.append(progress);
+            }
+            return (*existing)->future;
+        }
+
+        job->key = key;
+        job->promise.start();
+        job->future = job->promise.future();
+        if (progress) {
+            job->progress.append(progress);
+        }
+        m_inFlight.insert(key, job);
+        ++m_requestsStarted;
+    }
+
+    // One host, one worker: its connections stay warm
+    Worker *worker = m_workers.at(qHash(prepared.url().host()) % m_workers.size());
+    QMetaObject::invokeMethod(worker, [this, worker, job, verb, prepared, body, timeoutMs]() {
+        start(worker, job, verb, prepared, body, timeoutMs);
+    }, Qt::QueuedConnection);
+
+    return job->future;
+}
+
+void NetworkClient::start(Worker *worker, const std::shared_ptr<InFlight> &job, const QByteArray &verb,
+                          const QNetworkRequest &request, const QByteArray &body, int timeoutMs)
+{
+    if (job->future.isCanceled()) {
+        NetworkResponse response;
+        response.cancelled = true;
+        response.error = QStringLiteral("Request cancelled");
+        complete(job, response);
+        return;
+    }
+
+    QNetworkAccessManager *manager = worker->manager();
+    QNetworkReply *reply = manager->sendCustomRequest(request, verb, body);
+
+    auto timedOut = std::make_shared<bool>(false);
+    auto received = std::make_shared<QByteArray>();
+    if (timeoutMs > 0) {
+        QTimer::singleShot(timeoutMs, reply, [reply, timedOut, received]() {
+            *timedOut = true;
+            // abort() drops the buffer; keep what arrived so callers can resume
+            *received = reply->readAll();
+            reply->abort();
+        });
+    }
+
+    auto *watcher = new QFutureWatcher<NetworkResponse>(reply);
+    QObject::connect(watcher, &QFutureWatcher<NetworkResponse>::canceled, reply, &QNetworkReply::abort);
+    watcher->setFuture(job->future);
+
+    QObject::connect(reply, &QNetworkReply::downloadProgress, reply,
+                     [this, job](qint64 bytesReceived, qint64 bytesTotal) {
+                         QList<ProgressCallback> callbacks;
+                         {
+                             QMutexLocker locker(&m_mutex);
+                             callbacks = job->progress;
+                         }
+                         for (const ProgressCallback &callback : std::as_const(callbacks)) {
+                             callback(bytesReceived, bytesTotal);
+                         }
+                     });
+
+    QObject::connect(reply, &QNetworkReply::finished, reply, [this, job, reply, timedOut, received]() {
+        NetworkResponse response;
+        response.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        response.headers = reply->rawHeaderPairs();
+        if (*timedOut) {
+            response.timedOut = true;
+            response.error = QStringLiteral("Request timeout");
+            response.data = *received;
+        } else if (job->future.isCanceled()) {
+            response.cancelled = true;
+            response.error = QStringLiteral("Request cancelled");
+        } else if (reply->error() == QNetworkReply::NoError) {
+            response.success = true;
+            response.data = reply->readAll();
+        } else {
+            response.error = reply->errorString();
+            response.data = reply->readAll();
+        }
+        reply->deleteLater();
+        complete(job, response);
+    });
+}
+
+void NetworkClient::complete(const std::shared_ptr<InFlight> &job, const NetworkResponse &response)
+{
+    // Forget it first, so whoever the result wakes can issue it afresh
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_inFlight.constFind(job->key);
+        if (it != m_inFlight.cend() && *it == job) {
+            m_inFlight.erase(it);
+        }
+    }
+    job->promise.addResult(response);
+    job->promise.finish();
+}
+
+} // namespace Remus
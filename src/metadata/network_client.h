@@ -0,0 +1,147 @@
+#ifndef REMUS_NETWORK_CLIENT_H
+#define REMUS_NETWORK_CLIENT_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QNetworkRequest>
+#include <QPair>
+#include <QString>
+#include <functional>
+#include <memory>
+#include "../core/constants/network.h"
+
+class QThread;
+
+namespace Remus {
+
+/**
+ * @brief Outcome of one HTTP request
+ */
+struct NetworkResponse {
+    bool success = false;
+    QByteArray data;            // Body (also kept for error responses, and the part
+                                // received before a timeout or dropped connection)
+    QString error;              // Empty on success
+    int statusCode = 0;         // HTTP status, 0 if none was received
+    QList<QPair<QByteArray, QByteArray>> headers;  // Response headers as received
+    bool timedOut = false;
+    bool cancelled = false;
+
+    /**
+     * @brief Value of a response header (name compared case-insensitively)
+     */
+    QByteArray header(const QByteArray &name) const;
+};
+
+/**
+ * @brief Shared asynchronous HTTP engine for the metadata providers
+ *
+ * Requests run on a few network threads, each with one
+ * QNetworkAccessManager, so a waiting caller neither spins a nested event
+ * loop nor re-enters its own. Requests to the same host always go to the
+ * same worker so its keep-alive connections are reused, and HTTP/2 is
+ * allowed, so servers that speak it multiplex them over one connection.
+ *
+ * Results are delivered as futures (chain with QFuture::then). Identical
+ * requests - same method, URL, headers and body - issued while one is in
+ * flight share its future. Cancelling a future aborts the transfer, for
+ * every caller sharing it.
+ *
+ * wait() is the blocking wrapper the synchronous provider methods use. It
+ * must not be called on a network thread, nor on the GUI thread: it blocks
+ * without an event loop, so the UI would stop painting until it returns.
+ */
+class NetworkClient
+{
+public:
+    using ProgressCallback = std::function<void(qint64 bytesReceived, qint64 bytesTotal)>;
+
+    explicit NetworkClient(int workers = Constants::Network::NETWORK_THREAD_POOL_SIZE);
+    ~NetworkClient();
+
+    NetworkClient(const NetworkClient &) = delete;
+    NetworkClient &operator=(const NetworkClient &) = delete;
+
+    /**
+     * @brief Process-wide client shared by providers and downloaders
+     *
+     * Created on first use and torn down by shutdownShared(), which runs
+     * when the application is about to quit (or, without exec(), when it
+     * is destroyed) - while the event dispatcher still exists.
+     */
+    static NetworkClient &shared();
+
+    /**
+     * @brief Destroy the shared client, cancelling what it has in flight
+     *
+     * A later shared() call creates a new one.
+     */
+    static void shutdownShared();
+
+    /**
+     * @brief Start a GET request
+     * @param timeoutMs Total time allowed; 0 for none
+     * @param progress Called on the network thread as data arrives
+     */
+    QFuture<NetworkResponse> get(const QNetworkRequest &request, int timeoutMs,
+                                 const ProgressCallback &progress = {});
+
+    /**
+     * @brief Start a POST request
+     */
+    QFuture<NetworkResponse> post(const QNetworkRequest &request, const QByteArray &body,
+                                  int timeoutMs);
+
+    /**
+     * @brief Block until a request completes
+     * @return Its response; a cancelled response if the future was cancelled
+     */
+    static NetworkResponse wait(QFuture<NetworkResponse> future);
+
+    /**
+     * @brief Cancel every request in flight
+     */
+    void cancelAll();
+
+    int inFlightCount() const;
+
+    /**
+     * @brief Requests actually sent (joined duplicates not counted)
+     */
+    int requestsStarted() const;
+
+    int workerCount() const { return m_workers.size(); }
+
+private:
+    struct InFlight;
+    class Worker;
+
+    QFuture<NetworkResponse> send(const QByteArray &verb, const QNetworkRequest &request,
+                                  const QByteArray &body, int timeoutMs,
+                                  const ProgressCallback &progress);
+
+    /**
+     * @brief Issue a request on the worker's thread
+     */
+    void start(Worker *worker, const std::shared_ptr<InFlight> &job, const QByteArray &verb,
+               const QNetworkRequest &request, const QByteArray &body, int timeoutMs);
+
+    /**
+     * @brief Publish a response and forget the request
+     */
+    void complete(const std::shared_ptr<InFlight> &job, const NetworkResponse &response);
+
+    QList<QThread *> m_threads;
+    QList<Worker *> m_workers;
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, std::shared_ptr<InFlight>> m_inFlight;   // By request key
+    int m_requestsStarted = 0;
+};
+
+} // namespace Remus
+
+#endif // REMUS_NETWORK_CLIENT_H
@@ -1,8 +1,16 @@
 #include "provider_orchestrator.h"
 #include "filename_normalizer.h"
 #include "hasheous_provider.h"
+#include "metadata_cache.h"
 #include <QDebug>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QScopeGuard>
+#include <QThread>
+#include <QWaitCondition>
 #include <algorithm>
+#include <exception>
 #include "../core/constants/constants.h"
 #include "../core/constants/match_methods.h"
 #include "../core/logging_categories.h"
@@ -20,11 +28,91 @@ namespace Remus {
 
 using namespace Constants;
 
+/**
+ * @brief Thread-safe latency counters, shared with in-flight lookups
+ */
+class ProviderOrchestrator::LatencyRecorder
+{
+public:
+    enum class Outcome { Hit, Miss, Error };
+
+    void record(const QString &provider, qint64 elapsedMs, Outcome outcome, bool abandoned = false)
+    {
+        QMutexLocker locker(&m_mutex);
+        ProviderLatencyStats &stats = m_stats[provider];
+        ++stats.requests;
+        if (outcome == Outcome::Hit) {
+            ++stats.hits;
+        } else if (outcome == Outcome::Error) {
+            ++stats.errors;
+        }
+        if (abandoned) {
+            ++stats.abandoned;
+        }
+        stats.totalMs += elapsedMs;
+        stats.maxMs = qMax(stats.maxMs, elapsedMs);
+        stats.lastMs = elapsedMs;
+    }
+
+    ProviderLatencyStats stats(const QString &provider) const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_stats.value(provider);
+    }
+
+    QMap<QString, ProviderLatencyStats> all() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_stats;
+    }
+
+    void reset()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats.clear();
+    }
+
+private:
+    mutable QMutex m_mutex;
+    QMap<QString, ProviderLatencyStats> m_stats;
+};
+
+namespace {
+
+enum class LaneStatus { Idle, Running, Hit, Miss, Error, Skipped };
+
+/**
+ * @brief What a fan-out and its provider lanes share
+ *
+ * Lanes can outlive the fan-out (a blocking provider call cannot be
+ * interrupted), so this is reference counted and late answers are dropped.
+ */
+template <typename Result>
+struct FanOutState {
+    QMutex mutex;
+    QWaitCondition changed;
+    QList<Result> results;
+    QList<LaneStatus> status;
+    QStringList errors;
+    bool abandoned = false;
+};
+
+} // namespace
+
 ProviderOrchestrator::ProviderOrchestrator(QObject *parent)
     : QObject(parent)
+    , m_hedgeDelayMs(Network::PROVIDER_HEDGE_DELAY_MS)
+    , m_lookupTimeoutMs(Network::PROVIDER_LOOKUP_TIMEOUT_MS)
+    , m_latency(std::make_shared<LatencyRecorder>())
 {
 }
 
+ProviderOrchestrator::~ProviderOrchestrator()
+{
+    // Bring providers home so they are deleted as our children
+    setConcurrentLookups(false);
+}
+
 void ProviderOrchestrator::addProvider(const QString &name, MetadataProvider *provider, int priority)
 {
     if (!provider) {
@@ -41,6 +129,9 @@ void ProviderOrchestrator::addProvider(const QString &name, MetadataProvider *pr
     info.supportsHash = detectHashSupport(name);
     
     m_providers[name] = info;
+    if (m_concurrent) {
+        startProviderThread(name, m_providers[name]);
+    }
     
     qInfo() << "Added provider:" << name 
             << "| Priority:" << priority 
@@ -51,6 +142,7 @@ void ProviderOrchestrator::removeProvider(const QString &name)
 {
     if (m_providers.contains(name)) {
         ProviderInfo info = m_providers.take(name);
+        stopProviderThread(info);
         delete info.provider;
         qInfo() << "Removed provider:" << name;
     }
@@ -81,6 +173,355 @@ bool ProviderOrchestrator::providerSupportsHash(const QString &name) const
     return false;
 }
 
+void ProviderOrchestrator::setConcurrentLookups(bool enabled)
+{
+    if (enabled == m_concurrent) {
+        return;
+    }
+    m_concurrent = enabled;
+
+    for (auto it = m_providers.begin(); it != m_providers.end(); ++it) {
+        if (enabled) {
+            startProviderThread(it.key(), it.value());
+        } else {
+            stopProviderThread(it.value());
+        }
+    }
+    qInfo() << "Concurrent provider lookups" << (enabled ? "enabled" : "disabled");
+}
+
+void ProviderOrchestrator::setHedgeDelay(int ms)
+{
+    m_hedgeDelayMs = qMax(0, ms);
+}
+
+void ProviderOrchestrator::setLookupTimeout(int ms)
+{
+    m_lookupTimeoutMs = qMax(0, ms);
+}
+
+void ProviderOrchestrator::setMetadataCache(MetadataCache *cache)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_cache = cache;
+}
+
+QStringList ProviderOrchestrator::withoutKnownMisses(const QStringList &providers,
+                                                     const QString &hash, const QString &system)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    if (!m_cache) {
+        return providers;
+    }
+
+    QStringList remaining;
+    for (const QString &providerName : providers) {
+        if (m_cache->isKnownMiss(providerName, hash, system)) {
+            qInfo() << "Skipping" << providerName << "- no match for" << hash << "cached";
+            continue;
+        }
+        remaining.append(providerName);
+    }
+    return remaining;
+}
+
+void ProviderOrchestrator::storeMisses(const QStringList &providers, const QString &hash,
+                                       const QString &system)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    if (!m_cache) {
+        return;
+    }
+    for (const QString &providerName : providers) {
+        if (m_cache->negativeTtl(providerName) > 0) {
+            m_cache->storeMiss(providerName, hash, system);
+        }
+    }
+}
+
+ProviderLatencyStats ProviderOrchestrator::providerStats(const QString &name) const
+{
+    return m_latency->stats(name);
+}
+
+QMap<QString, ProviderLatencyStats> ProviderOrchestrator::allProviderStats() const
+{
+    return m_latency->all();
+}
+
+void ProviderOrchestrator::resetProviderStats()
+{
+    m_latency->reset();
+}
+
+void ProviderOrchestrator::logProviderStats() const
+{
+    const auto stats = allProviderStats();
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const ProviderLatencyStats &s = it.value();
+        qInfo().noquote() << QString("Provider %1: %2 lookups, %3 hits, %4 errors, %5 abandoned, "
+                                     "avg %6 ms, max %7 ms")
+                                 .arg(it.key()).arg(s.requests).arg(s.hits).arg(s.errors)
+                                 .arg(s.abandoned).arg(s.averageMs(), 0, 'f', 1).arg(s.maxMs);
+    }
+}
+
+void ProviderOrchestrator::startProviderThread(const QString &name, ProviderInfo &info)
+{
+    if (info.thread) {
+        return;
+    }
+    // A QObject with a parent cannot change threads
+    info.provider->setParent(nullptr);
+    info.thread = new QThread();
+    info.thread->setObjectName(QStringLiteral("provider-%1").arg(name));
+    info.provider->moveToThread(info.thread);
+    info.thread->start();
+}
+
+void ProviderOrchestrator::stopProviderThread(ProviderInfo &info)
+{
+    if (!info.thread) {
+        return;
+    }
+    // Only the provider's own thread can hand it back; this also waits
+    // for a lookup still running there
+    QThread *home = thread();
+    MetadataProvider *provider = info.provider;
+    QMetaObject::invokeMethod(provider, [provider, home]() {
+        provider->moveToThread(home);
+    }, Qt::BlockingQueuedConnection);
+
+    info.thread->quit();
+    info.thread->wait();
+    delete info.thread;
+    info.thread = nullptr;
+    provider->setParent(this);
+}
+
+template <typename Result>
+Result ProviderOrchestrator::callProvider(const ProviderInfo &info,
+                                          const std::function<Result()> &call) const
+{
+    if (!info.thread) {
+        return call();
+    }
+
+    Result result;
+    std::exception_ptr error;
+    QMetaObject::invokeMethod(info.provider, [&]() {
+        try {
+            result = call();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }, Qt::BlockingQueuedConnection);
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+template <typename Result>
+int ProviderOrchestrator::fanOut(const QStringList &providers, const QString &method,
+                                 const std::function<Result(const QString &, MetadataProvider *)> &lookup,
+                                 const std::function<bool(const Result &)> &isHit,
+                                 FanOutMode mode, QList<Result> *results)
+{
+    const int count = providers.size();
+    auto state = std::make_shared<FanOutState<Result>>();
+    state->results.resize(count);
+    state->status.fill(LaneStatus::Idle, count);
+    state->errors.resize(count);
+    const std::shared_ptr<LatencyRecorder> latency = m_latency;
+
+    auto launch = [&](int lane) {
+        const QString providerName = providers.at(lane);
+        MetadataProvider *provider = m_providers.value(providerName).provider;
+        emit tryingProvider(providerName, method);
+        qInfo() << "Asking" << providerName << "(" << method << ")";
+
+        QMetaObject::invokeMethod(provider, [state, lane, providerName, provider, lookup, isHit, latency]() {
+            {
+                QMutexLocker locker(&state->mutex);
+                if (state->abandoned) {
+                    state->status[lane] = LaneStatus::Skipped;
+                    return;
+                }
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            Result result;
+            LaneStatus status;
+            QString error;
+            try {
+                result = lookup(providerName, provider);
+                status = isHit(result) ? LaneStatus::Hit : LaneStatus::Miss;
+            } catch (const std::exception &e) {
+                status = LaneStatus::Error;
+                error = QString::fromUtf8(e.what());
+            }
+
+            QMutexLocker locker(&state->mutex);
+            latency->record(providerName, timer.elapsed(),
+                            status == LaneStatus::Hit ? LatencyRecorder::Outcome::Hit
+                            : status == LaneStatus::Miss ? LatencyRecorder::Outcome::Miss
+                                                         : LatencyRecorder::Outcome::Error,
+                            state->abandoned);
+            state->results[lane] = std::move(result);
+            state->status[lane] = status;
+            state->errors[lane] = error;
+            state->changed.wakeAll();
+        }, Qt::QueuedConnection);
+    };
+
+    const QDeadlineTimer deadline(m_lookupTimeoutMs);
+    QDeadlineTimer nextHedge;   // Expired: the first provider starts at once
+    int launched = 0;
+    int winner = -1;
+
+    QMutexLocker locker(&state->mutex);
+    const QList<LaneStatus> &status = state->status;
+    auto missed = [](LaneStatus s) { return s == LaneStatus::Miss || s == LaneStatus::Error; };
+
+    while (true) {
+        if (mode == FanOutMode::FirstHit) {
+            // Decided once every higher-priority provider has missed
+            int first = 0;
+            while (first < count && missed(status.at(first))) {
+                ++first;
+            }
+            if (first == count) {
+                break;
+            }
+            if (status.at(first) == LaneStatus::Hit) {
+                winner = first;
+                break;
+            }
+        } else if (launched == count
+                   && std::none_of(status.cbegin(), status.cend(),
+                                   [](LaneStatus s) { return s == LaneStatus::Running; })) {
+            break;
+        }
+
+        // Hedge: start the next provider after the delay, or at once when
+        // every started one has missed. Collecting needs all of them anyway.
+        if (launched < count
+            && (mode == FanOutMode::CollectAll || nextHedge.hasExpired()
+                || std::none_of(status.cbegin(), status.cbegin() + launched,
+                                [](LaneStatus s) { return s == LaneStatus::Running; }))) {
+            const int lane = launched++;
+            state->status[lane] = LaneStatus::Running;
+            nextHedge.setRemainingTime(m_hedgeDelayMs);
+            locker.unlock();
+            launch(lane);
+            locker.relock();
+            continue;
+        }
+
+        if (deadline.hasExpired()) {
+            qWarning() << "Provider lookup timed out after" << m_lookupTimeoutMs << "ms";
+            if (mode == FanOutMode::FirstHit) {
+                const auto hit = std::find(status.cbegin(), status.cend(), LaneStatus::Hit);
+                winner = hit == status.cend() ? -1 : int(hit - status.cbegin());
+            }
+            break;
+        }
+
+        const QDeadlineTimer wakeAt = (launched < count && nextHedge.deadline() < deadline.deadline())
+                                          ? nextHedge : deadline;
+        state->changed.wait(&state->mutex, wakeAt);
+    }
+
+    // Lanes not yet running are skipped, late answers ignored
+    state->abandoned = true;
+    const QList<LaneStatus> outcome = state->status;
+    const QStringList errors = state->errors;
+    if (results) {
+        *results = state->results;
+    }
+    locker.unlock();
+
+    for (int lane = 0; lane < launched; ++lane) {
+        const QString &providerName = providers.at(lane);
+        switch (outcome.at(lane)) {
+        case LaneStatus::Hit:
+            if (mode == FanOutMode::CollectAll || lane == winner) {
+                qInfo() << "✓" << providerName << "answered";
+                emit providerSucceeded(providerName, method);
+            } else if (results) {
+                (*results)[lane] = Result();
+            }
+            break;
+        case LaneStatus::Miss:
+            qInfo() << "✗" << providerName << "returned no results";
+            emit providerFailed(providerName, "No results");
+            break;
+        case LaneStatus::Error:
+            qWarning() << "✗" << providerName << "error:" << errors.at(lane);
+            emit providerFailed(providerName, errors.at(lane));
+            break;
+        default:
+            qInfo() << "✗" << providerName << "cancelled";
+            emit providerFailed(providerName, "Cancelled");
+            break;
+        }
+    }
+    return winner;
+}
+
+GameMetadata ProviderOrchestrator::lookupHash(const QString &providerName, MetadataProvider *provider,
+                                              const QString &hash, const QString &system,
+                                              const QString &crc32, const QString &md5, const QString &sha1,
+                                              bool *definiteMiss)
+{
+    // Providers report timeouts and API errors as a signal next to an empty
+    // result; only an empty result without one is a real "no match"
+    bool reportedError = false;
+    const QMetaObject::Connection errorConnection = QObject::connect(
+        provider, &MetadataProvider::errorOccurred, provider,
+        [&reportedError]() { reportedError = true; }, Qt::DirectConnection);
+    const auto disconnectGuard = qScopeGuard([&errorConnection]() {
+        QObject::disconnect(errorConnection);
+    });
+
+    GameMetadata metadata;
+    const bool multiHash = providerName.compare(Constants::Providers::HASHEOUS, Qt::CaseInsensitive) == 0
+        && (!crc32.isEmpty() || !md5.isEmpty() || !sha1.isEmpty());
+    auto *hasheous = multiHash ? qobject_cast<HasheousProvider *>(provider) : nullptr;
+    if (hasheous) {
+        // Prefer multi-hash path when available
+        metadata = hasheous->getByHashes(crc32, md5, sha1, system);
+    } else {
+        metadata = provider->getByHash(hash, system);
+    }
+
+    if (definiteMiss) {
+        *definiteMiss = metadata.title.isEmpty() && !reportedError;
+    }
+    return metadata;
+}
+
+GameMetadata ProviderOrchestrator::lookupName(MetadataProvider *provider, const QString &normalizedName,
+                                              const QString &system)
+{
+    const QList<SearchResult> results = provider->searchByName(normalizedName, system, QString());
+    if (results.isEmpty()) {
+        return GameMetadata();
+    }
+
+    // Use the best match (first result) and fetch full metadata
+    const SearchResult &best = results.first();
+    GameMetadata metadata = provider->getById(best.id);
+    if (!metadata.title.isEmpty()) {
+        metadata.matchScore = best.matchScore;
+        metadata.matchMethod = (best.matchScore >= 0.95f) ? MatchMethods::NAME : MatchMethods::FUZZY;
+    }
+    return metadata;
+}
+
 QStringList ProviderOrchestrator::getSortedProviders(bool hashOnly) const
 {
     QList<QPair<QString, int>> providerPriorities;
@@ -136,8 +577,48 @@ GameMetadata ProviderOrchestrator::getByHashWithFallback(const QString &hash,
         emit allProvidersFailed();
         return GameMetadata();
     }
+
+    hashProviders = withoutKnownMisses(hashProviders, hash, system);
+    if (hashProviders.isEmpty()) {
+        qInfo() << "Every hash provider is known to have no match for hash:" << hash;
+        emit allProvidersFailed();
+        return GameMetadata();
+    }
     
     qInfo() << "Trying hash-based providers:" << hashProviders;
+
+    if (m_concurrent) {
+        // Lanes report their misses from the provider threads
+        struct Misses {
+            QMutex mutex;
+            QStringList providers;
+        };
+        const auto misses = std::make_shared<Misses>();
+        QList<GameMetadata> results;
+        const int winner = fanOut<GameMetadata>(hashProviders, MatchMethods::HASH,
+            [=](const QString &providerName, MetadataProvider *provider) {
+                bool definiteMiss = false;
+                GameMetadata metadata = lookupHash(providerName, provider, hash, system,
+                                                   crc32, md5, sha1, &definiteMiss);
+                if (definiteMiss) {
+                    QMutexLocker locker(&misses->mutex);
+                    misses->providers.append(providerName);
+                }
+                return metadata;
+            },
+            [](const GameMetadata &metadata) { return !metadata.title.isEmpty(); },
+            FanOutMode::FirstHit, &results);
+        {
+            QMutexLocker locker(&misses->mutex);
+            storeMisses(misses->providers, hash, system);
+        }
+        if (winner >= 0) {
+            return results.at(winner);
+        }
+        qWarning() << "All hash providers failed for hash:" << hash;
+        emit allProvidersFailed();
+        return GameMetadata();
+    }
     
     for (const QString &providerName : hashProviders) {
         const ProviderInfo &info = m_providers[providerName];
@@ -145,30 +626,28 @@ GameMetadata ProviderOrchestrator::getByHashWithFallback(const QString &hash,
         emit tryingProvider(providerName, MatchMethods::HASH);
         qInfo() << "Trying" << providerName << "with hash:" << hash;
         
+        QElapsedTimer timer;
+        timer.start();
         try {
-            GameMetadata metadata;
-
-            if (providerName.compare(Constants::Providers::HASHEOUS, Qt::CaseInsensitive) == 0) {
-                // Prefer multi-hash path when available
-                auto *hasheous = qobject_cast<HasheousProvider *>(info.provider);
-                if (hasheous && (!crc32.isEmpty() || !md5.isEmpty() || !sha1.isEmpty())) {
-                    metadata = hasheous->getByHashes(crc32, md5, sha1, system);
-                } else {
-                    metadata = info.provider->getByHash(hash, system);
-                }
-            } else {
-                metadata = info.provider->getByHash(hash, system);
-            }
+            bool definiteMiss = false;
+            GameMetadata metadata = lookupHash(providerName, info.provider, hash, system,
+                                               crc32, md5, sha1, &definiteMiss);
             
             if (!metadata.title.isEmpty()) {
+                m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Hit);
                 qInfo() << "✓" << providerName << "found match:" << metadata.title;
                 emit providerSucceeded(providerName, MatchMethods::HASH);
                 return metadata;
             } else {
+                m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Miss);
                 qInfo() << "✗" << providerName << "returned no results";
                 emit providerFailed(providerName, "No results");
+                if (definiteMiss) {
+                    storeMisses({providerName}, hash, system);
+                }
             }
         } catch (const std::exception &e) {
+            m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Error);
             qWarning() << "✗" << providerName << "error:" << e.what();
             emit providerFailed(providerName, e.what());
         }
@@ -179,6 +658,38 @@ GameMetadata ProviderOrchestrator::getByHashWithFallback(const QString &hash,
     return GameMetadata();
 }
 
+int ProviderOrchestrator::prefetchHashes(const QList<FileHashes> &files)
+{
+    if (files.isEmpty()) {
+        return 0;
+    }
+
+    for (auto it = m_providers.constBegin(); it != m_providers.constEnd(); ++it) {
+        if (it.key().compare(Constants::Providers::HASHEOUS, Qt::CaseInsensitive) != 0
+            || !it.value().enabled) {
+            continue;
+        }
+        auto *hasheous = qobject_cast<HasheousProvider *>(it.value().provider);
+        if (!hasheous) {
+            continue;
+        }
+
+        QList<HasheousProvider::HashSet> hashSets;
+        hashSets.reserve(files.size());
+        for (const FileHashes &file : files) {
+            hashSets.append({file.crc32, file.md5, file.sha1});
+        }
+
+        qInfo() << "Prefetching" << files.size() << "hash lookups from" << it.key();
+        const QList<GameMetadata> results = callProvider<QList<GameMetadata>>(it.value(), [&]() {
+            return hasheous->getByHashesBatch(hashSets);
+        });
+        return static_cast<int>(std::count_if(results.cbegin(), results.cend(),
+            [](const GameMetadata &metadata) { return !metadata.title.isEmpty(); }));
+    }
+    return 0;
+}
+
 QList<SearchResult> ProviderOrchestrator::searchAllProviders(const QString &name, const QString &system)
 {
     if (name.isEmpty()) {
@@ -190,6 +701,25 @@ QList<SearchResult> ProviderOrchestrator::searchAllProviders(const QString &name
     QList<SearchResult> allResults;
     
     qInfo() << "Searching all providers for:" << name << "(" << system << ")";
+
+    if (m_concurrent) {
+        QList<QList<SearchResult>> perProvider;
+        fanOut<QList<SearchResult>>(providers, MatchMethods::NAME,
+            [=](const QString &, MetadataProvider *provider) {
+                return provider->searchByName(name, system);
+            },
+            [](const QList<SearchResult> &results) { return !results.isEmpty(); },
+            FanOutMode::CollectAll, &perProvider);
+
+        // Priority order, as the sequential search returns them
+        for (int i = 0; i < providers.size(); ++i) {
+            for (SearchResult result : std::as_const(perProvider.at(i))) {
+                result.provider = providers.at(i);
+                allResults.append(result);
+            }
+        }
+        providers.clear();
+    }
     
     for (const QString &providerName : providers) {
         const ProviderInfo &info = m_providers[providerName];
@@ -197,10 +727,13 @@ QList<SearchResult> ProviderOrchestrator::searchAllProviders(const QString &name
         emit tryingProvider(providerName, MatchMethods::NAME);
         qInfo() << "Searching" << providerName << "for:" << name;
         
+        QElapsedTimer timer;
+        timer.start();
         try {
             QList<SearchResult> results = info.provider->searchByName(name, system);
             
             if (!results.isEmpty()) {
+                m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Hit);
                 qInfo() << "✓" << providerName << "found" << results.size() << "results";
                 
                 // Tag results with provider name
@@ -211,10 +744,12 @@ QList<SearchResult> ProviderOrchestrator::searchAllProviders(const QString &name
                 allResults.append(results);
                 emit providerSucceeded(providerName, MatchMethods::NAME);
             } else {
+                m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Miss);
                 qInfo() << "✗" << providerName << "returned no results";
                 emit providerFailed(providerName, "No results");
             }
         } catch (const std::exception &e) {
+            m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Error);
             qWarning() << "✗" << providerName << "error:" << e.what();
             emit providerFailed(providerName, e.what());
         }
@@ -259,6 +794,20 @@ GameMetadata ProviderOrchestrator::searchWithFallback(const QString &hash,
         qInfo() << "Normalized name for search:" << name << "->" << normalizedName;
         
         QStringList providers = getSortedProviders(false);
+
+        if (m_concurrent) {
+            QList<GameMetadata> results;
+            const int winner = fanOut<GameMetadata>(providers, MatchMethods::NAME,
+                [=](const QString &, MetadataProvider *provider) {
+                    return lookupName(provider, normalizedName, system);
+                },
+                [](const GameMetadata &metadata) { return !metadata.title.isEmpty(); },
+                FanOutMode::FirstHit, &results);
+            if (winner >= 0) {
+                return results.at(winner);
+            }
+            providers.clear();
+        }
         
         for (const QString &providerName : providers) {
             const ProviderInfo &info = m_providers[providerName];
@@ -266,30 +815,25 @@ GameMetadata ProviderOrchestrator::searchWithFallback(const QString &hash,
             emit tryingProvider(providerName, MatchMethods::NAME);
             qInfo() << "Trying" << providerName << "with name:" << normalizedName;
             
+            QElapsedTimer timer;
+            timer.start();
             try {
-                QList<SearchResult> results = info.provider->searchByName(normalizedName, system, QString());
+                GameMetadata metadata = lookupName(info.provider, normalizedName, system);
                 
-                if (!results.isEmpty()) {
-                    // Use the best match (first result)
-                    const SearchResult &best = results.first();
-                    qInfo() << "✓" << providerName << "found match:" << best.title 
-                            << "(score:" << best.matchScore << ")";
-                    
-                    // Fetch full metadata
-                    GameMetadata metadata = info.provider->getById(best.id);
-                    
-                    if (!metadata.title.isEmpty()) {
-                        metadata.matchScore = best.matchScore;
-                        metadata.matchMethod = (best.matchScore >= 0.95f) ? MatchMethods::NAME : MatchMethods::FUZZY;
-                        emit providerSucceeded(providerName, MatchMethods::NAME);
-                        return metadata;
-                    }
+                if (!metadata.title.isEmpty()) {
+                    m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Hit);
+                    qInfo() << "✓" << providerName << "found match:" << metadata.title
+                            << "(score:" << metadata.matchScore << ")";
+                    emit providerSucceeded(providerName, MatchMethods::NAME);
+                    return metadata;
                 }
                 
+                m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Miss);
                 qInfo() << "✗" << providerName << "returned no results";
                 emit providerFailed(providerName, "No results");
                 
             } catch (const std::exception &e) {
+                m_latency->record(providerName, timer.elapsed(), LatencyRecorder::Outcome::Error);
                 qWarning() << "✗" << providerName << "error:" << e.what();
                 emit providerFailed(providerName, e.what());
             }
@@ -309,7 +853,7 @@ ArtworkUrls ProviderOrchestrator::getArtworkWithFallback(const QString &id, cons
         
         if (info.enabled) {
             qInfo() << "Fetching artwork from preferred provider:" << providerName;
-            return info.provider->getArtwork(id);
+            return callProvider<ArtworkUrls>(info, [&]() { return info.provider->getArtwork(id); });
         }
     }
     
@@ -320,7 +864,7 @@ ArtworkUrls ProviderOrchestrator::getArtworkWithFallback(const QString &id, cons
         const ProviderInfo &info = m_providers[name];
         
         qInfo() << "Trying artwork from:" << name;
-        ArtworkUrls artwork = info.provider->getArtwork(id);
+        ArtworkUrls artwork = callProvider<ArtworkUrls>(info, [&]() { return info.provider->getArtwork(id); });
         
         if (!artwork.boxFront.isEmpty()) {
             qInfo() << "✓ Got artwork from:" << name;
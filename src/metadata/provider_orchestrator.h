@@ -4,9 +4,31 @@
 #include <QObject>
 #include <QList>
 #include <QMap>
+#include <QMutex>
+#include <functional>
+#include <memory>
+
+class QThread;
 
 namespace Remus {
 
+class MetadataCache;
+
+/**
+ * @brief Latency and outcome counters for one provider's lookups
+ */
+struct ProviderLatencyStats {
+    int requests = 0;           // Lookups that completed (hit, miss or error)
+    int hits = 0;               // Lookups that returned a result
+    int errors = 0;             // Lookups that threw
+    int abandoned = 0;          // Completed after the orchestrator had moved on
+    qint64 totalMs = 0;
+    qint64 maxMs = 0;
+    qint64 lastMs = 0;
+
+    double averageMs() const { return requests > 0 ? double(totalMs) / requests : 0.0; }
+};
+
 /**
  * @brief Metadata provider orchestrator with intelligent fallback
  * 
@@ -18,13 +40,26 @@ namespace Remus {
  * 5. IGDB (name) - richest metadata
  * 
  * Provider order can be customized via configuration.
+ *
+ * By default providers are tried one after another on the calling thread.
+ * With setConcurrentLookups(true) every provider gets its own thread and
+ * hash/name lookups fan out: the highest-priority provider starts at once
+ * and each next one after the hedge delay (or immediately once all started
+ * ones missed; a delay of 0 starts all together). The result is returned
+ * as soon as it is decidable - the best-priority hit with no
+ * higher-priority lookup still pending - or when the lookup timeout
+ * expires; later answers are discarded and queued lookups are skipped.
+ * Latency per provider is recorded in both modes.
+ *
+ * With a MetadataCache set, hash lookups skip providers that recently had
+ * no match for the hash and remember new misses.
  */
 class ProviderOrchestrator : public QObject {
     Q_OBJECT
 
 public:
     explicit ProviderOrchestrator(QObject *parent = nullptr);
-    ~ProviderOrchestrator() override = default;
+    ~ProviderOrchestrator() override;
 
     /**
      * @brief Add a provider to the orchestrator
@@ -85,6 +120,26 @@ public:
                                        const QString &md5 = QString(),
                                        const QString &sha1 = QString());
     
+    /**
+     * @brief Hashes of one file, for prefetchHashes() (any may be empty)
+     */
+    struct FileHashes {
+        QString crc32;
+        QString md5;
+        QString sha1;
+    };
+
+    /**
+     * @brief Ask batch-capable providers about many files ahead of their lookups
+     *
+     * Hasheous answers the whole list pipelined (getByHashesBatch()), and
+     * the getByHashWithFallback() calls that follow with the same crc32,
+     * md5 and sha1 reuse its hits and misses instead of sending one request
+     * per file. Blocks like a lookup; does nothing if Hasheous is disabled.
+     * @return Number of files matched
+     */
+    int prefetchHashes(const QList<FileHashes> &files);
+
     /**
      * @brief Get artwork with fallback
      * @param id Game ID
@@ -107,6 +162,56 @@ public:
      */
     bool providerSupportsHash(const QString &name) const;
 
+    /**
+     * @brief Run each provider on its own thread and fan lookups out
+     *
+     * Off by default. Call from the thread that owns the orchestrator.
+     */
+    void setConcurrentLookups(bool enabled);
+    bool concurrentLookups() const { return m_concurrent; }
+
+    /**
+     * @brief Delay before the next provider is also asked (concurrent mode)
+     * @param ms 0 starts every eligible provider at once
+     */
+    void setHedgeDelay(int ms);
+    int hedgeDelay() const { return m_hedgeDelayMs; }
+
+    /**
+     * @brief Longest a concurrent lookup waits for a decidable result
+     */
+    void setLookupTimeout(int ms);
+    int lookupTimeout() const { return m_lookupTimeoutMs; }
+
+    /**
+     * @brief Latency counters of one provider (zeroed if never used)
+     */
+    ProviderLatencyStats providerStats(const QString &name) const;
+
+    /**
+     * @brief Latency counters of every provider that completed a lookup
+     */
+    QMap<QString, ProviderLatencyStats> allProviderStats() const;
+
+    void resetProviderStats();
+
+    /**
+     * @brief Write one line of latency counters per provider to the log
+     */
+    void logProviderStats() const;
+
+    /**
+     * @brief Remember per-provider "no match" answers to hash lookups
+     *
+     * Hash lookups then skip a provider with an unexpired miss for the hash,
+     * and record a miss when a provider answers without a match and without
+     * reporting an error. Providers whose negative TTL is 0 are always asked.
+     * Not owned (nullptr disables). Lookups use the cache from their calling
+     * thread, one at a time, so it needs a connection nothing else uses.
+     */
+    void setMetadataCache(MetadataCache *cache);
+    MetadataCache *metadataCache() const { return m_cache; }
+
 signals:
     /**
      * @brief Emitted when trying a provider
@@ -140,9 +245,79 @@ private:
         int priority;
         bool enabled;
         bool supportsHash;
+        QThread *thread = nullptr;  // Own thread in concurrent mode
+    };
+
+    /// How a fan-out finishes
+    enum class FanOutMode {
+        FirstHit,       // Best-priority hit wins; the rest are abandoned
+        CollectAll      // Wait for every provider (or the timeout)
     };
+
+    class LatencyRecorder;
     
     QMap<QString, ProviderInfo> m_providers;
+    bool m_concurrent = false;
+    int m_hedgeDelayMs;
+    int m_lookupTimeoutMs;
+    std::shared_ptr<LatencyRecorder> m_latency;
+    MetadataCache *m_cache = nullptr;
+    QMutex m_cacheMutex;        // Serializes lookups' use of m_cache
+
+    /**
+     * @brief Move a provider onto its own thread, or back to ours
+     */
+    void startProviderThread(const QString &name, ProviderInfo &info);
+    void stopProviderThread(ProviderInfo &info);
+
+    /**
+     * @brief Run a provider call on the provider's thread and wait for it
+     *
+     * Direct call unless the provider has its own thread. Exceptions are
+     * rethrown on the calling thread.
+     */
+    template <typename Result>
+    Result callProvider(const ProviderInfo &info, const std::function<Result()> &call) const;
+
+    /**
+     * @brief Ask providers concurrently (concurrent mode only)
+     * @param providers Provider names, highest priority first
+     * @param lookup Runs on the provider's thread
+     * @param isHit Whether a result answers the lookup
+     * @param results Receives each provider's result (default for none)
+     * @return Index of the winning provider, or -1 (always -1 for CollectAll)
+     */
+    template <typename Result>
+    int fanOut(const QStringList &providers, const QString &method,
+               const std::function<Result(const QString &, MetadataProvider *)> &lookup,
+               const std::function<bool(const Result &)> &isHit,
+               FanOutMode mode, QList<Result> *results);
+
+    /**
+     * @brief One provider's hash lookup (multi-hash for Hasheous)
+     * @param definiteMiss Set when the provider answered "no match" without an error
+     */
+    static GameMetadata lookupHash(const QString &providerName, MetadataProvider *provider,
+                                   const QString &hash, const QString &system,
+                                   const QString &crc32, const QString &md5, const QString &sha1,
+                                   bool *definiteMiss = nullptr);
+
+    /**
+     * @brief Drop providers the metadata cache knows have no match for a hash
+     */
+    QStringList withoutKnownMisses(const QStringList &providers, const QString &hash,
+                                   const QString &system);
+
+    /**
+     * @brief Record definite misses in the metadata cache
+     */
+    void storeMisses(const QStringList &providers, const QString &hash, const QString &system);
+
+    /**
+     * @brief One provider's name lookup: best search result, then its full metadata
+     */
+    static GameMetadata lookupName(MetadataProvider *provider, const QString &normalizedName,
+                                   const QString &system);
     
     /**
      * @brief Get providers sorted by priority (highest first)
@@ -1,57 +1,352 @@
 #include "rate_limiter.h"
+#include "../core/constants/network.h"
+#include "../core/constants/settings.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QHash>
+#include <QPromise>
+#include <QSettings>
 #include <QThread>
+#include <QTimer>
 #include <QDebug>
+#include <cmath>
+#include <memory>
 
 namespace Remus {
 
+namespace {
+
+QDate currentQuotaDay()
+{
+    return QDateTime::currentDateTimeUtc().date();
+}
+
+/**
+ * @brief Thread with an event loop for acquireAsync() timers
+ *
+ * Callers may have no event loop of their own (pool threads).
+ */
+class TimerThread
+{
+public:
+    TimerThread()
+    {
+        m_thread.setObjectName(QStringLiteral("rate-limiter"));
+        m_context = new QObject();
+        m_context->moveToThread(&m_thread);
+        m_thread.start();
+    }
+
+    ~TimerThread()
+    {
+        // Pending timers go with the context; their promises cancel themselves
+        QObject *context = m_context;
+        QMetaObject::invokeMethod(context, [context]() { delete context; },
+                                  Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    QObject *context() const { return m_context; }
+
+private:
+    QThread m_thread;
+    QObject *m_context;
+};
+
+} // namespace
+
 RateLimiter::RateLimiter(QObject *parent)
     : QObject(parent)
 {
+    m_clock.start();
+    m_quotaDay = currentQuotaDay();
+}
+
+RateLimiter::~RateLimiter()
+{
+    flushUsage();
+}
+
+RateLimiter *RateLimiter::shared(const QString &budget)
+{
+    static QMutex mutex;
+    static QHash<QString, RateLimiter *> limiters;
+
+    QMutexLocker locker(&mutex);
+    RateLimiter *&limiter = limiters[budget];
+    if (!limiter) {
+        limiter = new RateLimiter();
+        limiter->setObjectName(budget);
+    }
+    return limiter;
 }
 
 void RateLimiter::setInterval(int milliseconds)
+{
+    setRate(milliseconds > 0 ? 1000.0 / milliseconds : 0.0, 1);
+}
+
+void RateLimiter::setRate(double requestsPerSecond, int burst)
 {
     QMutexLocker locker(&m_mutex);
-    m_intervalMs = milliseconds;
+    refill();
+    m_ratePerMs = requestsPerSecond > 0.0 ? requestsPerSecond / 1000.0 : 0.0;
+    m_burst = qMax(1, burst);
+    // Start full; later changes keep what is left
+    m_tokens = m_lastRequestAt < 0 ? m_burst : qMin(m_tokens, m_burst);
 }
 
-void RateLimiter::waitIfNeeded()
+void RateLimiter::setDailyQuota(int requests)
 {
     QMutexLocker locker(&m_mutex);
+    m_dailyQuota = qMax(0, requests);
+}
 
-    if (!m_lastRequest.isValid()) {
-        m_lastRequest = QDateTime::currentDateTime();
+int RateLimiter::dailyQuota() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dailyQuota;
+}
+
+void RateLimiter::setPersistenceKey(const QString &key)
+{
+    flushUsage();
+
+    QMutexLocker locker(&m_mutex);
+    const bool wasPersisted = !m_persistenceKey.isEmpty();
+    m_persistenceKey = key;
+    if (key.isEmpty()) {
         return;
     }
+    if (!wasPersisted && QCoreApplication::instance()) {
+        // Shared limiters outlive the application object; save what is left before it goes
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &RateLimiter::flushUsage, Qt::DirectConnection);
+    }
+
+    QSettings settings;
+    settings.beginGroup(QString::fromLatin1(Constants::Settings::Providers::RATE_LIMIT_USAGE_GROUP));
+    settings.beginGroup(key);
+    const QDate storedDay = QDate::fromString(settings.value(QStringLiteral("day")).toString(), Qt::ISODate);
+    rollQuotaDay();
+    if (storedDay == m_quotaDay) {
+        // Another process may have spent some of it too
+        m_usedToday = qMax(m_usedToday, settings.value(QStringLiteral("used")).toInt());
+        m_stats.usedToday = m_usedToday;
+    }
+}
+
+void RateLimiter::refill() const
+{
+    const qint64 now = m_clock.elapsed();
+    if (m_ratePerMs <= 0.0) {
+        m_tokens = m_burst;
+    } else if (m_tokens < m_burst) {
+        m_tokens = qMin(m_burst, m_tokens + double(now - m_refilledAt) * m_ratePerMs);
+    }
+    m_refilledAt = now;
+}
+
+void RateLimiter::rollQuotaDay() const
+{
+    const QDate today = currentQuotaDay();
+    if (today != m_quotaDay) {
+        m_quotaDay = today;
+        m_usedToday = 0;
+        // Yesterday's unsaved uses no longer count against anything
+        m_unsavedUses = 0;
+    }
+}
+
+bool RateLimiter::noteUsage()
+{
+    if (m_persistenceKey.isEmpty()) {
+        return false;
+    }
+    ++m_unsavedUses;
+    return m_unsavedUses >= Constants::Network::RATE_LIMIT_SAVE_BATCH
+           || m_clock.elapsed() - m_savedAt >= Constants::Network::RATE_LIMIT_SAVE_INTERVAL_MS;
+}
+
+void RateLimiter::flushUsage()
+{
+    QMutexLocker saveLocker(&m_saveMutex);
+
+    QString key;
+    QDate day;
+    int uses = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        rollQuotaDay();
+        if (m_persistenceKey.isEmpty() || m_unsavedUses == 0) {
+            return;
+        }
+        key = m_persistenceKey;
+        day = m_quotaDay;
+        uses = m_unsavedUses;
+        m_unsavedUses = 0;
+        m_savedAt = m_clock.elapsed();
+    }
+
+    // Add ours to the stored count as it is now, not as it was at load, so
+    // other processes spending the same quota are not overwritten
+    QSettings settings;
+    settings.sync();
+    settings.beginGroup(QString::fromLatin1(Constants::Settings::Providers::RATE_LIMIT_USAGE_GROUP));
+    settings.beginGroup(key);
+    const QDate storedDay = QDate::fromString(settings.value(QStringLiteral("day")).toString(), Qt::ISODate);
+    const int stored = storedDay == day ? settings.value(QStringLiteral("used")).toInt() : 0;
+    const int total = stored + uses;
+    settings.setValue(QStringLiteral("day"), day.toString(Qt::ISODate));
+    settings.setValue(QStringLiteral("used"), total);
+    settings.endGroup();
+    settings.endGroup();
+    settings.sync();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_quotaDay == day) {
+        // Pick up what the others spent, plus ours since the snapshot
+        m_usedToday = qMax(m_usedToday, total + m_unsavedUses);
+        m_stats.usedToday = m_usedToday;
+    }
+}
+
+bool RateLimiter::tryAcquire()
+{
+    QMutexLocker locker(&m_mutex);
+    refill();
+    rollQuotaDay();
+    if (m_dailyQuota > 0 && m_usedToday >= m_dailyQuota) {
+        ++m_stats.rejected;
+        return false;
+    }
+    if (m_tokens < 1.0) {
+        return false;
+    }
+
+    m_tokens -= 1.0;
+    ++m_usedToday;
+    ++m_stats.acquired;
+    m_stats.usedToday = m_usedToday;
+    m_lastRequestAt = m_clock.elapsed();
+    const bool saveDue = noteUsage();
+    locker.unlock();
+
+    if (saveDue) {
+        flushUsage();
+    }
+    return true;
+}
+
+qint64 RateLimiter::reserve()
+{
+    QMutexLocker locker(&m_mutex);
+    refill();
+    rollQuotaDay();
+    if (m_dailyQuota > 0 && m_usedToday >= m_dailyQuota) {
+        ++m_stats.rejected;
+        return -1;
+    }
 
-    qint64 elapsed = m_lastRequest.msecsTo(QDateTime::currentDateTime());
-    
-    if (elapsed < m_intervalMs) {
-        int sleepTime = m_intervalMs - elapsed;
-        qDebug() << "Rate limiter: waiting" << sleepTime << "ms";
-        locker.unlock();  // Unlock during sleep
-        QThread::msleep(sleepTime);
-        locker.relock();
+    qint64 waitMs = 0;
+    if (m_tokens < 1.0) {
+        waitMs = qint64(std::ceil((1.0 - m_tokens) / m_ratePerMs));
+        ++m_stats.throttled;
+        m_stats.throttledMs += waitMs;
     }
 
-    m_lastRequest = QDateTime::currentDateTime();
+    m_tokens -= 1.0;
+    ++m_usedToday;
+    ++m_stats.acquired;
+    m_stats.usedToday = m_usedToday;
+    m_lastRequestAt = m_clock.elapsed() + waitMs;
+    const bool saveDue = noteUsage();
+    locker.unlock();
+
+    if (saveDue) {
+        flushUsage();
+    }
+    return waitMs;
+}
+
+QFuture<bool> RateLimiter::acquireAsync()
+{
+    static TimerThread timers;
+
+    const qint64 waitMs = reserve();
+    if (waitMs <= 0) {
+        return QtFuture::makeReadyFuture(waitMs == 0);
+    }
+
+    auto promise = std::make_shared<QPromise<bool>>();
+    promise->start();
+    QFuture<bool> future = promise->future();
+    QObject *context = timers.context();
+    QMetaObject::invokeMethod(context, [context, promise, waitMs]() {
+        QTimer::singleShot(waitMs, context, [promise]() {
+            promise->addResult(true);
+            promise->finish();
+        });
+    }, Qt::QueuedConnection);
+    return future;
+}
+
+bool RateLimiter::waitIfNeeded()
+{
+    const qint64 waitMs = reserve();
+    if (waitMs < 0) {
+        qWarning() << "Rate limiter" << objectName() << ": daily quota reached";
+        return false;
+    }
+    if (waitMs > 0) {
+        qDebug() << "Rate limiter: waiting" << waitMs << "ms";
+        QThread::msleep(waitMs);
+    }
+    return true;
+}
+
+qint64 RateLimiter::timeUntilAvailable() const
+{
+    QMutexLocker locker(&m_mutex);
+    refill();
+    rollQuotaDay();
+    if (m_dailyQuota > 0 && m_usedToday >= m_dailyQuota) {
+        return -1;
+    }
+    if (m_tokens >= 1.0) {
+        return 0;
+    }
+    return qint64(std::ceil((1.0 - m_tokens) / m_ratePerMs));
 }
 
 void RateLimiter::reset()
 {
     QMutexLocker locker(&m_mutex);
-    m_lastRequest = QDateTime();
+    m_tokens = m_burst;
+    m_refilledAt = m_clock.elapsed();
+    m_lastRequestAt = -1;
 }
 
 qint64 RateLimiter::timeSinceLastRequest() const
 {
     QMutexLocker locker(&m_mutex);
-    
-    if (!m_lastRequest.isValid()) {
-        return m_intervalMs;  // Return interval if no request yet
+
+    if (m_lastRequestAt < 0) {
+        // Return interval if no request yet
+        return m_ratePerMs > 0.0 ? qint64(1.0 / m_ratePerMs) : 0;
     }
-    
-    return m_lastRequest.msecsTo(QDateTime::currentDateTime());
+
+    return qMax<qint64>(0, m_clock.elapsed() - m_lastRequestAt);
+}
+
+RateLimiterStats RateLimiter::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    rollQuotaDay();
+    RateLimiterStats stats = m_stats;
+    stats.usedToday = m_usedToday;
+    return stats;
 }
 
 } // namespace Remus
@@ -2,35 +2,124 @@
 #define REMUS_RATE_LIMITER_H
 
 #include <QObject>
-#include <QDateTime>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QMutex>
+#include <QString>
 
 namespace Remus {
 
 /**
- * @brief Rate limiter for API requests
- * 
- * Ensures minimum interval between requests to respect API limits.
+ * @brief Throttling counters of a rate limiter
+ */
+struct RateLimiterStats {
+    int acquired = 0;           // Requests let through
+    int throttled = 0;          // ... of which had to wait for a token
+    qint64 throttledMs = 0;     // Total time callers were told to wait
+    int rejected = 0;           // Refused because the daily quota was spent
+    int usedToday = 0;          // Daily quota used (UTC day)
+};
+
+/**
+ * @brief Token-bucket rate limiter for API requests
+ *
+ * Tokens refill at a steady rate up to a burst size; each request takes
+ * one. A request that finds the bucket empty reserves the next token and
+ * is told how long to wait, so concurrent callers get consecutive slots
+ * instead of queueing on a lock. An optional daily quota (UTC day) caps
+ * the total, and can be persisted so a restart does not reset it.
+ *
+ * Providers get their limiter from shared(), so every instance of one
+ * provider in the process spends the same budget. Persisted usage is
+ * written in batches, outside the lock, and added to whatever other
+ * processes stored in the meantime.
  */
 class RateLimiter : public QObject {
     Q_OBJECT
 
 public:
     explicit RateLimiter(QObject *parent = nullptr);
+    ~RateLimiter() override;
+
+    /**
+     * @brief Process-wide limiter for a budget (usually a provider name)
+     *
+     * Created unconfigured on first use and never destroyed.
+     */
+    static RateLimiter *shared(const QString &budget);
 
     /**
      * @brief Set minimum interval between requests (milliseconds)
+     *
+     * Same as setRate(1000 / milliseconds, 1).
      */
     void setInterval(int milliseconds);
 
+    /**
+     * @brief Set the sustained rate and how many requests may go at once
+     * @param requestsPerSecond 0 or less disables rate limiting
+     */
+    void setRate(double requestsPerSecond, int burst = 1);
+
+    /**
+     * @brief Cap requests per UTC day
+     * @param requests 0 for no cap
+     */
+    void setDailyQuota(int requests);
+    int dailyQuota() const;
+
+    /**
+     * @brief Keep daily quota usage in QSettings under this key
+     *
+     * Loads the stored usage if it is from today. Empty disables persistence.
+     */
+    void setPersistenceKey(const QString &key);
+
+    /**
+     * @brief Write usage not yet persisted
+     *
+     * Runs on its own every RATE_LIMIT_SAVE_BATCH requests or
+     * RATE_LIMIT_SAVE_INTERVAL_MS, on destruction and when the application
+     * quits.
+     */
+    void flushUsage();
+
+    /**
+     * @brief Take a token if one is available now
+     * @return False if the caller would have to wait or the quota is spent
+     */
+    bool tryAcquire();
+
+    /**
+     * @brief Reserve the next token without blocking
+     * @return Milliseconds until the reserved slot, or -1 if the daily
+     *         quota is spent (nothing reserved)
+     */
+    qint64 reserve();
+
+    /**
+     * @brief Reserve a token; the future completes when it may be used
+     * @return Future holding false if the daily quota is spent
+     */
+    QFuture<bool> acquireAsync();
+
     /**
      * @brief Wait if necessary to respect rate limit
      * Blocks until it's safe to make next request
+     * @return False (without waiting) if the daily quota is spent
+     */
+    bool waitIfNeeded();
+
+    /**
+     * @brief Milliseconds until a token is available, -1 if the quota is spent
      */
-    void waitIfNeeded();
+    qint64 timeUntilAvailable() const;
 
     /**
      * @brief Reset rate limiter
+     *
+     * Refills the bucket. Daily quota usage is kept.
      */
     void reset();
 
@@ -39,10 +128,33 @@ public:
      */
     qint64 timeSinceLastRequest() const;
 
+    RateLimiterStats stats() const;
+
 private:
-    QDateTime m_lastRequest;
-    int m_intervalMs = 1000;  // Default: 1 second
+    /// Add tokens for the time since the last refill (caller holds the mutex)
+    void refill() const;
+    /// Start a new quota day if the date changed (caller holds the mutex)
+    void rollQuotaDay() const;
+    /// Count one use towards the next save; true if it is due (caller holds the mutex)
+    bool noteUsage();
+
     mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    double m_ratePerMs = 0.001;         // Default: 1 request per second
+    double m_burst = 1.0;
+    mutable double m_tokens = 1.0;      // Negative while slots are reserved ahead
+    mutable qint64 m_refilledAt = 0;    // m_clock time of the last refill
+    qint64 m_lastRequestAt = -1;        // m_clock time of the last acquisition
+
+    int m_dailyQuota = 0;
+    mutable int m_usedToday = 0;
+    mutable QDate m_quotaDay;
+    QString m_persistenceKey;
+    mutable int m_unsavedUses = 0;      // Used today since the last save
+    qint64 m_savedAt = 0;               // m_clock time of the last save
+    QMutex m_saveMutex;                 // Keeps saves from interleaving
+
+    RateLimiterStats m_stats;
 };
 
 } // namespace Remus
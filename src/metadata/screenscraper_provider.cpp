@@ -1,14 +1,12 @@
 #include "screenscraper_provider.h"
+#include "network_client.h"
 #include "../core/system_resolver.h"
 #include "../core/constants/providers.h"
 #include <QNetworkRequest>
-#include <QNetworkReply>
 #include <QUrlQuery>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QEventLoop>
-#include <QTimer>
 #include <QDebug>
 #include "../core/constants/constants.h"
 #include "../core/logging_categories.h"
@@ -26,10 +24,11 @@ namespace Remus {
 
 ScreenScraperProvider::ScreenScraperProvider(QObject *parent)
     : MetadataProvider(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
-    , m_rateLimiter(new RateLimiter(this))
+    , m_rateLimiter(RateLimiter::shared(Constants::Providers::SCREENSCRAPER))
 {
     m_rateLimiter->setInterval(Constants::Network::SCREENSCRAPER_RATE_LIMIT_MS);
+    m_rateLimiter->setDailyQuota(Constants::Network::SCREENSCRAPER_DAILY_QUOTA);
+    m_rateLimiter->setPersistenceKey(Constants::Providers::SCREENSCRAPER);
 }
 
 void ScreenScraperProvider::setCredentials(const QString &username, const QString &password)
@@ -54,7 +53,10 @@ QList<SearchResult> ScreenScraperProvider::searchByName(const QString &title,
         return results;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return results;
+    }
 
     // Build API URL - jeuRecherche.php for name search
     QUrl url(QString(Constants::API::SCREENSCRAPER_BASE_URL) + Constants::API::SCREENSCRAPER_JEURECHERCHE_ENDPOINT);
@@ -118,7 +120,10 @@ GameMetadata ScreenScraperProvider::getByHash(const QString &hash, const QString
         return metadata;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return metadata;
+    }
 
     // Build API URL - jeuInfos.php for hash-based ROM identification
     QUrl url(QString(Constants::API::SCREENSCRAPER_BASE_URL) + Constants::API::SCREENSCRAPER_JEUINFOS_ENDPOINT);
@@ -162,7 +167,10 @@ GameMetadata ScreenScraperProvider::getById(const QString &id)
         return metadata;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return metadata;
+    }
 
     // Build API URL
     QUrl url(QString(Constants::API::SCREENSCRAPER_BASE_URL) + Constants::API::SCREENSCRAPER_GETGAME_ENDPOINT);
@@ -197,7 +205,10 @@ ArtworkUrls ScreenScraperProvider::getArtwork(const QString &id)
         return artwork;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return artwork;
+    }
 
     QUrl url(QString(Constants::API::SCREENSCRAPER_BASE_URL) + Constants::API::SCREENSCRAPER_GETGAME_ENDPOINT);
     QUrlQuery query;
@@ -230,31 +241,19 @@ ScreenScraperProvider::ApiResponse ScreenScraperProvider::makeRequest(const QUrl
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, Constants::API::USER_AGENT);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::SCREENSCRAPER_TIMEOUT_MS);
-
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
-
-    timeout.start();
-    loop.exec();
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().get(request, Constants::Network::SCREENSCRAPER_TIMEOUT_MS));
 
-    if (timeout.isActive()) {
-        timeout.stop();
-        
-        if (reply->error() == QNetworkReply::NoError) {
+    if (!reply.timedOut) {
+        if (reply.success) {
             response.success = true;
-            response.data = reply->readAll();
+            response.data = reply.data;
         } else {
             response.success = false;
-            response.error = reply->errorString();
+            response.error = reply.error;
             
             // Check for rate limiting
-            if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 429) {
+            if (reply.statusCode == 429) {
                 emit rateLimitReached();
             }
         }
@@ -263,7 +262,6 @@ ScreenScraperProvider::ApiResponse ScreenScraperProvider::makeRequest(const QUrl
         response.error = "Request timeout";
     }
 
-    reply->deleteLater();
     return response;
 }
 
@@ -496,7 +494,10 @@ bool ScreenScraperProvider::isAvailable()
         return false;
     }
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return false;
+    }
 
     QUrl url(QString(Constants::API::SCREENSCRAPER_BASE_URL) + "/ssuserInfos.php");
     QUrlQuery query;
@@ -5,7 +5,6 @@
 #include "rate_limiter.h"
 #include "../core/constants/hash_algorithms.h"
 #include "../core/constants/providers.h"
-#include <QNetworkAccessManager>
 
 namespace Remus {
 
@@ -59,7 +58,6 @@ private:
     QString mapSystemToScreenScraper(const QString &system);
     QString detectHashType(const QString &hash);
 
-    QNetworkAccessManager *m_networkManager;
     RateLimiter *m_rateLimiter;
     QString m_devId;
     QString m_devPassword;
@@ -1,12 +1,10 @@
 #include "thegamesdb_provider.h"
+#include "network_client.h"
 #include <QNetworkRequest>
-#include <QNetworkReply>
 #include <QUrlQuery>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QEventLoop>
-#include <QTimer>
 #include <QDebug>
 #include "../core/constants/constants.h"
 
@@ -14,8 +12,7 @@ namespace Remus {
 
 TheGamesDBProvider::TheGamesDBProvider(QObject *parent)
     : MetadataProvider(parent)
-    , m_networkManager(new QNetworkAccessManager(this))
-    , m_rateLimiter(new RateLimiter(this))
+    , m_rateLimiter(RateLimiter::shared(Constants::Providers::THEGAMESDB))
 {
     m_rateLimiter->setInterval(Constants::Network::THEGAMESDB_RATE_LIMIT_MS);
 }
@@ -31,7 +28,10 @@ QList<SearchResult> TheGamesDBProvider::searchByName(const QString &title,
 {
     QList<SearchResult> results;
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return results;
+    }
 
     // Build API URL
     QUrl url(QString(Constants::API::THEGAMESDB_BASE_URL) + Constants::API::THEGAMESDB_GAMES_ENDPOINT);
@@ -114,7 +114,10 @@ GameMetadata TheGamesDBProvider::getById(const QString &id)
 {
     GameMetadata metadata;
 
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return metadata;
+    }
 
     // Build API URL
     QUrl url(QString(Constants::API::THEGAMESDB_BASE_URL) + Constants::API::THEGAMESDB_GAMEINFO_ENDPOINT);
@@ -154,7 +157,10 @@ ArtworkUrls TheGamesDBProvider::getArtwork(const QString &id)
     ArtworkUrls artwork;
 
     // Artwork requires separate API call to Images endpoint
-    m_rateLimiter->waitIfNeeded();
+    if (!m_rateLimiter->waitIfNeeded()) {
+        emit rateLimitReached();
+        return artwork;
+    }
 
     QUrl url(QString(Constants::API::THEGAMESDB_BASE_URL) + Constants::API::THEGAMESDB_IMAGES_ENDPOINT);
     QUrlQuery query;
@@ -221,35 +227,22 @@ TheGamesDBProvider::ApiResponse TheGamesDBProvider::makeRequest(const QUrl &url)
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::UserAgentHeader, Constants::API::USER_AGENT);
 
-    QNetworkReply *reply = m_networkManager->get(request);
-    
-    QEventLoop loop;
-    QTimer timeout;
-    timeout.setSingleShot(true);
-    timeout.setInterval(Constants::Network::THEGAMESDB_TIMEOUT_MS);
-
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    const NetworkResponse reply = NetworkClient::wait(
+        NetworkClient::shared().get(request, Constants::Network::THEGAMESDB_TIMEOUT_MS));
 
-    timeout.start();
-    loop.exec();
-
-    if (timeout.isActive()) {
-        timeout.stop();
-        
-        if (reply->error() == QNetworkReply::NoError) {
+    if (!reply.timedOut) {
+        if (reply.success) {
             response.success = true;
-            response.data = reply->readAll();
+            response.data = reply.data;
         } else {
             response.success = false;
-            response.error = reply->errorString();
+            response.error = reply.error;
         }
     } else {
         response.success = false;
         response.error = "Request timeout";
     }
 
-    reply->deleteLater();
     return response;
 }
 
@@ -5,7 +5,6 @@
 #include "rate_limiter.h"
 #include "../core/system_resolver.h"
 #include "../core/constants/providers.h"
-#include <QNetworkAccessManager>
 
 namespace Remus {
 
@@ -51,7 +50,6 @@ private:
     ApiResponse makeRequest(const QUrl &url);
     GameMetadata parseGameJson(const QJsonObject &game);
 
-    QNetworkAccessManager *m_networkManager;
     RateLimiter *m_rateLimiter;
     QString m_apiKey;
 };
@@ -0,0 +1,245 @@
+#include "title_index.h"
+#include "../core/dat_index.h"
+#include <QRegularExpression>
+#include <algorithm>
+#include <vector>
+
+namespace Remus {
+
+namespace {
+
+/**
+ * @brief Distinct trigrams of a normalised title, padded with one space each side
+ */
+QList<quint64> trigramsOf(const QString &normalized)
+{
+    const QString padded = QLatin1Char(' ') + normalized + QLatin1Char(' ');
+    QList<quint64> trigrams;
+    trigrams.reserve(padded.size());
+    for (qsizetype i = 0; i + 3 <= padded.size(); ++i) {
+        trigrams.append((quint64(padded.at(i).unicode()) << 32)
+                        | (quint64(padded.at(i + 1).unicode()) << 16)
+                        | quint64(padded.at(i + 2).unicode()));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+QStringList distinctWords(const QString &normalized)
+{
+    QStringList words;
+    for (const QString &word : normalized.split(QLatin1Char(' '), Qt::SkipEmptyParts)) {
+        if (!words.contains(word)) {
+            words.append(word);
+        }
+    }
+    return words;
+}
+
+} // namespace
+
+TitleIndex::TitleIndex(const QStringList &titles)
+{
+    QHash<QString, int> titleIds;
+    QHash<QString, QList<int>> words;
+
+    for (int entry = 0; entry < titles.size(); ++entry) {
+        const QString &title = titles.at(entry);
+        if (title.isEmpty() || titleIds.contains(title)) {
+            continue;
+        }
+        const int id = m_titles.size();
+        titleIds.insert(title, id);
+
+        const QString normalized = normalize(title);
+        const QStringList titleWords = distinctWords(normalized);
+        const QList<quint64> trigrams = trigramsOf(normalized);
+
+        m_titles.append(title);
+        m_normalized.append(normalized);
+        m_entries.append(entry);
+        m_wordCounts.append(titleWords.size());
+        m_trigramCounts.append(trigrams.size());
+
+        // Ids only grow, so every posting list stays sorted
+        for (const QString &word : titleWords) {
+            words[word].append(id);
+        }
+        for (quint64 trigram : trigrams) {
+            m_trigramPostings[trigram].append(id);
+        }
+    }
+
+    m_words = words.keys();
+    std::sort(m_words.begin(), m_words.end());
+    m_wordPostings.reserve(m_words.size());
+    for (const QString &word : std::as_const(m_words)) {
+        m_wordPostings.append(words.value(word));
+    }
+}
+
+std::shared_ptr<const TitleIndex> TitleIndex::build(const DatIndex &index)
+{
+    QStringList titles;
+    titles.reserve(index.entryCount());
+    for (int i = 0; i < index.entryCount(); ++i) {
+        titles.append(index.gameName(i));
+    }
+    return std::make_shared<const TitleIndex>(titles);
+}
+
+QString TitleIndex::normalize(const QString &title)
+{
+    // Drop "(USA)", "[!]" and the like
+    QString base;
+    base.reserve(title.size());
+    int depth = 0;
+    for (const QChar c : title) {
+        if (c == QLatin1Char('(') || c == QLatin1Char('[')) {
+            ++depth;
+        } else if (c == QLatin1Char(')') || c == QLatin1Char(']')) {
+            if (depth > 0) {
+                --depth;
+            }
+            base.append(QLatin1Char(' '));
+        } else if (depth == 0) {
+            base.append(c);
+        }
+    }
+
+    // No-Intro sorts articles last: "Legend of Zelda, The - ..." -> "The Legend of Zelda - ..."
+    static const QRegularExpression trailingArticle(
+        "^(.*?),\\s+(The|A|An)(?=\\s*$|\\s+-|\\s*:)",
+        QRegularExpression::CaseInsensitiveOption);
+    base.replace(trailingArticle, "\\2 \\1");
+
+    // Decompose so accents can be dropped: "Pokémon" -> "pokemon"
+    const QString decomposed = base.normalized(QString::NormalizationForm_KD);
+    QString normalized;
+    normalized.reserve(decomposed.size());
+    for (const QChar c : decomposed) {
+        if (c.isMark() || c == QLatin1Char('\'') || c == QChar(0x2019)) {
+            continue; // "Sonic's" -> "sonics"
+        }
+        if (c.isLetterOrNumber()) {
+            normalized.append(c.toLower());
+        } else if (!normalized.isEmpty() && !normalized.endsWith(QLatin1Char(' '))) {
+            normalized.append(QLatin1Char(' '));
+        }
+    }
+    if (normalized.endsWith(QLatin1Char(' '))) {
+        normalized.chop(1);
+    }
+    return normalized;
+}
+
+QList<int> TitleIndex::wordPostings(const QString &word, bool prefix) const
+{
+    auto it = std::lower_bound(m_words.cbegin(), m_words.cend(), word);
+    if (!prefix) {
+        if (it != m_words.cend() && *it == word) {
+            return m_wordPostings.at(it - m_words.cbegin());
+        }
+        return {};
+    }
+
+    QList<int> ids;
+    int expanded = 0;
+    for (; it != m_words.cend() && it->startsWith(word) && expanded < MAX_PREFIX_EXPANSION;
+         ++it, ++expanded) {
+        ids.append(m_wordPostings.at(it - m_words.cbegin()));
+    }
+    if (expanded > 1) {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    return ids;
+}
+
+QList<TitleIndex::Match> TitleIndex::search(const QString &query, int limit,
+                                            const Filter &filter) const
+{
+    const QString normalizedQuery = normalize(query);
+    if (normalizedQuery.isEmpty() || m_titles.isEmpty()) {
+        return {};
+    }
+    const QStringList queryWords = distinctWords(normalizedQuery);
+    const QString lastWord = normalizedQuery.section(QLatin1Char(' '), -1);
+
+    QList<Match> matches;
+    auto accept = [&](int id, float score) {
+        if (!filter || filter(m_titles.at(id))) {
+            matches.append({m_entries.at(id), m_titles.at(id), score});
+        }
+    };
+
+    // Exact, prefix and word-overlap candidates share at least one query word
+    std::vector<quint16> wordHits(m_titles.size(), 0);
+    QList<int> candidates;
+    for (const QString &word : queryWords) {
+        for (int id : wordPostings(word, word == lastWord)) {
+            if (wordHits[id]++ == 0) {
+                candidates.append(id);
+            }
+        }
+    }
+    for (int id : std::as_const(candidates)) {
+        const QString &normalized = m_normalized.at(id);
+        if (normalized == normalizedQuery) {
+            accept(id, 1.0f);
+        } else if (normalized.startsWith(normalizedQuery)) {
+            // Closer in length ranks higher
+            accept(id, 0.9f + 0.05f * float(normalizedQuery.size()) / float(normalized.size()));
+        } else {
+            const float queryCoverage = float(wordHits[id]) / float(queryWords.size());
+            const float titleCoverage = qMin(1.0f, float(wordHits[id]) / float(qMax(1, m_wordCounts.at(id))));
+            accept(id, 0.5f + 0.25f * queryCoverage + 0.1f * titleCoverage);
+        }
+    }
+
+    // Fuzzy (typos, split or joined words) only fills remaining slots
+    if (limit <= 0 || matches.size() < limit) {
+        const QList<quint64> queryTrigrams = trigramsOf(normalizedQuery);
+        std::vector<quint16> shared(m_titles.size(), 0);
+        QList<int> fuzzy;
+        for (quint64 trigram : queryTrigrams) {
+            const auto postings = m_trigramPostings.constFind(trigram);
+            if (postings == m_trigramPostings.cend()) {
+                continue;
+            }
+            for (int id : *postings) {
+                if (wordHits[id] == 0 && shared[id]++ == 0) {
+                    fuzzy.append(id);
+                }
+            }
+        }
+        for (int id : std::as_const(fuzzy)) {
+            const float dice = 2.0f * float(shared[id])
+                               / float(queryTrigrams.size() + m_trigramCounts.at(id));
+            if (dice >= MIN_FUZZY_SIMILARITY) {
+                accept(id, 0.5f * dice);
+            }
+        }
+    }
+
+    // Ties go to the shorter title, then to DAT order
+    auto better = [](const Match &a, const Match &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        if (a.title.size() != b.title.size()) {
+            return a.title.size() < b.title.size();
+        }
+        return a.entry < b.entry;
+    };
+    if (limit > 0 && matches.size() > limit) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+    return matches;
+}
+
+} // namespace Remus
@@ -0,0 +1,109 @@
+#ifndef REMUS_TITLE_INDEX_H
+#define REMUS_TITLE_INDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+
+namespace Remus {
+
+class DatIndex;
+
+/**
+ * @brief In-memory search index over the game titles of one DAT
+ *
+ * Titles are normalised (tags in "(...)"/"[...]" dropped, "Name, The"
+ * turned into "The Name", accents and punctuation removed, lower case)
+ * and indexed twice: an inverted index over whole words and one over
+ * character trigrams. A query only scores titles that share a word or
+ * trigram with it and ranks them
+ *
+ *   exact (1.0) > prefix (0.9-0.95) > word overlap (0.5-0.85) > fuzzy (< 0.5)
+ *
+ * The last query word also matches as a prefix, so partially typed
+ * queries find their titles. Duplicate titles (multi-rom games) are
+ * indexed once, under their first entry. A built index is immutable and
+ * can be searched from any thread.
+ */
+class TitleIndex
+{
+public:
+    /**
+     * @brief One ranked title
+     */
+    struct Match {
+        int entry = -1;         // First DAT entry carrying the title
+        QString title;          // Title as written in the DAT
+        float score = 0.0f;     // 0.0 to 1.0
+    };
+
+    /// Receives a title as written in the DAT; returning false skips it
+    using Filter = std::function<bool(const QString &title)>;
+
+    /// Titles returned when no limit is given
+    static constexpr int DEFAULT_LIMIT = 10;
+
+    /// Trigram (Dice) similarity below which fuzzy candidates are dropped
+    static constexpr float MIN_FUZZY_SIMILARITY = 0.4f;
+
+    /// Vocabulary words a partial last query word may expand to
+    static constexpr int MAX_PREFIX_EXPANSION = 256;
+
+    TitleIndex() = default;
+
+    /**
+     * @brief Index titles; titles[i] is the title of DAT entry i
+     */
+    explicit TitleIndex(const QStringList &titles);
+
+    /**
+     * @brief Index the game names of a DAT index
+     */
+    static std::shared_ptr<const TitleIndex> build(const DatIndex &index);
+
+    /**
+     * @brief Ranked top titles for a query, best first
+     * @param query Free text; normalised the same way as the titles
+     * @param limit Maximum titles returned (<= 0 for all candidates)
+     * @param filter Optional; titles it rejects are skipped
+     */
+    QList<Match> search(const QString &query, int limit = DEFAULT_LIMIT,
+                        const Filter &filter = nullptr) const;
+
+    /**
+     * @brief Number of distinct titles indexed
+     */
+    int titleCount() const { return m_titles.size(); }
+
+    /**
+     * @brief Normalised form of a title, as used for matching
+     *
+     * Example: "Legend of Zelda, The - A Link to the Past (USA)"
+     *          -> "the legend of zelda a link to the past"
+     */
+    static QString normalize(const QString &title);
+
+private:
+    QList<int> wordPostings(const QString &word, bool prefix) const;
+
+    // Per distinct title
+    QStringList m_titles;       // As written in the DAT
+    QStringList m_normalized;   // normalize(title)
+    QList<int> m_entries;       // First entry index
+    QList<int> m_wordCounts;    // Distinct words in the normalised title
+    QList<int> m_trigramCounts; // Distinct trigrams in the normalised title
+
+    // Word vocabulary, sorted for prefix ranges, with ascending title ids
+    QStringList m_words;
+    QList<QList<int>> m_wordPostings;
+
+    // Trigram key -> ascending title ids
+    QHash<quint64, QList<int>> m_trigramPostings;
+};
+
+} // namespace Remus
+
+#endif // REMUS_TITLE_INDEX_H
@@ -1,9 +1,11 @@
 #include "hash_service.h"
 
-#include "../core/hasher.h"
 #include "../core/database.h"
 #include "../core/archive_extractor.h"
+#include "../core/archive_listing_cache.h"
+#include "../core/zip_reader.h"
 
+#include <QDebug>
 #include <QFileInfo>
 #include <QThread>
 #include <QThreadPool>
@@ -62,8 +64,18 @@ int HashService::hashAll(Database *db,
     const int originalMaxThreads = pool->maxThreadCount();
     pool->setMaxThreadCount(maxThreads);
 
+    // CRC-only runs can answer archive members from the scanner's listings
+    ArchiveListingCache loadedListings;
+    const ArchiveListingCache *listingCache = m_listingCache;
+    if (m_crcOnly && !listingCache) {
+        loadedListings.load(*db);
+        listingCache = &loadedListings;
+    }
+
+    const Hasher::ReadStrategy strategy = readStrategy();
+    const bool crcOnly = m_crcOnly;
     QList<HashTaskResult> taskResults = QtConcurrent::blockingMapped(files,
-        [cancelled](const FileRecord &file) {
+        [cancelled, strategy, crcOnly, listingCache](const FileRecord &file) {
             HashTaskResult task;
             task.fileId = file.id;
             task.filename = file.filename;
@@ -75,6 +87,9 @@ int HashService::hashAll(Database *db,
             }
 
             HashService worker;
+            worker.setReadStrategy(strategy);
+            worker.setCrcOnly(crcOnly);
+            worker.setArchiveListingCache(listingCache);
             task.result = worker.hashRecord(file);
             return task;
         });
@@ -83,6 +98,7 @@ int HashService::hashAll(Database *db,
 
     int hashed = 0;
     int done = 0;
+    WriteBatch batch(*db);
     for (const HashTaskResult &task : taskResults) {
         if (task.skipped) {
             done++;
@@ -95,6 +111,7 @@ int HashService::hashAll(Database *db,
                                  task.result.crc32,
                                  task.result.md5,
                                  task.result.sha1);
+            batch.recordWrite();
             hashed++;
         } else if (logCb) {
             logCb(QString("Hash failed for %1: %2").arg(task.filename, task.result.error));
@@ -104,11 +121,43 @@ int HashService::hashAll(Database *db,
         if (progressCb) progressCb(done, total, task.currentPath);
     }
 
+    if (!batch.finish()) {
+        // Each hashed file was one recorded write
+        hashed -= batch.rowsLost();
+        if (logCb) {
+            logCb(QString("Database commit failed, %1 hash updates rolled back: %2")
+                      .arg(batch.rowsLost()).arg(batch.lastError()));
+        }
+    }
+
     if (progressCb) progressCb(total, total, {});
-    if (logCb) logCb(QString("Hashing complete: %1/%2").arg(hashed).arg(total));
+    if (logCb) {
+        logCb(QString("Hashing complete: %1/%2 (%3 rows/s written)")
+                  .arg(hashed).arg(total).arg(qRound(batch.rowsPerSecond())));
+    }
     return hashed;
 }
 
+void HashService::setReadStrategy(Hasher::ReadStrategy strategy)
+{
+    m_hasher->setReadStrategy(strategy);
+}
+
+Hasher::ReadStrategy HashService::readStrategy() const
+{
+    return m_hasher->readStrategy();
+}
+
+void HashService::setCrcOnly(bool crcOnly)
+{
+    m_crcOnly = crcOnly;
+}
+
+void HashService::setArchiveListingCache(const ArchiveListingCache *cache)
+{
+    m_listingCache = cache;
+}
+
 bool HashService::hashFile(Database *db, int fileId)
 {
     if (!db) return false;
@@ -139,10 +188,18 @@ HashResult HashService::hashRecord(const FileRecord &file)
 
     if (!treatAsArchive) {
         int headerSize = Hasher::detectHeaderSize(file.currentPath, file.extension);
+        if (m_crcOnly) {
+            HashResult result;
+            result.crc32 = m_hasher->calculateHash(file.currentPath, "CRC32",
+                                                   headerSize > 0, headerSize);
+            result.success = !result.crc32.isEmpty();
+            if (!result.success) result.error = "Failed to read file or file is empty";
+            return result;
+        }
         return m_hasher->calculateHashes(file.currentPath, headerSize > 0, headerSize);
     }
 
-    // Archive-aware hashing: extract to temp dir, then hash
+    // Archive-aware hashing
     HashResult result;
     QFileInfo archiveInfo(archivePath);
     if (!archiveInfo.exists()) {
@@ -150,6 +207,32 @@ HashResult HashService::hashRecord(const FileRecord &file)
         return result;
     }
 
+    const QString internalPath = file.archiveInternalPath.isEmpty()
+        ? file.filename : file.archiveInternalPath;
+
+    // The scan already recorded the member's CRC32; DATs only key unheadered images by it
+    if (m_crcOnly && m_listingCache && !Hasher::extensionMayHaveHeader(file.extension)) {
+        const QString cachedCrc = m_listingCache->memberCrc32(archiveInfo, internalPath);
+        if (!cachedCrc.isEmpty()) {
+            result.crc32 = cachedCrc;
+            result.success = true;
+            return result;
+        }
+    }
+
+    // ZIP members are inflated in-process; other formats (and ZIP methods
+    // zlib can't decode) go through an external extractor and a temp dir
+    if (ZipReader::isZipPath(archivePath)) {
+        result = m_hasher->calculateZipMemberHashes(archivePath, internalPath,
+                                                    file.extension, m_crcOnly);
+        if (result.success) {
+            return result;
+        }
+        qDebug() << "In-process ZIP hashing failed, extracting instead:"
+                 << archivePath << result.error;
+        result = HashResult();
+    }
+
     QTemporaryDir tempDir;
     if (!tempDir.isValid()) {
         result.error = "Failed to create temporary directory";
@@ -157,9 +240,6 @@ HashResult HashService::hashRecord(const FileRecord &file)
     }
 
     ArchiveExtractor extractor;
-    const QString internalPath = file.archiveInternalPath.isEmpty()
-        ? file.filename : file.archiveInternalPath;
-
     ExtractionResult extraction = extractor.extractFile(archivePath, internalPath, tempDir.path());
 
     if (!extraction.success || extraction.extractedFiles.isEmpty()) {
@@ -5,19 +5,21 @@
 #include <QString>
 #include <QList>
 
+#include "../core/hasher.h"
+
 namespace Remus {
 
+class ArchiveListingCache;
 class Database;
-class Hasher;
 class SystemDetector;
 struct FileRecord;
-struct HashResult;
 
 /**
  * @brief Shared hashing service (non-QObject, callback-based)
  *
  * Wraps Hasher + per-system header detection + DB hash persistence.
- * Supports archive-aware hashing (extracts compressed files to hash them).
+ * Supports archive-aware hashing: ZIP members are inflated in-process,
+ * other archives are extracted to a temporary directory first.
  * Usable by both GUI controllers and TUI screens.
  */
 class HashService {
@@ -57,8 +59,35 @@ public:
      */
     HashResult hashRecord(const FileRecord &file);
 
+    /**
+     * @brief Select how files are read while hashing (applies to hashAll workers too)
+     */
+    void setReadStrategy(Hasher::ReadStrategy strategy);
+    Hasher::ReadStrategy readStrategy() const;
+
+    /**
+     * @brief Compute only CRC32 (MD5/SHA1 left empty)
+     *
+     * For ZIP members without a copier header this reuses the CRC32 stored
+     * in the central directory, so no member data is read at all.
+     */
+    void setCrcOnly(bool crcOnly);
+    bool crcOnly() const { return m_crcOnly; }
+
+    /**
+     * @brief Archive listings to answer CRC-only requests from (not owned)
+     *
+     * In CRC-only mode a member of an unchanged archive whose cached listing
+     * carries its CRC32 is answered without opening the archive, which
+     * also covers 7z and RAR members that would otherwise be extracted.
+     * hashAll() loads the database's listings itself when none is set.
+     */
+    void setArchiveListingCache(const ArchiveListingCache *cache);
+
 private:
     Hasher *m_hasher = nullptr;
+    bool m_crcOnly = false;
+    const ArchiveListingCache *m_listingCache = nullptr;
 };
 
 } // namespace Remus
@@ -1,10 +1,14 @@
 #include "library_service.h"
 
+#include "../core/archive_listing_cache.h"
 #include "../core/scanner.h"
 #include "../core/system_detector.h"
 #include "../core/database.h"
 
+#include <QDir>
 #include <QFileInfo>
+#include <QHash>
+#include <QSet>
 
 namespace Remus {
 
@@ -31,6 +35,7 @@ int LibraryService::scan(const QString &path, Database *db,
     }
 
     if (logCb) logCb(QString("Scanning: %1").arg(path));
+    m_lastSummary = RescanSummary();
 
     // Wire scanner signals to callbacks (direct connections, same thread)
     QMetaObject::Connection progConn, fileConn;
@@ -41,17 +46,38 @@ int LibraryService::scan(const QString &path, Database *db,
             [&](const QString &p) { progressCb(0, 0, p); });
     }
 
+    // Unchanged archives are listed from the previous scan instead of reopened
+    ArchiveListingCache listingCache;
+    listingCache.load(*db);
+    m_scanner->setArchiveListingCache(&listingCache);
+
     QList<ScanResult> results = m_scanner->scan(path);
+    m_scanner->setArchiveListingCache(nullptr);
 
     // Disconnect temporary connections
     if (progConn) QObject::disconnect(progConn);
     if (fileConn) QObject::disconnect(fileConn);
 
     if (m_scanner->wasCancelled()) {
+        // Listings read so far are still valid; only pruning needs a full scan
+        listingCache.flush(*db);
         if (logCb) logCb("Scan cancelled");
         return 0;
     }
 
+    if (!m_scanner->lastError().isEmpty()) {
+        // An empty result here says nothing about the stored rows; keep them
+        if (logCb) logCb(QString("Scan failed: %1").arg(m_scanner->lastError()));
+        return 0;
+    }
+
+    listingCache.flush(*db, path);
+    if (logCb && listingCache.hits() + listingCache.misses() > 0) {
+        logCb(QString("Archive listings: %1 cached, %2 read")
+                  .arg(listingCache.hits())
+                  .arg(listingCache.misses()));
+    }
+
     if (progressCb) progressCb(results.size(), results.size(), {});
     if (logCb) logCb(QString("Scan complete: %1 files").arg(results.size()));
 
@@ -62,9 +88,31 @@ int LibraryService::scan(const QString &path, Database *db,
         return 0;
     }
 
-    int inserted = persistScanResults(results, libraryId, db);
-    if (logCb) logCb(QString("Inserted %1 files into database").arg(inserted));
-    return inserted;
+    const QStringList unlisted = m_scanner->unlistedPaths();
+    if (logCb && !unlisted.isEmpty()) {
+        logCb(QString("Could not list %1 directories or archives; their files are kept")
+                  .arg(unlisted.size()));
+    }
+
+    m_lastSummary = persistScanResults(results, path, unlisted, libraryId, db);
+    if (logCb && m_lastSummary.lostWrites > 0) {
+        logCb(QString("Database commit failed, %1 writes rolled back: %2")
+                  .arg(m_lastSummary.lostWrites)
+                  .arg(m_lastSummary.writeError));
+    }
+    if (logCb) {
+        logCb(QString("Inserted %1 files into database (%2 rows/s)")
+                  .arg(m_lastSummary.added)
+                  .arg(qRound(m_lastSummary.rowsPerSecond)));
+        if (m_lastSummary.unchanged > 0 || m_lastSummary.modified > 0
+            || m_lastSummary.removed > 0) {
+            logCb(QString("Rescan: %1 unchanged, %2 modified, %3 removed")
+                      .arg(m_lastSummary.unchanged)
+                      .arg(m_lastSummary.modified)
+                      .arg(m_lastSummary.removed));
+        }
+    }
+    return m_lastSummary.added;
 }
 
 void LibraryService::cancelScan()
@@ -129,18 +177,28 @@ QStringList LibraryService::getAllExtensions() const
     return m_detector->getAllExtensions();
 }
 
-int LibraryService::persistScanResults(const QList<ScanResult> &results,
-                                       int libraryId, Database *db)
+LibraryService::RescanSummary LibraryService::persistScanResults(
+    const QList<ScanResult> &results, const QString &scanRoot,
+    const QStringList &unlistedPaths, int libraryId, Database *db)
 {
-    int inserted = 0;
-    for (const ScanResult &sr : results) {
-        // Detect system — use internal archive path for compressed files
-        const QString systemDetectPath = sr.isCompressed && !sr.archiveInternalPath.isEmpty()
-            ? sr.archiveInternalPath
-            : sr.path;
-        QString systemName = m_detector->detectSystem(sr.extension, systemDetectPath);
-        int systemId = systemName.isEmpty() ? 0 : db->getSystemId(systemName);
+    RescanSummary summary;
+
+    // Rows are unique on (original_path, filename); archive members share a path
+    auto keyFor = [](const QString &originalPath, const QString &filename) {
+        return originalPath + QLatin1Char('\n') + filename;
+    };
 
+    QHash<QString, Database::FileFingerprintEntry> stored;
+    for (const auto &entry : db->getFileFingerprints(libraryId)) {
+        stored.insert(keyFor(entry.originalPath, entry.filename), entry);
+    }
+
+    QSet<int> seen;
+    seen.reserve(stored.size());
+
+    WriteBatch batch(*db);
+
+    for (const ScanResult &sr : results) {
         FileRecord rec;
         rec.libraryId          = libraryId;
         rec.originalPath       = sr.path;
@@ -151,15 +209,77 @@ int LibraryService::persistScanResults(const QList<ScanResult> &results,
         rec.isCompressed       = sr.isCompressed;
         rec.archivePath        = sr.archivePath;
         rec.archiveInternalPath = sr.archiveInternalPath;
-        rec.systemId           = systemId;
         rec.isPrimary          = sr.isPrimary;
         rec.lastModified       = sr.lastModified;
+        rec.fingerprint        = sr.fingerprint;
+        rec.crc32              = sr.crc32;
+
+        auto it = stored.constFind(keyFor(sr.path, sr.filename));
+        if (it != stored.constEnd()) {
+            const Database::FileFingerprintEntry &entry = it.value();
+            seen.insert(entry.fileId);
+
+            if (entry.fingerprint == sr.fingerprint) {
+                summary.unchanged++;
+            } else if (!entry.fingerprint.isValid()) {
+                // Row predates fingerprinting: adopt the current one without
+                // throwing away hashes we have no reason to distrust
+                db->updateFileFingerprint(entry.fileId, rec, false);
+                batch.recordWrite();
+                summary.unchanged++;
+            } else if (db->updateFileFingerprint(entry.fileId, rec, true)) {
+                batch.recordWrite();
+                summary.modified++;
+            }
+            continue;
+        }
+
+        // Detect system — use internal archive path for compressed files
+        const QString systemDetectPath = sr.isCompressed && !sr.archiveInternalPath.isEmpty()
+            ? sr.archiveInternalPath
+            : sr.path;
+        QString systemName = m_detector->detectSystem(sr.extension, systemDetectPath);
+        rec.systemId = systemName.isEmpty() ? 0 : db->getSystemId(systemName);
 
         if (db->insertFile(rec) > 0) {
-            inserted++;
+            batch.recordWrite();
+            summary.added++;
+        }
+    }
+
+    // Prune rows under the scanned root that the scan did not find. Files an
+    // organize step moved elsewhere are kept as long as they still exist, and
+    // so are files in directories or archives the scan could not list.
+    const QString root = QDir::cleanPath(QFileInfo(scanRoot).absoluteFilePath());
+    const QString rootPrefix = root.endsWith(QLatin1Char('/')) ? root : root + QLatin1Char('/');
+    auto isUnlisted = [&unlistedPaths](const QString &path) {
+        for (const QString &unlisted : unlistedPaths) {
+            if (path == unlisted || path.startsWith(unlisted + QLatin1Char('/'))) {
+                return true;
+            }
         }
+        return false;
+    };
+    for (const auto &entry : std::as_const(stored)) {
+        if (seen.contains(entry.fileId)) continue;
+        if (!entry.originalPath.startsWith(rootPrefix)) continue;
+        if (isUnlisted(entry.originalPath)) continue;
+
+        const bool relocated = entry.currentPath != entry.originalPath;
+        if (relocated && QFileInfo::exists(entry.currentPath)) continue;
+
+        if (db->removeFile(entry.fileId)) {
+            batch.recordWrite();
+            summary.removed++;
+        }
+    }
+
+    if (!batch.finish()) {
+        summary.lostWrites = batch.rowsLost();
+        summary.writeError = batch.lastError();
     }
-    return inserted;
+    summary.rowsPerSecond = batch.rowsPerSecond();
+    return summary;
 }
 
 } // namespace Remus
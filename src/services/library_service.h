@@ -23,6 +23,19 @@ struct FileRecord;
  */
 class LibraryService {
 public:
+    /**
+     * @brief Outcome of reconciling a scan against the stored library
+     */
+    struct RescanSummary {
+        int added = 0;      ///< New files inserted
+        int unchanged = 0;  ///< Fingerprint matched; hashes and matches kept
+        int modified = 0;   ///< Fingerprint changed; hashes reset for re-processing
+        int removed = 0;    ///< Rows pruned because the file is gone
+        int lostWrites = 0; ///< Row writes rolled back because a commit failed
+        QString writeError; ///< Why the last failed commit failed
+        double rowsPerSecond = 0.0;  ///< Database write throughput while persisting
+    };
+
     using ProgressCallback = std::function<void(int done, int total, const QString &path)>;
     using LogCallback      = std::function<void(const QString &message)>;
 
@@ -31,6 +44,13 @@ public:
 
     /**
      * @brief Scan a directory, persist results to database
+     *
+     * Rescanning an existing library is incremental: each file's
+     * (size, mtime, inode) fingerprint is compared with the stored one, so
+     * unchanged files keep their hashes and matches, changed files are queued
+     * for re-hashing, and rows whose file disappeared are removed. Nothing is
+     * persisted or removed if the root is missing or unreadable, and rows
+     * inside directories or archives that could not be listed are kept.
      * @param path       Directory to scan
      * @param db         Database to persist into (caller owns)
      * @param progressCb Progress callback (done, total, currentFile)
@@ -42,6 +62,11 @@ public:
              LogCallback logCb = nullptr,
              int existingLibraryId = 0);
 
+    /**
+     * @brief Breakdown of the most recent completed scan
+     */
+    RescanSummary lastRescanSummary() const { return m_lastSummary; }
+
     /**
      * @brief Cancel a running scan
      */
@@ -83,13 +108,20 @@ public:
 
 private:
     /**
-     * @brief Convert scan results to FileRecords and insert into DB
+     * @brief Reconcile scan results with the library's stored rows
+     *
+     * Inserts new files, refreshes fingerprints of changed ones and prunes
+     * rows under @p scanRoot that the scan no longer finds, except those
+     * at or under one of @p unlistedPaths.
      */
-    int persistScanResults(const QList<ScanResult> &results,
-                           int libraryId, Database *db);
+    RescanSummary persistScanResults(const QList<ScanResult> &results,
+                                     const QString &scanRoot,
+                                     const QStringList &unlistedPaths,
+                                     int libraryId, Database *db);
 
     Scanner        *m_scanner  = nullptr;
     SystemDetector *m_detector = nullptr;
+    RescanSummary   m_lastSummary;
 };
 
 } // namespace Remus
@@ -4,18 +4,22 @@
 #include "../core/database.h"
 
 #include <QFileInfo>
+#include <QHash>
+#include <QtConcurrent/QtConcurrentMap>
 
 namespace Remus {
 
-MatchService::MatchService()
-    : m_engine(new MatchingEngine())
-{
-}
+namespace {
 
-MatchService::~MatchService()
-{
-    delete m_engine;
-}
+struct MatchTaskResult {
+    int fileId = 0;
+    int systemId = 0;
+    QString currentPath;
+    Match match;
+    bool skipped = false;
+};
+
+} // namespace
 
 MatchService::MatchStats MatchService::matchAll(Database *db,
                                                  ProgressCallback progressCb,
@@ -25,21 +29,57 @@ MatchService::MatchStats MatchService::matchAll(Database *db,
     MatchStats stats;
     if (!db) return stats;
 
-    QList<FileRecord> files = db->getAllFiles();
+    // Files that already have a match keep it; rescans drop the matches of changed files
+    QList<FileRecord> files = db->getUnmatchedFiles();
     const int total = files.size();
-    int done = 0;
+    if (progressCb) progressCb(0, total, QString());
 
-    for (const FileRecord &fr : files) {
-        if (cancelled && cancelled->load()) break;
-        if (progressCb) progressCb(done, total, fr.currentPath);
+    if (total == 0) {
+        if (logCb) logCb(QString("Matching complete: nothing to match"));
+        return stats;
+    }
 
-        QFileInfo info(fr.currentPath);
-        QString hash = fr.crc32.isEmpty() ? fr.md5 : fr.crc32;
-        QString systemName = db->getSystemDisplayName(fr.systemId);
+    // Database calls stay on this thread: resolve system names once per run
+    QHash<int, QString> systemNames;
+    for (const FileRecord &fr : std::as_const(files)) {
+        if (!systemNames.contains(fr.systemId)) {
+            systemNames.insert(fr.systemId, db->getSystemDisplayName(fr.systemId));
+        }
+    }
 
-        Match match = m_engine->matchFile(fr.currentPath, hash,
-                                          info.completeBaseName(), systemName);
+    // Matching is pure; the workers never touch the database
+    QList<MatchTaskResult> taskResults = QtConcurrent::blockingMapped(files,
+        [cancelled, &systemNames](const FileRecord &fr) {
+            MatchTaskResult task;
+            task.fileId = fr.id;
+            task.systemId = fr.systemId;
+            task.currentPath = fr.currentPath;
+
+            if (cancelled && cancelled->load()) {
+                task.skipped = true;
+                return task;
+            }
+
+            MatchingEngine engine;
+            const QString hash = fr.crc32.isEmpty() ? fr.md5 : fr.crc32;
+            task.match = engine.matchFile(fr.currentPath, hash,
+                                          QFileInfo(fr.currentPath).completeBaseName(),
+                                          systemNames.value(fr.systemId));
+            return task;
+        });
+
+    // Files of the same game share one lookup of its row
+    QHash<QString, int> gameIds;
+    int done = 0;
+    WriteBatch batch(*db);
+    for (const MatchTaskResult &task : std::as_const(taskResults)) {
+        if (task.skipped) {
+            done++;
+            if (progressCb) progressCb(done, total, task.currentPath);
+            continue;
+        }
 
+        const Match &match = task.match;
         if (match.matchMethod == "hash") {
             stats.hashMatches++;
         } else if (match.matchMethod.contains("name")) {
@@ -50,13 +90,28 @@ MatchService::MatchStats MatchService::matchAll(Database *db,
 
         // Persist match to DB
         if (match.confidence > 0) {
-            int gameId = db->insertGame(match.title, fr.systemId, match.region);
+            const QString gameKey = QString("%1\x1f%2\x1f%3")
+                                        .arg(match.title, QString::number(task.systemId), match.region);
+            int gameId = gameIds.value(gameKey);
+            if (gameId == 0) {
+                gameId = db->insertGame(match.title, task.systemId, match.region);
+                gameIds.insert(gameKey, gameId);
+                batch.recordWrite();
+            }
             if (gameId > 0) {
-                db->insertMatch(fr.id, gameId, match.confidence, match.matchMethod, match.nameMatchScore);
+                db->insertMatch(task.fileId, gameId, match.confidence, match.matchMethod,
+                                match.nameMatchScore);
+                batch.recordWrite();
             }
         }
 
-        ++done;
+        done++;
+        if (progressCb) progressCb(done, total, task.currentPath);
+    }
+
+    if (!batch.finish() && logCb) {
+        logCb(QString("Database commit failed, %1 match writes rolled back: %2")
+                  .arg(batch.rowsLost()).arg(batch.lastError()));
     }
 
     if (progressCb) progressCb(total, total, {});
@@ -79,8 +134,9 @@ Match MatchService::matchFile(Database *db, int fileId)
     QString hash = fr.crc32.isEmpty() ? fr.md5 : fr.crc32;
     QString systemName = db->getSystemDisplayName(fr.systemId);
 
-    Match match = m_engine->matchFile(fr.currentPath, hash,
-                                      info.completeBaseName(), systemName);
+    MatchingEngine engine;
+    Match match = engine.matchFile(fr.currentPath, hash,
+                                   info.completeBaseName(), systemName);
 
     if (match.confidence > 0) {
         int gameId = db->insertGame(match.title, fr.systemId, match.region);
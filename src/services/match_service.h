@@ -11,7 +11,6 @@
 
 namespace Remus {
 
-class MatchingEngine;
 struct Match;
 
 /**
@@ -33,11 +32,11 @@ public:
         int noMatch     = 0;
     };
 
-    MatchService();
-    ~MatchService();
-
     /**
-     * @brief Match all files in the database (offline, DAT-based)
+     * @brief Match every file that has no match yet (offline, DAT-based)
+     *
+     * Files are matched in parallel; their results are written from the
+     * calling thread in batched transactions.
      * @param db         Database (reads files, writes matches)
      * @param progressCb Progress callback
      * @param logCb      Optional log callback
@@ -78,9 +77,6 @@ public:
      * @brief Get the match for a specific file
      */
     Database::MatchResult getMatchForFile(Database *db, int fileId) const;
-
-private:
-    MatchingEngine *m_engine = nullptr;
 };
 
 } // namespace Remus
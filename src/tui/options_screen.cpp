@@ -44,6 +44,12 @@ OptionsScreen::OptionsScreen(TuiApp &app)
     // Section: Performance
     m_fields.push_back({ "PERFORMANCE", "", "", FieldType::Text, true });
     m_fields.push_back({ "Parallel Hashing",   Remus::Constants::Settings::Performance::PARALLEL_HASHING, "true", FieldType::Toggle, false });
+    m_fields.push_back({ "Hash Read Strategy (auto|buffered|pread|mmap|direct)", Remus::Constants::Settings::Performance::READ_STRATEGY,
+                          Remus::Constants::Settings::Defaults::READ_STRATEGY.toStdString(), FieldType::Text, false });
+    m_fields.push_back({ "Concurrent Provider Lookups", Remus::Constants::Settings::Metadata::CONCURRENT_LOOKUPS,
+                          Remus::Constants::Settings::Defaults::CONCURRENT_LOOKUPS.toStdString(), FieldType::Toggle, false });
+    m_fields.push_back({ "Provider Hedge Delay (ms)", Remus::Constants::Settings::Metadata::HEDGE_DELAY_MS,
+                          Remus::Constants::Settings::Defaults::HEDGE_DELAY_MS.toStdString(), FieldType::Text, false });
 
     // Start selection on first non-header field
     m_selected = 1;
@@ -4,7 +4,9 @@
 #include "../services/hash_service.h"
 #include "../services/match_service.h"
 #include "../core/database.h"
+#include "../core/constants/settings.h"
 
+#include <QSettings>
 #include <QSqlDatabase>
 
 bool TuiPipeline::start(const std::string& libraryPath,
@@ -77,6 +79,9 @@ void TuiPipeline::run(const std::string& libraryPath,
 
     // ── Hashing ───────────────────────────────────────────
     Remus::HashService hashService;
+    hashService.setReadStrategy(Remus::Hasher::readStrategyFromName(
+        QSettings().value(Remus::Constants::Settings::Performance::READ_STRATEGY,
+                          Remus::Constants::Settings::Defaults::READ_STRATEGY).toString()));
     hashService.hashAll(
         threadDb.get(),
         [&](int done, int total, const QString &path) {
@@ -39,19 +39,49 @@ ArtworkController::ArtworkController(Database *db,
     
     // Ensure base directory exists
     QDir().mkpath(m_artworkBasePath);
+    m_downloader->setStorePath(m_artworkBasePath + "/" + Constants::Settings::Files::ARTWORK_STORE_SUBDIR);
 
     // Connect downloader signals
     connect(m_downloader, &ArtworkDownloader::downloadCompleted,
             this, [this](const QUrl &url, const QString &filePath) {
-                Q_UNUSED(url);
-                Q_UNUSED(filePath);
-                m_downloadProgress++;
-                emit downloadProgressChanged();
+                const auto target = m_batchTargets.constFind(filePath);
+                if (target == m_batchTargets.cend()) {
+                    m_downloadProgress++;
+                    emit downloadProgressChanged();
+                    return;
+                }
+                
+                const BatchTarget batchTarget = *target;
+                m_batchTargets.erase(target);
+                m_batchUrls[url.toString(QUrl::FullyEncoded)].removeAll(filePath);
+                emit artworkDownloaded(batchTarget.gameId, batchTarget.type, filePath);
+                if (!batchTarget.inBatch) {
+                    settleSingleFile();
+                    return;
+                }
+                m_batchSucceeded.insert(batchTarget.gameId);
+                settleBatchFile(batchTarget.gameId);
             });
 
     connect(m_downloader, &ArtworkDownloader::downloadFailed,
             this, [this](const QUrl &url, const QString &error) {
                 qWarning() << "Artwork download failed:" << url << error;
+                
+                // Every file still waiting on this URL is done for
+                const QStringList destinations = m_batchUrls.take(url.toString(QUrl::FullyEncoded));
+                for (const QString &destPath : destinations) {
+                    const auto target = m_batchTargets.constFind(destPath);
+                    if (target != m_batchTargets.cend()) {
+                        const BatchTarget batchTarget = *target;
+                        m_batchTargets.erase(target);
+                        if (batchTarget.inBatch) {
+                            settleBatchFile(batchTarget.gameId);
+                        } else {
+                            emit artworkFailed(batchTarget.gameId, batchTarget.type, error);
+                            settleSingleFile();
+                        }
+                    }
+                }
             });
 }
 
@@ -60,6 +90,7 @@ void ArtworkController::setArtworkBasePath(const QString &path)
     if (m_artworkBasePath != path) {
         m_artworkBasePath = path;
         QDir().mkpath(m_artworkBasePath);
+        m_downloader->setStorePath(m_artworkBasePath + "/" + Constants::Settings::Files::ARTWORK_STORE_SUBDIR);
         emit artworkBasePathChanged();
     }
 }
@@ -166,43 +197,70 @@ void ArtworkController::downloadArtwork(int gameId, const QStringList &types)
         artworkTypes = {"boxart", "screenshot", "banner", "logo"};
     }
     
-    m_downloading = true;
-    m_downloadProgress = 0;
-    m_downloadTotal = artworkTypes.size();
-    emit downloadingChanged();
-    emit downloadTotalChanged();
+    // Progress counters belong to a running batch; these files just join its queue
+    if (!m_batchRunning && m_singlePending == 0) {
+        m_downloadProgress = 0;
+        m_downloadTotal = 0;
+        m_cancelRequested = false;
+    }
     
     for (const QString &type : artworkTypes) {
-        if (m_cancelRequested) break;
-        
         QUrl url = getArtworkUrl(gameId, type);
         if (url.isValid() && !url.isLocalFile()) {
             downloadSingleArtwork(gameId, type, url);
         }
     }
+    if (m_singlePending == 0) {
+        return;
+    }
     
-    m_downloading = false;
-    m_cancelRequested = false;
-    emit downloadingChanged();
+    if (!m_batchRunning) {
+        emit downloadTotalChanged();
+        emit downloadProgressChanged();
+    }
+    if (!m_downloading) {
+        m_downloading = true;
+        emit downloadingChanged();
+    }
 }
 
 void ArtworkController::downloadSingleArtwork(int gameId, const QString &type, const QUrl &url)
 {
-    QString destPath = getArtworkPath(gameId, type);
-    
-    // Ensure directory exists
-    QFileInfo fileInfo(destPath);
-    QDir().mkpath(fileInfo.absolutePath());
+    const QString destPath = getArtworkPath(gameId, type);
+    if (m_batchTargets.contains(destPath)) {
+        return;     // Already on its way
+    }
     
-    if (m_downloader->download(url, destPath)) {
-        emit artworkDownloaded(gameId, type, destPath);
-    } else {
-        emit artworkFailed(gameId, type, "Download failed");
+    // Queued like a batch file, so the GUI thread never waits on the network
+    m_batchTargets.insert(destPath, {gameId, type, false});
+    m_batchUrls[url.toString(QUrl::FullyEncoded)].append(destPath);
+    ++m_singlePending;
+    if (!m_batchRunning) {
+        ++m_downloadTotal;
+    }
+    m_downloader->enqueue(url, destPath);
+}
+
+void ArtworkController::settleSingleFile()
+{
+    --m_singlePending;
+    if (!m_batchRunning) {
+        m_downloadProgress++;
+        emit downloadProgressChanged();
+    }
+    if (m_singlePending == 0 && !m_batchRunning) {
+        m_downloading = false;
+        m_cancelRequested = false;
+        emit downloadingChanged();
     }
 }
 
 void ArtworkController::downloadAllArtwork(const QString &systemFilter, bool overwrite)
 {
+    if (m_batchRunning) {
+        return;
+    }
+    
     // Get all matched games
     QSqlQuery query(m_db->database());
     
@@ -234,62 +292,99 @@ void ArtworkController::downloadAllArtwork(const QString &systemFilter, bool ove
     }
     
     m_downloading = true;
+    m_batchRunning = true;
     m_cancelRequested = false;
     m_downloadProgress = 0;
     m_downloadTotal = gameIds.size();
     emit downloadingChanged();
     emit downloadTotalChanged();
     
-    int downloaded = 0;
-    int failed = 0;
+    m_batchDownloaded = 0;
+    m_batchFailed = 0;
+    m_batchPending.clear();
+    m_batchSucceeded.clear();
     
     QStringList types = {"boxart", "screenshot"};  // Primary types for batch
     
+    // Queue everything; the downloader fetches a URL shared by several
+    // games once and runs a few transfers per host at a time
     for (int gameId : gameIds) {
-        if (m_cancelRequested) break;
-        
-        bool anySuccess = false;
+        bool anyPresent = false;
         for (const QString &type : types) {
-            if (m_cancelRequested) break;
-            
             // Skip if already exists and not overwriting
             if (!overwrite && hasLocalArtwork(gameId, type)) {
-                anySuccess = true;
+                anyPresent = true;
+                continue;
+            }
+            
+            QString destPath = getArtworkPath(gameId, type);
+            if (m_batchTargets.contains(destPath)) {
+                // Already queued by downloadArtwork()
+                anyPresent = true;
                 continue;
             }
             
             QUrl url = getArtworkUrl(gameId, type);
             if (url.isValid() && !url.isLocalFile()) {
-                QString destPath = getArtworkPath(gameId, type);
-                QFileInfo fileInfo(destPath);
-                QDir().mkpath(fileInfo.absolutePath());
-                
-                if (m_downloader->download(url, destPath)) {
-                    anySuccess = true;
-                    emit artworkDownloaded(gameId, type, destPath);
-                }
+                m_batchTargets.insert(destPath, {gameId, type, true});
+                m_batchUrls[url.toString(QUrl::FullyEncoded)].append(destPath);
+                ++m_batchPending[gameId];
+                m_downloader->enqueue(url, destPath);
             }
         }
         
-        if (anySuccess) {
-            downloaded++;
-        } else {
-            failed++;
+        if (!m_batchPending.contains(gameId)) {
+            // Nothing to fetch for this game
+            if (anyPresent) {
+                m_batchDownloaded++;
+            } else {
+                m_batchFailed++;
+            }
+            m_downloadProgress++;
+        } else if (anyPresent) {
+            m_batchSucceeded.insert(gameId);
         }
-        
-        m_downloadProgress++;
-        emit downloadProgressChanged();
     }
+    emit downloadProgressChanged();
     
-    m_downloading = false;
+    if (m_batchPending.isEmpty()) {
+        finishBatch();
+    }
+}
+
+void ArtworkController::settleBatchFile(int gameId)
+{
+    if (--m_batchPending[gameId] > 0) {
+        return;
+    }
+    m_batchPending.remove(gameId);
+    
+    if (m_batchSucceeded.contains(gameId)) {
+        m_batchDownloaded++;
+    } else {
+        m_batchFailed++;
+    }
+    m_downloadProgress++;
+    emit downloadProgressChanged();
+    
+    if (m_batchPending.isEmpty()) {
+        finishBatch();
+    }
+}
+
+void ArtworkController::finishBatch()
+{
+    m_batchRunning = false;
+    m_downloading = m_singlePending > 0;
     m_cancelRequested = false;
     emit downloadingChanged();
-    emit batchDownloadCompleted(downloaded, failed);
+    emit batchDownloadCompleted(m_batchDownloaded, m_batchFailed);
 }
 
 void ArtworkController::cancelDownloads()
 {
     m_cancelRequested = true;
+    m_downloader->cancelAll();
 }
 
 QVariantMap ArtworkController::getArtworkStats()
@@ -391,7 +486,8 @@ void ArtworkController::clearArtworkCache()
     QDir artworkDir(m_artworkBasePath);
     
     // Remove all subdirectories and files
-    QStringList subdirs = {"boxart", "screenshots", "banners", "logos", "fanart", "titlescreens"};
+    QStringList subdirs = {"boxart", "screenshots", "banners", "logos", "fanart", "titlescreens",
+                           Constants::Settings::Files::ARTWORK_STORE_SUBDIR};
     for (const QString &subdir : subdirs) {
         QDir dir(m_artworkBasePath + "/" + subdir);
         if (dir.exists()) {
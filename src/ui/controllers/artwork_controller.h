@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QUrl>
 #include <QVariantMap>
@@ -69,6 +71,9 @@ public:
 
     /**
      * @brief Download artwork for a specific game
+     *
+     * Queues the files and returns; artworkDownloaded() or artworkFailed()
+     * reports each one.
      * @param gameId Game database ID
      * @param types List of artwork types to download (empty = all)
      */
@@ -76,6 +81,9 @@ public:
 
     /**
      * @brief Batch download artwork for all matched games
+     *
+     * Queues the downloads and returns; batchDownloadCompleted() reports
+     * the outcome. Ignored while a batch is running.
      * @param systemFilter Optional: only download for specific system
      * @param overwrite Whether to re-download existing artwork
      */
@@ -121,7 +129,21 @@ signals:
     void batchDownloadCompleted(int downloaded, int failed);
 
 private:
+    /**
+     * @brief Where a queued download lands
+     */
+    struct BatchTarget {
+        int gameId = 0;
+        QString type;
+        bool inBatch = true;    // Queued by downloadAllArtwork(), not downloadArtwork()
+    };
+
     void downloadSingleArtwork(int gameId, const QString &type, const QUrl &url);
+    /// One of a game's queued files is done (either way)
+    void settleBatchFile(int gameId);
+    /// A downloadArtwork() file is done (either way)
+    void settleSingleFile();
+    void finishBatch();
     QString typeToSubfolder(const QString &type) const;
     QString getArtworkFilename(int gameId, const QString &type) const;
 
@@ -134,6 +156,16 @@ private:
     int m_downloadProgress = 0;
     int m_downloadTotal = 0;
     QString m_artworkBasePath;
+
+    // Queued downloads bookkeeping
+    QHash<QString, BatchTarget> m_batchTargets;     // By destination path
+    int m_singlePending = 0;                        // downloadArtwork() files left
+    bool m_batchRunning = false;
+    QHash<QString, QStringList> m_batchUrls;        // Waiting destinations by URL
+    QHash<int, int> m_batchPending;                 // Files left per game
+    QSet<int> m_batchSucceeded;                     // Games with at least one file
+    int m_batchDownloaded = 0;
+    int m_batchFailed = 0;
 };
 
 } // namespace Remus
@@ -212,46 +212,10 @@ QVariantMap ExportController::getExportPreview(const QStringList &systems)
 
 QString ExportController::getRetroArchSystemName(const QString &system) const
 {
-    // Map system IDs to RetroArch playlist names (using libretro naming conventions)
-    using namespace Constants::Systems;
-    static const QHash<int, QString> mapping = {
-        {ID_NES, "Nintendo - Nintendo Entertainment System"},
-        {ID_SNES, "Nintendo - Super Nintendo Entertainment System"},
-        {ID_N64, "Nintendo - Nintendo 64"},
-        {ID_GB, "Nintendo - Game Boy"},
-        {ID_GBC, "Nintendo - Game Boy Color"},
-        {ID_GBA, "Nintendo - Game Boy Advance"},
-        {ID_NDS, "Nintendo - Nintendo DS"},
-        {ID_GAMECUBE, "Nintendo - GameCube"},
-        {ID_WII, "Nintendo - Wii"},
-        {ID_GENESIS, "Sega - Mega Drive - Genesis"},
-        {ID_MASTER_SYSTEM, "Sega - Master System - Mark III"},
-        {ID_GAME_GEAR, "Sega - Game Gear"},
-        {ID_SATURN, "Sega - Saturn"},
-        {ID_DREAMCAST, "Sega - Dreamcast"},
-        {ID_SEGA_CD, "Sega - Mega-CD - Sega CD"},
-        {ID_32X, "Sega - 32X"},
-        {ID_PSX, "Sony - PlayStation"},
-        {ID_PS2, "Sony - PlayStation 2"},
-        {ID_PSP, "Sony - PlayStation Portable"},
-        {ID_PSVITA, "Sony - PlayStation Vita"},
-        {ID_TURBOGRAFX16, "NEC - PC Engine - TurboGrafx 16"},
-        {ID_TURBOGRAFX_CD, "NEC - PC Engine CD - TurboGrafx-CD"},
-        {ID_NEO_GEO, "SNK - Neo Geo"},
-        {ID_NGP, "SNK - Neo Geo Pocket"},
-        {ID_ARCADE, "MAME"},
-        {ID_ATARI_2600, "Atari - 2600"},
-        {ID_ATARI_7800, "Atari - 7800"},
-        {ID_LYNX, "Atari - Lynx"},
-        {ID_ATARI_JAGUAR, "Atari - Jaguar"},
-        {ID_WONDERSWAN, "Bandai - WonderSwan"},
-        {ID_VIRTUAL_BOY, "Nintendo - Virtual Boy"}
-    };
-    
     // Convert system name to ID, then lookup RetroArch name
-    int systemId = SystemResolver::systemIdByName(system);
-    if (systemId > 0 && mapping.contains(systemId)) {
-        return mapping.value(systemId);
+    const QString retroArchName = SystemResolver::libretroName(SystemResolver::systemIdByName(system));
+    if (!retroArchName.isEmpty()) {
+        return retroArchName;
     }
     
     // Fallback: return the input system name
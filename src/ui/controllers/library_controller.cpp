@@ -2,6 +2,8 @@
 #include <QDebug>
 #include <QDir>
 #include <QFileInfo>
+#include <QSettings>
+#include "../../core/constants/settings.h"
 #include "../../core/logging_categories.h"
 #include "../../services/library_service.h"
 #include "../../services/hash_service.h"
@@ -103,6 +105,9 @@ void LibraryController::hashFiles()
     m_hashing = true;
     emit hashingChanged();
     emit hashingStarted();
+    m_hashService->setReadStrategy(Hasher::readStrategyFromName(
+        QSettings().value(Constants::Settings::Performance::READ_STRATEGY,
+                          Constants::Settings::Defaults::READ_STRATEGY).toString()));
     
     QMetaObject::invokeMethod(this, [this]() {
         int hashed = m_hashService->hashAll(m_db,
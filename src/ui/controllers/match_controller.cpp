@@ -1,11 +1,12 @@
 #include "match_controller.h"
+#include "../../core/fuzzy_matcher.h"
 #include "../../metadata/filename_normalizer.h"
 #include "../../services/match_service.h"
 #include <QDebug>
 #include <QRegularExpression>
 #include <QSqlQuery>
 #include <QSqlError>
-#include <QVector>
+#include <QtConcurrent/QtConcurrentRun>
 #include "../../core/logging_categories.h"
 
 #undef qDebug
@@ -25,10 +26,15 @@ MatchController::MatchController(Database *db, QObject *parent)
     , m_matchService(new MatchService())
 {
     m_orchestrator = new ProviderOrchestrator(this);
+    m_lookupPool.setMaxThreadCount(1);
 }
 
 MatchController::~MatchController()
 {
+    // Let the pool's wait cover only the file being looked up
+    if (m_matchWatcher) {
+        m_matchWatcher->cancel();
+    }
     delete m_matchService;
 }
 
@@ -44,65 +50,60 @@ void MatchController::startMatching()
     
     // Get all files without matches (or with low confidence matches)
     QList<FileRecord> files = m_db->getExistingFiles();
-    int matchedCount = 0;
     int totalFiles = files.size();
     
     qDebug() << "Starting metadata matching for" << totalFiles << "files";
     
-    for (const FileRecord &file : files) {
-        if (!m_matching) {
-            qDebug() << "Matching cancelled";
-            break;
-        }
-        
-        // Skip if already has high confidence match
-        // In real implementation, check matches table first
-        
-        // Try hash-based matching first (highest confidence)
-        QString hash = !file.crc32.isEmpty() ? file.crc32 : 
-                       !file.md5.isEmpty() ? file.md5 : file.sha1;
-        
-        if (!hash.isEmpty()) {
-            QString systemName = getSystemName(file.systemId);
-            GameMetadata metadata = m_orchestrator->getByHashWithFallback(hash, systemName);
-            
-            if (!metadata.title.isEmpty()) {
-                qDebug() << "Hash match found for" << file.filename << "->" << metadata.title;
-                emit matchFound(file.id, metadata.title, 100.0f);
-                matchedCount++;
-                continue;
-            }
-        }
+    // Everything the lookups need is read here; the database stays on this thread
+    QList<LookupRequest> requests;
+    requests.reserve(totalFiles);
+    for (const FileRecord &file : std::as_const(files)) {
+        requests.append(lookupRequest(file));
+    }
+    
+    auto *watcher = new QFutureWatcher<LookupResult>(this);
+    m_matchWatcher = watcher;
+    connect(watcher, &QFutureWatcher<LookupResult>::resultReadyAt, this, [this, watcher](int index) {
+        const LookupResult result = watcher->resultAt(index);
+        emit matchFound(result.fileId, result.metadata.title, result.confidence);
+    });
+    connect(watcher, &QFutureWatcher<LookupResult>::finished, this, [this, watcher, totalFiles]() {
+        const int matchedCount = watcher->future().resultCount();
+        m_matchWatcher = nullptr;
+        watcher->deleteLater();
         
-        // Fall back to name-based matching
-        QString cleanName = Metadata::FilenameNormalizer::normalize(file.filename);
-        QString systemName = getSystemName(file.systemId);
+        m_matching = false;
+        emit matchingChanged();
+        emit matchingCompleted(matchedCount, totalFiles);
         
-        if (!cleanName.isEmpty()) {
-            GameMetadata metadata = m_orchestrator->searchWithFallback("", cleanName, systemName);
-            
-            if (!metadata.title.isEmpty()) {
-                // Calculate confidence based on name similarity
-                float confidence = calculateNameSimilarity(cleanName, metadata.title);
-                qDebug() << "Name match found for" << file.filename << "->" << metadata.title 
-                         << "(" << confidence << "% confidence)";
-                emit matchFound(file.id, metadata.title, confidence);
-                matchedCount++;
+        qDebug() << "Matching complete:" << matchedCount << "/" << totalFiles << "matched";
+    });
+    
+    ProviderOrchestrator *orchestrator = m_orchestrator;
+    watcher->setFuture(QtConcurrent::run(&m_lookupPool,
+        [orchestrator, requests](QPromise<LookupResult> &promise) {
+            for (const LookupRequest &request : requests) {
+                if (promise.isCanceled()) {
+                    qDebug() << "Matching cancelled";
+                    return;
+                }
+                
+                // Skip if already has high confidence match
+                // In real implementation, check matches table first
+                const LookupResult result = lookup(orchestrator, request);
+                if (!result.metadata.title.isEmpty()) {
+                    promise.addResult(result);
+                }
             }
-        }
-    }
-    
-    m_matching = false;
-    emit matchingChanged();
-    emit matchingCompleted(matchedCount, totalFiles);
-    
-    qDebug() << "Matching complete:" << matchedCount << "/" << totalFiles << "matched";
+        }));
 }
 
 void MatchController::stopMatching()
 {
-    m_matching = false;
-    emit matchingChanged();
+    // The lookup in flight completes; matchingCompleted() follows it
+    if (m_matchWatcher) {
+        m_matchWatcher->cancel();
+    }
     qDebug() << "Matching stopped";
 }
 
@@ -116,63 +117,84 @@ void MatchController::matchFile(int fileId)
     
     qDebug() << "Matching single file:" << file.filename;
     
-    // Try hash-based matching first (highest confidence)
-    QString hash = !file.crc32.isEmpty() ? file.crc32 : 
+    ProviderOrchestrator *orchestrator = m_orchestrator;
+    const LookupRequest request = lookupRequest(file);
+    const int systemId = file.systemId;
+    QtConcurrent::run(&m_lookupPool, [orchestrator, request]() {
+        return lookup(orchestrator, request);
+    }).then(this, [this, systemId](const LookupResult &result) {
+        const GameMetadata &metadata = result.metadata;
+        if (metadata.title.isEmpty()) {
+            return;
+        }
+        
+        // Convert genres list to comma-separated string
+        QString genresStr = metadata.genres.join(", ");
+        QString playersStr = metadata.players > 0 ? QString::number(metadata.players) : QString();
+        
+        // Insert game and match with complete metadata
+        int gameId = m_db->insertGame(metadata.title, systemId, metadata.region,
+                                      metadata.publisher, metadata.developer, metadata.releaseDate,
+                                      metadata.description, genresStr, playersStr, metadata.rating);
+        if (gameId > 0) {
+            m_db->insertMatch(result.fileId, gameId, result.confidence, result.matchMethod);
+        }
+        
+        emit matchFound(result.fileId, metadata.title, result.confidence);
+        emit libraryUpdated();
+    });
+}
+
+MatchController::LookupRequest MatchController::lookupRequest(const FileRecord &file) const
+{
+    LookupRequest request;
+    request.fileId = file.id;
+    request.filename = file.filename;
+    request.hash = !file.crc32.isEmpty() ? file.crc32 : 
                    !file.md5.isEmpty() ? file.md5 : file.sha1;
+    request.systemName = getSystemName(file.systemId);
+    return request;
+}
+
+MatchController::LookupResult MatchController::lookup(ProviderOrchestrator *orchestrator,
+                                                      const LookupRequest &request)
+{
+    LookupResult result;
+    result.fileId = request.fileId;
     
-    if (!hash.isEmpty()) {
-        QString systemName = getSystemName(file.systemId);
-        GameMetadata metadata = m_orchestrator->getByHashWithFallback(hash, systemName);
-        
-        if (!metadata.title.isEmpty()) {
-            qDebug() << "Hash match found for" << file.filename << "->" << metadata.title;
-            
-            // Convert genres list to comma-separated string
-            QString genresStr = metadata.genres.join(", ");
-            QString playersStr = metadata.players > 0 ? QString::number(metadata.players) : QString();
+    try {
+        // Try hash-based matching first (highest confidence)
+        if (!request.hash.isEmpty()) {
+            result.metadata = orchestrator->getByHashWithFallback(request.hash, request.systemName);
             
-            // Insert game and match with complete metadata
-            int gameId = m_db->insertGame(metadata.title, file.systemId, metadata.region,
-                                          metadata.publisher, metadata.developer, metadata.releaseDate,
-                                          metadata.description, genresStr, playersStr, metadata.rating);
-            if (gameId > 0) {
-                m_db->insertMatch(file.id, gameId, 100.0f, "hash");
+            if (!result.metadata.title.isEmpty()) {
+                qDebug() << "Hash match found for" << request.filename << "->" << result.metadata.title;
+                result.confidence = 100.0f;
+                result.matchMethod = "hash";
+                return result;
             }
-            
-            emit matchFound(file.id, metadata.title, 100.0f);
-            emit libraryUpdated();
-            return;
         }
-    }
-    
-    // Fall back to name-based matching
-    QString cleanName = Metadata::FilenameNormalizer::normalize(file.filename);
-    QString systemName = getSystemName(file.systemId);
-    
-    if (!cleanName.isEmpty()) {
-        GameMetadata metadata = m_orchestrator->searchWithFallback("", cleanName, systemName);
         
-        if (!metadata.title.isEmpty()) {
-            float confidence = calculateNameSimilarity(cleanName, metadata.title);
-            qDebug() << "Name match found for" << file.filename << "->" << metadata.title 
-                     << "(" << confidence << "% confidence)";
-            
-            // Convert genres list to comma-separated string
-            QString genresStr = metadata.genres.join(", ");
-            QString playersStr = metadata.players > 0 ? QString::number(metadata.players) : QString();
+        // Fall back to name-based matching
+        QString cleanName = Metadata::FilenameNormalizer::normalize(request.filename);
+        
+        if (!cleanName.isEmpty()) {
+            result.metadata = orchestrator->searchWithFallback("", cleanName, request.systemName);
             
-            // Insert game and match with complete metadata
-            int gameId = m_db->insertGame(metadata.title, file.systemId, metadata.region,
-                                          metadata.publisher, metadata.developer, metadata.releaseDate,
-                                          metadata.description, genresStr, playersStr, metadata.rating);
-            if (gameId > 0) {
-                m_db->insertMatch(file.id, gameId, confidence, confidence >= 90 ? "exact" : "fuzzy");
+            if (!result.metadata.title.isEmpty()) {
+                // Calculate confidence based on name similarity
+                result.confidence = calculateNameSimilarity(cleanName, result.metadata.title);
+                result.matchMethod = result.confidence >= 90 ? "exact" : "fuzzy";
+                qDebug() << "Name match found for" << request.filename << "->" << result.metadata.title 
+                         << "(" << result.confidence << "% confidence)";
             }
-            
-            emit matchFound(file.id, metadata.title, confidence);
-            emit libraryUpdated();
         }
+    } catch (const std::exception &e) {
+        // A failed lookup is a miss; the batch goes on with the next file
+        qWarning() << "Metadata lookup failed for" << request.filename << ":" << e.what();
+        result.metadata = GameMetadata();
     }
+    return result;
 }
 
 void MatchController::confirmMatch(int fileId)
@@ -211,10 +233,10 @@ QString MatchController::getSystemName(int systemId) const
     return "Unknown";
 }
 
-float MatchController::calculateNameSimilarity(const QString &name1, const QString &name2) const
+float MatchController::calculateNameSimilarity(const QString &name1, const QString &name2)
 {
-    QString n1 = name1.toLower().simplified();
-    QString n2 = name2.toLower().simplified();
+    QString n1 = FuzzyMatcher::normalize(name1);
+    QString n2 = FuzzyMatcher::normalize(name2);
     
     // Exact match
     if (n1 == n2) return 100.0f;
@@ -222,45 +244,8 @@ float MatchController::calculateNameSimilarity(const QString &name1, const QStri
     // If one contains the other completely
     if (n2.contains(n1) || n1.contains(n2)) return 90.0f;
     
-    // Calculate Levenshtein distance
-    int distance = levenshteinDistance(n1, n2);
-    int maxLength = qMax(n1.length(), n2.length());
-    
-    if (maxLength == 0) return 100.0f;
-    
     // Convert to similarity percentage (100% = identical, 0% = completely different)
-    float similarity = (1.0f - (float)distance / maxLength) * 100.0f;
-    
-    // Set minimum threshold
-    return qMax(0.0f, similarity);
-}
-
-int MatchController::levenshteinDistance(const QString &s1, const QString &s2) const
-{
-    const int len1 = s1.length();
-    const int len2 = s2.length();
-    
-    // Create distance matrix
-    QVector<QVector<int>> d(len1 + 1, QVector<int>(len2 + 1));
-    
-    // Initialize first column and row
-    for (int i = 0; i <= len1; ++i) d[i][0] = i;
-    for (int j = 0; j <= len2; ++j) d[0][j] = j;
-    
-    // Calculate distances
-    for (int i = 1; i <= len1; ++i) {
-        for (int j = 1; j <= len2; ++j) {
-            int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            
-            int deletion = d[i - 1][j] + 1;
-            int insertion = d[i][j - 1] + 1;
-            int substitution = d[i - 1][j - 1] + cost;
-            
-            d[i][j] = qMin(deletion, qMin(insertion, substitution));
-        }
-    }
-    
-    return d[len1][len2];
+    return FuzzyMatcher::similarity(n1, n2) * 100.0f;
 }
 
 } // namespace Remus
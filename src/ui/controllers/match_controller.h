@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QObject>
+#include <QFutureWatcher>
+#include <QThreadPool>
 #include "../core/database.h"
 #include "../metadata/provider_orchestrator.h"
 
@@ -8,6 +10,13 @@ namespace Remus {
 
 class MatchService;
 
+/**
+ * @brief Matches library files against the metadata providers for QML
+ *
+ * Provider lookups run on a worker thread, one at a time; results come
+ * back as signals on the GUI thread, so the view keeps painting and
+ * stopMatching() takes effect between files.
+ */
 class MatchController : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool matching READ isMatching NOTIFY matchingChanged)
@@ -36,14 +45,41 @@ signals:
     void libraryUpdated();
     
 private:
+    /**
+     * @brief A file to look up, read from the database on the GUI thread
+     */
+    struct LookupRequest {
+        int fileId = 0;
+        QString filename;
+        QString hash;
+        QString systemName;
+    };
+
+    /**
+     * @brief What the providers answered for one file
+     */
+    struct LookupResult {
+        int fileId = 0;
+        GameMetadata metadata;
+        float confidence = 0.0f;
+        QString matchMethod;
+    };
+
+    /// Hash lookup, then name search (runs on the lookup thread)
+    static LookupResult lookup(ProviderOrchestrator *orchestrator, const LookupRequest &request);
+    LookupRequest lookupRequest(const FileRecord &file) const;
     QString getSystemName(int systemId) const;
-    float calculateNameSimilarity(const QString &name1, const QString &name2) const;
-    int levenshteinDistance(const QString &s1, const QString &s2) const;
+    static float calculateNameSimilarity(const QString &name1, const QString &name2);
     
     Database *m_db;
     ProviderOrchestrator *m_orchestrator;
     MatchService *m_matchService = nullptr;
     bool m_matching = false;
+    QFutureWatcher<LookupResult> *m_matchWatcher = nullptr;   // startMatching() run
+
+    // Declared last so it is destroyed (waiting for a running lookup)
+    // before the orchestrator it uses
+    QThreadPool m_lookupPool;
 };
 
 } // namespace Remus
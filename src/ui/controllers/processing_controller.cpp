@@ -1,4 +1,5 @@
 #include "processing_controller.h"
+#include "../../core/constants/settings.h"
 #include "../../core/constants/systems.h"
 #include "../../metadata/filename_normalizer.h"
 #include <QDebug>
@@ -9,10 +10,12 @@
 #include <QDateTime>
 #include <QMetaObject>
 #include <QRegularExpression>
+#include <QSettings>
 #include <QSqlQuery>
+#include <QtConcurrent/QtConcurrentRun>
 #include "../../core/logging_categories.h"
 #include "../../core/constants/match_methods.h"
-#include "../../core/constants/hash_algorithms.h"
+#include "../../core/constants/network.h"
 #include "../../core/constants/settings.h"
 
 #undef qDebug
@@ -39,6 +42,21 @@ ProcessingController::ProcessingController(Database *db,
     m_archiveExtractor = new ArchiveExtractor(this);
     m_chdConverter = new CHDConverter(this);
     m_artworkDownloader = new ArtworkDownloader(this);
+    m_lookupPool.setMaxThreadCount(1);
+    
+    // Artwork step downloads come back here; anything else is not ours
+    connect(m_artworkDownloader, &ArtworkDownloader::downloadCompleted,
+            this, [this](const QUrl &, const QString &filePath) {
+                if (m_processing && !m_pendingArtworkPath.isEmpty() && filePath == m_pendingArtworkPath) {
+                    finishArtwork(true);
+                }
+            });
+    connect(m_artworkDownloader, &ArtworkDownloader::downloadFailed,
+            this, [this](const QUrl &url, const QString &) {
+                if (m_processing && !m_pendingArtworkPath.isEmpty() && url == m_pendingArtworkUrl) {
+                    finishArtwork(false);
+                }
+            });
     
     // Timer for async step transitions
     m_stepTimer = new QTimer(this);
@@ -122,6 +140,7 @@ void ProcessingController::setArtworkBasePath(const QString &path)
 {
     if (m_artworkBasePath != path) {
         m_artworkBasePath = path;
+        m_artworkDownloader->setStorePath(m_artworkBasePath + "/" + Constants::Settings::Files::ARTWORK_STORE_SUBDIR);
         emit artworkBasePathChanged();
     }
 }
@@ -151,11 +170,28 @@ void ProcessingController::startProcessing(const QVariantList &fileIds)
         qWarning() << "No valid file IDs in queue";
         return;
     }
+
+    m_hasher->setReadStrategy(Hasher::readStrategyFromName(
+        QSettings().value(Constants::Settings::Performance::READ_STRATEGY,
+                          Constants::Settings::Defaults::READ_STRATEGY).toString()));
+
+    // Files hashed by an earlier run keep their hashes when re-hashed, so
+    // their lookups can be batched ahead; archives get new ones on extraction
+    m_prefetchQueue.clear();
+    for (int fileId : std::as_const(m_fileQueue)) {
+        const FileRecord file = m_db->getFileById(fileId);
+        if (file.id <= 0 || isArchiveFile(file.currentPath)
+            || file.crc32.isEmpty() || file.md5.isEmpty() || file.sha1.isEmpty()) {
+            continue;
+        }
+        m_prefetchQueue.append({fileId, {file.crc32, file.md5, file.sha1}});
+    }
     
     // Initialize state
     m_processing = true;
     m_paused = false;
     m_cancelled = false;
+    ++m_runId;
     m_currentFileIndex = 0;
     m_totalFiles = m_fileQueue.size();
     m_successCount = 0;
@@ -192,6 +228,9 @@ void ProcessingController::resumeProcessing()
     emit pausedChanged();
     qInfo() << "Processing resumed";
     
+    // A lookup or download still out continues the pipeline when it's done
+    if (m_stepPending) return;
+    
     // Continue with current step
     advanceStep();
 }
@@ -204,6 +243,14 @@ void ProcessingController::cancelProcessing()
     m_processing = false;
     m_paused = false;
     m_currentStep = PipelineStep::Idle;
+    m_stepPending = false;
+    ++m_runId;
+    m_prefetchQueue.clear();
+    
+    // A lookup still running finishes on its own and is dropped; an
+    // artwork transfer is aborted
+    m_pendingArtworkPath.clear();
+    m_artworkDownloader->cancelAll();
     
     emit processingChanged();
     emit pausedChanged();
@@ -253,6 +300,9 @@ void ProcessingController::processNextFile()
         setStatusMessage(QString("Complete: %1 processed, %2 failed")
                         .arg(m_successCount).arg(m_failCount));
         qInfo() << "Processing complete. Success:" << m_successCount << "Failed:" << m_failCount;
+        if (m_orchestrator) {
+            m_orchestrator->logProviderStats();
+        }
         return;
     }
     
@@ -487,10 +537,11 @@ void ProcessingController::stepHash()
 {
     qDebug() << "Hashing:" << m_workingFilePath;
     
-    // Calculate hashes using display names (hasher expects uppercase: "CRC32", "MD5", "SHA1")
-    QString crc32 = m_hasher->calculateHash(m_workingFilePath, HashAlgorithms::CRC32_DISPLAY);
-    QString md5 = m_hasher->calculateHash(m_workingFilePath, HashAlgorithms::MD5_DISPLAY);
-    QString sha1 = m_hasher->calculateHash(m_workingFilePath, HashAlgorithms::SHA1_DISPLAY);
+    // Single streaming pass computes all three digests
+    HashResult hashes = m_hasher->calculateHashes(m_workingFilePath);
+    QString crc32 = hashes.crc32;
+    QString md5 = hashes.md5;
+    QString sha1 = hashes.sha1;
     
     // Update database
     m_db->updateFileHashes(m_currentFileId, crc32, md5, sha1);
@@ -513,41 +564,110 @@ void ProcessingController::stepMatch()
     
     // Get system name for provider API calls
     QString systemName = SystemResolver::internalName(m_currentSystemId);
-    GameMetadata metadata;
-    QString matchMethod = MatchMethods::NONE;
-    int confidence = 0;
+    
+    const ProviderOrchestrator::FileHashes hashes{file.crc32, file.md5, file.sha1};
+    const QString cleanName = Metadata::FilenameNormalizer::normalize(m_currentFilename);
+    const QList<ProviderOrchestrator::FileHashes> prefetch = takePrefetchBatch();
+    
+    // The lookup waits on the network; the database is only touched here
+    ProviderOrchestrator *orchestrator = m_orchestrator;
+    const int runId = m_runId;
+    m_stepPending = true;
+    QtConcurrent::run(&m_lookupPool, [orchestrator, prefetch, hashes, cleanName, systemName]() {
+        if (!prefetch.isEmpty()) {
+            orchestrator->prefetchHashes(prefetch);
+        }
+        return lookupMatch(orchestrator, hashes, cleanName, systemName);
+    }).then(this, [this, runId](const MatchLookup &lookup) {
+        if (runId != m_runId) {
+            return;     // Cancelled (or restarted) while the providers were asked
+        }
+        m_stepPending = false;
+        storeMatch(lookup);
+        onStepComplete(true, QString());
+    });
+}
+
+QList<ProviderOrchestrator::FileHashes> ProcessingController::takePrefetchBatch()
+{
+    int index = 0;
+    while (index < m_prefetchQueue.size() && m_prefetchQueue.at(index).first != m_currentFileId) {
+        ++index;
+    }
+    if (index == m_prefetchQueue.size()) {
+        return {};
+    }
+
+    // Entries before the current file belong to files already done
+    const int end = qMin<int>(index + Network::HASHEOUS_BATCH_IN_FLIGHT, m_prefetchQueue.size());
+    QList<ProviderOrchestrator::FileHashes> batch;
+    for (int i = index; i < end; ++i) {
+        batch.append(m_prefetchQueue.at(i).second);
+    }
+    m_prefetchQueue.remove(0, end);
+    return batch;
+}
+
+ProcessingController::MatchLookup ProcessingController::lookupMatch(ProviderOrchestrator *orchestrator,
+                                                                    const ProviderOrchestrator::FileHashes &hashes,
+                                                                    const QString &cleanName,
+                                                                    const QString &systemName)
+{
+    MatchLookup lookup;
+    lookup.matchMethod = MatchMethods::NONE;
     
     // Try hash-based matching with all available hashes
     // Prefer MD5/SHA1 (widely supported by metadata providers like Hasheous)
     // Then try CRC32 (supported by some No-Intro databases)
     QStringList hashesToTry;
-    if (!file.md5.isEmpty()) hashesToTry.append(file.md5);
-    if (!file.sha1.isEmpty()) hashesToTry.append(file.sha1);
-    if (!file.crc32.isEmpty()) hashesToTry.append(file.crc32);
-    
-    for (const QString &hash : hashesToTry) {
-        metadata = m_orchestrator->getByHashWithFallback(hash, systemName);
-        if (!metadata.title.isEmpty()) {
-            matchMethod = MatchMethods::HASH;
-            confidence = 100;
-            qDebug() << "Hash match found:" << metadata.title << "(using" << hash.left(8) << "...)";
-            break;
+    if (!hashes.md5.isEmpty()) hashesToTry.append(hashes.md5);
+    if (!hashes.sha1.isEmpty()) hashesToTry.append(hashes.sha1);
+    if (!hashes.crc32.isEmpty()) hashesToTry.append(hashes.crc32);
+    
+    try {
+        for (const QString &hash : hashesToTry) {
+            // Hasheous takes all three at once (and finds prefetched answers by them)
+            lookup.metadata = orchestrator->getByHashWithFallback(hash, systemName, hashes.crc32,
+                                                                  hashes.md5, hashes.sha1);
+            if (!lookup.metadata.title.isEmpty()) {
+                lookup.matchMethod = MatchMethods::HASH;
+                lookup.confidence = 100;
+                qDebug() << "Hash match found:" << lookup.metadata.title << "(using" << hash.left(8) << "...)";
+                break;
+            }
         }
-    }
-    
-    // Fall back to name-based matching
-    if (metadata.title.isEmpty()) {
-        QString cleanName = Metadata::FilenameNormalizer::normalize(m_currentFilename);
         
-        if (!cleanName.isEmpty()) {
-            metadata = m_orchestrator->searchWithFallback("", cleanName, systemName);
-            if (!metadata.title.isEmpty()) {
-                matchMethod = MatchMethods::NAME;
-                confidence = 70;  // Name match base confidence
-                qDebug() << "Name match found:" << metadata.title;
+        // Fall back to name-based matching
+        if (lookup.metadata.title.isEmpty() && !cleanName.isEmpty()) {
+            lookup.metadata = orchestrator->searchWithFallback("", cleanName, systemName);
+            if (!lookup.metadata.title.isEmpty()) {
+                lookup.matchMethod = MatchMethods::NAME;
+                lookup.confidence = 70;  // Name match base confidence
+                qDebug() << "Name match found:" << lookup.metadata.title;
             }
         }
+    } catch (const std::exception &e) {
+        qWarning() << "Metadata lookup failed:" << e.what();
+        return MatchLookup{GameMetadata(), MatchMethods::NONE, 0, ArtworkUrls()};
+    }
+    
+    // Fetch artwork URLs from provider for the artwork pipeline step
+    const GameMetadata &metadata = lookup.metadata;
+    if (!metadata.title.isEmpty() && !metadata.providerId.isEmpty() && !metadata.id.isEmpty()) {
+        try {
+            lookup.artwork = orchestrator->getArtworkWithFallback(metadata.id, systemName, metadata.providerId);
+        } catch (...) {
+            qDebug() << "Failed to fetch artwork URLs";
+        }
     }
+    return lookup;
+}
+
+void ProcessingController::storeMatch(const MatchLookup &lookup)
+{
+    const GameMetadata &metadata = lookup.metadata;
+    m_pendingArtworkUrl    = QUrl();
+    m_pendingArtworkGameId = -1;
     
     // Store match in database if found
     if (!metadata.title.isEmpty()) {
@@ -572,33 +692,21 @@ void ProcessingController::stepMatch()
         
         if (gameId > 0) {
             // Create match record
-            m_db->insertMatch(m_currentFileId, gameId, confidence, matchMethod);
-            qDebug() << "Match stored: gameId=" << gameId << "confidence=" << confidence;
+            m_db->insertMatch(m_currentFileId, gameId, lookup.confidence, lookup.matchMethod);
+            qDebug() << "Match stored: gameId=" << gameId << "confidence=" << lookup.confidence;
 
             // Emit signal for real-time sidebar update
             emit matchFound(m_currentFileId, metadata.title, metadata.publisher,
-                           releaseYear, confidence, matchMethod);
-
-            // Fetch artwork URLs from provider and cache for the artwork pipeline step
-            ArtworkUrls artwork;
-            if (!metadata.providerId.isEmpty() && !metadata.id.isEmpty()) {
-                try {
-                    artwork = m_orchestrator->getArtworkWithFallback(metadata.id, systemName, metadata.providerId);
-                } catch (...) {
-                    qDebug() << "Failed to fetch artwork URLs";
-                }
-            }
+                           releaseYear, lookup.confidence, lookup.matchMethod);
 
             // Store for stepArtwork — prefer boxFront, fall back to screenshot
+            const ArtworkUrls &artwork = lookup.artwork;
             if (!artwork.boxFront.isEmpty()) {
                 m_pendingArtworkUrl    = artwork.boxFront;
                 m_pendingArtworkGameId = gameId;
             } else if (!artwork.screenshot.isEmpty()) {
                 m_pendingArtworkUrl    = artwork.screenshot;
                 m_pendingArtworkGameId = gameId;
-            } else {
-                m_pendingArtworkUrl    = QUrl();
-                m_pendingArtworkGameId = -1;
             }
 
             // Emit detailed metadata for sidebar display
@@ -612,8 +720,6 @@ void ProcessingController::stepMatch()
                                 metadata.ratingSource);
         }
     }
-    
-    onStepComplete(true, QString());
 }
 
 void ProcessingController::stepMetadata()
@@ -666,9 +772,18 @@ void ProcessingController::stepArtwork()
         return;
     }
 
-    if (m_artworkDownloader->download(m_pendingArtworkUrl, destPath)) {
-        qDebug() << "Artwork downloaded:" << destPath;
-        emit artworkDownloaded(m_currentFileId, m_pendingArtworkGameId, destPath);
+    // Queued; finishArtwork() continues the pipeline once it lands or fails
+    m_pendingArtworkPath = destPath;
+    m_stepPending = true;
+    m_artworkDownloader->enqueue(m_pendingArtworkUrl, destPath);
+}
+
+void ProcessingController::finishArtwork(bool downloaded)
+{
+    m_stepPending = false;
+    if (downloaded) {
+        qDebug() << "Artwork downloaded:" << m_pendingArtworkPath;
+        emit artworkDownloaded(m_currentFileId, m_pendingArtworkGameId, m_pendingArtworkPath);
     } else {
         qWarning() << "Artwork download failed for gameId" << m_pendingArtworkGameId
                    << "URL:" << m_pendingArtworkUrl.toString();
@@ -677,6 +792,7 @@ void ProcessingController::stepArtwork()
     // Reset pending state for next file
     m_pendingArtworkUrl    = QUrl();
     m_pendingArtworkGameId = -1;
+    m_pendingArtworkPath.clear();
 
     onStepComplete(true, QString());
 }
@@ -5,6 +5,7 @@
 #include <QStringList>
 #include <QUrl>
 #include <QVariantList>
+#include <QThreadPool>
 #include <QTimer>
 #include "../../core/database.h"
 #include "../../core/hasher.h"
@@ -41,6 +42,10 @@ enum class PipelineStep {
  * 5. Artwork (download cover art, screenshots)
  * 6. CHD conversion (optional, for disc-based games)
  * 
+ * Provider lookups run on a worker thread and artwork goes through the
+ * downloader's queue, so the GUI thread never waits on the network and
+ * pause/cancel are handled while a request is out.
+ *
  * Exposed to QML as a context property.
  */
 class ProcessingController : public QObject {
@@ -158,6 +163,35 @@ private:
     void advanceStep();
     void completeCurrentFile(bool success, const QString &error = QString());
     
+    /**
+     * @brief What the providers answered for one file
+     */
+    struct MatchLookup {
+        GameMetadata metadata;
+        QString matchMethod;
+        int confidence = 0;
+        ArtworkUrls artwork;
+    };
+
+    /**
+     * @brief Ask the providers about a file (runs on the lookup thread)
+     */
+    static MatchLookup lookupMatch(ProviderOrchestrator *orchestrator,
+                                   const ProviderOrchestrator::FileHashes &hashes,
+                                   const QString &cleanName, const QString &systemName);
+    /**
+     * @brief Hashes to look up in one batch before the current file's lookup
+     *
+     * The current file and the ones after it that were hashed before the
+     * run, up to one batch window; empty if the current file is not among
+     * them or was already covered by an earlier batch.
+     */
+    QList<ProviderOrchestrator::FileHashes> takePrefetchBatch();
+    /// Store a match found by lookupMatch() and announce it
+    void storeMatch(const MatchLookup &lookup);
+    /// The artwork step's download is done (either way)
+    void finishArtwork(bool downloaded);
+
     // Individual pipeline steps
     void stepExtract();
     void stepHash();
@@ -188,9 +222,12 @@ private:
     bool m_processing = false;
     bool m_paused = false;
     bool m_cancelled = false;
+    bool m_stepPending = false;      // A step waits on a lookup or download
+    int m_runId = 0;                 // Bumped per start/cancel; stale lookups check it
     
     // Queue management
     QList<int> m_fileQueue;
+    QList<QPair<int, ProviderOrchestrator::FileHashes>> m_prefetchQueue;  // Hashed before the run, queue order
     int m_currentFileIndex = 0;
     int m_totalFiles = 0;
     int m_successCount = 0;
@@ -218,9 +255,14 @@ private:
     QString m_artworkBasePath;
     QUrl    m_pendingArtworkUrl;
     int     m_pendingArtworkGameId = -1;
+    QString m_pendingArtworkPath;   // Destination of the download in flight
 
     // Timer for async step completion
     QTimer *m_stepTimer;
+
+    // Provider lookups, one at a time; declared last so it is destroyed
+    // (waiting for a running lookup) before anything the lookup touches
+    QThreadPool m_lookupPool;
 };
 
 } // namespace Remus
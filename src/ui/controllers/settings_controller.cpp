@@ -64,11 +64,14 @@ QVariantMap SettingsController::keys() const
     map["igdbClientId"] = Constants::Settings::Providers::IGDB_CLIENT_ID;
     map["igdbClientSecret"] = Constants::Settings::Providers::IGDB_CLIENT_SECRET;
     map["metadataProviderPriority"] = Constants::Settings::Metadata::PROVIDER_PRIORITY;
+    map["metadataConcurrentLookups"] = Constants::Settings::Metadata::CONCURRENT_LOOKUPS;
+    map["metadataHedgeDelayMs"] = Constants::Settings::Metadata::HEDGE_DELAY_MS;
     map["organizeNamingTemplate"] = Constants::Settings::Organize::NAMING_TEMPLATE;
     map["organizeBySystem"] = Constants::Settings::Organize::BY_SYSTEM;
     map["organizePreserveOriginals"] = Constants::Settings::Organize::PRESERVE_ORIGINALS;
     map["performanceHashAlgorithm"] = Constants::Settings::Performance::HASH_ALGORITHM;
     map["performanceParallelHashing"] = Constants::Settings::Performance::PARALLEL_HASHING;
+    map["performanceReadStrategy"] = Constants::Settings::Performance::READ_STRATEGY;
     return map;
 }
 
@@ -81,6 +84,9 @@ QVariantMap SettingsController::defaults() const
     map["organizeBySystem"] = Constants::Settings::Defaults::ORGANIZE_BY_SYSTEM;
     map["preserveOriginals"] = Constants::Settings::Defaults::PRESERVE_ORIGINALS;
     map["parallelHashing"] = Constants::Settings::Defaults::PARALLEL_HASHING;
+    map["readStrategy"] = Constants::Settings::Defaults::READ_STRATEGY;
+    map["concurrentLookups"] = Constants::Settings::Defaults::CONCURRENT_LOOKUPS;
+    map["hedgeDelayMs"] = Constants::Settings::Defaults::HEDGE_DELAY_MS;
     map["templateVariableHint"] = Constants::Settings::Defaults::TEMPLATE_VARIABLE_HINT;
     return map;
 }
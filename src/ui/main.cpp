@@ -4,6 +4,7 @@
 #include <QIcon>
 #include <QStandardPaths>
 #include <QSettings>
+#include <QSqlDatabase>
 #include <QDir>
 #include <QDebug>
 #include "../core/database.h"
@@ -23,6 +24,7 @@
 #include "theme_constants.h"
 #include "../core/constants/constants.h"
 #include "../metadata/provider_orchestrator.h"
+#include "../metadata/metadata_cache.h"
 #include "../metadata/local_database_provider.h"
 #include "../metadata/hasheous_provider.h"
 #include "../metadata/screenscraper_provider.h"
@@ -66,8 +68,21 @@ int main(int argc, char *argv[])
     FileListModel fileListModel(&db);
     MatchListModel matchListModel(&db);
     
+    // Remembered "no match" answers. Lookups run off the GUI thread, so the
+    // cache gets a connection of its own.
+    QSqlDatabase cacheConnection = QSqlDatabase::cloneDatabase(
+        db.database(), QStringLiteral("remus-metadata-cache"));
+    MetadataCache metadataCache(cacheConnection);
+    // Local DAT lookups are cheap and change whenever a DAT is imported
+    metadataCache.setNegativeTtl(QStringLiteral("localdatabase"), 0);
+
     // Create provider orchestrator for metadata operations
     ProviderOrchestrator orchestrator;
+    if (cacheConnection.open()) {
+        orchestrator.setMetadataCache(&metadataCache);
+    } else {
+        qWarning() << "Metadata cache unavailable: lookups will not remember misses";
+    }
     
     // Add Local Database provider (HIGHEST priority - offline hash-based matching)
     auto localDbProvider = new LocalDatabaseProvider();
@@ -149,6 +164,12 @@ int main(int argc, char *argv[])
     const int igdbPriority = igdbInfo ? igdbInfo->priority : 40;
     orchestrator.addProvider(Constants::Providers::IGDB, igdbProvider, igdbPriority);
     qDebug() << "Initialized IGDB provider (priority:" << igdbPriority << ")";
+
+    // Opt-in: ask providers in parallel, staggered by the hedge delay
+    orchestrator.setHedgeDelay(settings.value(Constants::Settings::Metadata::HEDGE_DELAY_MS,
+                                              Constants::Settings::Defaults::HEDGE_DELAY_MS).toInt());
+    orchestrator.setConcurrentLookups(settings.value(Constants::Settings::Metadata::CONCURRENT_LOOKUPS,
+                                                     Constants::Settings::Defaults::CONCURRENT_LOOKUPS).toBool());
     
     // Create M8 controllers (artwork, metadata editor, export)
     ArtworkController artworkController(&db, &orchestrator);
@@ -4,7 +4,7 @@
 #include <QFile>
 #include <QMap>
 #include <QDir>
-#include <QRegularExpression>
+#include <algorithm>
 #include "../../core/constants/systems.h"
 #include "../../core/constants/settings.h"
 
@@ -38,6 +38,30 @@ int FileListModel::rowCount(const QModelIndex &parent) const
     return m_groupedFiles.count();
 }
 
+bool FileListModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return false;
+    return m_groupsRequested < m_sqlGroups;
+}
+
+void FileListModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || !m_db || m_groupsRequested >= m_sqlGroups)
+        return;
+
+    const QList<FileGroupEntry> page = fetchGroups();
+    if (!page.isEmpty()) {
+        const int first = m_groupedFiles.count();
+        beginInsertRows(QModelIndex(), first, first + page.count() - 1);
+        m_groupedFiles.append(page);
+        rebuildRowIndex();
+        endInsertRows();
+    }
+    emit countChanged();
+    emit countsChanged();
+}
+
 QVariant FileListModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid() || index.row() >= m_groupedFiles.count())
@@ -263,10 +287,166 @@ void FileListModel::refresh()
 void FileListModel::clear()
 {
     beginResetModel();
-    m_files.clear();
     m_groupedFiles.clear();
+    m_sqlGroups = 0;
+    m_groupsRequested = 0;
+    m_lastRequestedKey = GroupKey();
+    m_missingGroups.clear();
+    rebuildRowIndex();
     endResetModel();
+    m_unprocessedCount = 0;
+    m_processedCount = 0;
+    emit countChanged();
+    emit countsChanged();
+}
+
+void FileListModel::updateFile(int fileId)
+{
+    if (!m_db) {
+        return;
+    }
+
+    const int row = m_rowByFileId.value(fileId, -1);
+    if (row >= 0) {
+        refreshRow(row);
+        if (m_rowByFileId.contains(fileId)) {
+            emit countChanged();
+            emit countsChanged();
+            return;
+        }
+    }
+
+    // New file (e.g. extracted from an archive), or one that left its group
+    const FileRecord record = m_db->getFileById(fileId);
+    if (record.id > 0) {
+        placeGroup({Database::fileGroupDirectory(record.originalPath),
+                    Database::fileGroupName(record.filename)});
+    }
     emit countChanged();
+    emit countsChanged();
+}
+
+void FileListModel::refreshRow(int row)
+{
+    const FileGroupEntry old = m_groupedFiles.at(row);
+    const GroupKey key = groupKey(old);
+
+    const QList<FileRecord> files = m_db->getFileGroup(key.first, key.second,
+                                                       systemFilterId(), m_showMatchedOnly);
+    const QList<FileRecord> existing = m_db->filterExisting(files);
+    QList<int> fileIds;
+    for (const FileRecord &file : existing) {
+        fileIds.append(file.id);
+    }
+
+    // The marker may have been written by the step that changed the file
+    m_processedDirs.remove(key.first);
+    const QList<FileGroupEntry> regrouped = groupFiles(existing, m_db->getMatchesForFiles(fileIds));
+
+    if (regrouped.isEmpty()) {
+        removeRow(row);
+        countGroup(old.isProcessed, -1);
+        if (files.isEmpty()) {
+            // Left the filters: later groups move up one place in SQL
+            --m_sqlGroups;
+            --m_groupsRequested;
+        } else {
+            m_missingGroups.insert(key);
+        }
+        return;
+    }
+
+    for (int id : old.allFileIds) {
+        m_rowByFileId.remove(id);
+    }
+    m_groupedFiles[row] = regrouped.first();
+    for (int id : std::as_const(m_groupedFiles[row].allFileIds)) {
+        m_rowByFileId.insert(id, row);
+    }
+    if (old.isProcessed != m_groupedFiles.at(row).isProcessed) {
+        countGroup(old.isProcessed, -1);
+        countGroup(!old.isProcessed, 1);
+    }
+
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx);
+}
+
+void FileListModel::placeGroup(const GroupKey &key)
+{
+    const int shownRow = m_rowByGroup.value(key, -1);
+    if (shownRow >= 0) {
+        refreshRow(shownRow);
+        return;
+    }
+
+    const QList<FileRecord> files = m_db->getFileGroup(key.first, key.second,
+                                                       systemFilterId(), m_showMatchedOnly);
+    if (files.isEmpty()) {
+        return;     // Outside the filters
+    }
+
+    // Beyond the fetched pages: the row comes with its page, only the total moves
+    const bool fetched = !canFetchMore(QModelIndex()) || !groupKeyLess(m_lastRequestedKey, key);
+    if (!fetched) {
+        int total = 0;
+        for (int count : m_db->getFileGroupCountsByDirectory(systemFilterId(), m_showMatchedOnly)) {
+            total += count;
+        }
+        countGroup(isProcessedDirectory(key.first), total - m_sqlGroups);
+        m_sqlGroups = total;
+        return;
+    }
+
+    const QList<FileRecord> existing = m_db->filterExisting(files);
+    QList<int> fileIds;
+    for (const FileRecord &file : existing) {
+        fileIds.append(file.id);
+    }
+    m_processedDirs.remove(key.first);
+    const QList<FileGroupEntry> grouped = groupFiles(existing, m_db->getMatchesForFiles(fileIds));
+
+    // Within the fetched pages every group is shown or known missing,
+    // so any other group is new to SQL and shifts the next page by one
+    const bool wasMissing = m_missingGroups.contains(key);
+    if (grouped.isEmpty()) {
+        if (!wasMissing) {
+            m_missingGroups.insert(key);
+            ++m_sqlGroups;
+            ++m_groupsRequested;
+        }
+        return;
+    }
+    if (wasMissing) {
+        m_missingGroups.remove(key);
+    } else {
+        ++m_sqlGroups;
+        ++m_groupsRequested;
+    }
+
+    const FileGroupEntry &entry = grouped.first();
+    const auto position = std::upper_bound(m_groupedFiles.cbegin(), m_groupedFiles.cend(), key,
+        [](const GroupKey &value, const FileGroupEntry &element) {
+            return groupKeyLess(value, groupKey(element));
+        });
+    insertRow(int(position - m_groupedFiles.cbegin()), entry);
+    countGroup(entry.isProcessed, 1);
+}
+
+void FileListModel::insertRow(int row, const FileGroupEntry &entry)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    m_groupedFiles.insert(row, entry);
+    rebuildRowIndex();
+    endInsertRows();
+}
+
+void FileListModel::removeRow(int row)
+{
+    beginRemoveRows(QModelIndex(), row, row);
+    m_groupedFiles.removeAt(row);
+    rebuildRowIndex();
+    endRemoveRows();
 }
 
 void FileListModel::setDatabase(Database *db)
@@ -285,13 +465,11 @@ void FileListModel::setSelected(int fileId, bool selected)
         m_selectedIds.remove(fileId);
     }
     
-    // Find the row that changed and emit dataChanged
-    for (int i = 0; i < m_groupedFiles.count(); ++i) {
-        if (m_groupedFiles[i].primaryFileId == fileId) {
-            QModelIndex idx = index(i);
-            emit dataChanged(idx, idx, {IsSelectedRole});
-            break;
-        }
+    // Emit dataChanged for the row if the view has it
+    const int row = m_rowByFileId.value(fileId, -1);
+    if (row >= 0 && m_groupedFiles.at(row).primaryFileId == fileId) {
+        QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, {IsSelectedRole});
     }
     
     emit selectionChanged();
@@ -305,6 +483,13 @@ void FileListModel::toggleSelected(int fileId)
 
 void FileListModel::selectAllUnprocessed(bool selected)
 {
+    // Groups not fetched yet are selected too
+    if (selected) {
+        while (canFetchMore(QModelIndex())) {
+            fetchMore(QModelIndex());
+        }
+    }
+
     for (const FileGroupEntry &entry : m_groupedFiles) {
         if (!entry.isProcessed) {
             if (selected) {
@@ -315,7 +500,7 @@ void FileListModel::selectAllUnprocessed(bool selected)
         }
     }
     
-    // Emit dataChanged for all rows
+    // Emit dataChanged for all fetched rows
     if (!m_groupedFiles.isEmpty()) {
         emit dataChanged(index(0), index(m_groupedFiles.count() - 1), {IsSelectedRole});
     }
@@ -358,70 +543,94 @@ bool FileListModel::isSelected(int fileId) const
     return m_selectedIds.contains(fileId);
 }
 
-void FileListModel::updateCounts()
+void FileListModel::countGroup(bool processed, int delta)
 {
-    m_unprocessedCount = 0;
-    m_processedCount = 0;
-    
-    for (const FileGroupEntry &entry : m_groupedFiles) {
-        if (entry.isProcessed) {
-            m_processedCount++;
-        } else {
-            m_unprocessedCount++;
-        }
+    if (processed) {
+        m_processedCount += delta;
+    } else {
+        m_unprocessedCount += delta;
     }
-    
-    emit countsChanged();
 }
 
-QString FileListModel::extractBaseName(const QString &filename) const
+bool FileListModel::isProcessedDirectory(const QString &directory)
 {
-    // Remove extension and common suffixes like "(Track 01)"
-    QFileInfo fi(filename);
-    QString baseName = fi.completeBaseName();
-    
-    // Remove track indicators for multi-bin games
-    static QRegularExpression trackPattern(R"(\s*\(Track\s*\d+\)$)", QRegularExpression::CaseInsensitiveOption);
-    baseName.remove(trackPattern);
-    
-    return baseName.trimmed();
+    // Check for .remusmd marker file in directory (source of truth for processed state)
+    // Marker file existence determines processing status, not database flag
+    // This handles cases where user manually deletes extracted folders
+    auto it = m_processedDirs.constFind(directory);
+    if (it == m_processedDirs.constEnd()) {
+        const QString markerPath = directory + "/" + Constants::Settings::Files::MARKER_PROCESSED;
+        it = m_processedDirs.insert(directory, QFile::exists(markerPath));
+    }
+    return it.value();
 }
 
-void FileListModel::groupFiles(const QList<FileRecord> &files, const QMap<int, Database::MatchResult> &matches)
+bool FileListModel::groupKeyLess(const GroupKey &a, const GroupKey &b)
 {
-    m_groupedFiles.clear();
-    
-    // Map to group files by their base name AND source location
-    // Key: source path + base name - keeps archives separate from extracted folders
-    QMap<QString, FileGroupEntry> groups;
+    const QByteArray dirA = a.first.toUtf8();
+    const QByteArray dirB = b.first.toUtf8();
+    if (dirA != dirB) {
+        return dirA < dirB;
+    }
+    return a.second.toUtf8() < b.second.toUtf8();
+}
+
+QString FileListModel::systemDisplayName(int systemId)
+{
+    auto it = m_systemNames.constFind(systemId);
+    if (it != m_systemNames.constEnd()) {
+        return it.value();
+    }
+    const QString name = m_db->getSystemDisplayName(systemId);
+    m_systemNames.insert(systemId, name);
+    return name;
+}
+
+void FileListModel::rebuildRowIndex()
+{
+    m_rowByFileId.clear();
+    m_rowByGroup.clear();
+    for (int row = 0; row < m_groupedFiles.count(); ++row) {
+        const FileGroupEntry &entry = m_groupedFiles.at(row);
+        for (int id : entry.allFileIds) {
+            m_rowByFileId.insert(id, row);
+        }
+        m_rowByGroup.insert(groupKey(entry), row);
+    }
+}
+
+QList<FileGroupEntry> FileListModel::groupFiles(const QList<FileRecord> &files,
+                                                const QMap<int, Database::MatchResult> &matches)
+{
+    // Group files by their base name AND source location, keeping the
+    // order they came in (SQL group order)
+    // This keeps archive contents separate from extracted folder contents
+    QList<FileGroupEntry> groups;
+    QHash<GroupKey, int> groupIndex;
     
     for (const FileRecord &file : files) {
-        // Create a grouping key based on source location + base name
-        // This keeps archive contents separate from extracted folder contents
-        QFileInfo pathInfo(file.originalPath);
-        QString baseName = extractBaseName(file.filename);
-        QString groupKey = pathInfo.path() + "/" + baseName;
+        const QString baseName = Database::fileGroupName(file.filename);
+        const GroupKey key{Database::fileGroupDirectory(file.originalPath), baseName};
         
-        if (!groups.contains(groupKey)) {
+        auto indexIt = groupIndex.constFind(key);
+        if (indexIt == groupIndex.constEnd()) {
             FileGroupEntry entry;
             entry.primaryFileId = file.id;
+            entry.groupDirectory = key.first;
+            entry.groupName = key.second;
             entry.displayName = baseName;
             entry.currentPath = file.currentPath;
             entry.systemId = file.systemId;
-            entry.systemName = m_db->getSystemDisplayName(file.systemId);
+            entry.systemName = systemDisplayName(file.systemId);
             entry.lastModified = file.lastModified.toString(Qt::ISODate);
             entry.processingStatus = file.processingStatus;
+            entry.isProcessed = isProcessedDirectory(key.first);
             
-            // Check for .remusmd marker file in directory (source of truth for processed state)
-            // Marker file existence determines processing status, not database flag
-            // This handles cases where user manually deletes extracted folders
-            QString markerPath = pathInfo.path() + "/" + Constants::Settings::Files::MARKER_PROCESSED;
-            entry.isProcessed = QFile::exists(markerPath);
-            
-            groups[groupKey] = entry;
+            indexIt = groupIndex.insert(key, groups.count());
+            groups.append(entry);
         }
         
-        FileGroupEntry &entry = groups[groupKey];
+        FileGroupEntry &entry = groups[indexIt.value()];
         
         // Add extension if not already present
         QString ext = file.extension.toLower();
@@ -525,9 +734,8 @@ void FileListModel::groupFiles(const QList<FileRecord> &files, const QMap<int, D
         });
     };
     
-    // Convert map to list and finalize workflow states
-    for (auto it = groups.begin(); it != groups.end(); ++it) {
-        FileGroupEntry &entry = it.value();
+    // Finalize workflow states
+    for (FileGroupEntry &entry : groups) {
         sortExtensions(entry.extensions);
         
         // === Determine workflow states ===
@@ -581,11 +789,45 @@ void FileListModel::groupFiles(const QList<FileRecord> &files, const QMap<int, D
         } else {
             entry.matchState = WorkflowState::NeedsAction;
         }
-        
-        m_groupedFiles.append(entry);
     }
     
-    qDebug() << "FileListModel: Grouped" << files.count() << "files into" << m_groupedFiles.count() << "entries";
+    return groups;
+}
+
+QList<FileGroupEntry> FileListModel::fetchGroups()
+{
+    const QList<FileRecord> files = m_db->getFileGroupPage(systemFilterId(), m_showMatchedOnly,
+                                                           m_groupsRequested, FETCH_PAGE_SIZE);
+    m_groupsRequested = qMin(m_groupsRequested + FETCH_PAGE_SIZE, m_sqlGroups);
+    if (files.isEmpty()) {
+        return {};
+    }
+    m_lastRequestedKey = {Database::fileGroupDirectory(files.last().originalPath),
+                          Database::fileGroupName(files.last().filename)};
+
+    // Existence checks and match lookups only for this page
+    const QList<FileRecord> existing = m_db->filterExisting(files);
+    QList<int> fileIds;
+    fileIds.reserve(existing.size());
+    for (const FileRecord &file : existing) {
+        fileIds.append(file.id);
+    }
+    const QList<FileGroupEntry> grouped = groupFiles(existing, m_db->getMatchesForFiles(fileIds));
+
+    // Groups with no file left on disk are not shown, nor counted
+    QSet<GroupKey> shown;
+    for (const FileGroupEntry &entry : grouped) {
+        shown.insert(groupKey(entry));
+    }
+    for (const FileRecord &file : files) {
+        const GroupKey key{Database::fileGroupDirectory(file.originalPath),
+                           Database::fileGroupName(file.filename)};
+        if (!shown.contains(key) && !m_missingGroups.contains(key)) {
+            m_missingGroups.insert(key);
+            countGroup(isProcessedDirectory(key.first), -1);
+        }
+    }
+    return grouped;
 }
 
 void FileListModel::loadFiles()
@@ -595,63 +837,36 @@ void FileListModel::loadFiles()
         return;
     }
     
-    beginResetModel();
-    
-    // Load all files from database
-    m_files = m_db->getExistingFiles();
-    
-    // Load all matches for workflow state
-    QMap<int, Database::MatchResult> matches = m_db->getAllMatches();
-    
-    // DEBUG: Log which file IDs have matches
-    qDebug() << "FileListModel: getAllMatches() returned" << matches.count() << "matches for file IDs:" << matches.keys();
-    for (auto it = matches.begin(); it != matches.end(); ++it) {
-        qDebug() << "  File ID" << it.key() << "-> Game:" << it.value().gameTitle 
-                 << "Publisher:" << it.value().publisher 
-                 << "Confidence:" << it.value().confidence;
-    }
-    
-    // Apply system filter if set
-    if (!m_systemFilter.isEmpty()) {
-        QList<FileRecord> filtered;
-        int systemId = m_systemFilter.toInt();
-        for (const FileRecord &file : m_files) {
-            if (file.systemId == systemId) {
-                filtered.append(file);
-            }
-        }
-        m_files = filtered;
-    }
-    
-    // Apply matched filter
-    if (m_showMatchedOnly) {
-        QList<FileRecord> filtered;
-        for (const FileRecord &file : m_files) {
-            if (matches.contains(file.id)) {
-                filtered.append(file);
-            }
-        }
-        m_files = filtered;
+    m_systemNames.clear();
+    m_processedDirs.clear();
+    m_missingGroups.clear();
+    m_lastRequestedKey = GroupKey();
+
+    // Filters are applied in SQL; only group counts are read up front
+    const QHash<QString, int> groupCounts =
+        m_db->getFileGroupCountsByDirectory(systemFilterId(), m_showMatchedOnly);
+    m_sqlGroups = 0;
+    m_unprocessedCount = 0;
+    m_processedCount = 0;
+    for (auto it = groupCounts.constBegin(); it != groupCounts.constEnd(); ++it) {
+        m_sqlGroups += it.value();
+        countGroup(isProcessedDirectory(it.key()), it.value());
     }
+
+    // Only the first page is stat'ed and grouped
+    m_groupsRequested = 0;
+    QList<FileGroupEntry> grouped = fetchGroups();
     
-    // Group files by game with match info
-    groupFiles(m_files, matches);
-    
-    // Update processed/unprocessed counts
-    updateCounts();
+    beginResetModel();
+    m_groupedFiles = std::move(grouped);
+    rebuildRowIndex();
+    endResetModel();
     
-    qDebug() << "FileListModel::loadFiles() loaded" << m_files.count() << "files into" 
-             << m_groupedFiles.count() << "groups"
+    qDebug() << "FileListModel::loadFiles() loaded" << m_groupedFiles.count() << "of"
+             << totalCount() << "groups"
              << "(" << m_unprocessedCount << "unprocessed," << m_processedCount << "processed)";
-    for (const FileGroupEntry &entry : m_groupedFiles) {
-        qDebug() << "  -" << entry.displayName << "(" << entry.extensions.join("/") << ")" 
-                 << entry.fileCount << "files"
-                 << "hash:" << (entry.hasHashes ? "yes" : "no")
-                 << "match:" << (entry.matchInfo.gameId > 0 ? entry.matchInfo.matchedTitle : "none")
-                 << "processed:" << (entry.isProcessed ? "yes" : "no");
-    }
     
-    endResetModel();
+    emit countsChanged();
     emit countChanged();
 }
 
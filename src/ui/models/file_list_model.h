@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QList>
 #include <QSet>
 #include <QStringList>
@@ -47,6 +48,8 @@ struct MatchInfo {
 struct FileGroupEntry {
     // === Basic file info ===
     int primaryFileId = 0;           ///< ID of the primary file (.cue, .gdi, etc.)
+    QString groupDirectory;           ///< Group key: directory of the files
+    QString groupName;                ///< Group key: shared base name
     QString displayName;              ///< Name to show (without extension)
     QString currentPath;              ///< Path to primary file
     QStringList extensions;           ///< All extensions in this group [".cue", ".bin"]
@@ -90,10 +93,17 @@ struct FileGroupEntry {
  * Provides a list view of scanned ROM files with system grouping,
  * filtering, and sorting capabilities. Multi-file games (e.g., .cue + .bin)
  * are grouped and displayed as a single entry.
+ *
+ * Filters, ordering and paging run in SQL: a refresh counts the groups
+ * and loads only the first page, and each fetchMore() loads the next one,
+ * with existence checks and match lookups limited to that page. Pipeline
+ * updates to individual files go through updateFile(), which re-reads only
+ * the affected group and changes, inserts or removes its row.
  */
 class FileListModel : public QAbstractListModel {
     Q_OBJECT
     Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY countChanged)
     Q_PROPERTY(int unprocessedCount READ unprocessedCount NOTIFY countsChanged)
     Q_PROPERTY(int processedCount READ processedCount NOTIFY countsChanged)
     Q_PROPERTY(int selectedCount READ selectedCount NOTIFY selectionChanged)
@@ -157,12 +167,20 @@ public:
     };
     Q_ENUM(FileRole)
     
+    /// Groups exposed to the view per fetchMore() call
+    static constexpr int FETCH_PAGE_SIZE = 200;
+
     explicit FileListModel(Database *db = nullptr, QObject *parent = nullptr);
     
     // QAbstractListModel interface
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /// Number of groups matching the filters, including rows not fetched yet
+    int totalCount() const { return m_sqlGroups - m_missingGroups.size(); }
     
     // Property getters/setters
     QString systemFilter() const { return m_systemFilter; }
@@ -179,10 +197,25 @@ public:
     // Database operations
     Q_INVOKABLE void refresh();
     Q_INVOKABLE void clear();
+
+    /**
+     * @brief Re-read the group containing a file and update its row in place
+     *
+     * A file outside the current filters is ignored. One that is not shown
+     * yet (e.g. just extracted) joins its group's row, or gets a row of its
+     * own if its group falls within the fetched pages.
+     */
+    Q_INVOKABLE void updateFile(int fileId);
     
     // Selection operations
     Q_INVOKABLE void setSelected(int fileId, bool selected);
     Q_INVOKABLE void toggleSelected(int fileId);
+
+    /**
+     * @brief Select or deselect every unprocessed group
+     *
+     * Selecting fetches the pages not loaded yet first.
+     */
     Q_INVOKABLE void selectAllUnprocessed(bool selected);
     Q_INVOKABLE void clearSelection();
     Q_INVOKABLE QVariantList getSelectedUnprocessed() const;
@@ -199,21 +232,49 @@ signals:
     void errorOccurred(const QString &error);
     
 private:
+    using GroupKey = QPair<QString, QString>;   // Directory, name
+
     void loadFiles();
-    void groupFiles(const QList<FileRecord> &files, const QMap<int, Database::MatchResult> &matches);
-    void updateCounts();
-    QString extractBaseName(const QString &filename) const;
+    /// Load, stat and group the next page of groups
+    QList<FileGroupEntry> fetchGroups();
+    QList<FileGroupEntry> groupFiles(const QList<FileRecord> &files,
+                                     const QMap<int, Database::MatchResult> &matches);
+    /// Re-read the group shown at @p row; removes the row if the group is gone
+    void refreshRow(int row);
+    /// Show the group of a file that is not in the model
+    void placeGroup(const GroupKey &key);
+    void insertRow(int row, const FileGroupEntry &entry);
+    void removeRow(int row);
+    void rebuildRowIndex();
+    /// Add @p delta groups to the processed or unprocessed count
+    void countGroup(bool processed, int delta);
+    bool isProcessedDirectory(const QString &directory);
+    QString systemDisplayName(int systemId);
+    int systemFilterId() const { return m_systemFilter.toInt(); }
+    /// Group order of the SQL pages (BINARY collation compares UTF-8 bytes)
+    static bool groupKeyLess(const GroupKey &a, const GroupKey &b);
+    static GroupKey groupKey(const FileGroupEntry &entry)
+    {
+        return {entry.groupDirectory, entry.groupName};
+    }
     
     Database *m_db = nullptr;
-    QList<FileRecord> m_files;           // Raw file records
-    QList<FileGroupEntry> m_groupedFiles; // Grouped entries for display
+    QList<FileGroupEntry> m_groupedFiles; // Groups fetched so far, in SQL order
+    int m_sqlGroups = 0;                 // Groups matching the filters in the database
+    int m_groupsRequested = 0;           // Groups asked of SQL so far (next page offset)
+    GroupKey m_lastRequestedKey;         // Last group of the last page
+    QSet<GroupKey> m_missingGroups;      // Requested groups with no file left on disk
+    QHash<int, int> m_rowByFileId;       // Every file ID in a group -> row
+    QHash<GroupKey, int> m_rowByGroup;   // Group key -> row
+    QHash<QString, bool> m_processedDirs; // Directory -> has a processed marker
+    QHash<int, QString> m_systemNames;   // System display name cache
     QString m_systemFilter;
     bool m_showMatchedOnly = false;
     
     // Selection tracking
     QSet<int> m_selectedIds;             // File IDs currently selected
-    int m_unprocessedCount = 0;          // Count of unprocessed files
-    int m_processedCount = 0;            // Count of processed files
+    int m_unprocessedCount = 0;          // Count of unprocessed groups
+    int m_processedCount = 0;            // Count of processed groups
 };
 
 } // namespace Remus
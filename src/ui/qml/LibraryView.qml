@@ -123,6 +123,10 @@ Page {
             processingStatus = processingController.statusMessage;
         }
         
+        function onFileCompleted(fileId, success, error) {
+            fileListModel.updateFile(fileId);
+        }
+        
         function onProcessingCompleted(successCount, failCount) {
             isProcessing = false;
             processingStatus = "Complete: " + successCount + " processed" + 
@@ -0,0 +1,257 @@
+#ifndef REMUS_TESTS_HTTP_STUB_SERVER_H
+#define REMUS_TESTS_HTTP_STUB_SERVER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief A request as the stub server received it
+ */
+struct HttpStubRequest {
+    QByteArray method;
+    QString path;
+    QHash<QByteArray, QByteArray> headers;  // Names lower-cased
+    QByteArray body;
+
+    QByteArray header(const QByteArray &name) const { return headers.value(name.toLower()); }
+};
+
+/**
+ * @brief How the stub server answers one request
+ */
+struct HttpStubResponse {
+    int status = 200;
+    QList<QPair<QByteArray, QByteArray>> headers;
+    QByteArray body;
+    int delayMs = 0;        // Answer after this long
+    bool hold = false;      // Answer only when respondToHeld() is called
+    int cutAfter = -1;      // Send this many body bytes, then drop the connection
+    bool close = false;     // Send "Connection: close" and disconnect
+
+    HttpStubResponse() = default;
+    HttpStubResponse(int status, const QByteArray &body = QByteArray())
+        : status(status), body(body) {}
+};
+
+/**
+ * @brief Minimal local HTTP/1.1 server for network tests
+ *
+ * Parses requests (pipelined, with Content-Length bodies) on kept-alive
+ * connections, records them and answers whatever the handler returns.
+ * Runs on the creating thread, or on a thread of its own for clients that
+ * block the test thread while they wait; the handler then runs on that
+ * thread too.
+ */
+class HttpStubServer : public QObject
+{
+public:
+    using Handler = std::function<HttpStubResponse(const HttpStubRequest &)>;
+
+    explicit HttpStubServer(Handler handler = Handler(), bool ownThread = false)
+        : m_handler(std::move(handler))
+    {
+        if (!ownThread) {
+            listen();
+            return;
+        }
+        m_thread = std::make_unique<QThread>();
+        moveToThread(m_thread.get());
+        m_thread->start();
+        QMetaObject::invokeMethod(this, [this]() { listen(); }, Qt::BlockingQueuedConnection);
+    }
+
+    ~HttpStubServer() override
+    {
+        if (m_thread) {
+            QMetaObject::invokeMethod(this, [this]() { delete m_server; m_server = nullptr; },
+                                      Qt::BlockingQueuedConnection);
+            m_thread->quit();
+            m_thread->wait();
+        }
+    }
+
+    /// Replace the handler (set it before requests arrive)
+    void setHandler(Handler handler) { m_handler = std::move(handler); }
+
+    quint16 port() const { return m_port; }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(m_port).arg(path));
+    }
+
+    int requests() const { QMutexLocker locker(&m_mutex); return m_log.size(); }
+
+    /// Requests made for @p path, oldest first
+    QList<HttpStubRequest> requests(const QString &path) const
+    {
+        QMutexLocker locker(&m_mutex);
+        QList<HttpStubRequest> matching;
+        for (const HttpStubRequest &request : m_log) {
+            if (request.path == path) {
+                matching.append(request);
+            }
+        }
+        return matching;
+    }
+
+    int connections() const { QMutexLocker locker(&m_mutex); return m_connections; }
+
+    /// Most responses that were waiting to be sent at the same time
+    int maxOpen() const { QMutexLocker locker(&m_mutex); return m_maxOpen; }
+
+    int held() const { QMutexLocker locker(&m_mutex); return m_held.size(); }
+
+    /// Answer every held request with @p response
+    void respondToHeld(const HttpStubResponse &response)
+    {
+        QList<QPointer<QTcpSocket>> held;
+        {
+            QMutexLocker locker(&m_mutex);
+            held.swap(m_held);
+            m_open -= held.size();
+        }
+        for (const QPointer<QTcpSocket> &socket : std::as_const(held)) {
+            if (socket) {
+                QMetaObject::invokeMethod(socket, [this, socket, response]() { write(socket, response); });
+            }
+        }
+    }
+
+private:
+    void listen()
+    {
+        m_server = new QTcpServer(this);
+        connect(m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+                {
+                    QMutexLocker locker(&m_mutex);
+                    ++m_connections;
+                }
+                auto buffer = std::make_shared<QByteArray>();
+                connect(socket, &QTcpSocket::readyRead, socket, [this, socket, buffer]() {
+                    buffer->append(socket->readAll());
+                    serve(socket, *buffer);
+                });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+        m_server->listen(QHostAddress::LocalHost);
+        m_port = m_server->serverPort();
+    }
+
+    /// Answer every complete request in the buffer
+    void serve(QTcpSocket *socket, QByteArray &buffer)
+    {
+        while (true) {
+            const int headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0) {
+                return;
+            }
+            HttpStubRequest request;
+            const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+            const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+            request.method = requestLine.value(0);
+            request.path = QString::fromLatin1(requestLine.value(1));
+            for (int i = 1; i < lines.size(); ++i) {
+                const int colon = lines.at(i).indexOf(':');
+                if (colon > 0) {
+                    request.headers.insert(lines.at(i).left(colon).trimmed().toLower(),
+                                           lines.at(i).mid(colon + 1).trimmed());
+                }
+            }
+            const int length = request.header("content-length").toInt();
+            if (buffer.size() < headerEnd + 4 + length) {
+                return;
+            }
+            request.body = buffer.mid(headerEnd + 4, length);
+            buffer.remove(0, headerEnd + 4 + length);
+
+            {
+                QMutexLocker locker(&m_mutex);
+                m_log.append(request);
+            }
+            const HttpStubResponse response = m_handler ? m_handler(request) : HttpStubResponse(404);
+
+            QMutexLocker locker(&m_mutex);
+            m_maxOpen = qMax(m_maxOpen, ++m_open);
+            if (response.hold) {
+                m_held.append(socket);
+            } else if (response.delayMs > 0) {
+                locker.unlock();
+                QTimer::singleShot(response.delayMs, socket, [this, socket, response]() {
+                    {
+                        QMutexLocker locker(&m_mutex);
+                        --m_open;
+                    }
+                    write(socket, response);
+                });
+            } else {
+                --m_open;
+                locker.unlock();
+                write(socket, response);
+            }
+        }
+    }
+
+    static QByteArray reason(int status)
+    {
+        switch (status) {
+        case 200: return "OK";
+        case 206: return "Partial Content";
+        case 404: return "Not Found";
+        case 416: return "Range Not Satisfiable";
+        case 500: return "Internal Server Error";
+        default:  return "Status";
+        }
+    }
+
+    void write(QTcpSocket *socket, const HttpStubResponse &response)
+    {
+        QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + ' '
+                          + reason(response.status) + "\r\n";
+        for (const auto &header : response.headers) {
+            head += header.first + ": " + header.second + "\r\n";
+        }
+        head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+        if (response.close) {
+            head += "Connection: close\r\n";
+        }
+        head += "\r\n";
+
+        if (response.cutAfter >= 0) {
+            socket->write(head + response.body.left(response.cutAfter));
+            socket->flush();
+            socket->disconnectFromHost();
+            return;
+        }
+        socket->write(head + response.body);
+        if (response.close) {
+            socket->disconnectFromHost();
+        }
+    }
+
+    Handler m_handler;
+    std::unique_ptr<QThread> m_thread;
+    QTcpServer *m_server = nullptr;
+    quint16 m_port = 0;
+
+    mutable QMutex m_mutex;
+    QList<HttpStubRequest> m_log;
+    QList<QPointer<QTcpSocket>> m_held;
+    int m_connections = 0;
+    int m_open = 0;
+    int m_maxOpen = 0;
+};
+
+#endif // REMUS_TESTS_HTTP_STUB_SERVER_H
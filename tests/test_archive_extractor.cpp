@@ -2,18 +2,66 @@
 #include <QTemporaryDir>
 #include <QFile>
 #include "../src/core/archive_extractor.h"
+#include "../src/core/seven_zip_reader.h"
 
 using namespace Remus;
 
+namespace {
+
+// Tiny archives holding roms/game.sfc (72 bytes) and readme.txt ("hello\n"),
+// written by zip and bsdtar (7z with a plain header and with an LZMA-encoded one)
+const char ZIP_FIXTURE[] =
+    "504b03041400000008001588505df8bae7050e000000480000000d000000726f6d732f67"
+    "616d652e7366630bf6730dd60df2f7d50da68c0100504b03040a00000000001588505d20"
+    "303a3606000000060000000a000000726561646d652e74787468656c6c6f0a504b01021e"
+    "031400000008001588505df8bae7050e000000480000000d0000000000000001000000a4"
+    "8100000000726f6d732f67616d652e736663504b01021e030a00000000001588505d2030"
+    "3a3606000000060000000a0000000000000001000000a48139000000726561646d652e74"
+    "7874504b0506000000000200020073000000670000000000";
+
+const char SEVEN_ZIP_STORE_FIXTURE[] =
+    "377abcaf271c0003e3d4dd544e00000000000000a500000000000000f42f3ced534e4553"
+    "2d524f4d2d534e45532d524f4d2d534e45532d524f4d2d534e45532d524f4d2d534e4553"
+    "2d524f4d2d534e45532d524f4d2d534e45532d524f4d2d534e45532d524f4d2d68656c6c"
+    "6f0a010406000209480600070b02000101000101000c480600080a01f8bae70520303a36"
+    "0000050211330072006f006d0073002f00670061006d0065002e00730066006300000072"
+    "006500610064006d0065002e007400780074000000141201006d3cb9e08f5ddd016d3cb9"
+    "e08f5ddd01121201006d3cb9e08f5ddd016d3cb9e08f5ddd0113120100856bb9e08f5ddd"
+    "01856bb9e08f5ddd01150a01002080a4812080a4810000";
+
+const char SEVEN_ZIP_LZMA_FIXTURE[] =
+    "377abcaf271c0003c266b17d9c000000000000002100000000000000c3ea8b3b00299384"
+    "b34aa4d65eee086a65c47f1653e7c2acca78ddffffba5600000000813307ae0fcfd96fbc"
+    "0febea9e010d62038dd34c423f0ebca11918448d2064fd7befb70622f74893c51fa1a94d"
+    "5fa7667e158a84d57840b4001afbe4d02fd4a3aa14c5e250763c012cb52e3680c2a58b2d"
+    "4e5aea97b606db28515d4b7c6f60abc2de480ea4d2dce1f4b14e136bb2bfe990bb017d80"
+    "ccafffff330c000017061d01097f00070b01000123030101055d000080000c80ac0a0195"
+    "a5db370000";
+
+QString writeFixture(const QTemporaryDir &dir, const QString &name, const char *hex)
+{
+    const QString path = dir.filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(QByteArray::fromHex(hex));
+    return path;
+}
+
+} // namespace
+
 class FakeArchiveExtractor : public ArchiveExtractor
 {
 public:
     ProcessResult nextResult;
     QStringList fakeFiles;
+    int processCalls = 0;
 
 protected:
     ProcessResult runProcess(const QString &, const QStringList &, int) override
     {
+        processCalls++;
         return nextResult;
     }
 
@@ -37,6 +85,10 @@ private slots:
     void testGetArchiveInfoZip();
     void testGetArchiveInfo7z();
     void testGetArchiveInfoRar();
+    void testNativeListingZip();
+    void testNativeListingSevenZip_data();
+    void testNativeListingSevenZip();
+    void testNativeListingFallsBackToTool();
     void testExtractZip();
     void testExtractUnsupported();
 };
@@ -99,6 +151,80 @@ void ArchiveExtractorTest::testGetArchiveInfoRar()
     QCOMPARE(info.contents.first(), QStringLiteral("file.nes"));
 }
 
+void ArchiveExtractorTest::testNativeListingZip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFixture(dir, "set.zip", ZIP_FIXTURE);
+
+    FakeArchiveExtractor extractor;
+    ArchiveInfo info = extractor.getArchiveInfo(path);
+    QCOMPARE(extractor.processCalls, 0);
+    QVERIFY(info.listedNatively);
+    QCOMPARE(info.fileCount, 2);
+    QCOMPARE(info.contents, QStringList({"roms/game.sfc", "readme.txt"}));
+    QCOMPARE(info.members.at(0).size, qint64(72));
+    QCOMPARE(info.members.at(0).crc32, QStringLiteral("05e7baf8"));
+    QCOMPARE(info.members.at(1).size, qint64(6));
+    QCOMPARE(info.members.at(1).crc32, QStringLiteral("363a3020"));
+    QCOMPARE(info.uncompressedSize, qint64(78));
+}
+
+void ArchiveExtractorTest::testNativeListingSevenZip_data()
+{
+    QTest::addColumn<QByteArray>("hex");
+    QTest::addColumn<bool>("needsLzma");
+    QTest::newRow("plain-header") << QByteArray(SEVEN_ZIP_STORE_FIXTURE) << false;
+    QTest::newRow("lzma-header") << QByteArray(SEVEN_ZIP_LZMA_FIXTURE) << true;
+}
+
+void ArchiveExtractorTest::testNativeListingSevenZip()
+{
+    QFETCH(QByteArray, hex);
+    QFETCH(bool, needsLzma);
+    if (needsLzma && !SevenZipReader::hasLzmaSupport()) {
+        QSKIP("Built without liblzma");
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFixture(dir, "set.7z", hex.constData());
+
+    SevenZipReader reader(path);
+    QVERIFY2(reader.open(), qPrintable(reader.errorString()));
+
+    FakeArchiveExtractor extractor;
+    ArchiveInfo info = extractor.getArchiveInfo(path);
+    QCOMPARE(extractor.processCalls, 0);
+    QVERIFY(info.listedNatively);
+    QCOMPARE(info.contents, QStringList({"roms/game.sfc", "readme.txt"}));
+    QCOMPARE(info.members.at(0).size, qint64(72));
+    QCOMPARE(info.members.at(0).crc32, QStringLiteral("05e7baf8"));
+    QCOMPARE(info.members.at(1).crc32, QStringLiteral("363a3020"));
+}
+
+void ArchiveExtractorTest::testNativeListingFallsBackToTool()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile junk(dir.filePath("junk.7z"));
+    QVERIFY(junk.open(QIODevice::WriteOnly));
+    junk.write("definitely not a 7z archive");
+    junk.close();
+
+    FakeArchiveExtractor extractor;
+    extractor.nextResult.started = true;
+    extractor.nextResult.exitCode = 0;
+    extractor.nextResult.stdOutput =
+        "2026-02-05 18:40  .....       812000       400000  file.nes\n";
+
+    ArchiveInfo info = extractor.getArchiveInfo(junk.fileName());
+    QVERIFY(!info.listedNatively);
+    QCOMPARE(info.contents, QStringList({"file.nes"}));
+    QCOMPARE(info.members.first().size, qint64(812000));
+    QVERIFY(info.members.first().crc32.isEmpty());
+}
+
 void ArchiveExtractorTest::testExtractZip()
 {
     FakeArchiveExtractor extractor;
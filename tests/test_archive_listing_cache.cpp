@@ -0,0 +1,214 @@
+/**
+ * @file test_archive_listing_cache.cpp
+ * @brief Unit tests for the persistent archive listing cache.
+ *
+ * Archives here are junk bytes with a .rar/.7z extension: on a cache hit
+ * they must never be opened, so any tool or reader touching them would
+ * produce an empty listing and fail the test.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "../src/core/archive_listing_cache.h"
+#include "../src/core/archive_extractor.h"
+#include "../src/core/database.h"
+#include "../src/services/hash_service.h"
+
+using namespace Remus;
+
+namespace {
+
+QString writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(data);
+    return path;
+}
+
+ArchiveInfo makeListing(const QString &path)
+{
+    ArchiveInfo info;
+    info.path = path;
+    info.format = ArchiveExtractor::detectFormat(path);
+    info.listedNatively = true;
+    info.members = {
+        {"roms/game.gb", 32768, "1234abcd"},
+        {"readme.txt", 12, QString()},
+    };
+    return info;
+}
+
+} // namespace
+
+class ArchiveListingCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDatabaseRoundTrip();
+    void testLookupSurvivesReload();
+    void testChangedArchiveMisses();
+    void testFlushPrunesVanishedArchives();
+    void testExtractorUsesCache();
+    void testCrcOnlyHashFromCache();
+};
+
+void ArchiveListingCacheTest::testDatabaseRoundTrip()
+{
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+
+    Database::ArchiveListingEntry entry;
+    entry.archivePath = "/roms/set.7z";
+    entry.archiveSize = 4096;
+    entry.archiveMtimeMs = 1700000000000;
+    entry.format = ArchiveFormat::SevenZip;
+    entry.listedNatively = true;
+    entry.members = makeListing(entry.archivePath).members;
+    QCOMPARE(db.saveArchiveListing(entry), 3);
+
+    // Saving again replaces rather than duplicating members
+    entry.members.removeLast();
+    QCOMPARE(db.saveArchiveListing(entry), 2);
+
+    const QList<Database::ArchiveListingEntry> listings = db.getArchiveListings();
+    QCOMPARE(listings.size(), 1);
+    QCOMPARE(listings.first().archiveMtimeMs, entry.archiveMtimeMs);
+    QCOMPARE(listings.first().format, ArchiveFormat::SevenZip);
+    QCOMPARE(listings.first().members.size(), 1);
+    QCOMPARE(listings.first().members.first().size, qint64(32768));
+    QCOMPARE(listings.first().members.first().crc32, QString("1234abcd"));
+
+    QVERIFY(db.removeArchiveListing(entry.archivePath));
+    QVERIFY(db.getArchiveListings().isEmpty());
+}
+
+void ArchiveListingCacheTest::testLookupSurvivesReload()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir.filePath("set.rar"), QByteArray(100, 'x'));
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+
+    ArchiveListingCache first;
+    first.load(db);
+    first.store(QFileInfo(path), makeListing(path));
+    QCOMPARE(first.flush(db), 3);
+
+    ArchiveListingCache second;
+    QCOMPARE(second.load(db), 1);
+    ArchiveInfo info;
+    QVERIFY(second.lookup(QFileInfo(path), info));
+    QCOMPARE(info.members.size(), 2);
+    QCOMPARE(info.contents, QStringList({"roms/game.gb", "readme.txt"}));
+    QCOMPARE(info.fileCount, 2);
+    QVERIFY(info.listedNatively);
+    QCOMPARE(second.hits(), 1);
+    QCOMPARE(second.misses(), 0);
+}
+
+void ArchiveListingCacheTest::testChangedArchiveMisses()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir.filePath("set.rar"), QByteArray(100, 'x'));
+
+    ArchiveListingCache cache;
+    cache.store(QFileInfo(path), makeListing(path));
+    QCOMPARE(cache.memberCrc32(QFileInfo(path), "roms/game.gb"), QString("1234abcd"));
+
+    writeFile(path, QByteArray(200, 'y'));
+    ArchiveInfo info;
+    QVERIFY(!cache.lookup(QFileInfo(path), info));
+    QVERIFY(cache.memberCrc32(QFileInfo(path), "roms/game.gb").isEmpty());
+    QCOMPARE(cache.misses(), 1);
+}
+
+void ArchiveListingCacheTest::testFlushPrunesVanishedArchives()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("lib"));
+    const QString kept = writeFile(dir.filePath("lib/kept.rar"), QByteArray(10, 'k'));
+    const QString gone = writeFile(dir.filePath("lib/gone.rar"), QByteArray(10, 'g'));
+    const QString outside = writeFile(dir.filePath("other.rar"), QByteArray(10, 'o'));
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+
+    ArchiveListingCache seed;
+    seed.load(db);
+    for (const QString &path : {kept, gone, outside}) {
+        seed.store(QFileInfo(path), makeListing(path));
+    }
+    seed.flush(db);
+
+    // Rescan of lib/ that only sees kept.rar
+    ArchiveListingCache rescan;
+    QCOMPARE(rescan.load(db), 3);
+    ArchiveInfo info;
+    QVERIFY(rescan.lookup(QFileInfo(kept), info));
+    rescan.flush(db, dir.filePath("lib"));
+
+    QStringList remaining;
+    for (const auto &listing : db.getArchiveListings()) {
+        remaining.append(QFileInfo(listing.archivePath).fileName());
+    }
+    remaining.sort();
+    QCOMPARE(remaining, QStringList({"kept.rar", "other.rar"}));
+}
+
+void ArchiveListingCacheTest::testExtractorUsesCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir.filePath("set.rar"), QByteArray(100, 'x'));
+
+    ArchiveListingCache cache;
+    cache.store(QFileInfo(path), makeListing(path));
+
+    ArchiveExtractor extractor;
+    extractor.setUnrarPath("/nonexistent/unrar");
+    extractor.setSevenZipPath("/nonexistent/7z");
+    extractor.setListingCache(&cache);
+
+    const ArchiveInfo info = extractor.getArchiveInfo(path);
+    QCOMPARE(info.path, path);
+    QCOMPARE(info.members.size(), 2);
+    QCOMPARE(info.members.first().crc32, QString("1234abcd"));
+    QCOMPARE(cache.hits(), 1);
+}
+
+void ArchiveListingCacheTest::testCrcOnlyHashFromCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir.filePath("set.7z"), QByteArray(100, 'x'));
+
+    ArchiveListingCache cache;
+    cache.store(QFileInfo(path), makeListing(path));
+
+    FileRecord record;
+    record.filename = "game.gb";
+    record.extension = ".gb";
+    record.currentPath = path;
+    record.archivePath = path;
+    record.archiveInternalPath = "roms/game.gb";
+    record.isCompressed = true;
+
+    HashService service;
+    service.setCrcOnly(true);
+    service.setArchiveListingCache(&cache);
+    const HashResult result = service.hashRecord(record);
+    QVERIFY(result.success);
+    QCOMPARE(result.crc32, QString("1234abcd"));
+    QVERIFY(result.md5.isEmpty());
+}
+
+QTEST_MAIN(ArchiveListingCacheTest)
+#include "test_archive_listing_cache.moc"
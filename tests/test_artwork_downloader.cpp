@@ -2,16 +2,103 @@
 #include <QTemporaryDir>
 #include <QFile>
 #include <QSignalSpy>
+#include <QCryptographicHash>
 #include "metadata/artwork_downloader.h"
+#include "http_stub_server.h"
 
 using namespace Remus;
 
+/**
+ * @brief Local stand-in for an artwork host
+ *
+ * Every path returns bodyFor(path) with an ETag, and honours Range
+ * requests whose If-Range matches it. /slow/... answers after a delay.
+ * The first request for /cut/..., /noetag/... (sent without ETag),
+ * /changed/... and /misranged/... drops the connection halfway through;
+ * /changed/... then serves a new image, and /misranged/... answers later
+ * Range requests from the wrong offset.
+ */
+class StubArtworkServer : public HttpStubServer {
+public:
+    StubArtworkServer()
+    {
+        setHandler([this](const HttpStubRequest &request) { return serve(request); });
+    }
+
+    static QByteArray bodyFor(const QString &path)
+    {
+        // Regional releases often share the same box art
+        if (path.startsWith("/usa/") || path.startsWith("/eur/")) {
+            return QByteArray("shared-box-art-").repeated(50);
+        }
+        return ("image:" + path.toUtf8()).repeated(20);
+    }
+
+    /// Range headers sent for @p path, oldest first
+    QStringList ranges(const QString &path) const
+    {
+        QStringList ranges;
+        for (const HttpStubRequest &request : requests(path)) {
+            ranges.append(QString::fromLatin1(request.header("range")));
+        }
+        return ranges;
+    }
+
+    /// What @p path serves once its first request was cut off
+    static QByteArray laterBodyFor(const QString &path)
+    {
+        return path.startsWith("/changed/") ? ("new-image:" + path.toUtf8()).repeated(20) : bodyFor(path);
+    }
+
+private:
+    static bool cutFirst(const QString &path)
+    {
+        return path.startsWith("/cut/") || path.startsWith("/noetag/")
+               || path.startsWith("/changed/") || path.startsWith("/misranged/");
+    }
+
+    HttpStubResponse serve(const HttpStubRequest &request)
+    {
+        const bool first = requests(request.path).size() == 1;
+        const QByteArray body = first ? bodyFor(request.path) : laterBodyFor(request.path);
+        const QByteArray etag = '"' + QCryptographicHash::hash(body, QCryptographicHash::Sha1).toHex().left(16) + '"';
+        const QByteArray range = request.header("range");
+
+        HttpStubResponse response(200, body);
+        response.close = true;
+        if (!request.path.startsWith("/noetag/")) {
+            response.headers.append({"ETag", etag});
+        }
+        if (cutFirst(request.path) && first) {
+            response.cutAfter = body.size() / 2;
+        } else if (range.startsWith("bytes=") && request.header("if-range") == etag) {
+            const qint64 from = request.path.startsWith("/misranged/") ? 0 : range.mid(6).chopped(1).toLongLong();
+            response.status = 206;
+            response.body = body.mid(from);
+            response.headers.append({"Content-Range", "bytes " + QByteArray::number(from) + "-"
+                                     + QByteArray::number(body.size() - 1) + "/"
+                                     + QByteArray::number(body.size())});
+        } else if (request.path.startsWith("/slow/")) {
+            response.delayMs = 100;
+        }
+        return response;
+    }
+};
+
 class ArtworkDownloaderTest : public QObject {
     Q_OBJECT
 
 private slots:
     void downloadsLocalFile();
     void invalidUrlFails();
+    void queueLimitsConcurrencyPerHost();
+    void queueFetchesSharedUrlOnce();
+    void identicalImagesStoredOnce();
+    void interruptedDownloadResumes();
+    void resumeNeedsValidator();
+    void changedImageIsFetchedWhole();
+    void misrangedResumeIsDiscarded();
+    void queueCancel();
 };
 
 void ArtworkDownloaderTest::downloadsLocalFile()
@@ -47,5 +134,192 @@ void ArtworkDownloaderTest::invalidUrlFails()
     QVERIFY(!failSpy.isEmpty());
 }
 
+void ArtworkDownloaderTest::queueLimitsConcurrencyPerHost()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    downloader.setMaxConcurrent(8);
+    downloader.setMaxPerHost(2);
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    for (int i = 0; i < 6; ++i) {
+        downloader.enqueue(server.url(QString("/slow/%1.png").arg(i)), dir.filePath(QString("out/%1.png").arg(i)));
+    }
+    QCOMPARE(downloader.pendingCount(), 6);
+
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(finishedSpy.first().at(0).toInt(), 6);
+    QCOMPARE(finishedSpy.first().at(1).toInt(), 0);
+    QCOMPARE(server.maxOpen(), 2);
+    QCOMPARE(downloader.pendingCount(), 0);
+}
+
+void ArtworkDownloaderTest::queueFetchesSharedUrlOnce()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    QSignalSpy completeSpy(&downloader, &ArtworkDownloader::downloadCompleted);
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    const QUrl url = server.url("/box/1.png");
+    downloader.enqueue(url, dir.filePath("boxart/Game A.png"));
+    downloader.enqueue(url, dir.filePath("boxart/Game B.png"));
+    // Nothing is reported from inside enqueue()
+    QCOMPARE(completeSpy.count(), 0);
+
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(completeSpy.count(), 2);
+    QCOMPARE(server.requests(), 1);
+
+    QFile file(dir.filePath("boxart/Game B.png"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), StubArtworkServer::bodyFor("/box/1.png"));
+
+    // Known URLs are only linked, even by a new downloader
+    ArtworkDownloader later;
+    later.setStorePath(dir.filePath("store"));
+    QSignalSpy laterSpy(&later, &ArtworkDownloader::queueFinished);
+    later.enqueue(url, dir.filePath("boxart/Game C.png"));
+    QVERIFY(laterSpy.wait(5000));
+    QCOMPARE(server.requests(), 1);
+    QVERIFY(QFile::exists(dir.filePath("boxart/Game C.png")));
+}
+
+void ArtworkDownloaderTest::identicalImagesStoredOnce()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    downloader.enqueue(server.url("/usa/sonic.png"), dir.filePath("boxart/Sonic (USA).png"));
+    downloader.enqueue(server.url("/eur/sonic.png"), dir.filePath("boxart/Sonic (Europe).png"));
+    downloader.enqueue(server.url("/jpn/sonic.png"), dir.filePath("boxart/Sonic (Japan).png"));
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(finishedSpy.first().at(0).toInt(), 3);
+
+    ArtworkStore store(dir.filePath("store"));
+    QCOMPARE(store.blobCount(), 2);
+    QFile europe(dir.filePath("boxart/Sonic (Europe).png"));
+    QVERIFY(europe.open(QIODevice::ReadOnly));
+    QCOMPARE(europe.readAll(), StubArtworkServer::bodyFor("/eur/sonic.png"));
+}
+
+void ArtworkDownloaderTest::interruptedDownloadResumes()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    const QString path = "/cut/large.png";
+    const QByteArray body = StubArtworkServer::bodyFor(path);
+    downloader.enqueue(server.url(path), dir.filePath("boxart/Large.png"));
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(finishedSpy.first().at(0).toInt(), 1);
+
+    // The retry asked only for the missing half, of the same image
+    const QStringList ranges = server.ranges(path);
+    QCOMPARE(ranges.size(), 2);
+    QVERIFY(ranges.contains(QString("bytes=%1-").arg(body.size() / 2)));
+    QVERIFY(!server.requests(path).last().header("if-range").isEmpty());
+
+    QFile file(dir.filePath("boxart/Large.png"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), body);
+    QVERIFY(!QFile::exists(ArtworkStore(dir.filePath("store")).partialPath(server.url(path))));
+}
+
+void ArtworkDownloaderTest::resumeNeedsValidator()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    // Without ETag or Last-Modified the kept half could not be checked
+    const QString path = "/noetag/large.png";
+    downloader.enqueue(server.url(path), dir.filePath("boxart/Large.png"));
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(finishedSpy.first().at(0).toInt(), 1);
+    QCOMPARE(server.ranges(path), QStringList({QString(), QString()}));
+
+    QFile file(dir.filePath("boxart/Large.png"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), StubArtworkServer::bodyFor(path));
+}
+
+void ArtworkDownloaderTest::changedImageIsFetchedWhole()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    const QString path = "/changed/large.png";
+    downloader.enqueue(server.url(path), dir.filePath("boxart/Large.png"));
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(finishedSpy.first().at(0).toInt(), 1);
+
+    // The resume was asked for, but the old half was not kept
+    QCOMPARE(server.requests(path).size(), 2);
+    QVERIFY(!server.ranges(path).last().isEmpty());
+    QFile file(dir.filePath("boxart/Large.png"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), StubArtworkServer::laterBodyFor(path));
+}
+
+void ArtworkDownloaderTest::misrangedResumeIsDiscarded()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    const QString path = "/misranged/large.png";
+    downloader.enqueue(server.url(path), dir.filePath("boxart/Large.png"));
+    QVERIFY(finishedSpy.wait(5000));
+    QCOMPARE(finishedSpy.first().at(0).toInt(), 1);
+
+    // Resume, wrong Content-Range, then the whole image
+    QCOMPARE(server.ranges(path).size(), 3);
+    QVERIFY(server.ranges(path).last().isEmpty());
+    QFile file(dir.filePath("boxart/Large.png"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), StubArtworkServer::bodyFor(path));
+}
+
+void ArtworkDownloaderTest::queueCancel()
+{
+    QTemporaryDir dir;
+    StubArtworkServer server;
+    ArtworkDownloader downloader;
+    downloader.setStorePath(dir.filePath("store"));
+    downloader.setMaxPerHost(1);
+    QSignalSpy finishedSpy(&downloader, &ArtworkDownloader::queueFinished);
+
+    for (int i = 0; i < 4; ++i) {
+        downloader.enqueue(server.url(QString("/slow/%1.png").arg(i)), dir.filePath(QString("out/%1.png").arg(i)));
+    }
+    QTRY_COMPARE(server.requests(), 1);
+    downloader.cancelAll();
+
+    QVERIFY(finishedSpy.count() == 1 || finishedSpy.wait(5000));
+    const int completed = finishedSpy.first().at(0).toInt();
+    const int failed = finishedSpy.first().at(1).toInt();
+    QCOMPARE(completed + failed, 4);
+    QVERIFY(failed >= 3);
+    QCOMPARE(server.requests(), 1);
+}
+
 QTEST_MAIN(ArtworkDownloaderTest)
 #include "test_artwork_downloader.moc"
@@ -1,9 +1,168 @@
 #include <QtTest/QtTest>
 #include <QTemporaryFile>
+#include <QTemporaryDir>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <zlib.h>
 #include "../src/metadata/clrmamepro_parser.h"
 
 using namespace Remus;
 
+namespace {
+
+const QString GENESIS_DAT =
+    QStringLiteral(REMUS_DATABASES_DIR "/Sega - Mega Drive - Genesis.dat");
+
+QByteArray gzipData(const QByteArray &data)
+{
+    z_stream stream{};
+    deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    QByteArray out(static_cast<int>(deflateBound(&stream, data.size())) + 32, Qt::Uninitialized);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    return out;
+}
+
+/// Single stored member ZIP: local header + central directory + EOCD
+QByteArray storedZip(const QByteArray &name, const QByteArray &data)
+{
+    auto put16 = [](QByteArray &out, quint16 value) {
+        char buf[2];
+        qToLittleEndian(value, buf);
+        out.append(buf, 2);
+    };
+    auto put32 = [](QByteArray &out, quint32 value) {
+        char buf[4];
+        qToLittleEndian(value, buf);
+        out.append(buf, 4);
+    };
+    const quint32 crc = static_cast<quint32>(
+        crc32(0L, reinterpret_cast<const Bytef *>(data.constData()), static_cast<uInt>(data.size())));
+
+    QByteArray zip;
+    put32(zip, 0x04034b50);
+    put16(zip, 20);
+    put16(zip, 0);
+    put16(zip, 0);      // stored
+    put32(zip, 0);      // time + date
+    put32(zip, crc);
+    put32(zip, static_cast<quint32>(data.size()));
+    put32(zip, static_cast<quint32>(data.size()));
+    put16(zip, static_cast<quint16>(name.size()));
+    put16(zip, 0);
+    zip.append(name);
+    zip.append(data);
+
+    const quint32 centralOffset = static_cast<quint32>(zip.size());
+    QByteArray central;
+    put32(central, 0x02014b50);
+    put16(central, 20);
+    put16(central, 20);
+    put16(central, 0);
+    put16(central, 0);
+    put32(central, 0);
+    put32(central, crc);
+    put32(central, static_cast<quint32>(data.size()));
+    put32(central, static_cast<quint32>(data.size()));
+    put16(central, static_cast<quint16>(name.size()));
+    put16(central, 0);  // extra
+    put16(central, 0);  // comment
+    put16(central, 0);  // disk
+    put16(central, 0);  // internal attributes
+    put32(central, 0);  // external attributes
+    put32(central, 0);  // local header offset
+    central.append(name);
+    zip.append(central);
+
+    put32(zip, 0x06054b50);
+    put16(zip, 0);
+    put16(zip, 0);
+    put16(zip, 1);
+    put16(zip, 1);
+    put32(zip, static_cast<quint32>(central.size()));
+    put32(zip, centralOffset);
+    put16(zip, 0);
+    return zip;
+}
+
+/**
+ * @brief The regex parser ClrMameProParser used to be, kept as a reference
+ *
+ * One entry per game (first rom only); needs each game's ")" on its own line.
+ */
+QList<ClrMameProEntry> legacyRegexParse(const QString &content)
+{
+    static const QRegularExpression gameRegex(R"(game\s*\(([^{}]*?)\n\s*\))",
+                                              QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression kvRegex(R"((\w+)\s+([^\n]+))");
+    static const QRegularExpression romRegex(R"(rom \((.*?)\)\s*$)",
+                                             QRegularExpression::MultilineOption);
+    static const QRegularExpression attrRegex(R"((\w+)\s+(?:"([^"]*)"|(\S+)))");
+    static const QRegularExpression regionRegex(R"(\(([^)]+)\))");
+
+    QList<ClrMameProEntry> entries;
+    QRegularExpressionMatchIterator games = gameRegex.globalMatch(content);
+    while (games.hasNext()) {
+        const QString block = games.next().captured(1);
+
+        QMap<QString, QString> game;
+        QRegularExpressionMatchIterator pairs = kvRegex.globalMatch(block);
+        while (pairs.hasNext()) {
+            const QRegularExpressionMatch pair = pairs.next();
+            QString value = pair.captured(2).trimmed();
+            if (value.startsWith('"') && value.endsWith('"')) {
+                value = value.mid(1, value.length() - 2);
+            }
+            game[pair.captured(1)] = value;
+        }
+
+        const QRegularExpressionMatch romMatch = romRegex.match(block);
+        if (!romMatch.hasMatch()) {
+            continue;
+        }
+        QMap<QString, QString> rom;
+        QRegularExpressionMatchIterator attrs = attrRegex.globalMatch(romMatch.captured(1));
+        while (attrs.hasNext()) {
+            const QRegularExpressionMatch attr = attrs.next();
+            rom[attr.captured(1)] = attr.captured(2).isEmpty() ? attr.captured(3) : attr.captured(2);
+        }
+
+        ClrMameProEntry entry;
+        entry.gameName = game.value("name");
+        entry.description = game.value("description", entry.gameName);
+        entry.serial = game.value("serial");
+        entry.romName = rom.value("name");
+        entry.size = rom.value("size").toLongLong();
+        entry.crc32 = rom.value("crc").toUpper();
+        entry.md5 = rom.value("md5").toLower();
+        entry.sha1 = rom.value("sha1").toLower();
+        entry.region = game.value("region");
+        if (entry.region.isEmpty()) {
+            const QRegularExpressionMatch region = regionRegex.match(entry.gameName);
+            if (region.hasMatch()) {
+                entry.region = region.captured(1).split(',').first().trimmed();
+            }
+        }
+        if (!entry.gameName.isEmpty() && !entry.crc32.isEmpty()) {
+            entries.append(entry);
+        }
+    }
+    return entries;
+}
+
+QByteArray readAll(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+} // namespace
+
 /**
  * @brief Unit tests for ClrMameProParser
  *
@@ -13,6 +172,8 @@ using namespace Remus;
  * - Full hash coverage (CRC32, MD5, SHA1)
  * - Header parsing
  * - Malformed / empty input handling
+ * - gzip and zipped DATs, progress reporting
+ * - Equivalence with (and a benchmark against) the old regex parser
  */
 class ClrMameProParserTest : public QObject {
     Q_OBJECT
@@ -34,6 +195,11 @@ private slots:
     void testParseMultipleGames();
     void testParseAllHashFields();
     void testParseRegionExtracted();
+    void testParseEveryRomOfGame();
+    void testParseInlineClosingParen();
+    void testParseGzipDat();
+    void testParseZippedDat();
+    void testProgressReported();
 
     // ── Header parsing tests ──────────────────────────────────────
     void testParseHeader();
@@ -43,6 +209,12 @@ private slots:
     void testParseEmptyFile();
     void testParseNonExistentFile();
     void testParseNoGameBlocks();
+    void testTokenizerSkipsBomAndQuotes();
+
+    // ── Bundled DAT ───────────────────────────────────────────────
+    void testMatchesRegexParserOnBundledDat();
+    void benchmarkRegexParser();
+    void benchmarkStreamingParser();
 };
 
 // ─────────────────────────────────────────────────────────────────
@@ -143,6 +315,131 @@ void ClrMameProParserTest::testParseRegionExtracted()
     QVERIFY(!entries[0].region.isEmpty());
 }
 
+void ClrMameProParserTest::testParseEveryRomOfGame()
+{
+    QString content =
+        "game (\n"
+        "    name \"Disc Game (Japan)\"\n"
+        "    serial \"SLPS-00001\"\n"
+        "    rom ( name \"Disc Game (Track 1).bin\" size 1000 crc 11111111 )\n"
+        "    rom ( name \"Disc Game (Track 2).bin\" size 2000 crc 22222222 )\n"
+        "    rom ( name \"Disc Game.cue\" size 30 md5 ABCDEF0123456789ABCDEF0123456789 )\n"
+        "    rom ( name \"readme.txt\" size 5 )\n"
+        ")\n";
+
+    QTemporaryFile tmp;
+    QString path = writeTempDat(tmp, content);
+    QVERIFY(!path.isEmpty());
+
+    QList<ClrMameProEntry> entries = ClrMameProParser::parse(path);
+
+    // Every hashed rom becomes an entry; the unhashed one is dropped
+    QCOMPARE(entries.size(), 3);
+    QCOMPARE(entries[1].romName, QString("Disc Game (Track 2).bin"));
+    QCOMPARE(entries[1].crc32, QString("22222222"));
+    QCOMPARE(entries[1].size, qint64(2000));
+    QCOMPARE(entries[2].md5, QString("abcdef0123456789abcdef0123456789"));
+    QVERIFY(entries[2].crc32.isEmpty());
+    for (const ClrMameProEntry &entry : entries) {
+        QCOMPARE(entry.gameName, QString("Disc Game (Japan)"));
+        QCOMPARE(entry.serial, QString("SLPS-00001"));
+        QCOMPARE(entry.region, QString("Japan"));
+    }
+}
+
+void ClrMameProParserTest::testParseInlineClosingParen()
+{
+    // Nothing requires the closing parenthesis to sit on its own line
+    QString content =
+        "clrmamepro ( name \"Compact\" version 1 )\n"
+        "game ( name \"One (USA)\" rom ( name \"one.md\" size 1 crc 0000000A ) )\n"
+        "game ( name \"Two (Europe)\" region \"Europe\" "
+        "rom ( name \"two.md\" size 2 crc 0000000B ) )";
+
+    QTemporaryFile tmp;
+    QString path = writeTempDat(tmp, content);
+    QVERIFY(!path.isEmpty());
+
+    QMap<QString, QString> header;
+    QList<ClrMameProEntry> entries = ClrMameProParser::parse(path, &header);
+
+    QCOMPARE(header.value("name"), QString("Compact"));
+    QCOMPARE(header.value("version"), QString("1"));
+    QCOMPARE(entries.size(), 2);
+    QCOMPARE(entries[0].crc32, QString("0000000A"));
+    QCOMPARE(entries[1].gameName, QString("Two (Europe)"));
+    QCOMPARE(entries[1].region, QString("Europe"));
+}
+
+void ClrMameProParserTest::testParseGzipDat()
+{
+    const QByteArray content =
+        "clrmamepro (\n\tname \"Zipped\"\n)\n"
+        "game (\n\tname \"Game (USA)\"\n\trom ( name \"game.md\" size 4 crc DEADBEEF )\n)\n";
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("system.dat.gz"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(gzipData(content));
+    file.close();
+
+    QCOMPARE(ClrMameProParser::parseHeader(file.fileName()).value("name"), QString("Zipped"));
+    QList<ClrMameProEntry> entries = ClrMameProParser::parse(file.fileName());
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].crc32, QString("DEADBEEF"));
+
+    // A truncated stream is rejected rather than half-parsed
+    QFile truncated(dir.filePath("truncated.dat.gz"));
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    truncated.write(gzipData(content).left(20));
+    truncated.close();
+    QVERIFY(!ClrMameProParser::parseFile(truncated.fileName(), nullptr));
+}
+
+void ClrMameProParserTest::testParseZippedDat()
+{
+    const QByteArray content =
+        "game (\n\tname \"Game (USA)\"\n\trom ( name \"game.md\" size 4 crc CAFEBABE )\n)\n";
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("system.zip"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(storedZip("system.dat", content));
+    file.close();
+
+    QList<ClrMameProEntry> entries = ClrMameProParser::parse(file.fileName());
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries[0].crc32, QString("CAFEBABE"));
+}
+
+void ClrMameProParserTest::testProgressReported()
+{
+    QString content;
+    for (int i = 0; i < 20000; ++i) {
+        content += QString("game (\n\tname \"Game %1 (USA)\"\n"
+                           "\trom ( name \"game%1.md\" size 1 crc %2 )\n)\n")
+                       .arg(i).arg(i, 8, 16, QChar('0'));
+    }
+
+    QTemporaryFile tmp;
+    QString path = writeTempDat(tmp, content);
+    QVERIFY(!path.isEmpty());
+
+    QList<QPair<qint64, qint64>> reports;
+    QList<ClrMameProEntry> entries = ClrMameProParser::parse(path, nullptr,
+        [&reports](qint64 done, qint64 total) { reports.append({done, total}); });
+
+    QCOMPARE(entries.size(), 20000);
+    QVERIFY(reports.size() >= 2);
+    for (int i = 1; i < reports.size(); ++i) {
+        QVERIFY(reports[i].first >= reports[i - 1].first);
+    }
+    QCOMPARE(reports.last().first, QFileInfo(path).size());
+    QCOMPARE(reports.last().second, QFileInfo(path).size());
+}
+
 // ─────────────────────────────────────────────────────────────────
 // Header parsing tests
 // ─────────────────────────────────────────────────────────────────
@@ -222,6 +519,83 @@ void ClrMameProParserTest::testParseNoGameBlocks()
     QVERIFY(entries.isEmpty());
 }
 
+void ClrMameProParserTest::testTokenizerSkipsBomAndQuotes()
+{
+    using Token = ClrMameProTokenizer::Token;
+    const QByteArray text = "\xEF\xBB\xBFgame ( name \"A (B) C\" )";
+    ClrMameProTokenizer tokens(text);
+
+    QCOMPARE(tokens.next(), Token::Word);
+    QCOMPARE(tokens.text().toByteArray(), QByteArray("game"));
+    QCOMPARE(tokens.next(), Token::Open);
+    QCOMPARE(tokens.next(), Token::Word);
+    QCOMPARE(tokens.next(), Token::String);
+    QCOMPARE(tokens.text().toByteArray(), QByteArray("A (B) C"));
+    // Views point into the input rather than a copy
+    QVERIFY(tokens.text().data() >= text.constData());
+    QVERIFY(tokens.text().data() < text.constData() + text.size());
+    QCOMPARE(tokens.next(), Token::Close);
+    QCOMPARE(tokens.next(), Token::End);
+    QCOMPARE(tokens.position(), qsizetype(text.size()));
+}
+
+// ─────────────────────────────────────────────────────────────────
+// Bundled DAT
+// ─────────────────────────────────────────────────────────────────
+
+void ClrMameProParserTest::testMatchesRegexParserOnBundledDat()
+{
+    if (!QFileInfo::exists(GENESIS_DAT)) {
+        QSKIP("Bundled Genesis DAT not available");
+    }
+
+    const QList<ClrMameProEntry> expected = legacyRegexParse(QString::fromUtf8(readAll(GENESIS_DAT)));
+    QMap<QString, QString> header;
+    const QList<ClrMameProEntry> actual = ClrMameProParser::parse(GENESIS_DAT, &header);
+
+    QCOMPARE(header.value("version"), ClrMameProParser::parseHeader(GENESIS_DAT).value("version"));
+    QVERIFY(expected.size() > 1000);
+    QCOMPARE(actual.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QCOMPARE(actual[i].gameName, expected[i].gameName);
+        QCOMPARE(actual[i].description, expected[i].description);
+        QCOMPARE(actual[i].region, expected[i].region);
+        QCOMPARE(actual[i].romName, expected[i].romName);
+        QCOMPARE(actual[i].size, expected[i].size);
+        QCOMPARE(actual[i].crc32, expected[i].crc32);
+        QCOMPARE(actual[i].md5, expected[i].md5);
+        QCOMPARE(actual[i].sha1, expected[i].sha1);
+        QCOMPARE(actual[i].serial, expected[i].serial);
+    }
+}
+
+void ClrMameProParserTest::benchmarkRegexParser()
+{
+    if (!QFileInfo::exists(GENESIS_DAT)) {
+        QSKIP("Bundled Genesis DAT not available");
+    }
+
+    // Same work as the old parse(): read, decode, then match game blocks
+    QList<ClrMameProEntry> entries;
+    QBENCHMARK {
+        entries = legacyRegexParse(QString::fromUtf8(readAll(GENESIS_DAT)));
+    }
+    QVERIFY(!entries.isEmpty());
+}
+
+void ClrMameProParserTest::benchmarkStreamingParser()
+{
+    if (!QFileInfo::exists(GENESIS_DAT)) {
+        QSKIP("Bundled Genesis DAT not available");
+    }
+
+    QList<ClrMameProEntry> entries;
+    QBENCHMARK {
+        entries = ClrMameProParser::parse(GENESIS_DAT);
+    }
+    QVERIFY(!entries.isEmpty());
+}
+
 QTEST_MAIN(ClrMameProParserTest)
 #include "test_clrmamepro_parser.moc"
 
@@ -0,0 +1,338 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include "../src/core/dat_index.h"
+#include "../src/metadata/local_database_provider.h"
+
+using namespace Remus;
+
+/**
+ * @brief Unit tests for DatIndex and its use by LocalDatabaseProvider
+ *
+ * Covers:
+ * - Compiling entries and looking them up by CRC32 / MD5 / SHA1
+ * - Duplicate hashes (last DAT entry wins, as with the old hash tables)
+ * - Rejecting stale, truncated and foreign images
+ * - The provider mapping a previously compiled index instead of re-parsing
+ * - Parallel directory loads and lazy per-system loading
+ * - Title search restricted to the requested system's DAT
+ */
+class DatIndexTest : public QObject {
+    Q_OBJECT
+
+private:
+    static ClrMameProEntry makeEntry(const QString &name, const QString &crc,
+                                     const QString &md5 = QString(),
+                                     const QString &sha1 = QString())
+    {
+        ClrMameProEntry entry;
+        entry.gameName = name;
+        entry.description = name;
+        entry.region = "USA";
+        entry.romName = name + ".md";
+        entry.size = 524288;
+        entry.crc32 = crc;
+        entry.md5 = md5;
+        entry.sha1 = sha1;
+        entry.status = "verified";
+        return entry;
+    }
+
+    static bool writeFile(const QString &path, const QByteArray &data)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        return file.write(data) == data.size();
+    }
+
+    static QByteArray datText(const QString &crc)
+    {
+        return QString(
+            "clrmamepro (\n"
+            "\tname \"Test System\"\n"
+            "\tversion \"2026.01.17\"\n"
+            ")\n"
+            "game (\n"
+            "\tname \"Sonic The Hedgehog (USA, Europe)\"\n"
+            "\trom ( name \"Sonic The Hedgehog (USA, Europe).md\" size 524288 crc %1 )\n"
+            ")\n").arg(crc).toUtf8();
+    }
+
+private slots:
+    // ── Image format ──────────────────────────────────────────────
+    void testLookupByEachHash();
+    void testDuplicateHashLastWins();
+    void testHeaderFields();
+    void testMapRejectsStaleSource();
+    void testRejectsCorruptImages();
+
+    // ── Provider integration ──────────────────────────────────────
+    void testProviderMapsCompiledIndex();
+    void testProviderWithoutIndexDirectory();
+    void testParallelLoadDatabases();
+    void testLazyLoadingOpensRequestedSystem();
+    void testSearchByNameHonoursSystem();
+};
+
+// ─────────────────────────────────────────────────────────────────
+// Image format
+// ─────────────────────────────────────────────────────────────────
+
+void DatIndexTest::testLookupByEachHash()
+{
+    const QList<ClrMameProEntry> entries = {
+        makeEntry("Alpha", "F9394E97", "0123456789abcdef0123456789abcdef",
+                  "da39a3ee5e6b4b0d3255bfef95601890afd80709"),
+        makeEntry("Beta", "00000001"),
+        makeEntry("Gamma", "FFFFFFFF"),
+    };
+    auto index = DatIndex::fromImage(DatIndex::compile(entries, {}, QFileInfo()));
+    QVERIFY(index);
+    QCOMPARE(index->entryCount(), 3);
+
+    QCOMPARE(index->find(u"f9394e97"), 0);
+    QCOMPARE(index->find(u" F9394E97 "), 0);
+    QCOMPARE(index->findCrc32(0xFFFFFFFFu), 2);
+    QCOMPARE(index->find(u"0123456789ABCDEF0123456789ABCDEF"), 0);
+    QCOMPARE(index->find(u"DA39A3EE5E6B4B0D3255BFEF95601890AFD80709"), 0);
+    QCOMPARE(index->find(u"12345678"), -1);
+    QCOMPARE(index->find(u"not-a-hash"), -1);
+
+    const ClrMameProEntry alpha = index->entry(0);
+    QCOMPARE(alpha.gameName, QString("Alpha"));
+    QCOMPARE(alpha.romName, QString("Alpha.md"));
+    QCOMPARE(alpha.region, QString("USA"));
+    QCOMPARE(alpha.status, QString("verified"));
+    QCOMPARE(alpha.size, qint64(524288));
+    QCOMPARE(alpha.crc32, QString("F9394E97"));
+    QCOMPARE(alpha.md5, QString("0123456789abcdef0123456789abcdef"));
+    QCOMPARE(alpha.sha1, QString("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+
+    // Entries without MD5/SHA1 come back without them
+    QVERIFY(index->entry(1).md5.isEmpty());
+    QVERIFY(index->entry(1).sha1.isEmpty());
+    QCOMPARE(index->entry(1).crc32, QString("00000001"));
+}
+
+void DatIndexTest::testDuplicateHashLastWins()
+{
+    const QList<ClrMameProEntry> entries = {
+        makeEntry("First", "AABBCCDD"),
+        makeEntry("Other", "11223344"),
+        makeEntry("Second", "AABBCCDD"),
+    };
+    auto index = DatIndex::fromImage(DatIndex::compile(entries, {}, QFileInfo()));
+    QVERIFY(index);
+    QCOMPARE(index->gameName(index->find(u"aabbccdd")), QString("Second"));
+}
+
+void DatIndexTest::testHeaderFields()
+{
+    const QMap<QString, QString> header = {
+        {"name", "Sega - Mega Drive - Genesis"},
+        {"version", "2026.01.17"},
+        {"description", "Genesis"},
+    };
+    auto index = DatIndex::fromImage(
+        DatIndex::compile({makeEntry("Alpha", "F9394E97")}, header, QFileInfo()));
+    QVERIFY(index);
+    QCOMPARE(index->datName(), QString("Sega - Mega Drive - Genesis"));
+    QCOMPARE(index->datVersion(), QString("2026.01.17"));
+    QCOMPARE(index->datDescription(), QString("Genesis"));
+}
+
+void DatIndexTest::testMapRejectsStaleSource()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString datPath = dir.filePath("system.dat");
+    const QString indexPath = dir.filePath("cache/system.rdi");
+    QVERIFY(writeFile(datPath, datText("F9394E97")));
+
+    const QByteArray image = DatIndex::compile({makeEntry("Alpha", "F9394E97")}, {},
+                                               QFileInfo(datPath));
+    QVERIFY(DatIndex::write(image, indexPath));
+
+    auto mapped = DatIndex::map(indexPath, QFileInfo(datPath));
+    QVERIFY(mapped);
+    QVERIFY(mapped->isMapped());
+    QCOMPARE(mapped->find(u"F9394E97"), 0);
+
+    // A DAT of a different size invalidates the index
+    QVERIFY(writeFile(datPath, datText("F9394E97") + "\n"));
+    QString error;
+    QVERIFY(!DatIndex::map(indexPath, QFileInfo(datPath), &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void DatIndexTest::testRejectsCorruptImages()
+{
+    const QByteArray image = DatIndex::compile({makeEntry("Alpha", "F9394E97")}, {}, QFileInfo());
+    QVERIFY(DatIndex::fromImage(image));
+
+    QVERIFY(!DatIndex::fromImage(image.left(image.size() - 1)));
+    QVERIFY(!DatIndex::fromImage(QByteArray("clrmamepro (\n)\n")));
+
+    QByteArray wrongVersion = image;
+    wrongVersion[8] = static_cast<char>(DatIndex::FORMAT_VERSION + 1);
+    QString error;
+    QVERIFY(!DatIndex::fromImage(wrongVersion, &error));
+    QVERIFY(error.contains("version"));
+}
+
+// ─────────────────────────────────────────────────────────────────
+// Provider integration
+// ─────────────────────────────────────────────────────────────────
+
+void DatIndexTest::testProviderMapsCompiledIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString datPath = dir.filePath("Test System.dat");
+    QVERIFY(writeFile(datPath, datText("F9394E97")));
+    const QDateTime mtime = QFileInfo(datPath).lastModified();
+
+    LocalDatabaseProvider first;
+    first.setIndexDirectory(dir.filePath("index"));
+    QCOMPARE(first.loadDatabase(datPath), 1);
+    QVERIFY(QFileInfo::exists(first.indexPathFor(QFileInfo(datPath))));
+    QCOMPARE(first.getLoadedDats().first().version, QString("2026.01.17"));
+
+    // Same size and mtime but different contents: only the index can answer
+    // with the old CRC, which proves the DAT was not parsed again
+    QVERIFY(writeFile(datPath, datText("0BADF00D")));
+    {
+        QFile file(datPath);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(mtime, QFileDevice::FileModificationTime));
+    }
+
+    LocalDatabaseProvider second;
+    second.setIndexDirectory(dir.filePath("index"));
+    QCOMPARE(second.loadDatabase(datPath), 1);
+    QCOMPARE(second.getByHash("f9394e97", QString()).title,
+             QString("Sonic The Hedgehog (USA, Europe)"));
+    QVERIFY(second.getByHash("0BADF00D", QString()).title.isEmpty());
+}
+
+void DatIndexTest::testProviderWithoutIndexDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString datPath = dir.filePath("Test System.dat");
+    QVERIFY(writeFile(datPath, datText("F9394E97")));
+
+    LocalDatabaseProvider provider;
+    provider.setIndexDirectory(QString());
+    QVERIFY(provider.indexPathFor(QFileInfo(datPath)).isEmpty());
+    QCOMPARE(provider.loadDatabase(datPath), 1);
+
+    ROMSignals input;
+    input.crc32 = "f9394e97";
+    input.filename = "Sonic The Hedgehog (USA, Europe).md";
+    input.fileSize = 524288;
+    const QList<MultiSignalMatch> matches = provider.matchROM(input);
+    QCOMPARE(matches.size(), 1);
+    QVERIFY(matches.first().hashMatch);
+    QCOMPARE(matches.first().matchedHash, QString("CRC32:F9394E97"));
+    QCOMPARE(matches.first().confidenceScore, 180);
+
+    // Reloading the same system replaces its entries instead of adding to them
+    QCOMPARE(provider.loadDatabase(datPath), 1);
+    QCOMPARE(provider.getDatabaseStats().value("Test System"), 1);
+    QCOMPARE(provider.getLoadedDats().size(), 1);
+}
+
+void DatIndexTest::testParallelLoadDatabases()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QStringList crcs = {"00000001", "00000002", "00000003", "00000004", "00000005"};
+    for (int i = 0; i < crcs.size(); ++i) {
+        QVERIFY(writeFile(dir.filePath(QString("System %1.dat").arg(i)), datText(crcs[i])));
+    }
+
+    LocalDatabaseProvider provider;
+    provider.setIndexDirectory(QString());
+    QSignalSpy loaded(&provider, &LocalDatabaseProvider::databaseLoaded);
+    QSignalSpy progress(&provider, &LocalDatabaseProvider::loadingProgress);
+
+    QCOMPARE(provider.loadDatabases(dir.path()), crcs.size());
+    QCOMPARE(loaded.count(), crcs.size());
+    QCOMPARE(progress.count(), crcs.size());
+    // Registered in directory order whatever order the workers finished in
+    for (int i = 0; i < crcs.size(); ++i) {
+        QCOMPARE(loaded.at(i).at(0).toString(), QString("System %1").arg(i));
+        QCOMPARE(progress.at(i).at(0).toInt(), i + 1);
+        QCOMPARE(progress.at(i).at(1).toInt(), crcs.size());
+    }
+    QCOMPARE(provider.getDatabaseStats().size(), crcs.size());
+    QVERIFY(!provider.getByHash("00000004", QString()).title.isEmpty());
+}
+
+void DatIndexTest::testLazyLoadingOpensRequestedSystem()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("Sega - Mega Drive - Genesis.dat"), datText("F9394E97")));
+    QVERIFY(writeFile(dir.filePath("Nintendo - Game Boy.dat"), datText("0BADF00D")));
+
+    LocalDatabaseProvider provider;
+    provider.setIndexDirectory(QString());
+    provider.setLazyLoading(true);
+    QSignalSpy loaded(&provider, &LocalDatabaseProvider::databaseLoaded);
+
+    QCOMPARE(provider.loadDatabases(dir.path()), 0);
+    QCOMPARE(provider.pendingSystems().size(), 2);
+    QCOMPARE(loaded.count(), 0);
+    QVERIFY(provider.getLoadedDats().isEmpty());
+
+    // An internal system name opens just that system's DAT
+    QVERIFY(!provider.getByHash("f9394e97", "Genesis").title.isEmpty());
+    QCOMPARE(loaded.count(), 1);
+    QCOMPARE(loaded.first().at(0).toString(), QString("Sega - Mega Drive - Genesis"));
+    QCOMPARE(provider.pendingSystems(), QStringList({"Nintendo - Game Boy"}));
+
+    // Hashes from DATs that are still pending are not found for that system...
+    QVERIFY(provider.getByHash("0BADF00D", "Genesis").title.isEmpty());
+    QCOMPARE(loaded.count(), 1);
+
+    // ...while matching without a system opens everything left
+    ROMSignals input;
+    input.crc32 = "0BADF00D";
+    input.filename = "Sonic The Hedgehog (USA, Europe).md";
+    input.fileSize = 524288;
+    QCOMPARE(provider.matchROM(input).size(), 1);
+    QCOMPARE(loaded.count(), 2);
+    QVERIFY(provider.pendingSystems().isEmpty());
+    QCOMPARE(provider.getLoadedDats().size(), 2);
+}
+
+void DatIndexTest::testSearchByNameHonoursSystem()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeFile(dir.filePath("Sega - Mega Drive - Genesis.dat"), datText("F9394E97")));
+    QVERIFY(writeFile(dir.filePath("Nintendo - Game Boy.dat"), datText("0BADF00D")));
+
+    LocalDatabaseProvider provider;
+    provider.setIndexDirectory(QString());
+    QCOMPARE(provider.loadDatabases(dir.path()), 2);
+
+    QList<SearchResult> results = provider.searchByName("sonic the hedgehog", "Genesis");
+    QCOMPARE(results.size(), 1);
+    QCOMPARE(results.first().id, QString("F9394E97"));
+    QCOMPARE(results.first().system, QString("Genesis"));
+    QCOMPARE(results.first().matchScore, 1.0f);
+
+    // No system searches every DAT
+    results = provider.searchByName("sonic hedg", QString());
+    QCOMPARE(results.size(), 2);
+
+    QVERIFY(provider.searchByName("sonic", "Genesis", "Japan").isEmpty());
+    QCOMPARE(provider.searchByName("sonic", "Genesis", "Europe").size(), 1);
+}
+
+QTEST_MAIN(DatIndexTest)
+#include "test_dat_index.moc"
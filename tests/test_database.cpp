@@ -1,5 +1,6 @@
 #include <QtTest/QtTest>
 #include <QTemporaryDir>
+#include <QSqlQuery>
 #include "../src/core/database.h"
 
 using namespace Remus;
@@ -24,6 +25,10 @@ private slots:
     void testGetFilesWithoutHashes();
     void testGetUnprocessedFiles();
     void testUpdateFilePath();
+    void testWriteBatchCommitsInChunks();
+    void testWriteBatchRollsBackFailedCommit();
+    void testGetAllFilesSeesWrites();
+    void testGetExistingFilesFiltersMissing();
 };
 
 // ── Helpers ──────────────────────────────────────────────────────────────────
@@ -302,5 +307,119 @@ void DatabaseTest::testUpdateFilePath()
     QCOMPARE(got.currentPath, newPath);
 }
 
+void DatabaseTest::testWriteBatchCommitsInChunks()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString dbPath = tmp.filePath("batch.db");
+
+    Database db;
+    QVERIFY(db.initialize(dbPath));
+    int libId = db.insertLibrary("/roms", "Test");
+    int sysId = db.getSystemId("NES");
+
+    {
+        WriteBatch batch(db, 10, 60000);
+        for (int i = 0; i < 25; ++i) {
+            QVERIFY(db.insertFile(makeRecord(libId, sysId, QString("rom%1.nes").arg(i))) > 0);
+            batch.recordWrite();
+        }
+        // Two full chunks committed; the remainder is still pending
+        QCOMPARE(batch.commitCount(), 2);
+        batch.finish();
+        QCOMPARE(batch.commitCount(), 3);
+        QCOMPARE(batch.rowsWritten(), 25);
+        QVERIFY(batch.rowsPerSecond() > 0.0);
+    }
+
+    // Everything is durable and visible to another connection
+    Database reader;
+    QVERIFY(reader.initialize(dbPath));
+    QCOMPARE(reader.getAllFiles().size(), 25);
+}
+
+void DatabaseTest::testWriteBatchRollsBackFailedCommit()
+{
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    int sysId = db.getSystemId("NES");
+    QSqlQuery pragma(db.database());
+    QVERIFY(pragma.exec("PRAGMA foreign_keys = ON"));
+
+    WriteBatch batch(db, 10, 60000);
+    // A deferred foreign key violation makes every COMMIT of this transaction fail
+    QVERIFY(pragma.exec("PRAGMA defer_foreign_keys = ON"));
+    QVERIFY(db.insertFile(makeRecord(9999, sysId, "orphan.nes")) > 0);
+    batch.recordWrite();
+
+    QVERIFY(!batch.finish());
+    QCOMPARE(batch.rowsLost(), 1);
+    QCOMPARE(batch.commitCount(), 0);
+    QVERIFY(!batch.lastError().isEmpty());
+
+    // The rows were rolled back and the connection is usable again
+    QVERIFY(db.getAllFiles().isEmpty());
+    int libId = db.insertLibrary("/roms", "Test");
+    QVERIFY(db.insertFile(makeRecord(libId, sysId, "kept.nes")) > 0);
+    QCOMPARE(db.getAllFiles().size(), 1);
+}
+
+void DatabaseTest::testGetAllFilesSeesWrites()
+{
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    int libId = db.insertLibrary("/roms", "Test");
+    int sysId = db.getSystemId("NES");
+
+    int fileId = db.insertFile(makeRecord(libId, sysId, "mario.nes"));
+    QList<FileRecord> files = db.getAllFiles();
+    QCOMPARE(files.size(), 1);
+    QVERIFY(!files.first().hashCalculated);
+
+    // Cached between calls, but any write must be reflected
+    QCOMPARE(db.getAllFiles().size(), 1);
+    QVERIFY(db.updateFileHashes(fileId, "aaaaaaaa", "md5", "sha1"));
+    files = db.getAllFiles();
+    QCOMPARE(files.size(), 1);
+    QVERIFY(files.first().hashCalculated);
+    QCOMPARE(files.first().crc32, QStringLiteral("aaaaaaaa"));
+
+    db.insertFile(makeRecord(libId, sysId, "zelda.nes"));
+    QCOMPARE(db.getAllFiles().size(), 2);
+}
+
+void DatabaseTest::testGetExistingFilesFiltersMissing()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    int libId = db.insertLibrary(tmp.path(), "Test");
+    int sysId = db.getSystemId("NES");
+
+    // Enough rows to take the parallel path; every third one exists on disk
+    const int total = 300;
+    int present = 0;
+    for (int i = 0; i < total; ++i) {
+        FileRecord fr = makeRecord(libId, sysId, QString("rom%1.nes").arg(i));
+        fr.originalPath = tmp.filePath(fr.filename);
+        fr.currentPath = fr.originalPath;
+        if (i % 3 == 0) {
+            QFile f(fr.currentPath);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            present++;
+        }
+        QVERIFY(db.insertFile(fr) > 0);
+    }
+
+    const QList<FileRecord> existing = db.getExistingFiles();
+    QCOMPARE(existing.size(), present);
+    for (int i = 1; i < existing.size(); ++i) {
+        QVERIFY(existing.at(i - 1).id < existing.at(i).id);
+    }
+    QCOMPARE(db.getAllFiles().size(), total);
+}
+
 QTEST_MAIN(DatabaseTest)
 #include "test_database.moc"
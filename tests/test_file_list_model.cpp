@@ -0,0 +1,212 @@
+/**
+ * @file test_file_list_model.cpp
+ * @brief Unit tests for FileListModel paging, SQL filters and in-place updates
+ */
+
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "../src/ui/models/file_list_model.h"
+#include "../src/core/database.h"
+
+using namespace Remus;
+
+class FileListModelTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    int addFile(Database &db, const QTemporaryDir &dir, int libId, int sysId, const QString &name)
+    {
+        const QString path = dir.filePath(name);
+        QFile f(path);
+        if (!f.open(QIODevice::WriteOnly)) {
+            return 0;
+        }
+        f.write("rom");
+        f.close();
+
+        FileRecord fr;
+        fr.libraryId    = libId;
+        fr.filename     = name;
+        fr.originalPath = path;
+        fr.currentPath  = path;
+        fr.extension    = "." + name.section('.', -1);
+        fr.systemId     = sysId;
+        fr.fileSize     = 3;
+        return db.insertFile(fr);
+    }
+
+private slots:
+    void testFetchesInPages();
+    void testSystemFilterRunsInSql();
+    void testUpdateFileEmitsDataChanged();
+    void testUpdateFileOutsideFilterIsIgnored();
+    void testNewFileInsertsOneRow();
+};
+
+void FileListModelTest::testFetchesInPages()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    const int libId = db.insertLibrary(dir.path(), "Test");
+    const int sysId = db.getSystemId("NES");
+
+    const int total = FileListModel::FETCH_PAGE_SIZE * 2 + 50;
+    for (int i = 0; i < total; ++i) {
+        QVERIFY(addFile(db, dir, libId, sysId, QString("game%1.nes").arg(i)) > 0);
+    }
+
+    FileListModel model(&db);
+    QCOMPARE(model.totalCount(), total);
+    QCOMPARE(model.rowCount(), FileListModel::FETCH_PAGE_SIZE);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), FileListModel::FETCH_PAGE_SIZE * 2);
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), total);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(insertSpy.count(), 2);
+
+    // Rows beyond the fetched window are not served
+    model.refresh();
+    QCOMPARE(model.rowCount(), FileListModel::FETCH_PAGE_SIZE);
+    QVERIFY(!model.data(model.index(FileListModel::FETCH_PAGE_SIZE), FileListModel::IdRole).isValid());
+}
+
+void FileListModelTest::testSystemFilterRunsInSql()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    const int libId = db.insertLibrary(dir.path(), "Test");
+    const int nesId = db.getSystemId("NES");
+    const int snesId = db.getSystemId("SNES");
+
+    addFile(db, dir, libId, nesId, "mario.nes");
+    addFile(db, dir, libId, nesId, "zelda.nes");
+    addFile(db, dir, libId, snesId, "dkc.sfc");
+
+    FileListModel model(&db);
+    QCOMPARE(model.totalCount(), 3);
+
+    model.setSystemFilter(QString::number(snesId));
+    QCOMPARE(model.totalCount(), 1);
+    QCOMPARE(model.data(model.index(0), FileListModel::SystemRole).toInt(), snesId);
+
+    model.setSystemFilter(QString());
+    QCOMPARE(model.totalCount(), 3);
+}
+
+void FileListModelTest::testUpdateFileEmitsDataChanged()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    const int libId = db.insertLibrary(dir.path(), "Test");
+    const int sysId = db.getSystemId("NES");
+
+    addFile(db, dir, libId, sysId, "mario.nes");
+    const int zeldaId = addFile(db, dir, libId, sysId, "zelda.nes");
+    QVERIFY(zeldaId > 0);
+
+    FileListModel model(&db);
+    int row = -1;
+    for (int i = 0; i < model.rowCount(); ++i) {
+        if (model.data(model.index(i), FileListModel::IdRole).toInt() == zeldaId) row = i;
+    }
+    QVERIFY(row >= 0);
+    QVERIFY(model.data(model.index(row), FileListModel::Crc32Role).toString().isEmpty());
+
+    QVERIFY(db.updateFileHashes(zeldaId, "12345678", "md5", "sha1"));
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+    model.updateFile(zeldaId);
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().at(0).value<QModelIndex>().row(), row);
+    QCOMPARE(model.data(model.index(row), FileListModel::Crc32Role).toString(),
+             QStringLiteral("12345678"));
+    QCOMPARE(model.data(model.index(row), FileListModel::HashStateRole).toInt(),
+             static_cast<int>(WorkflowState::Complete));
+}
+
+void FileListModelTest::testUpdateFileOutsideFilterIsIgnored()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    const int libId = db.insertLibrary(dir.path(), "Test");
+    const int nesId = db.getSystemId("NES");
+    const int snesId = db.getSystemId("SNES");
+
+    addFile(db, dir, libId, nesId, "mario.nes");
+    FileListModel model(&db);
+    model.setSystemFilter(QString::number(nesId));
+    QCOMPARE(model.totalCount(), 1);
+
+    const int dkcId = addFile(db, dir, libId, snesId, "dkc.sfc");
+    QVERIFY(dkcId > 0);
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+    model.updateFile(dkcId);
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.totalCount(), 1);
+}
+
+void FileListModelTest::testNewFileInsertsOneRow()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Database db;
+    QVERIFY(db.initialize(":memory:"));
+    const int libId = db.insertLibrary(dir.path(), "Test");
+    const int sysId = db.getSystemId("PlayStation");
+
+    addFile(db, dir, libId, sysId, "alpha.cue");
+    addFile(db, dir, libId, sysId, "gamma.cue");
+    FileListModel model(&db);
+    QCOMPARE(model.rowCount(), 2);
+    const int unprocessed = model.unprocessedCount();
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+
+    // A new game lands between the two, in SQL order
+    const int betaId = addFile(db, dir, libId, sysId, "beta.cue");
+    model.updateFile(betaId);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.first().at(1).toInt(), 1);
+    QCOMPARE(model.data(model.index(1), FileListModel::IdRole).toInt(), betaId);
+    QCOMPARE(model.totalCount(), 3);
+    QCOMPARE(model.unprocessedCount(), unprocessed + 1);
+
+    // A track of an existing game joins its row
+    const int trackId = addFile(db, dir, libId, sysId, "gamma (Track 2).bin");
+    model.updateFile(trackId);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(2), FileListModel::FileCountRole).toInt(), 2);
+}
+
+QTEST_MAIN(FileListModelTest)
+#include "test_file_list_model.moc"
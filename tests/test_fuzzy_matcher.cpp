@@ -0,0 +1,212 @@
+#include <QtTest/QtTest>
+#include <QRandomGenerator>
+#include "../src/core/fuzzy_matcher.h"
+
+using namespace Remus;
+
+/**
+ * @brief Unit tests for FuzzyMatcher
+ *
+ * Covers:
+ * - Bit-parallel edit distance against the textbook dynamic programme,
+ *   including patterns longer than one 64-bit word and non-ASCII text
+ * - Similarity semantics the matchers rely on
+ * - Pruned best-k queries returning exactly the brute-force answer
+ * - Batch queries matching single queries
+ */
+class FuzzyMatcherTest : public QObject {
+    Q_OBJECT
+
+private:
+    static int referenceDistance(const QString &a, const QString &b)
+    {
+        QList<int> previous(b.size() + 1);
+        QList<int> current(b.size() + 1);
+        for (int j = 0; j <= b.size(); ++j) {
+            previous[j] = j;
+        }
+        for (int i = 1; i <= a.size(); ++i) {
+            current[0] = i;
+            for (int j = 1; j <= b.size(); ++j) {
+                const int cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+                current[j] = qMin(qMin(previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+            }
+            std::swap(previous, current);
+        }
+        return previous[b.size()];
+    }
+
+    static QString randomString(QRandomGenerator &random, int maxLength)
+    {
+        static const QString alphabet = QString::fromUtf8("abcd éü");
+        QString text;
+        const int length = random.bounded(maxLength + 1);
+        for (int i = 0; i < length; ++i) {
+            text.append(alphabet.at(random.bounded(alphabet.size())));
+        }
+        return text;
+    }
+
+    static QStringList sampleTitles()
+    {
+        return {
+            "Super Mario Bros",
+            "Super Mario Bros 3",
+            "Super Mario World",
+            "Super Metroid",
+            "Mario Kart",
+            "Zelda",
+            "Metroid",
+            "Sonic The Hedgehog",
+        };
+    }
+
+private slots:
+    void testKnownDistances();
+    void testDistanceMatchesReference();
+    void testSimilarity();
+    void testBestMatchesRanking();
+    void testBestMatchesMatchesBruteForce();
+    void testBatchMatchesSingleQueries();
+    void benchmarkBestMatches();
+};
+
+void FuzzyMatcherTest::testKnownDistances()
+{
+    QCOMPARE(FuzzyMatcher::editDistance(u"mario", u"mario"), 0);
+    QCOMPARE(FuzzyMatcher::editDistance(u"mario", u"maria"), 1);
+    QCOMPARE(FuzzyMatcher::editDistance(u"super mario bros", u"super mario"), 5);
+    QCOMPARE(FuzzyMatcher::editDistance(u"", u"zelda"), 5);
+    QCOMPARE(FuzzyMatcher::editDistance(u"kitten", u"sitting"), 3);
+}
+
+void FuzzyMatcherTest::testDistanceMatchesReference()
+{
+    QRandomGenerator random(42);
+    for (int i = 0; i < 2000; ++i) {
+        // Every tenth pair spans several 64-bit blocks
+        const int maxLength = (i % 10 == 0) ? 200 : 40;
+        const QString a = randomString(random, maxLength);
+        const QString b = randomString(random, maxLength);
+        QCOMPARE(FuzzyMatcher::editDistance(a, b), referenceDistance(a, b));
+    }
+}
+
+void FuzzyMatcherTest::testSimilarity()
+{
+    QCOMPARE(FuzzyMatcher::similarity("Mario", "MARIO"), 1.0f);
+    QCOMPARE(FuzzyMatcher::similarity("  Super   Mario ", "super mario"), 1.0f);
+    QCOMPARE(FuzzyMatcher::similarity("", ""), 0.0f);
+    QCOMPARE(FuzzyMatcher::similarity("mario", ""), 0.0f);
+    QCOMPARE(FuzzyMatcher::similarity("mario", "marii"), 0.8f);
+}
+
+void FuzzyMatcherTest::testBestMatchesRanking()
+{
+    const FuzzyMatcher matcher(sampleTitles());
+    QCOMPARE(matcher.titleCount(), 8);
+
+    const QList<FuzzyMatcher::Candidate> best = matcher.bestMatches("super mario bros", 3);
+    QCOMPARE(best.size(), 3);
+    QCOMPARE(best.at(0).index, 0);
+    QCOMPARE(best.at(0).similarity, 1.0f);
+    QCOMPARE(best.at(1).index, 1);
+    QVERIFY(best.at(1).similarity > best.at(2).similarity);
+
+    // Nothing reaches the bar
+    QVERIFY(matcher.bestMatches("castlevania", 3, 0.8f).isEmpty());
+    QVERIFY(matcher.bestMatches(QString(), 3).isEmpty());
+    QVERIFY(matcher.bestMatches("zelda", 0).isEmpty());
+}
+
+void FuzzyMatcherTest::testBestMatchesMatchesBruteForce()
+{
+    QRandomGenerator random(7);
+    for (int round = 0; round < 200; ++round) {
+        QStringList titles;
+        for (int i = 0; i < 100; ++i) {
+            titles.append(randomString(random, 24));
+        }
+        const FuzzyMatcher matcher(titles);
+        const QString name = randomString(random, 20);
+        const int k = 1 + random.bounded(6);
+        const float minSimilarity = float(random.bounded(8)) / 10.0f;
+
+        QList<FuzzyMatcher::Candidate> expected;
+        const QString normalizedName = FuzzyMatcher::normalize(name);
+        if (!normalizedName.isEmpty()) {
+            for (int i = 0; i < titles.size(); ++i) {
+                const QString title = FuzzyMatcher::normalize(titles.at(i));
+                const int maxLength = qMax(normalizedName.size(), title.size());
+                const float similarity = 1.0f - float(referenceDistance(normalizedName, title)) / float(maxLength);
+                if (similarity >= minSimilarity) {
+                    expected.append({i, similarity});
+                }
+            }
+        }
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const FuzzyMatcher::Candidate &a, const FuzzyMatcher::Candidate &b) {
+                             return a.similarity > b.similarity;
+                         });
+        expected = expected.mid(0, k);
+
+        const QList<FuzzyMatcher::Candidate> best = matcher.bestMatches(name, k, minSimilarity);
+        QCOMPARE(best.size(), expected.size());
+        for (int i = 0; i < best.size(); ++i) {
+            QCOMPARE(best.at(i).index, expected.at(i).index);
+            QCOMPARE(best.at(i).similarity, expected.at(i).similarity);
+        }
+    }
+}
+
+void FuzzyMatcherTest::testBatchMatchesSingleQueries()
+{
+    const FuzzyMatcher matcher(sampleTitles());
+    const QStringList names = {"super mario", "metroid", "sonic hedgehog", "", "mario kart 64"};
+
+    const QList<QList<FuzzyMatcher::Candidate>> batch = matcher.bestMatches(names, 2, 0.3f);
+    QCOMPARE(batch.size(), names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        const QList<FuzzyMatcher::Candidate> single = matcher.bestMatches(names.at(i), 2, 0.3f);
+        QCOMPARE(batch.at(i).size(), single.size());
+        for (int j = 0; j < single.size(); ++j) {
+            QCOMPARE(batch.at(i).at(j).index, single.at(j).index);
+        }
+    }
+}
+
+void FuzzyMatcherTest::benchmarkBestMatches()
+{
+    QRandomGenerator random(1);
+    const QStringList words = {
+        "super", "mario", "zelda", "metroid", "sonic", "street", "fighter", "final",
+        "fantasy", "mega", "man", "castle", "dragon", "quest", "kart", "world",
+    };
+    auto randomTitle = [&]() {
+        QStringList parts;
+        const int count = 2 + random.bounded(3);
+        for (int i = 0; i < count; ++i) {
+            parts.append(words.at(random.bounded(words.size())));
+        }
+        return parts.join(' ');
+    };
+
+    QStringList titles;
+    for (int i = 0; i < 20000; ++i) {
+        titles.append(randomTitle());
+    }
+    QStringList names;
+    for (int i = 0; i < 200; ++i) {
+        names.append(randomTitle());
+    }
+    const FuzzyMatcher matcher(titles);
+
+    QList<QList<FuzzyMatcher::Candidate>> results;
+    QBENCHMARK {
+        results = matcher.bestMatches(names, 5, 0.6f);
+    }
+    QCOMPARE(results.size(), names.size());
+}
+
+QTEST_MAIN(FuzzyMatcherTest)
+#include "test_fuzzy_matcher.moc"
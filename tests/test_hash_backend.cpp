@@ -0,0 +1,177 @@
+#include <QtTest/QtTest>
+#include <QCryptographicHash>
+#include <zlib.h>
+#include "../src/core/hash_backend.h"
+
+using namespace Remus;
+
+namespace {
+QByteArray sampleData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    char *out = data.data();
+    quint32 state = 0x12345678u;
+    for (int i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        out[i] = static_cast<char>(state >> 24);
+    }
+    return data;
+}
+
+quint32 zlibCrc(const QByteArray &data)
+{
+    uLong crc = crc32(0L, Z_NULL, 0);
+    return static_cast<quint32>(crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), data.size()));
+}
+}
+
+class HashBackendTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void testCrc32_data();
+    void testCrc32();
+    void testSha1_data();
+    void testSha1();
+    void testSha1ResultIsStable();
+    void testScalarFallback();
+    void testBackendNames();
+    void benchmarkCrc32_data();
+    void benchmarkCrc32();
+    void benchmarkSha1_data();
+    void benchmarkSha1();
+};
+
+void HashBackendTest::cleanup()
+{
+    HashBackend::setAccelerationEnabled(true);
+}
+
+void HashBackendTest::testCrc32_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("step");
+
+    // Sizes around the 64-byte fold minimum and 16-byte tails, fed whole and in pieces
+    for (int size : {0, 1, 15, 16, 63, 64, 65, 79, 80, 127, 128, 1000, 65536 + 13}) {
+        for (int step : {1, 17, 64, 1 << 20}) {
+            QTest::newRow(qPrintable(QString("size%1_step%2").arg(size).arg(step))) << size << step;
+        }
+    }
+}
+
+void HashBackendTest::testCrc32()
+{
+    QFETCH(int, size);
+    QFETCH(int, step);
+
+    const QByteArray data = sampleData(size);
+    Crc32Digest digest;
+    for (int offset = 0; offset < size; offset += step) {
+        digest.addData(data.constData() + offset, qMin(step, size - offset));
+    }
+
+    QCOMPARE(digest.value(), zlibCrc(data));
+    QCOMPARE(digest.hex(), QString("%1").arg(zlibCrc(data), 8, 16, QChar('0')));
+}
+
+void HashBackendTest::testSha1_data()
+{
+    testCrc32_data();
+}
+
+void HashBackendTest::testSha1()
+{
+    QFETCH(int, size);
+    QFETCH(int, step);
+
+    const QByteArray data = sampleData(size);
+    Sha1Digest digest;
+    for (int offset = 0; offset < size; offset += step) {
+        digest.addData(data.constData() + offset, qMin(step, size - offset));
+    }
+
+    QCOMPARE(digest.result().toHex(), QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
+void HashBackendTest::testSha1ResultIsStable()
+{
+    const QByteArray data = sampleData(200);
+    Sha1Digest digest;
+    digest.addData(data.constData(), data.size());
+    const QByteArray first = digest.result();
+    QCOMPARE(digest.result(), first);
+    QCOMPARE(first.size(), 20);
+}
+
+void HashBackendTest::testScalarFallback()
+{
+    HashBackend::setAccelerationEnabled(false);
+    QVERIFY(!HashBackend::hasAcceleratedCrc32());
+    QVERIFY(!HashBackend::hasAcceleratedSha1());
+    QCOMPARE(HashBackend::crc32BackendName(), QString("zlib"));
+    QCOMPARE(HashBackend::sha1BackendName(), QString("qt"));
+
+    const QByteArray data = sampleData(4096 + 7);
+    Crc32Digest crc;
+    crc.addData(data.constData(), data.size());
+    Sha1Digest sha1;
+    sha1.addData(data.constData(), data.size());
+
+    QCOMPARE(crc.value(), zlibCrc(data));
+    QCOMPARE(sha1.result(), QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+}
+
+void HashBackendTest::testBackendNames()
+{
+    const HashBackend::CpuFeatures features = HashBackend::cpuFeatures();
+    QCOMPARE(HashBackend::hasAcceleratedCrc32(), features.pclmul && features.sse41);
+    QCOMPARE(HashBackend::hasAcceleratedSha1(), features.shaNi && features.ssse3 && features.sse41);
+    QCOMPARE(HashBackend::crc32BackendName(),
+             HashBackend::hasAcceleratedCrc32() ? QString("pclmul") : QString("zlib"));
+    QCOMPARE(HashBackend::sha1BackendName(),
+             HashBackend::hasAcceleratedSha1() ? QString("sha-ni") : QString("qt"));
+}
+
+void HashBackendTest::benchmarkCrc32_data()
+{
+    QTest::addColumn<bool>("accelerated");
+    QTest::newRow("scalar") << false;
+    QTest::newRow("dispatched") << true;
+}
+
+void HashBackendTest::benchmarkCrc32()
+{
+    QFETCH(bool, accelerated);
+    HashBackend::setAccelerationEnabled(accelerated);
+
+    const QByteArray data = sampleData(16 * 1024 * 1024);
+    QBENCHMARK {
+        Crc32Digest digest;
+        digest.addData(data.constData(), data.size());
+        QVERIFY(digest.value() != 0);
+    }
+}
+
+void HashBackendTest::benchmarkSha1_data()
+{
+    benchmarkCrc32_data();
+}
+
+void HashBackendTest::benchmarkSha1()
+{
+    QFETCH(bool, accelerated);
+    HashBackend::setAccelerationEnabled(accelerated);
+
+    const QByteArray data = sampleData(16 * 1024 * 1024);
+    QBENCHMARK {
+        Sha1Digest digest;
+        digest.addData(data.constData(), data.size());
+        QCOMPARE(digest.result().size(), 20);
+    }
+}
+
+QTEST_MAIN(HashBackendTest)
+#include "test_hash_backend.moc"
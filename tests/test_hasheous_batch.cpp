@@ -0,0 +1,269 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "metadata/hasheous_provider.h"
+#include "metadata/rate_limiter.h"
+#include "http_stub_server.h"
+
+using namespace Remus;
+
+/**
+ * @brief Local stand-in for the Hasheous lookup endpoint
+ *
+ * Answers POST /api/v1/Lookup/ByHash like the service: 200 with the game
+ * for a known MD5, 404 otherwise, 500 for MD5s marked as failing. Runs on
+ * its own thread, as the provider blocks the test thread while it waits.
+ */
+class StubHasheousServer : public HttpStubServer {
+public:
+    StubHasheousServer()
+        : HttpStubServer([this](const HttpStubRequest &request) { return lookup(request); }, true)
+    {
+    }
+
+    void addGame(const QString &md5, const QString &title)
+    {
+        QMutexLocker locker(&m_gamesMutex);
+        m_games.insert(md5, title);
+    }
+
+    void addFailure(const QString &md5)
+    {
+        QMutexLocker locker(&m_gamesMutex);
+        m_failures.insert(md5);
+    }
+
+private:
+    HttpStubResponse lookup(const HttpStubRequest &request)
+    {
+        const QString md5 = QJsonDocument::fromJson(request.body).object().value("mD5").toString();
+        QMutexLocker locker(&m_gamesMutex);
+        if (m_failures.contains(md5)) {
+            return HttpStubResponse(500);
+        }
+        if (!m_games.contains(md5)) {
+            return HttpStubResponse(404);
+        }
+        const QJsonObject game{
+            {"id", 7},
+            {"name", m_games.value(md5)},
+            {"signatures", QJsonArray{"NoIntro"}},
+            {"metadata", QJsonArray{QJsonObject{{"source", "IGDB"}, {"immutableId", "1234"}}}},
+        };
+        HttpStubResponse response(200, QJsonDocument(game).toJson(QJsonDocument::Compact));
+        response.headers.append({"Content-Type", "application/json"});
+        return response;
+    }
+
+    QMutex m_gamesMutex;
+    QHash<QString, QString> m_games;
+    QSet<QString> m_failures;
+};
+
+/**
+ * @brief Provider without the per-game IGDB fetch, so only lookups reach the stub
+ */
+class LookupOnlyHasheous : public HasheousProvider {
+public:
+    using HasheousProvider::HasheousProvider;
+
+protected:
+    GameMetadata fetchIgdbMetadata(int) override { return GameMetadata(); }
+};
+
+/**
+ * @brief Batch hash lookups against a local Hasheous stub
+ *
+ * Covers:
+ * - Results fanned back to every file, duplicates sent once
+ * - Misses remembered and skipped; server errors not treated as misses
+ * - Single lookups consult and feed the same miss set
+ * - Single lookups reuse batch hits once
+ * - The rate limit lets a whole window start at once
+ * - Throughput over a kept-alive connection set
+ */
+class HasheousBatchTest : public QObject {
+    Q_OBJECT
+
+private:
+    static QString md5For(int i) { return QString("%1").arg(i, 32, 16, QLatin1Char('0')); }
+
+    static HasheousProvider::HashSet hashSet(int i)
+    {
+        HasheousProvider::HashSet hashes;
+        hashes.md5 = md5For(i);
+        return hashes;
+    }
+
+    StubHasheousServer *m_server = nullptr;
+
+    HasheousProvider *newProvider(QObject *parent)
+    {
+        auto *provider = new HasheousProvider(parent);
+        provider->setBaseUrl(QString("http://127.0.0.1:%1").arg(m_server->port()));
+        // The stub has no rate limit to respect
+        RateLimiter::shared(Constants::Providers::HASHEOUS)->setRate(0.0);
+        return provider;
+    }
+
+private slots:
+    void init();
+    void cleanup();
+    void testResultsFanOutToFiles();
+    void testMissesAreRemembered();
+    void testErrorsAreNotMisses();
+    void testSingleLookupsShareMisses();
+    void testSingleLookupsReuseBatchHits();
+    void testRateLimitBurstCoversWindow();
+    void benchmarkBatchLookup();
+};
+
+void HasheousBatchTest::init()
+{
+    m_server = new StubHasheousServer();
+}
+
+void HasheousBatchTest::cleanup()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+void HasheousBatchTest::testResultsFanOutToFiles()
+{
+    m_server->addGame(md5For(1), "Sonic the Hedgehog");
+    m_server->addGame(md5For(2), "Streets of Rage");
+    QObject owner;
+    HasheousProvider *provider = newProvider(&owner);
+
+    // File 3 is a second copy of file 1
+    const QList<HasheousProvider::HashSet> files = {hashSet(1), hashSet(2), hashSet(9), hashSet(1)};
+    const QList<GameMetadata> results = provider->getByHashesBatch(files);
+
+    QCOMPARE(results.size(), 4);
+    QCOMPARE(results.at(0).title, QString("Sonic the Hedgehog"));
+    QCOMPARE(results.at(1).title, QString("Streets of Rage"));
+    QVERIFY(results.at(2).title.isEmpty());
+    QCOMPARE(results.at(3).title, QString("Sonic the Hedgehog"));
+    QCOMPARE(results.at(0).providerId, QString(Constants::Providers::HASHEOUS));
+    QCOMPARE(results.at(0).externalIds.value(Constants::Providers::ExternalId::IGDB), QString("1234"));
+    QCOMPARE(m_server->requests(), 3);
+}
+
+void HasheousBatchTest::testMissesAreRemembered()
+{
+    m_server->addGame(md5For(1), "Sonic the Hedgehog");
+    QObject owner;
+    HasheousProvider *provider = newProvider(&owner);
+
+    provider->getByHashesBatch({hashSet(1), hashSet(5), hashSet(6)});
+    QCOMPARE(provider->knownMissCount(), 2);
+    QCOMPARE(m_server->requests(), 3);
+
+    // Only the hit is asked again
+    const QList<GameMetadata> again = provider->getByHashesBatch({hashSet(1), hashSet(5), hashSet(6)});
+    QCOMPARE(m_server->requests(), 4);
+    QCOMPARE(again.at(0).title, QString("Sonic the Hedgehog"));
+    QVERIFY(again.at(1).title.isEmpty());
+}
+
+void HasheousBatchTest::testErrorsAreNotMisses()
+{
+    m_server->addFailure(md5For(3));
+    QObject owner;
+    HasheousProvider *provider = newProvider(&owner);
+
+    const QList<GameMetadata> results = provider->getByHashesBatch({hashSet(3)});
+    QVERIFY(results.at(0).title.isEmpty());
+    QCOMPARE(provider->knownMissCount(), 0);
+
+    provider->getByHashesBatch({hashSet(3)});
+    QCOMPARE(m_server->requests(), 2);
+}
+
+void HasheousBatchTest::testSingleLookupsShareMisses()
+{
+    m_server->addFailure(md5For(4));
+    QObject owner;
+    HasheousProvider *provider = newProvider(&owner);
+
+    QVERIFY(provider->getByHashes(QString(), md5For(8), QString(), QString()).title.isEmpty());
+    QCOMPARE(provider->knownMissCount(), 1);
+    QVERIFY(provider->getByHashes(QString(), md5For(8), QString(), QString()).title.isEmpty());
+    provider->getByHashesBatch({hashSet(8)});
+    QCOMPARE(m_server->requests(), 1);
+
+    // A server error is asked again
+    provider->getByHashes(QString(), md5For(4), QString(), QString());
+    provider->getByHashes(QString(), md5For(4), QString(), QString());
+    QCOMPARE(m_server->requests(), 3);
+    QCOMPARE(provider->knownMissCount(), 1);
+}
+
+void HasheousBatchTest::testSingleLookupsReuseBatchHits()
+{
+    m_server->addGame(md5For(1), "Sonic the Hedgehog");
+    QObject owner;
+    auto *provider = new LookupOnlyHasheous(&owner);
+    provider->setBaseUrl(QString("http://127.0.0.1:%1").arg(m_server->port()));
+    RateLimiter::shared(Constants::Providers::HASHEOUS)->setRate(0.0);
+
+    provider->getByHashesBatch({hashSet(1), hashSet(2)});
+    QCOMPARE(m_server->requests(), 2);
+
+    // The batch answered both; neither is sent again
+    QCOMPARE(provider->getByHashes(QString(), md5For(1), QString(), QString()).title,
+             QString("Sonic the Hedgehog"));
+    QVERIFY(provider->getByHashes(QString(), md5For(2), QString(), QString()).title.isEmpty());
+    QCOMPARE(m_server->requests(), 2);
+
+    // A hit is reused once; later lookups ask again
+    provider->getByHashes(QString(), md5For(1), QString(), QString());
+    QCOMPARE(m_server->requests(), 3);
+}
+
+void HasheousBatchTest::testRateLimitBurstCoversWindow()
+{
+    QObject owner;
+    new HasheousProvider(&owner);
+    RateLimiter *limiter = RateLimiter::shared(Constants::Providers::HASHEOUS);
+    limiter->reset();
+
+    for (int i = 0; i < Constants::Network::HASHEOUS_BATCH_IN_FLIGHT; ++i) {
+        QVERIFY(limiter->tryAcquire());
+    }
+    // The sustained rate is unchanged
+    QVERIFY(!limiter->tryAcquire());
+}
+
+void HasheousBatchTest::benchmarkBatchLookup()
+{
+    QList<HasheousProvider::HashSet> files;
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 2 == 0) {
+            m_server->addGame(md5For(i), QString("Game %1").arg(i));
+        }
+        files.append(hashSet(i));
+    }
+    QObject owner;
+    HasheousProvider *provider = newProvider(&owner);
+
+    QList<GameMetadata> results;
+    QBENCHMARK_ONCE {
+        results = provider->getByHashesBatch(files);
+    }
+
+    int hits = 0;
+    for (const GameMetadata &metadata : std::as_const(results)) {
+        hits += metadata.title.isEmpty() ? 0 : 1;
+    }
+    QCOMPARE(hits, 1000);
+    QCOMPARE(m_server->requests(), 2000);
+    // Kept-alive connections are reused, not opened per lookup
+    QVERIFY2(m_server->connections() <= Constants::Network::HASHEOUS_BATCH_IN_FLIGHT,
+             qPrintable(QString::number(m_server->connections())));
+}
+
+QTEST_MAIN(HasheousBatchTest)
+#include "test_hasheous_batch.moc"
@@ -2,6 +2,7 @@
 #include <QTemporaryDir>
 #include <QFile>
 #include <QCryptographicHash>
+#include <QSignalSpy>
 #include <zlib.h>
 #include "../src/core/hasher.h"
 
@@ -14,6 +15,26 @@ QString crc32Hex(const QByteArray &data)
     crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), data.size());
     return QString("%1").arg(crc, 8, 16, QChar('0')).toLower();
 }
+
+QByteArray patternData(qint64 size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    char *out = data.data();
+    for (qint64 i = 0; i < size; ++i) {
+        out[i] = static_cast<char>((i * 131 + (i >> 12)) & 0xFF);
+    }
+    return data;
+}
+
+void addStrategyRows()
+{
+    QTest::addColumn<int>("strategy");
+    QTest::newRow("buffered") << static_cast<int>(Hasher::ReadStrategy::Buffered);
+    QTest::newRow("pread") << static_cast<int>(Hasher::ReadStrategy::Positional);
+    QTest::newRow("mmap") << static_cast<int>(Hasher::ReadStrategy::MemoryMapped);
+    QTest::newRow("direct") << static_cast<int>(Hasher::ReadStrategy::Direct);
+    QTest::newRow("auto") << static_cast<int>(Hasher::ReadStrategy::Auto);
+}
 }
 
 class HasherTest : public QObject
@@ -24,6 +45,13 @@ private slots:
     void testCalculateHashes();
     void testCalculateHashSingle();
     void testStripHeader();
+    void testMultiChunkStreaming();
+    void testProgressPerChunk();
+    void testReadStrategies_data();
+    void testReadStrategies();
+    void testReadStrategyNames();
+    void benchmarkReadStrategies_data();
+    void benchmarkReadStrategies();
     void testDetectHeaderSize();
     void testMissingFile();
 };
@@ -92,6 +120,166 @@ void HasherTest::testStripHeader()
     QCOMPARE(result.crc32, crc32Hex(data));
 }
 
+void HasherTest::testMultiChunkStreaming()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // Span several chunks with a non-aligned tail so chunk boundaries are exercised
+    const QString filePath = dir.path() + "/large.iso";
+    QByteArray data;
+    data.reserve(Hasher::CHUNK_SIZE * 3 + 123);
+    for (qint64 i = 0; i < Hasher::CHUNK_SIZE * 3 + 123; ++i) {
+        data.append(static_cast<char>((i * 31) & 0xFF));
+    }
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(data) == data.size());
+    file.close();
+
+    Hasher hasher;
+    HashResult result = hasher.calculateHashes(filePath);
+    QVERIFY(result.success);
+    QCOMPARE(result.crc32, crc32Hex(data));
+    QCOMPARE(result.md5, QString(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex()));
+    QCOMPARE(result.sha1, QString(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex()));
+
+    // Header skip must still apply when the payload spans chunks
+    HashResult stripped = hasher.calculateHashes(filePath, true, 512);
+    QVERIFY(stripped.success);
+    QCOMPARE(stripped.sha1, QString(QCryptographicHash::hash(data.mid(512), QCryptographicHash::Sha1).toHex()));
+}
+
+void HasherTest::testProgressPerChunk()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString filePath = dir.path() + "/progress.bin";
+    const QByteArray data(Hasher::CHUNK_SIZE * 4, 'x');
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(data) == data.size());
+    file.close();
+
+    Hasher hasher;
+    QSignalSpy spy(&hasher, &Hasher::hashProgress);
+    QVERIFY(hasher.calculateHashes(filePath).success);
+
+    QCOMPARE(spy.count(), 4);
+    QCOMPARE(spy.first().at(0).toString(), filePath);
+    QCOMPARE(spy.first().at(1).toInt(), 25);
+    QCOMPARE(spy.last().at(1).toInt(), 100);
+}
+
+void HasherTest::testReadStrategies_data()
+{
+    addStrategyRows();
+}
+
+void HasherTest::testReadStrategies()
+{
+    QFETCH(int, strategy);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // Larger than MMAP_THRESHOLD so Auto resolves to mmap on local disks,
+    // with an unaligned tail for the O_DIRECT short read.
+    const QString filePath = dir.path() + "/disc.bin";
+    const QByteArray data = patternData(Hasher::MMAP_THRESHOLD + 4096 * 3 + 77);
+
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(data) == data.size());
+    file.close();
+
+    Hasher hasher;
+    hasher.setReadStrategy(static_cast<Hasher::ReadStrategy>(strategy));
+    QVERIFY(hasher.effectiveReadStrategy(filePath) != Hasher::ReadStrategy::Auto);
+
+    HashResult result = hasher.calculateHashes(filePath);
+    QVERIFY(result.success);
+    QCOMPARE(result.crc32, crc32Hex(data));
+    QCOMPARE(result.md5, QString(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex()));
+    QCOMPARE(result.sha1, QString(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex()));
+
+    // Unaligned header skip exercises the page/block alignment paths
+    HashResult stripped = hasher.calculateHashes(filePath, true, 512 + 16);
+    QVERIFY(stripped.success);
+    QCOMPARE(stripped.crc32, crc32Hex(data.mid(512 + 16)));
+
+    HashResult missing = hasher.calculateHashes(dir.path() + "/missing.bin");
+    QVERIFY(!missing.success);
+    QVERIFY(!missing.error.isEmpty());
+}
+
+void HasherTest::testReadStrategyNames()
+{
+    const QList<Hasher::ReadStrategy> strategies = {
+        Hasher::ReadStrategy::Auto, Hasher::ReadStrategy::Buffered,
+        Hasher::ReadStrategy::Positional, Hasher::ReadStrategy::MemoryMapped,
+        Hasher::ReadStrategy::Direct
+    };
+    for (Hasher::ReadStrategy strategy : strategies) {
+        QCOMPARE(Hasher::readStrategyFromName(Hasher::readStrategyName(strategy)), strategy);
+    }
+    QCOMPARE(Hasher::readStrategyFromName(" MMAP "), Hasher::ReadStrategy::MemoryMapped);
+    QCOMPARE(Hasher::readStrategyFromName("bogus"), Hasher::ReadStrategy::Auto);
+
+    // Small files never pay mmap setup cost in Auto mode
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString smallPath = dir.path() + "/small.gb";
+    QFile small(smallPath);
+    QVERIFY(small.open(QIODevice::WriteOnly));
+    QVERIFY(small.write(QByteArray(32768, 'g')) == 32768);
+    small.close();
+
+    Hasher hasher;
+    QCOMPARE(hasher.effectiveReadStrategy(smallPath), Hasher::ReadStrategy::Buffered);
+}
+
+void HasherTest::benchmarkReadStrategies_data()
+{
+    addStrategyRows();
+}
+
+void HasherTest::benchmarkReadStrategies()
+{
+    QFETCH(int, strategy);
+
+    // Point REMUS_HASH_BENCH_FILE at a real image to compare strategies on
+    // a given storage type, e.g.:
+    //   REMUS_HASH_BENCH_FILE=/mnt/nas/game.iso ./test_hasher benchmarkReadStrategies
+    // or set REMUS_RUN_BENCHMARKS=1 to time a generated file. Skipped in
+    // the regular ctest run otherwise.
+    QString filePath = qEnvironmentVariable("REMUS_HASH_BENCH_FILE");
+    if (filePath.isEmpty() && !qEnvironmentVariableIsSet("REMUS_RUN_BENCHMARKS")) {
+        QSKIP("Set REMUS_RUN_BENCHMARKS or REMUS_HASH_BENCH_FILE to run");
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    if (filePath.isEmpty()) {
+        filePath = dir.path() + "/bench.bin";
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        const QByteArray data = patternData(Hasher::CHUNK_SIZE * 32);
+        QVERIFY(file.write(data) == data.size());
+        file.close();
+    }
+
+    Hasher hasher;
+    hasher.setReadStrategy(static_cast<Hasher::ReadStrategy>(strategy));
+
+    QBENCHMARK {
+        QVERIFY(hasher.calculateHashes(filePath).success);
+    }
+}
+
 void HasherTest::testDetectHeaderSize()
 {
     QTemporaryDir dir;
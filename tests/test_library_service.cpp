@@ -5,6 +5,7 @@
 
 #include <QtTest/QtTest>
 #include <QTemporaryDir>
+#include <QDir>
 #include <QFile>
 
 #include "../src/services/library_service.h"
@@ -41,6 +42,14 @@ private:
         txt.close();
     }
 
+    FileRecord findFile(Database &db, const QString &filename)
+    {
+        for (const auto &f : db.getAllFiles()) {
+            if (f.filename == filename) return f;
+        }
+        return {};
+    }
+
 private slots:
 
     void testScanInsertsFiles()
@@ -173,6 +182,150 @@ private slots:
             if (f.libraryId == libId) remainingForLib++;
         QCOMPARE(remainingForLib, 0);
     }
+
+    void testRescanKeepsUnchangedFiles()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        createStubRoms(tmp.path());
+
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/lib_svc_rescan.db"));
+
+        LibraryService svc;
+        QCOMPARE(svc.scan(tmp.path(), &db), 2);
+
+        FileRecord rom = findFile(db, "TestRom.nes");
+        QVERIFY(rom.id > 0);
+        QVERIFY(rom.fingerprint.isValid());
+        QVERIFY(db.updateFileHashes(rom.id, "deadbeef", "md5", "sha1"));
+
+        QCOMPARE(svc.scan(tmp.path(), &db), 0);
+        QCOMPARE(svc.lastRescanSummary().unchanged, 2);
+        QCOMPARE(svc.lastRescanSummary().modified, 0);
+        QCOMPARE(svc.lastRescanSummary().removed, 0);
+
+        FileRecord after = findFile(db, "TestRom.nes");
+        QCOMPARE(after.id, rom.id);
+        QVERIFY(after.hashCalculated);
+        QCOMPARE(after.crc32, QString("deadbeef"));
+    }
+
+    void testRescanInvalidatesModifiedFiles()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        createStubRoms(tmp.path());
+
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/lib_svc_modified.db"));
+
+        LibraryService svc;
+        svc.scan(tmp.path(), &db);
+
+        FileRecord rom = findFile(db, "TestRom.nes");
+        QVERIFY(db.updateFileHashes(rom.id, "deadbeef", "md5", "sha1"));
+
+        QFile f(tmp.path() + "/TestRom.nes");
+        QVERIFY(f.open(QIODevice::Append));
+        f.write(QByteArray(16, '\xCC'));
+        f.close();
+
+        QCOMPARE(svc.scan(tmp.path(), &db), 0);
+        QCOMPARE(svc.lastRescanSummary().modified, 1);
+        QCOMPARE(svc.lastRescanSummary().unchanged, 1);
+
+        FileRecord after = findFile(db, "TestRom.nes");
+        QCOMPARE(after.id, rom.id);
+        QVERIFY(!after.hashCalculated);
+        QVERIFY(after.crc32.isEmpty());
+        QCOMPARE(after.fileSize, rom.fileSize + 16);
+    }
+
+    void testRescanPrunesDeletedFiles()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        createStubRoms(tmp.path());
+
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/lib_svc_deleted.db"));
+
+        LibraryService svc;
+        svc.scan(tmp.path(), &db);
+        QVERIFY(findFile(db, "Another.nes").id > 0);
+
+        QVERIFY(QFile::remove(tmp.path() + "/Another.nes"));
+
+        svc.scan(tmp.path(), &db);
+        QCOMPARE(svc.lastRescanSummary().removed, 1);
+        QCOMPARE(findFile(db, "Another.nes").id, 0);
+        QVERIFY(findFile(db, "TestRom.nes").id > 0);
+    }
+
+    void testRescanOfMissingRootKeepsRows()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        const QString romDir = tmp.path() + "/roms";
+        QVERIFY(QDir().mkpath(romDir));
+        createStubRoms(romDir);
+
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/lib_svc_missing.db"));
+
+        LibraryService svc;
+        QCOMPARE(svc.scan(romDir, &db), 2);
+
+        // An unmounted share looks like a missing directory
+        QVERIFY(QDir(romDir).removeRecursively());
+
+        QCOMPARE(svc.scan(romDir, &db), 0);
+        QCOMPARE(svc.lastRescanSummary().removed, 0);
+        QVERIFY(findFile(db, "TestRom.nes").id > 0);
+        QVERIFY(findFile(db, "Another.nes").id > 0);
+    }
+
+    void testRescanKeepsMembersOfUnlistableArchive()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        createStubRoms(tmp.path());
+
+        // Not a zip: neither the native reader nor a tool can list it
+        const QString archive = tmp.path() + "/Broken.zip";
+        QFile zip(archive);
+        QVERIFY(zip.open(QIODevice::WriteOnly));
+        zip.write("not a zip archive");
+        zip.close();
+
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/lib_svc_archive.db"));
+        const int libraryId = db.insertLibrary(tmp.path());
+        QVERIFY(libraryId > 0);
+
+        FileRecord member;
+        member.libraryId = libraryId;
+        member.originalPath = archive;
+        member.currentPath = archive;
+        member.filename = "Game.nes";
+        member.extension = ".nes";
+        member.isCompressed = true;
+        member.archivePath = archive;
+        member.archiveInternalPath = "Game.nes";
+        QVERIFY(db.insertFile(member) > 0);
+
+        LibraryService svc;
+        svc.scan(tmp.path(), &db, nullptr, nullptr, libraryId);
+        QCOMPARE(svc.lastRescanSummary().removed, 0);
+        QVERIFY(findFile(db, "Game.nes").id > 0);
+
+        // Once the archive itself is gone its members are pruned
+        QVERIFY(QFile::remove(archive));
+        svc.scan(tmp.path(), &db, nullptr, nullptr, libraryId);
+        QCOMPARE(svc.lastRescanSummary().removed, 1);
+        QCOMPARE(findFile(db, "Game.nes").id, 0);
+    }
 };
 
 QTEST_MAIN(TestLibraryService)
@@ -1,6 +1,6 @@
 /**
  * @file test_match_service.cpp
- * @brief Unit tests for MatchService (confirmMatch, rejectMatch, getAllMatches)
+ * @brief Unit tests for MatchService (matchAll, confirmMatch, rejectMatch, getAllMatches)
  */
 
 #include <QtTest/QtTest>
@@ -135,6 +135,65 @@ private slots:
         bool result = svc.confirmMatch(&db, 99999);
         Q_UNUSED(result);
     }
+
+    void testMatchAllOnlyVisitsUnmatchedFiles()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/matchall.db"));
+        auto [matchedId, gameId] = populateFixture(db);
+
+        FileRecord fr;
+        fr.libraryId = db.getFileById(matchedId).libraryId;
+        fr.filename = "Other.nes";
+        fr.originalPath = "/tmp/roms/Other.nes";
+        fr.currentPath = fr.originalPath;
+        fr.extension = ".nes";
+        fr.systemId = db.getSystemId("NES");
+        const int unmatchedId = db.insertFile(fr);
+        QVERIFY(unmatchedId > 0);
+
+        const QList<FileRecord> unmatched = db.getUnmatchedFiles();
+        QCOMPARE(unmatched.size(), 1);
+        QCOMPARE(unmatched.first().id, unmatchedId);
+
+        MatchService svc;
+        QStringList visited;
+        int reportedTotal = -1;
+        auto stats = svc.matchAll(&db, [&](int, int total, const QString &path) {
+            reportedTotal = total;
+            if (!path.isEmpty()) visited.append(path);
+        });
+
+        QCOMPARE(reportedTotal, 1);
+        QCOMPARE(visited, QStringList({fr.currentPath}));
+        QCOMPARE(stats.hashMatches + stats.nameMatches + stats.noMatch, 1);
+        // The existing match is left alone
+        QCOMPARE(db.getMatchForFile(matchedId).gameId, gameId);
+    }
+
+    void testMatchAllCancelled()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        Database db;
+        QVERIFY(db.initialize(tmp.path() + "/cancel.db"));
+
+        FileRecord fr;
+        fr.libraryId = db.insertLibrary("/tmp/roms");
+        fr.filename = "Other.nes";
+        fr.originalPath = "/tmp/roms/Other.nes";
+        fr.currentPath = fr.originalPath;
+        fr.extension = ".nes";
+        fr.systemId = db.getSystemId("NES");
+        QVERIFY(db.insertFile(fr) > 0);
+
+        MatchService svc;
+        std::atomic<bool> cancelled{true};
+        auto stats = svc.matchAll(&db, nullptr, nullptr, &cancelled);
+        QCOMPARE(stats.hashMatches + stats.nameMatches + stats.noMatch, 0);
+    }
 };
 
 QTEST_MAIN(TestMatchService)
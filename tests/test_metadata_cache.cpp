@@ -3,6 +3,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include "metadata/metadata_cache.h"
+#include "core/constants/network.h"
 
 using namespace Remus;
 
@@ -12,6 +13,11 @@ class MetadataCacheTest : public QObject {
 private slots:
     void storeAndRetrieveMetadata();
     void artworkAndCleanup();
+    void repeatedLookupsHitMemory();
+    void evictedEntriesComeFromDisk();
+    void legacyJsonRowsStillRead();
+    void missesExpirePerProvider();
+    void storingMatchClearsMisses();
 };
 
 static QSqlDatabase createDatabase()
@@ -89,5 +95,114 @@ void MetadataCacheTest::artworkAndCleanup()
     QCOMPARE(removed, 1);
 }
 
+void MetadataCacheTest::repeatedLookupsHitMemory()
+{
+    QSqlDatabase db = createDatabase();
+    MetadataCache cache(db);
+
+    GameMetadata metadata;
+    metadata.id = "7";
+    metadata.title = "Kid Icarus";
+    metadata.providerId = "dummy";
+    metadata.ratingSource = "IGDB";
+    metadata.screenshotUrls = {"http://example/1.png"};
+    QVERIFY(cache.store(metadata, "beef", "NES"));
+
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(cache.getByHash("beef", "NES").title, QString("Kid Icarus"));
+    }
+    QVERIFY(cache.getByHash("dead", "NES").title.isEmpty());
+
+    const auto stats = cache.getStats();
+    QCOMPARE(stats.memoryHits, 3);
+    QCOMPARE(stats.diskHits, 0);
+    QCOMPARE(stats.misses, 1);
+
+    // Fields the old JSON form dropped survive a round trip through SQLite
+    MetadataCache reopened(db);
+    const GameMetadata loaded = reopened.getByProviderId("dummy", "7");
+    QCOMPARE(loaded.ratingSource, QString("IGDB"));
+    QCOMPARE(loaded.screenshotUrls, metadata.screenshotUrls);
+    QCOMPARE(reopened.getStats().diskHits, 1);
+}
+
+void MetadataCacheTest::evictedEntriesComeFromDisk()
+{
+    QSqlDatabase db = createDatabase();
+    MetadataCache cache(db);
+    cache.setMemoryCapacity(2);
+
+    for (int i = 0; i < 3; ++i) {
+        GameMetadata metadata;
+        metadata.id = QString::number(i);
+        metadata.title = QString("Game %1").arg(i);
+        metadata.providerId = "dummy";
+        QVERIFY(cache.store(metadata));
+    }
+
+    QCOMPARE(cache.getByProviderId("dummy", "2").title, QString("Game 2"));
+    QCOMPARE(cache.getByProviderId("dummy", "0").title, QString("Game 0"));
+
+    const auto stats = cache.getStats();
+    QCOMPARE(stats.memoryEntries, 2);
+    QCOMPARE(stats.memoryHits, 1);
+    QCOMPARE(stats.diskHits, 1);
+}
+
+void MetadataCacheTest::legacyJsonRowsStillRead()
+{
+    QSqlDatabase db = createDatabase();
+    QSqlQuery insert(db);
+    insert.prepare("INSERT INTO cache (cache_key, cache_value, expiry) VALUES (?, ?, datetime('now', '+1 days'))");
+    insert.addBindValue(QString("metadata:hash:SNES:cafe"));
+    insert.addBindValue(QByteArray(R"({"id":"9","title":"Chrono Trigger","genres":["RPG"],"externalIds":{"igdb":"20"}})"));
+    QVERIFY(insert.exec());
+
+    MetadataCache cache(db);
+    const GameMetadata metadata = cache.getByHash("cafe", "SNES");
+    QCOMPARE(metadata.title, QString("Chrono Trigger"));
+    QCOMPARE(metadata.genres, QStringList{"RPG"});
+    QCOMPARE(metadata.externalIds.value("igdb"), QString("20"));
+}
+
+void MetadataCacheTest::missesExpirePerProvider()
+{
+    QSqlDatabase db = createDatabase();
+    MetadataCache cache(db);
+    cache.setNegativeTtl("hasheous", 0);
+
+    QVERIFY(cache.storeMiss("igdb", "f00d", "Genesis"));
+    QVERIFY(cache.storeMiss("hasheous", "f00d", "Genesis"));
+
+    QVERIFY(cache.isKnownMiss("igdb", "f00d", "Genesis"));
+    QVERIFY(!cache.isKnownMiss("hasheous", "f00d", "Genesis"));
+    QVERIFY(!cache.isKnownMiss("thegamesdb", "f00d", "Genesis"));
+    QCOMPARE(cache.negativeTtl("igdb"), Constants::Network::METADATA_NEGATIVE_TTL_S);
+
+    MetadataCache reopened(db);
+    QVERIFY(reopened.isKnownMiss("igdb", "f00d", "Genesis"));
+    QCOMPARE(reopened.getStats().negativeEntries, 1);
+
+    // Misses are not metadata
+    QCOMPARE(reopened.getStats().totalEntries, 0);
+}
+
+void MetadataCacheTest::storingMatchClearsMisses()
+{
+    QSqlDatabase db = createDatabase();
+    MetadataCache cache(db);
+    QVERIFY(cache.storeMiss("igdb", "abba", "GB"));
+    QVERIFY(cache.isKnownMiss("igdb", "abba", "GB"));
+
+    GameMetadata metadata;
+    metadata.id = "3";
+    metadata.title = "Tetris";
+    metadata.providerId = "screenscraper";
+    QVERIFY(cache.store(metadata, "abba", "GB"));
+
+    QVERIFY(!cache.isKnownMiss("igdb", "abba", "GB"));
+    QCOMPARE(cache.getStats().negativeEntries, 0);
+}
+
 QTEST_MAIN(MetadataCacheTest)
 #include "test_metadata_cache.moc"
@@ -0,0 +1,170 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "metadata/network_client.h"
+#include "http_stub_server.h"
+
+using namespace Remus;
+
+namespace {
+
+/// Hold every request until the test answers it
+HttpStubResponse holdRequest(const HttpStubRequest &)
+{
+    HttpStubResponse response;
+    response.hold = true;
+    return response;
+}
+
+HttpStubResponse closing(const QByteArray &body)
+{
+    HttpStubResponse response(200, body);
+    response.close = true;
+    return response;
+}
+
+} // namespace
+
+/**
+ * @brief Unit tests for NetworkClient
+ *
+ * Covers:
+ * - Blocking wrapper over local files
+ * - Deduplication of identical in-flight requests
+ * - Cancellation and timeouts
+ * - Shared client teardown
+ */
+class NetworkClientTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testWaitReadsLocalFile();
+    void testMissingFileFails();
+    void testIdenticalRequestsShareOneTransfer();
+    void testDifferentRequestsAreNotShared();
+    void testCancelAbortsTransfer();
+    void testTimeout();
+    void testSharedShutdownCancelsInFlight();
+};
+
+void NetworkClientTest::testWaitReadsLocalFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("box.png"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("image-bytes");
+    file.close();
+
+    NetworkClient client(2);
+    QList<qint64> progress;
+    const NetworkResponse response = NetworkClient::wait(client.get(
+        QNetworkRequest(QUrl::fromLocalFile(file.fileName())), 1000,
+        [&progress](qint64 received, qint64) { progress.append(received); }));
+
+    QVERIFY(response.success);
+    QCOMPARE(response.data, QByteArray("image-bytes"));
+    QVERIFY(!progress.isEmpty());
+    QCOMPARE(client.inFlightCount(), 0);
+}
+
+void NetworkClientTest::testMissingFileFails()
+{
+    NetworkClient client(1);
+    const NetworkResponse response = NetworkClient::wait(
+        client.get(QNetworkRequest(QUrl::fromLocalFile("/nonexistent/remus.png")), 1000));
+    QVERIFY(!response.success);
+    QVERIFY(!response.error.isEmpty());
+    QVERIFY(!response.timedOut);
+}
+
+void NetworkClientTest::testIdenticalRequestsShareOneTransfer()
+{
+    HttpStubServer server(holdRequest);
+    NetworkClient client(2);
+    const QNetworkRequest request(server.url("/game/1"));
+
+    QFuture<NetworkResponse> first = client.get(request, 5000);
+    QFuture<NetworkResponse> second = client.get(request, 5000);
+    QCOMPARE(client.requestsStarted(), 1);
+    QCOMPARE(client.inFlightCount(), 1);
+
+    QTRY_COMPARE(server.held(), 1);
+    server.respondToHeld(closing("{\"id\":1}"));
+    QTRY_VERIFY(first.isFinished() && second.isFinished());
+
+    QCOMPARE(server.requests(), 1);
+    QVERIFY(first.result().success);
+    QCOMPARE(second.result().data, QByteArray("{\"id\":1}"));
+    QCOMPARE(second.result().statusCode, 200);
+
+    // Finished requests are not shared any more
+    QFuture<NetworkResponse> third = client.get(request, 5000);
+    QCOMPARE(client.requestsStarted(), 2);
+    QTRY_COMPARE(server.held(), 1);
+    server.respondToHeld(closing("{}"));
+    QTRY_VERIFY(third.isFinished());
+}
+
+void NetworkClientTest::testDifferentRequestsAreNotShared()
+{
+    HttpStubServer server(holdRequest);
+    NetworkClient client(1);
+
+    QNetworkRequest withKey(server.url("/game/1"));
+    withKey.setRawHeader("X-Client-API-Key", "abc");
+    QFuture<NetworkResponse> a = client.get(QNetworkRequest(server.url("/game/1")), 5000);
+    QFuture<NetworkResponse> b = client.get(withKey, 5000);
+    QFuture<NetworkResponse> c = client.post(QNetworkRequest(server.url("/game/1")), "{}", 5000);
+    QCOMPARE(client.requestsStarted(), 3);
+
+    QTRY_COMPARE(server.held(), 3);
+    server.respondToHeld(closing("ok"));
+    QTRY_VERIFY(a.isFinished() && b.isFinished() && c.isFinished());
+}
+
+void NetworkClientTest::testCancelAbortsTransfer()
+{
+    HttpStubServer server(holdRequest);
+    NetworkClient client(1);
+
+    QFuture<NetworkResponse> future = client.get(QNetworkRequest(server.url("/slow")), 5000);
+    QTRY_COMPARE(server.held(), 1);
+    future.cancel();
+
+    QTRY_COMPARE(client.inFlightCount(), 0);
+    const NetworkResponse response = NetworkClient::wait(future);
+    QVERIFY(response.cancelled);
+    QVERIFY(!response.success);
+}
+
+void NetworkClientTest::testTimeout()
+{
+    HttpStubServer server(holdRequest);
+    NetworkClient client(1);
+
+    QFuture<NetworkResponse> future = client.get(QNetworkRequest(server.url("/never")), 100);
+    QTRY_VERIFY(future.isFinished());
+    const NetworkResponse response = future.result();
+    QVERIFY(response.timedOut);
+    QVERIFY(!response.success);
+    QCOMPARE(client.inFlightCount(), 0);
+}
+
+void NetworkClientTest::testSharedShutdownCancelsInFlight()
+{
+    HttpStubServer server(holdRequest);
+    QFuture<NetworkResponse> future =
+        NetworkClient::shared().get(QNetworkRequest(server.url("/quit")), 5000);
+    QTRY_COMPARE(server.held(), 1);
+
+    NetworkClient::shutdownShared();
+    QVERIFY(future.isFinished());
+    QVERIFY(NetworkClient::wait(future).cancelled);
+
+    // Asked for again, a fresh client is made
+    QCOMPARE(NetworkClient::shared().inFlightCount(), 0);
+    NetworkClient::shutdownShared();
+}
+
+QTEST_MAIN(NetworkClientTest)
+#include "test_network_client.moc"
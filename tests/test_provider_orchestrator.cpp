@@ -1,5 +1,11 @@
 #include <QtTest>
 #include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QThread>
+#include <atomic>
+#include "metadata/metadata_cache.h"
 #include "metadata/provider_orchestrator.h"
 #include "core/constants/match_methods.h"
 
@@ -15,10 +21,17 @@ public:
     bool requiresAuth() const override { return false; }
 
     QList<SearchResult> searchByName(const QString &, const QString &, const QString &) override {
+        simulateLatency();
         return m_searchResults;
     }
 
-    GameMetadata getByHash(const QString &, const QString &) override { return m_hashMetadata; }
+    GameMetadata getByHash(const QString &, const QString &) override {
+        simulateLatency();
+        if (m_reportError) {
+            emit errorOccurred("Request timeout");
+        }
+        return m_hashMetadata;
+    }
     GameMetadata getById(const QString &) override { return m_idMetadata; }
     ArtworkUrls getArtwork(const QString &) override { return m_artwork; }
 
@@ -26,8 +39,18 @@ public:
     GameMetadata m_idMetadata;
     QList<SearchResult> m_searchResults;
     ArtworkUrls m_artwork;
+    int m_delayMs = 0;
+    bool m_reportError = false;
+    std::atomic<int> m_calls{0};
 
 private:
+    void simulateLatency() {
+        ++m_calls;
+        if (m_delayMs > 0) {
+            QThread::msleep(m_delayMs);
+        }
+    }
+
     QString m_id;
 };
 
@@ -38,8 +61,26 @@ private slots:
     void hashProviderPriority();
     void fallsBackToNameSearch();
     void artworkFallback();
+    void concurrentLookupsOverlap();
+    void timeoutReturnsLowerPriorityHit();
+    void hedgeSkipsProvidersWhenFirstHits();
+    void searchAllProvidersConcurrently();
+    void recordsLatencyStats();
+    void cachedMissesSkipProviders();
+    void concurrentMissesAreCached();
 };
 
+static QSqlDatabase createCacheDatabase(const QString &connectionName)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    db.open();
+
+    QSqlQuery query(db);
+    query.exec("CREATE TABLE cache (cache_key TEXT PRIMARY KEY, cache_value BLOB, expiry TEXT, created_at TEXT DEFAULT CURRENT_TIMESTAMP)");
+    return db;
+}
+
 void ProviderOrchestratorTest::hashProviderPriority()
 {
     ProviderOrchestrator orchestrator;
@@ -111,5 +152,209 @@ void ProviderOrchestratorTest::artworkFallback()
     QCOMPARE(loaded.boxFront, artwork.boxFront);
 }
 
+void ProviderOrchestratorTest::concurrentLookupsOverlap()
+{
+    ProviderOrchestrator orchestrator;
+
+    auto *first = new StubProvider("screenscraper");
+    auto *second = new StubProvider("playmatch");
+    auto *third = new StubProvider("localdatabase");
+    first->m_delayMs = 200;
+    second->m_delayMs = 200;
+    third->m_delayMs = 200;
+    third->m_hashMetadata.title = "Third Hit";
+
+    orchestrator.addProvider("screenscraper", first, 90);
+    orchestrator.addProvider("playmatch", second, 80);
+    orchestrator.addProvider("localdatabase", third, 70);
+    orchestrator.setConcurrentLookups(true);
+    orchestrator.setHedgeDelay(0);
+
+    QSignalSpy failSpy(&orchestrator, &ProviderOrchestrator::providerFailed);
+    QElapsedTimer timer;
+    timer.start();
+    GameMetadata result = orchestrator.getByHashWithFallback("abcd", "NES");
+
+    // One after another this takes 600 ms
+    QCOMPARE(result.title, QString("Third Hit"));
+    QVERIFY2(timer.elapsed() < 450, qPrintable(QString::number(timer.elapsed())));
+    QCOMPARE(failSpy.count(), 2);
+}
+
+void ProviderOrchestratorTest::timeoutReturnsLowerPriorityHit()
+{
+    ProviderOrchestrator orchestrator;
+
+    auto *slow = new StubProvider("screenscraper");
+    slow->m_delayMs = 800;
+    slow->m_hashMetadata.title = "Slow Hit";
+    auto *fast = new StubProvider("playmatch");
+    fast->m_hashMetadata.title = "Fast Hit";
+
+    orchestrator.addProvider("screenscraper", slow, 90);
+    orchestrator.addProvider("playmatch", fast, 50);
+    orchestrator.setConcurrentLookups(true);
+    orchestrator.setHedgeDelay(0);
+    orchestrator.setLookupTimeout(200);
+
+    QSignalSpy failSpy(&orchestrator, &ProviderOrchestrator::providerFailed);
+    QElapsedTimer timer;
+    timer.start();
+    GameMetadata result = orchestrator.getByHashWithFallback("abcd", "NES");
+
+    QCOMPARE(result.title, QString("Fast Hit"));
+    QVERIFY(timer.elapsed() < 700);
+    QCOMPARE(failSpy.count(), 1);
+    QCOMPARE(failSpy.at(0).at(0).toString(), QString("screenscraper"));
+    QCOMPARE(failSpy.at(0).at(1).toString(), QString("Cancelled"));
+
+    // The slow answer still arrives, and is counted as abandoned
+    QTRY_COMPARE(orchestrator.providerStats("screenscraper").abandoned, 1);
+}
+
+void ProviderOrchestratorTest::hedgeSkipsProvidersWhenFirstHits()
+{
+    ProviderOrchestrator orchestrator;
+
+    auto *first = new StubProvider("screenscraper");
+    first->m_hashMetadata.title = "First Hit";
+    auto *second = new StubProvider("playmatch");
+    second->m_hashMetadata.title = "Second Hit";
+
+    orchestrator.addProvider("screenscraper", first, 90);
+    orchestrator.addProvider("playmatch", second, 50);
+    orchestrator.setConcurrentLookups(true);
+    orchestrator.setHedgeDelay(1000);
+
+    QSignalSpy trySpy(&orchestrator, &ProviderOrchestrator::tryingProvider);
+    GameMetadata result = orchestrator.getByHashWithFallback("abcd", "NES");
+
+    QCOMPARE(result.title, QString("First Hit"));
+    QCOMPARE(trySpy.count(), 1);
+    QCOMPARE(second->m_calls.load(), 0);
+
+    // A miss hands over without waiting for the hedge delay
+    first->m_hashMetadata = GameMetadata();
+    QElapsedTimer timer;
+    timer.start();
+    result = orchestrator.getByHashWithFallback("abcd", "NES");
+    QCOMPARE(result.title, QString("Second Hit"));
+    QVERIFY(timer.elapsed() < 900);
+}
+
+void ProviderOrchestratorTest::searchAllProvidersConcurrently()
+{
+    ProviderOrchestrator orchestrator;
+
+    auto *first = new StubProvider("igdb");
+    auto *second = new StubProvider("thegamesdb");
+    SearchResult a;
+    a.id = "1";
+    a.title = "From IGDB";
+    first->m_searchResults = {a};
+    first->m_delayMs = 100;
+    SearchResult b;
+    b.id = "2";
+    b.title = "From TheGamesDB";
+    second->m_searchResults = {b};
+
+    orchestrator.addProvider("igdb", first, 10);
+    orchestrator.addProvider("thegamesdb", second, 5);
+    orchestrator.setConcurrentLookups(true);
+
+    QList<SearchResult> results = orchestrator.searchAllProviders("Zelda", "NES");
+    QCOMPARE(results.size(), 2);
+    QCOMPARE(results.at(0).provider, QString("igdb"));
+    QCOMPARE(results.at(1).provider, QString("thegamesdb"));
+
+    // Back to the calling thread
+    orchestrator.setConcurrentLookups(false);
+    QCOMPARE(first->thread(), orchestrator.thread());
+    QCOMPARE(first->parent(), &orchestrator);
+}
+
+void ProviderOrchestratorTest::recordsLatencyStats()
+{
+    ProviderOrchestrator orchestrator;
+
+    auto *miss = new StubProvider("screenscraper");
+    miss->m_delayMs = 50;
+    auto *hit = new StubProvider("playmatch");
+    hit->m_hashMetadata.title = "Hit";
+
+    orchestrator.addProvider("screenscraper", miss, 90);
+    orchestrator.addProvider("playmatch", hit, 50);
+
+    orchestrator.getByHashWithFallback("abcd", "NES");
+    orchestrator.getByHashWithFallback("abcd", "NES");
+
+    const ProviderLatencyStats missStats = orchestrator.providerStats("screenscraper");
+    QCOMPARE(missStats.requests, 2);
+    QCOMPARE(missStats.hits, 0);
+    QVERIFY(missStats.lastMs >= 40);
+    QVERIFY(missStats.averageMs() >= 40.0);
+    QVERIFY(missStats.maxMs >= missStats.lastMs);
+    QCOMPARE(orchestrator.providerStats("playmatch").hits, 2);
+
+    orchestrator.resetProviderStats();
+    QVERIFY(orchestrator.allProviderStats().isEmpty());
+}
+
+void ProviderOrchestratorTest::cachedMissesSkipProviders()
+{
+    QSqlDatabase db = createCacheDatabase("orchestrator-misses");
+    MetadataCache cache(db);
+    ProviderOrchestrator orchestrator;
+    orchestrator.setMetadataCache(&cache);
+
+    auto *miss = new StubProvider("screenscraper");
+    auto *failing = new StubProvider("playmatch");
+    failing->m_reportError = true;
+    auto *hit = new StubProvider("localdatabase");
+    hit->m_hashMetadata.title = "Hit";
+
+    orchestrator.addProvider("screenscraper", miss, 90);
+    orchestrator.addProvider("playmatch", failing, 80);
+    orchestrator.addProvider("localdatabase", hit, 70);
+
+    QCOMPARE(orchestrator.getByHashWithFallback("abcd", "NES").title, QString("Hit"));
+    QVERIFY(cache.isKnownMiss("screenscraper", "abcd", "NES"));
+    // An error is not an answer
+    QVERIFY(!cache.isKnownMiss("playmatch", "abcd", "NES"));
+
+    QCOMPARE(orchestrator.getByHashWithFallback("abcd", "NES").title, QString("Hit"));
+    QCOMPARE(miss->m_calls.load(), 1);
+    QCOMPARE(failing->m_calls.load(), 2);
+
+    // Other hashes are still asked; a TTL of 0 keeps a provider uncached
+    cache.setNegativeTtl("screenscraper", 0);
+    orchestrator.getByHashWithFallback("ef01", "NES");
+    QCOMPARE(miss->m_calls.load(), 2);
+    QVERIFY(!cache.isKnownMiss("screenscraper", "ef01", "NES"));
+}
+
+void ProviderOrchestratorTest::concurrentMissesAreCached()
+{
+    QSqlDatabase db = createCacheDatabase("orchestrator-concurrent-misses");
+    MetadataCache cache(db);
+    ProviderOrchestrator orchestrator;
+    orchestrator.setMetadataCache(&cache);
+
+    auto *miss = new StubProvider("screenscraper");
+    auto *hit = new StubProvider("playmatch");
+    hit->m_hashMetadata.title = "Hit";
+
+    orchestrator.addProvider("screenscraper", miss, 90);
+    orchestrator.addProvider("playmatch", hit, 50);
+    orchestrator.setConcurrentLookups(true);
+    orchestrator.setHedgeDelay(0);
+
+    QCOMPARE(orchestrator.getByHashWithFallback("abcd", "NES").title, QString("Hit"));
+    QVERIFY(cache.isKnownMiss("screenscraper", "abcd", "NES"));
+
+    QCOMPARE(orchestrator.getByHashWithFallback("abcd", "NES").title, QString("Hit"));
+    QCOMPARE(miss->m_calls.load(), 1);
+}
+
 QTEST_MAIN(ProviderOrchestratorTest)
 #include "test_provider_orchestrator.moc"
@@ -1,5 +1,7 @@
 #include <QtTest>
 #include <QElapsedTimer>
+#include <QSettings>
+#include <QtConcurrent/QtConcurrentRun>
 #include "metadata/rate_limiter.h"
 
 using namespace Remus;
@@ -10,6 +12,14 @@ class RateLimiterTest : public QObject {
 private slots:
     void respectsInterval();
     void resetClearsLastRequest();
+    void burstPassesWithoutWaiting();
+    void tryAcquireNeverBlocks();
+    void concurrentCallersGetConsecutiveSlots();
+    void dailyQuotaRejects();
+    void quotaUsagePersists();
+    void persistedUsageIsMerged();
+    void acquireAsyncCompletesAfterDelay();
+    void sharedBudgetIsOneInstance();
 };
 
 void RateLimiterTest::respectsInterval()
@@ -43,5 +53,164 @@ void RateLimiterTest::resetClearsLastRequest()
     QVERIFY(timer.elapsed() < 5);
 }
 
+void RateLimiterTest::burstPassesWithoutWaiting()
+{
+    RateLimiter limiter;
+    limiter.setRate(10.0, 3);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(limiter.waitIfNeeded());
+    }
+    QVERIFY(timer.elapsed() < 50);
+
+    // The fourth waits for a refill (100 ms at 10/s)
+    QVERIFY(limiter.waitIfNeeded());
+    QVERIFY(timer.elapsed() >= 80);
+
+    const RateLimiterStats stats = limiter.stats();
+    QCOMPARE(stats.acquired, 4);
+    QCOMPARE(stats.throttled, 1);
+    QVERIFY(stats.throttledMs >= 80);
+}
+
+void RateLimiterTest::tryAcquireNeverBlocks()
+{
+    RateLimiter limiter;
+    limiter.setRate(2.0, 1);
+
+    QVERIFY(limiter.tryAcquire());
+    QVERIFY(!limiter.tryAcquire());
+    const qint64 wait = limiter.timeUntilAvailable();
+    QVERIFY(wait > 0 && wait <= 500);
+
+    // A reservation puts the next caller further back
+    QVERIFY(limiter.reserve() > 0);
+    QVERIFY(limiter.timeUntilAvailable() > 500);
+}
+
+void RateLimiterTest::concurrentCallersGetConsecutiveSlots()
+{
+    RateLimiter limiter;
+    limiter.setRate(20.0, 1);
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QFuture<void>> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.append(QtConcurrent::run([&limiter]() { limiter.waitIfNeeded(); }));
+    }
+    for (QFuture<void> &caller : callers) {
+        caller.waitForFinished();
+    }
+
+    // 4 requests at 20/s: the last goes at ~150 ms, not 4 x 50 ms serialised on a lock
+    const qint64 elapsed = timer.elapsed();
+    QVERIFY2(elapsed >= 130 && elapsed < 260, qPrintable(QString::number(elapsed)));
+}
+
+void RateLimiterTest::dailyQuotaRejects()
+{
+    RateLimiter limiter;
+    limiter.setRate(0.0);
+    limiter.setDailyQuota(2);
+
+    QVERIFY(limiter.waitIfNeeded());
+    QVERIFY(limiter.tryAcquire());
+    QVERIFY(!limiter.waitIfNeeded());
+    QVERIFY(!limiter.tryAcquire());
+    QCOMPARE(limiter.reserve(), qint64(-1));
+    QCOMPARE(limiter.timeUntilAvailable(), qint64(-1));
+
+    const RateLimiterStats stats = limiter.stats();
+    QCOMPARE(stats.usedToday, 2);
+    QCOMPARE(stats.rejected, 3);
+}
+
+void RateLimiterTest::quotaUsagePersists()
+{
+    QCoreApplication::setOrganizationName("RemusTest");
+    QCoreApplication::setApplicationName("test_rate_limiter");
+    const QString key = "quota-test";
+    QSettings().remove(QString("rate_limits/%1").arg(key));
+
+    {
+        RateLimiter limiter;
+        limiter.setRate(0.0);
+        limiter.setDailyQuota(3);
+        limiter.setPersistenceKey(key);
+        QVERIFY(limiter.tryAcquire());
+        QVERIFY(limiter.tryAcquire());
+    }
+
+    // A restart keeps today's usage
+    RateLimiter limiter;
+    limiter.setRate(0.0);
+    limiter.setDailyQuota(3);
+    limiter.setPersistenceKey(key);
+    QCOMPARE(limiter.stats().usedToday, 2);
+    QVERIFY(limiter.tryAcquire());
+    QVERIFY(!limiter.tryAcquire());
+
+    QSettings().remove(QString("rate_limits/%1").arg(key));
+}
+
+void RateLimiterTest::persistedUsageIsMerged()
+{
+    QCoreApplication::setOrganizationName("RemusTest");
+    QCoreApplication::setApplicationName("test_rate_limiter");
+    const QString key = "merge-test";
+    QSettings().remove(QString("rate_limits/%1").arg(key));
+
+    // Two limiters on one key stand in for two processes
+    RateLimiter first;
+    first.setRate(0.0);
+    first.setPersistenceKey(key);
+    RateLimiter second;
+    second.setRate(0.0);
+    second.setPersistenceKey(key);
+
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(first.tryAcquire());
+    }
+    QVERIFY(second.tryAcquire());
+    QVERIFY(second.tryAcquire());
+    first.flushUsage();
+    second.flushUsage();
+
+    // The later save adds to the earlier one instead of replacing it
+    QCOMPARE(QSettings().value(QString("rate_limits/%1/used").arg(key)).toInt(), 5);
+    QCOMPARE(second.stats().usedToday, 5);
+
+    QSettings().remove(QString("rate_limits/%1").arg(key));
+}
+
+void RateLimiterTest::acquireAsyncCompletesAfterDelay()
+{
+    RateLimiter limiter;
+    limiter.setRate(10.0, 1);
+
+    QFuture<bool> first = limiter.acquireAsync();
+    QVERIFY(first.isFinished());
+    QVERIFY(first.result());
+
+    QElapsedTimer timer;
+    timer.start();
+    QFuture<bool> second = limiter.acquireAsync();
+    QVERIFY(!second.isFinished());
+    second.waitForFinished();
+    QVERIFY(second.result());
+    QVERIFY(timer.elapsed() >= 80);
+}
+
+void RateLimiterTest::sharedBudgetIsOneInstance()
+{
+    RateLimiter *a = RateLimiter::shared("budget-test");
+    RateLimiter *b = RateLimiter::shared("budget-test");
+    QCOMPARE(a, b);
+    QVERIFY(RateLimiter::shared("other-budget") != a);
+}
+
 QTEST_MAIN(RateLimiterTest)
 #include "test_rate_limiter.moc"
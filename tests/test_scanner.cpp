@@ -3,7 +3,9 @@
 #include <QFile>
 #include <QTextStream>
 #include <QSignalSpy>
+#include <QDir>
 #include "core/scanner.h"
+#include "core/constants/settings.h"
 
 using namespace Remus;
 
@@ -14,6 +16,9 @@ private slots:
     void missingDirectoryEmitsError();
     void cancelStopsScan();
     void multiFileLinking();
+    void parallelWalkIsDeterministic();
+    void skipMarkerExcludesSubtree();
+    void skipMarkerChangesSeenByNextScan();
 };
 
 static QString writeFile(const QString &path, const QByteArray &data = QByteArray("data"))
@@ -107,5 +112,96 @@ void ScannerTest::multiFileLinking()
     QCOMPARE(linkedTracks, 2);
 }
 
+void ScannerTest::parallelWalkIsDeterministic()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // A few levels of per-system folders with files at every level
+    QDir root(dir.path());
+    for (int s = 0; s < 4; ++s) {
+        const QString system = QString("system_%1").arg(s);
+        for (int g = 0; g < 3; ++g) {
+            const QString group = system + QString("/group_%1").arg(g);
+            QVERIFY(root.mkpath(group));
+            for (int f = 0; f < 5; ++f) {
+                QVERIFY(!writeFile(root.filePath(group + QString("/rom_%1.nes").arg(f))).isEmpty());
+            }
+        }
+        QVERIFY(!writeFile(root.filePath(system + "/top.nes")).isEmpty());
+    }
+    QVERIFY(!writeFile(root.filePath("root.nes")).isEmpty());
+
+    auto scanPaths = [&](int threads) {
+        Scanner scanner;
+        scanner.setExtensions({".nes"});
+        scanner.setArchiveScanning(false);
+        scanner.setWalkerThreadCount(threads);
+        QStringList paths;
+        for (const ScanResult &result : scanner.scan(dir.path())) {
+            paths.append(result.path);
+        }
+        return paths;
+    };
+
+    const QStringList sequential = scanPaths(1);
+    QCOMPARE(sequential.size(), 4 * 3 * 5 + 4 + 1);
+    // Pre-order: a directory's files come before its subdirectories
+    QVERIFY(sequential.first().endsWith("/root.nes"));
+    QVERIFY(sequential.at(1).endsWith("/system_0/top.nes"));
+
+    for (int run = 0; run < 5; ++run) {
+        QCOMPARE(scanPaths(8), sequential);
+    }
+}
+
+void ScannerTest::skipMarkerExcludesSubtree()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QDir root(dir.path());
+    QVERIFY(root.mkpath("keep"));
+    QVERIFY(root.mkpath("skip/nested"));
+    QVERIFY(!writeFile(root.filePath("keep/a.nes")).isEmpty());
+    QVERIFY(!writeFile(root.filePath("skip/b.nes")).isEmpty());
+    QVERIFY(!writeFile(root.filePath("skip/nested/c.nes")).isEmpty());
+    QVERIFY(!writeFile(root.filePath(QString("skip/") +
+                                     Constants::Settings::Files::MARKER_SKIP_SCAN)).isEmpty());
+
+    Scanner scanner;
+    scanner.setExtensions({".nes"});
+    scanner.setArchiveScanning(false);
+    scanner.setWalkerThreadCount(4);
+    QList<ScanResult> results = scanner.scan(dir.path());
+
+    QCOMPARE(results.size(), 1);
+    QCOMPARE(results.first().filename, QString("a.nes"));
+}
+
+void ScannerTest::skipMarkerChangesSeenByNextScan()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QDir root(dir.path());
+    QVERIFY(root.mkpath("games"));
+    QVERIFY(!writeFile(root.filePath("games/a.nes")).isEmpty());
+    const QString marker = root.filePath(QString("games/") +
+                                         Constants::Settings::Files::MARKER_SKIP_SCAN);
+
+    // Same instance across scans: exclusion answers must not outlive a scan
+    Scanner scanner;
+    scanner.setExtensions({".nes"});
+    scanner.setArchiveScanning(false);
+    QCOMPARE(scanner.scan(dir.path()).size(), 1);
+
+    QVERIFY(!writeFile(marker).isEmpty());
+    QCOMPARE(scanner.scan(dir.path()).size(), 0);
+
+    QVERIFY(QFile::remove(marker));
+    QCOMPARE(scanner.scan(dir.path()).size(), 1);
+}
+
 QTEST_MAIN(ScannerTest)
 #include "test_scanner.moc"
@@ -0,0 +1,181 @@
+#include <QtTest/QtTest>
+#include "../src/metadata/title_index.h"
+
+using namespace Remus;
+
+/**
+ * @brief Unit tests for TitleIndex
+ *
+ * Covers:
+ * - Title normalisation (tags, trailing articles, accents, punctuation)
+ * - Ranking: exact > prefix > word overlap > fuzzy
+ * - Partially typed queries, filters and result limits
+ * - Query time on a 100k-title index
+ */
+class TitleIndexTest : public QObject {
+    Q_OBJECT
+
+private:
+    static QStringList sampleTitles()
+    {
+        return {
+            "Sonic The Hedgehog (USA, Europe)",
+            "Sonic The Hedgehog (USA, Europe)", // second rom of the same game
+            "Sonic The Hedgehog 2 (World)",
+            "Sonic & Knuckles (World)",
+            "Legend of Zelda, The - A Link to the Past (USA)",
+            "Pokémon Red (Europe)",
+            "Streets of Rage (Japan)",
+            "Sonic The Hedgehog (Japan)",
+        };
+    }
+
+private slots:
+    void testNormalize();
+    void testDuplicateTitlesIndexedOnce();
+    void testRankingOrder();
+    void testPartialLastWord();
+    void testTrailingArticleAndAccents();
+    void testFuzzyMatch();
+    void testFilterAndLimit();
+    void testEmptyQuery();
+    void benchmarkSearch();
+};
+
+void TitleIndexTest::testNormalize()
+{
+    QCOMPARE(TitleIndex::normalize("Sonic The Hedgehog (USA, Europe)"), QString("sonic the hedgehog"));
+    QCOMPARE(TitleIndex::normalize("Legend of Zelda, The - A Link to the Past (USA)"),
+             QString("the legend of zelda a link to the past"));
+    QCOMPARE(TitleIndex::normalize("Pokémon Red (Europe)"), QString("pokemon red"));
+    QCOMPARE(TitleIndex::normalize("Sonic's Schoolhouse [!]"), QString("sonics schoolhouse"));
+    QCOMPARE(TitleIndex::normalize("Sonic & Knuckles (World)"), QString("sonic knuckles"));
+}
+
+void TitleIndexTest::testDuplicateTitlesIndexedOnce()
+{
+    const TitleIndex index(sampleTitles());
+    QCOMPARE(index.titleCount(), 7);
+
+    // Reported once, under the first entry carrying the title
+    const QList<TitleIndex::Match> matches = index.search("Sonic The Hedgehog", 0);
+    int usaMatches = 0;
+    for (const TitleIndex::Match &match : matches) {
+        QVERIFY(match.entry != 1);
+        if (match.title == "Sonic The Hedgehog (USA, Europe)") {
+            QCOMPARE(match.entry, 0);
+            ++usaMatches;
+        }
+    }
+    QCOMPARE(usaMatches, 1);
+}
+
+void TitleIndexTest::testRankingOrder()
+{
+    const TitleIndex index(sampleTitles());
+    const QList<TitleIndex::Match> matches = index.search("sonic the hedgehog");
+    QCOMPARE(matches.size(), 5);
+
+    // Exact (both regions; the shorter name first), then prefix, then overlap
+    QCOMPARE(matches.at(0).entry, 7);
+    QCOMPARE(matches.at(0).score, 1.0f);
+    QCOMPARE(matches.at(1).entry, 0);
+    QCOMPARE(matches.at(1).score, 1.0f);
+    QCOMPARE(matches.at(2).entry, 2);
+    QVERIFY(matches.at(2).score >= 0.9f && matches.at(2).score < 1.0f);
+    QCOMPARE(matches.at(3).entry, 3);
+    QVERIFY(matches.at(3).score > 0.5f && matches.at(3).score < 0.9f);
+    // Only shares "the", and has more words besides
+    QCOMPARE(matches.at(4).entry, 4);
+    QVERIFY(matches.at(4).score > 0.5f && matches.at(4).score < matches.at(3).score);
+}
+
+void TitleIndexTest::testPartialLastWord()
+{
+    const TitleIndex index(sampleTitles());
+    const QList<TitleIndex::Match> matches = index.search("sonic the hedg");
+    QVERIFY(matches.size() >= 3);
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(matches.at(i).score >= 0.9f);
+        QVERIFY(matches.at(i).title.startsWith("Sonic The Hedgehog"));
+    }
+}
+
+void TitleIndexTest::testTrailingArticleAndAccents()
+{
+    const TitleIndex index(sampleTitles());
+
+    QList<TitleIndex::Match> matches = index.search("The Legend of Zelda");
+    QVERIFY(!matches.isEmpty());
+    QCOMPARE(matches.first().entry, 4);
+    QVERIFY(matches.first().score >= 0.9f);
+
+    matches = index.search("pokemon red");
+    QVERIFY(!matches.isEmpty());
+    QCOMPARE(matches.first().entry, 5);
+    QCOMPARE(matches.first().score, 1.0f);
+}
+
+void TitleIndexTest::testFuzzyMatch()
+{
+    const TitleIndex index(sampleTitles());
+    const QList<TitleIndex::Match> matches = index.search("strets");
+    QVERIFY(!matches.isEmpty());
+    QCOMPARE(matches.first().entry, 6);
+    QVERIFY(matches.first().score > 0.0f && matches.first().score < 0.5f);
+
+    QVERIFY(index.search("xyzzy").isEmpty());
+}
+
+void TitleIndexTest::testFilterAndLimit()
+{
+    const TitleIndex index(sampleTitles());
+
+    const QList<TitleIndex::Match> japan = index.search("sonic", 0, [](const QString &title) {
+        return title.contains("Japan");
+    });
+    QCOMPARE(japan.size(), 1);
+    QCOMPARE(japan.first().entry, 7);
+
+    QCOMPARE(index.search("sonic", 2).size(), 2);
+    QCOMPARE(index.search("sonic", 0).size(), 4);
+}
+
+void TitleIndexTest::testEmptyQuery()
+{
+    const TitleIndex index(sampleTitles());
+    QVERIFY(index.search(QString()).isEmpty());
+    QVERIFY(index.search("(USA)").isEmpty());
+    QVERIFY(TitleIndex().search("sonic").isEmpty());
+}
+
+void TitleIndexTest::benchmarkSearch()
+{
+    const QStringList words = {
+        "Super", "Dragon", "Quest", "Fantasy", "Street", "Fighter", "Mega", "Man",
+        "Metal", "Gear", "Castle", "Star", "Wars", "Racing", "Soccer", "Tennis",
+        "Golf", "Ninja", "Turtles", "Space", "Invaders", "Puzzle", "Tetris", "Kart",
+        "Legend", "Kingdom", "Hearts", "Final", "Blade", "Shadow", "Night", "World",
+    };
+    QStringList titles;
+    titles.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        titles.append(QString("%1 %2 %3 %4 (USA)")
+                          .arg(words.at(i % words.size()),
+                               words.at((i / words.size()) % words.size()),
+                               words.at((i / (words.size() * words.size())) % words.size()))
+                          .arg(i));
+    }
+    const TitleIndex index(titles);
+    QCOMPARE(index.titleCount(), titles.size());
+
+    QList<TitleIndex::Match> matches;
+    QBENCHMARK {
+        matches = index.search("dragon quest fant");
+    }
+    QCOMPARE(matches.size(), TitleIndex::DEFAULT_LIMIT);
+    QVERIFY(matches.first().score >= 0.9f);
+}
+
+QTEST_MAIN(TitleIndexTest)
+#include "test_title_index.moc"
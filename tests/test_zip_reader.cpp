@@ -0,0 +1,329 @@
+/**
+ * @file test_zip_reader.cpp
+ * @brief Unit tests for ZipReader and in-process ZIP member hashing.
+ *
+ * Archives are assembled in the test (stored and raw-deflate members) so no
+ * zip/unzip tools are needed. Hashes of members are compared with hashes of
+ * the same bytes written to a plain file.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QtEndian>
+#include <zlib.h>
+
+#include "../src/core/zip_reader.h"
+#include "../src/core/hasher.h"
+
+using namespace Remus;
+
+namespace {
+
+struct TestMember {
+    QString name;
+    QByteArray data;
+    bool deflate = true;
+};
+
+void put16(QByteArray &out, quint16 value)
+{
+    char buf[2];
+    qToLittleEndian(value, buf);
+    out.append(buf, 2);
+}
+
+void put32(QByteArray &out, quint32 value)
+{
+    char buf[4];
+    qToLittleEndian(value, buf);
+    out.append(buf, 4);
+}
+
+QByteArray rawDeflate(const QByteArray &data)
+{
+    z_stream stream{};
+    deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    QByteArray out(static_cast<int>(deflateBound(&stream, data.size())), Qt::Uninitialized);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    return out;
+}
+
+quint32 crcOf(const QByteArray &data)
+{
+    return static_cast<quint32>(crc32(0L, reinterpret_cast<const Bytef *>(data.constData()),
+                                      static_cast<uInt>(data.size())));
+}
+
+/// Minimal ZIP writer: local headers + central directory + EOCD
+QByteArray buildZip(const QList<TestMember> &members)
+{
+    QByteArray archive;
+    QByteArray central;
+    for (const TestMember &member : members) {
+        const QByteArray name = member.name.toUtf8();
+        const QByteArray payload = member.deflate ? rawDeflate(member.data) : member.data;
+        const quint16 method = member.deflate ? 8 : 0;
+        const quint32 crc = crcOf(member.data);
+        const quint32 offset = static_cast<quint32>(archive.size());
+
+        put32(archive, 0x04034b50);
+        put16(archive, 20);
+        put16(archive, 0x0800);
+        put16(archive, method);
+        put32(archive, 0);  // time + date
+        put32(archive, crc);
+        put32(archive, static_cast<quint32>(payload.size()));
+        put32(archive, static_cast<quint32>(member.data.size()));
+        put16(archive, static_cast<quint16>(name.size()));
+        put16(archive, 0);
+        archive.append(name);
+        archive.append(payload);
+
+        put32(central, 0x02014b50);
+        put16(central, 20);
+        put16(central, 20);
+        put16(central, 0x0800);
+        put16(central, method);
+        put32(central, 0);
+        put32(central, crc);
+        put32(central, static_cast<quint32>(payload.size()));
+        put32(central, static_cast<quint32>(member.data.size()));
+        put16(central, static_cast<quint16>(name.size()));
+        put16(central, 0);  // extra
+        put16(central, 0);  // comment
+        put16(central, 0);  // disk
+        put16(central, 0);  // internal attributes
+        put32(central, 0);  // external attributes
+        put32(central, offset);
+        central.append(name);
+    }
+
+    const quint32 centralOffset = static_cast<quint32>(archive.size());
+    archive.append(central);
+    put32(archive, 0x06054b50);
+    put16(archive, 0);
+    put16(archive, 0);
+    put16(archive, static_cast<quint16>(members.size()));
+    put16(archive, static_cast<quint16>(members.size()));
+    put32(archive, static_cast<quint32>(central.size()));
+    put32(archive, centralOffset);
+    put16(archive, 0);
+    return archive;
+}
+
+QString writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(data);
+    return path;
+}
+
+QByteArray patternData(qint64 size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    char *out = data.data();
+    for (qint64 i = 0; i < size; ++i) {
+        out[i] = static_cast<char>((i * 131 + (i >> 12)) & 0xFF);
+    }
+    return data;
+}
+
+} // namespace
+
+class ZipReaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testListsCentralDirectory();
+    void testStreamsStoredAndDeflated();
+    void testResolveEntry();
+    void testRejectsNonZip();
+    void testCorruptDataFails();
+    void testMemberHashesMatchPlainFile();
+    void testMemberHeaderStripping();
+    void testCrcOnlyUsesCentralDirectory();
+};
+
+void ZipReaderTest::testListsCentralDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray big = patternData(3 * ZipReader::OUTPUT_CHUNK_SIZE + 17);
+    const QString path = writeFile(dir.filePath("set.zip"), buildZip({
+        {"roms/game.sfc", big, true},
+        {"readme.txt", QByteArray("hello"), false},
+    }));
+    QVERIFY(!path.isEmpty());
+
+    ZipReader zip(path);
+    QVERIFY2(zip.open(), qPrintable(zip.errorString()));
+    QCOMPARE(zip.entries().size(), 2);
+
+    const ZipEntry &game = zip.entries().at(0);
+    QCOMPARE(game.name, QString("roms/game.sfc"));
+    QCOMPARE(game.method, quint16(8));
+    QCOMPARE(game.uncompressedSize, quint64(big.size()));
+    QCOMPARE(game.crc32, crcOf(big));
+    QVERIFY(game.isSupported());
+
+    QCOMPARE(zip.entries().at(1).method, quint16(0));
+    QCOMPARE(zip.entries().at(1).uncompressedSize, quint64(5));
+}
+
+void ZipReaderTest::testStreamsStoredAndDeflated()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray big = patternData(3 * ZipReader::OUTPUT_CHUNK_SIZE + 17);
+    const QByteArray small("stored bytes");
+    const QString path = writeFile(dir.filePath("set.zip"), buildZip({
+        {"a.bin", big, true},
+        {"b.bin", small, false},
+    }));
+
+    ZipReader zip(path);
+    QVERIFY(zip.open());
+
+    for (const ZipEntry &entry : zip.entries()) {
+        QByteArray collected;
+        int chunks = 0;
+        QString error;
+        QVERIFY2(zip.readEntry(entry, [&](const char *data, qint64 size) {
+            QVERIFY(size <= ZipReader::OUTPUT_CHUNK_SIZE);
+            collected.append(data, size);
+            chunks++;
+        }, error), qPrintable(error));
+        QCOMPARE(collected, entry.name == "a.bin" ? big : small);
+        if (entry.name == "a.bin") {
+            QVERIFY(chunks >= 4);
+        }
+    }
+}
+
+void ZipReaderTest::testResolveEntry()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir.filePath("set.zip"), buildZip({
+        {"docs/", QByteArray(), false},
+        {"info.txt", QByteArray("x"), false},
+        {"Game (USA).NES", QByteArray("y"), false},
+    }));
+
+    ZipReader zip(path);
+    QVERIFY(zip.open());
+    QCOMPARE(zip.resolveEntry("info.txt", ".nes")->name, QString("info.txt"));
+    QCOMPARE(zip.resolveEntry("renamed.nes", ".nes")->name, QString("Game (USA).NES"));
+    QCOMPARE(zip.resolveEntry("renamed.gb", ".gb")->name, QString("info.txt"));
+    QVERIFY(zip.findEntry("missing") == nullptr);
+}
+
+void ZipReaderTest::testRejectsNonZip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir.filePath("fake.zip"), patternData(4096));
+
+    ZipReader zip(path);
+    QVERIFY(!zip.open());
+    QVERIFY(!zip.errorString().isEmpty());
+
+    ZipReader missing(dir.filePath("missing.zip"));
+    QVERIFY(!missing.open());
+}
+
+void ZipReaderTest::testCorruptDataFails()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray data = patternData(256 * 1024);
+    QByteArray archive = buildZip({{"rom.bin", data, true}});
+    // Damage the middle of the compressed stream
+    for (int i = 200; i < 216; ++i) {
+        archive[i] = static_cast<char>(archive[i] ^ 0x5A);
+    }
+    const QString path = writeFile(dir.filePath("bad.zip"), archive);
+
+    Hasher hasher;
+    HashResult result = hasher.calculateZipMemberHashes(path, "rom.bin", ".bin");
+    QVERIFY(!result.success);
+    QVERIFY(!result.error.isEmpty());
+}
+
+void ZipReaderTest::testMemberHashesMatchPlainFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray data = patternData(2 * Hasher::CHUNK_SIZE + 333);
+    const QString plain = writeFile(dir.filePath("rom.md"), data);
+    const QString zipped = writeFile(dir.filePath("rom.zip"), buildZip({{"rom.md", data, true}}));
+
+    Hasher hasher;
+    const HashResult expected = hasher.calculateHashes(plain);
+    const HashResult actual = hasher.calculateZipMemberHashes(zipped, "rom.md", ".md");
+    QVERIFY2(actual.success, qPrintable(actual.error));
+    QCOMPARE(actual.crc32, expected.crc32);
+    QCOMPARE(actual.md5, expected.md5);
+    QCOMPARE(actual.sha1, expected.sha1);
+}
+
+void ZipReaderTest::testMemberHeaderStripping()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QByteArray data("NES\x1A", 4);
+    data.append(QByteArray(12, '\0'));
+    data.append(patternData(40 * 1024));
+    const QString plain = writeFile(dir.filePath("game.nes"), data);
+    const QString zipped = writeFile(dir.filePath("game.zip"), buildZip({{"game.nes", data, true}}));
+
+    Hasher hasher;
+    const HashResult expected = hasher.calculateHashes(plain, true, 16);
+    const HashResult actual = hasher.calculateZipMemberHashes(zipped, "game.nes", ".nes");
+    QVERIFY2(actual.success, qPrintable(actual.error));
+    QCOMPARE(actual.crc32, expected.crc32);
+    QCOMPARE(actual.sha1, expected.sha1);
+    QVERIFY(actual.crc32 != QString("%1").arg(crcOf(data), 8, 16, QChar('0')));
+
+    // Header-carrying extensions must still be streamed in CRC-only mode
+    const HashResult crcOnly = hasher.calculateZipMemberHashes(zipped, "game.nes", ".nes", true);
+    QVERIFY(crcOnly.success);
+    QCOMPARE(crcOnly.crc32, expected.crc32);
+    QVERIFY(crcOnly.md5.isEmpty());
+}
+
+void ZipReaderTest::testCrcOnlyUsesCentralDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray data = patternData(64 * 1024);
+    QByteArray archive = buildZip({{"rom.gb", data, false}});
+    // Corrupt member data: only the central directory may be consulted
+    archive[100] = static_cast<char>(archive[100] ^ 0xFF);
+    const QString path = writeFile(dir.filePath("rom.zip"), archive);
+
+    Hasher hasher;
+    const HashResult fast = hasher.calculateZipMemberHashes(path, "rom.gb", ".gb", true);
+    QVERIFY(fast.success);
+    QCOMPARE(fast.crc32, QString("%1").arg(crcOf(data), 8, 16, QChar('0')));
+    QVERIFY(fast.md5.isEmpty());
+    QVERIFY(fast.sha1.isEmpty());
+
+    // A full hash reads the data and notices the CRC mismatch
+    const HashResult full = hasher.calculateZipMemberHashes(path, "rom.gb", ".gb");
+    QVERIFY(!full.success);
+}
+
+QTEST_MAIN(ZipReaderTest)
+#include "test_zip_reader.moc"